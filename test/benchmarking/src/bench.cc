@@ -0,0 +1,420 @@
+/**
+ * @file   bench.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2017-2018 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file implements the benchmark harness used by `tiledb_bench`.
+ */
+
+#include "bench.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <type_traits>
+
+namespace tiledb {
+namespace bench {
+
+/* ****************************** */
+/*            BENCHMARK           */
+/* ****************************** */
+
+Benchmark::Benchmark(const std::string& name, const Params& params)
+    : name_(name)
+    , params_(params) {
+}
+
+Benchmark::~Benchmark() = default;
+
+const std::string& Benchmark::name() const {
+  return name_;
+}
+
+std::map<std::string, double> Benchmark::metrics() const {
+  return std::map<std::string, double>();
+}
+
+std::map<std::string, std::string> Benchmark::labels() const {
+  return std::map<std::string, std::string>();
+}
+
+int Benchmark::setup() {
+  return TILEDB_OK;
+}
+
+int Benchmark::pre_run() {
+  return TILEDB_OK;
+}
+
+int Benchmark::teardown() {
+  return TILEDB_OK;
+}
+
+/* ****************************** */
+/*             HARNESS            */
+/* ****************************** */
+
+int run_benchmark(Benchmark* benchmark, const Params& params, Result* result) {
+  result->name_ = benchmark->name();
+  result->latencies_ns_.clear();
+
+  if (benchmark->setup() != TILEDB_OK) {
+    benchmark->teardown();
+    return TILEDB_ERR;
+  }
+
+  uint64_t total = params.warmup_ + params.iterations_;
+  for (uint64_t i = 0; i < total; ++i) {
+    if (benchmark->pre_run() != TILEDB_OK) {
+      benchmark->teardown();
+      return TILEDB_ERR;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    int rc = benchmark->run();
+    auto end = std::chrono::steady_clock::now();
+    if (rc != TILEDB_OK) {
+      benchmark->teardown();
+      return TILEDB_ERR;
+    }
+
+    if (i >= params.warmup_)
+      result->latencies_ns_.push_back(
+          (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+              end - start)
+              .count());
+  }
+
+  // Collect the remaining info after the runs, since some metrics
+  // (e.g., compression ratios) are only known after a run
+  result->bytes_ = benchmark->bytes();
+  result->items_ = benchmark->items();
+  result->metrics_ = benchmark->metrics();
+  result->labels_ = benchmark->labels();
+
+  return benchmark->teardown();
+}
+
+/** Prints `str` as a JSON string literal. */
+static void json_string(FILE* out, const std::string& str) {
+  fputc('"', out);
+  for (auto c : str) {
+    if (c == '"' || c == '\\')
+      fputc('\\', out);
+    fputc(c, out);
+  }
+  fputc('"', out);
+}
+
+/** Prints `value` as a JSON number with a fixed number of decimals. */
+static void json_double(FILE* out, double value) {
+  if (std::isfinite(value))
+    fprintf(out, "%.3f", value);
+  else
+    fprintf(out, "null");
+}
+
+double median_latency_ns(const Result& result) {
+  auto sorted = result.latencies_ns_;
+  if (sorted.empty())
+    return 0;
+  std::sort(sorted.begin(), sorted.end());
+  size_t n = sorted.size();
+  return (n % 2 == 1) ?
+             (double)sorted[n / 2] :
+             ((double)sorted[n / 2 - 1] + (double)sorted[n / 2]) / 2;
+}
+
+void write_json_report(
+    const Params& params, const std::vector<Result>& results, FILE* out) {
+  int major, minor, rev;
+  tiledb_version(&major, &minor, &rev);
+
+  fprintf(out, "{\n");
+  fprintf(out, "  \"format_version\": 1,\n");
+  fprintf(out, "  \"tiledb_version\": \"%d.%d.%d\",\n", major, minor, rev);
+  fprintf(out, "  \"params\": {\n");
+  fprintf(out, "    \"iterations\": %" PRIu64 ",\n", params.iterations_);
+  fprintf(out, "    \"warmup\": %" PRIu64 ",\n", params.warmup_);
+  fprintf(out, "    \"seed\": %" PRIu64 ",\n", params.seed_);
+  fprintf(out, "    \"dim_size\": %" PRIu64 ",\n", params.dim_size_);
+  fprintf(out, "    \"tile_extent\": %" PRIu64 ",\n", params.tile_extent_);
+  fprintf(out, "    \"sparse_cells\": %" PRIu64 ",\n", params.sparse_cells_);
+  fprintf(
+      out, "    \"sparse_capacity\": %" PRIu64 ",\n", params.sparse_capacity_);
+  fprintf(out, "    \"fragment_num\": %" PRIu64 ",\n", params.fragment_num_);
+  fprintf(out, "    \"kv_items\": %" PRIu64 ",\n", params.kv_items_);
+  fprintf(
+      out,
+      "    \"compressor_bytes\": %" PRIu64 ",\n",
+      params.compressor_bytes_);
+  fprintf(
+      out,
+      "    \"compressor_tile_bytes\": %" PRIu64 ",\n",
+      params.compressor_tile_bytes_);
+  fprintf(out, "    \"compressor_levels\": [");
+  for (size_t i = 0; i < params.compressor_levels_.size(); ++i)
+    fprintf(out, "%s%d", (i == 0) ? "" : ", ", params.compressor_levels_[i]);
+  fprintf(out, "],\n");
+  fprintf(out, "    \"corpora\": [");
+  for (size_t i = 0; i < params.corpora_.size(); ++i) {
+    fprintf(out, (i == 0) ? "" : ", ");
+    json_string(out, params.corpora_[i]);
+  }
+  fprintf(out, "]\n");
+  fprintf(out, "  },\n");
+  fprintf(out, "  \"benchmarks\": [");
+
+  for (size_t r = 0; r < results.size(); ++r) {
+    const auto& result = results[r];
+    const auto& latencies = result.latencies_ns_;
+    double min = 0, max = 0, mean = 0, median = 0, stddev = 0;
+    if (!latencies.empty()) {
+      size_t n = latencies.size();
+      min = (double)*std::min_element(latencies.begin(), latencies.end());
+      max = (double)*std::max_element(latencies.begin(), latencies.end());
+      for (auto v : latencies)
+        mean += (double)v;
+      mean /= n;
+      median = median_latency_ns(result);
+      for (auto v : latencies)
+        stddev += ((double)v - mean) * ((double)v - mean);
+      stddev = std::sqrt(stddev / n);
+    }
+    double median_sec = median / 1e9;
+
+    fprintf(out, (r == 0) ? "\n" : ",\n");
+    fprintf(out, "    {\n");
+    fprintf(out, "      \"name\": ");
+    json_string(out, result.name_);
+    fprintf(out, ",\n");
+    fprintf(out, "      \"labels\": {");
+    size_t i = 0;
+    for (const auto& label : result.labels_) {
+      fprintf(out, (i++ == 0) ? "" : ", ");
+      json_string(out, label.first);
+      fprintf(out, ": ");
+      json_string(out, label.second);
+    }
+    fprintf(out, "},\n");
+    fprintf(
+        out,
+        "      \"iterations\": %" PRIu64 ",\n",
+        (uint64_t)result.latencies_ns_.size());
+    fprintf(out, "      \"bytes\": %" PRIu64 ",\n", result.bytes_);
+    fprintf(out, "      \"items\": %" PRIu64 ",\n", result.items_);
+    fprintf(out, "      \"latency_ns\": {\"min\": ");
+    json_double(out, min);
+    fprintf(out, ", \"median\": ");
+    json_double(out, median);
+    fprintf(out, ", \"mean\": ");
+    json_double(out, mean);
+    fprintf(out, ", \"max\": ");
+    json_double(out, max);
+    fprintf(out, ", \"stddev\": ");
+    json_double(out, stddev);
+    fprintf(out, "},\n");
+    fprintf(out, "      \"throughput_mb_per_sec\": ");
+    json_double(
+        out, (median_sec > 0) ? result.bytes_ / median_sec / 1e6 : 0.0);
+    fprintf(out, ",\n");
+    fprintf(out, "      \"items_per_sec\": ");
+    json_double(out, (median_sec > 0) ? result.items_ / median_sec : 0.0);
+    fprintf(out, ",\n");
+    fprintf(out, "      \"metrics\": {");
+    i = 0;
+    for (const auto& metric : result.metrics_) {
+      fprintf(out, (i++ == 0) ? "" : ", ");
+      json_string(out, metric.first);
+      fprintf(out, ": ");
+      json_double(out, metric.second);
+    }
+    fprintf(out, "}\n");
+    fprintf(out, "    }");
+  }
+
+  fprintf(out, "%s]\n", results.empty() ? "" : "\n  ");
+  fprintf(out, "}\n");
+}
+
+/* ****************************** */
+/*             HELPERS            */
+/* ****************************** */
+
+int check_rc(tiledb_ctx_t* ctx, int rc, const char* what) {
+  if (rc == TILEDB_OK)
+    return rc;
+
+  const char* msg = "unknown error";
+  tiledb_error_t* err = nullptr;
+  if (ctx != nullptr)
+    tiledb_ctx_get_last_error(ctx, &err);
+  if (err != nullptr)
+    tiledb_error_message(err, &msg);
+  fprintf(stderr, "[tiledb_bench] %s failed: %s\n", what, msg);
+  if (err != nullptr)
+    tiledb_error_free(&err);
+
+  return rc;
+}
+
+int remove_if_exists(tiledb_ctx_t* ctx, const std::string& uri) {
+  tiledb_object_t type;
+  if (check_rc(ctx, tiledb_object_type(ctx, uri.c_str(), &type), "type") !=
+      TILEDB_OK)
+    return TILEDB_ERR;
+  if (type == TILEDB_INVALID)
+    return TILEDB_OK;
+  return check_rc(ctx, tiledb_object_remove(ctx, uri.c_str()), uri.c_str());
+}
+
+DataGenerator::DataGenerator(uint64_t seed)
+    : engine_(seed) {
+}
+
+/** Draws a uniform integral value in `[low, high]`. */
+template <class T>
+static T draw(std::mt19937_64& engine, T low, T high, std::true_type) {
+  return std::uniform_int_distribution<T>(low, high)(engine);
+}
+
+/** Draws a uniform floating-point value in `[low, high)`. */
+template <class T>
+static T draw(std::mt19937_64& engine, T low, T high, std::false_type) {
+  return std::uniform_real_distribution<T>(low, high)(engine);
+}
+
+template <class T>
+std::vector<T> DataGenerator::uniform(uint64_t num, T low, T high) {
+  std::vector<T> ret(num);
+  for (uint64_t i = 0; i < num; ++i)
+    ret[i] = draw<T>(engine_, low, high, std::is_integral<T>());
+  return ret;
+}
+
+template <class T>
+std::vector<T> DataGenerator::runs(uint64_t num, uint64_t run_len) {
+  std::vector<T> ret(num);
+  std::uniform_int_distribution<uint64_t> next(0, 2 * run_len);
+  T value = T();
+  uint64_t left = next(engine_);
+  for (uint64_t i = 0; i < num; ++i) {
+    if (left == 0) {
+      value = value + T(1);
+      left = next(engine_);
+    } else {
+      --left;
+    }
+    ret[i] = value;
+  }
+  return ret;
+}
+
+template <class T>
+std::vector<T> DataGenerator::sorted(uint64_t num, T low, T high) {
+  auto ret = uniform<T>(num, low, high);
+  std::sort(ret.begin(), ret.end());
+  return ret;
+}
+
+std::vector<int64_t> DataGenerator::timestamps(
+    uint64_t num, int64_t start, int64_t step, int64_t jitter) {
+  std::vector<int64_t> ret(num);
+  std::uniform_int_distribution<int64_t> next(0, jitter);
+  int64_t value = start;
+  for (uint64_t i = 0; i < num; ++i) {
+    ret[i] = value;
+    value += step + next(engine_);
+  }
+  return ret;
+}
+
+std::vector<double> DataGenerator::readings(
+    uint64_t num, double start, double step) {
+  std::vector<double> ret(num);
+  std::uniform_int_distribution<int> next(-1, 1);
+  int64_t steps = 0;
+  for (uint64_t i = 0; i < num; ++i) {
+    ret[i] = start + steps * step;
+    steps += next(engine_);
+  }
+  return ret;
+}
+
+std::vector<char> DataGenerator::strings(
+    uint64_t nbytes, uint64_t cardinality) {
+  // Create the vocabulary
+  std::uniform_int_distribution<int> letter('a', 'z');
+  std::uniform_int_distribution<int> len(4, 12);
+  std::vector<std::string> words(std::max<uint64_t>(cardinality, 1));
+  for (auto& word : words) {
+    word.resize(len(engine_));
+    for (auto& c : word)
+      c = (char)letter(engine_);
+  }
+
+  // Concatenate random words, truncating the last one
+  std::vector<char> ret;
+  ret.reserve(nbytes);
+  std::uniform_int_distribution<uint64_t> pick(0, words.size() - 1);
+  while (ret.size() < nbytes) {
+    const auto& word = words[pick(engine_)];
+    auto n = std::min<uint64_t>(word.size(), nbytes - ret.size());
+    ret.insert(ret.end(), word.begin(), word.begin() + n);
+  }
+  return ret;
+}
+
+std::vector<uint64_t> DataGenerator::coords_2d(
+    uint64_t num, uint64_t dim_size) {
+  return uniform<uint64_t>(2 * num, 1, dim_size);
+}
+
+// Explicit template instantiations
+template std::vector<int32_t> DataGenerator::uniform<int32_t>(
+    uint64_t num, int32_t low, int32_t high);
+template std::vector<int64_t> DataGenerator::uniform<int64_t>(
+    uint64_t num, int64_t low, int64_t high);
+template std::vector<uint64_t> DataGenerator::uniform<uint64_t>(
+    uint64_t num, uint64_t low, uint64_t high);
+template std::vector<float> DataGenerator::uniform<float>(
+    uint64_t num, float low, float high);
+template std::vector<double> DataGenerator::uniform<double>(
+    uint64_t num, double low, double high);
+template std::vector<int32_t> DataGenerator::runs<int32_t>(
+    uint64_t num, uint64_t run_len);
+template std::vector<int64_t> DataGenerator::runs<int64_t>(
+    uint64_t num, uint64_t run_len);
+template std::vector<double> DataGenerator::runs<double>(
+    uint64_t num, uint64_t run_len);
+template std::vector<int64_t> DataGenerator::sorted<int64_t>(
+    uint64_t num, int64_t low, int64_t high);
+
+}  // namespace bench
+}  // namespace tiledb
@@ -0,0 +1,346 @@
+/**
+ * @file   bench.h
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2017-2018 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file declares the benchmark harness used by `tiledb_bench`.
+ */
+
+#ifndef TILEDB_BENCH_H
+#define TILEDB_BENCH_H
+
+#include <tiledb.h>
+
+#include <cinttypes>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace tiledb {
+namespace bench {
+
+/* ********************************* */
+/*             PARAMETERS            */
+/* ********************************* */
+
+/** The parameters shared by all benchmarks of a run. */
+struct Params {
+  /** Only benchmarks whose name contains this string are run. */
+  std::string filter_;
+  /** Directory in which the benchmark arrays are created. */
+  std::string dir_;
+  /** File the JSON report is written to (empty means stdout). */
+  std::string output_;
+  /** Number of timed iterations per benchmark. */
+  uint64_t iterations_;
+  /** Number of untimed warm-up iterations per benchmark. */
+  uint64_t warmup_;
+  /** Seed of the synthetic data generators. */
+  uint64_t seed_;
+  /** Number of cells along each dimension of the 2D benchmark arrays. */
+  uint64_t dim_size_;
+  /** Tile extent along each dimension of the 2D benchmark arrays. */
+  uint64_t tile_extent_;
+  /** Number of cells written in the sparse benchmarks. */
+  uint64_t sparse_cells_;
+  /** Tile capacity of the sparse benchmark arrays. */
+  uint64_t sparse_capacity_;
+  /** Number of fragments consolidated in the consolidation benchmark. */
+  uint64_t fragment_num_;
+  /** Number of items written and looked up in the key-value benchmarks. */
+  uint64_t kv_items_;
+  /** Number of bytes compressed in the compressor benchmarks. */
+  uint64_t compressor_bytes_;
+  /**
+   * Size of the tiles the compressor corpora are also split into (`0`
+   * means that each corpus is compressed only as a single tile).
+   */
+  uint64_t compressor_tile_bytes_;
+  /**
+   * Levels the compressor benchmarks are run at (`-1` is the compressor
+   * default). Compressors without levels are run only once.
+   */
+  std::vector<int> compressor_levels_;
+  /**
+   * User-supplied compressor corpora, each in the form `path[:DATATYPE]`.
+   * The file is treated as a single tile of `DATATYPE` (default `UINT8`).
+   */
+  std::vector<std::string> corpora_;
+
+  Params() {
+    dir_ = "tiledb_bench_arrays";
+    iterations_ = 5;
+    warmup_ = 1;
+    seed_ = 0;
+    dim_size_ = 1000;
+    tile_extent_ = 100;
+    sparse_cells_ = 1000000;
+    sparse_capacity_ = 10000;
+    fragment_num_ = 4;
+    kv_items_ = 10000;
+    compressor_bytes_ = 8 * 1024 * 1024;
+    compressor_tile_bytes_ = 64 * 1024;
+    compressor_levels_ = {-1};
+  }
+};
+
+/* ********************************* */
+/*             BENCHMARK             */
+/* ********************************* */
+
+/**
+ * Base class of all benchmarks. The harness invokes `setup` once, then
+ * `pre_run` (untimed) followed by `run` (timed) for every warm-up and timed
+ * iteration, and finally `teardown`. All functions return `TILEDB_OK` on
+ * success.
+ */
+class Benchmark {
+ public:
+  /** Constructor. */
+  Benchmark(const std::string& name, const Params& params);
+
+  /** Destructor. */
+  virtual ~Benchmark();
+
+  /** Returns the benchmark name. */
+  const std::string& name() const;
+
+  /**
+   * Returns the number of logical bytes processed by one `run`, used to
+   * compute the reported throughput.
+   */
+  virtual uint64_t bytes() const = 0;
+
+  /** Returns the number of cells/items processed by one `run`. */
+  virtual uint64_t items() const = 0;
+
+  /**
+   * Returns extra benchmark-specific metrics (e.g., compression ratio)
+   * to be included in the report.
+   */
+  virtual std::map<std::string, double> metrics() const;
+
+  /** Returns extra labels (e.g., layout, compressor) for the report. */
+  virtual std::map<std::string, std::string> labels() const;
+
+  /** Prepares state shared by all iterations. */
+  virtual int setup();
+
+  /** Prepares a single iteration. It is not timed. */
+  virtual int pre_run();
+
+  /** Runs the timed part of a single iteration. */
+  virtual int run() = 0;
+
+  /** Cleans up all state. */
+  virtual int teardown();
+
+ protected:
+  /** The benchmark name. */
+  std::string name_;
+
+  /** The run parameters. */
+  const Params& params_;
+};
+
+/** The outcome of running a single benchmark. */
+struct Result {
+  /** The benchmark name. */
+  std::string name_;
+  /** Logical bytes processed per iteration. */
+  uint64_t bytes_;
+  /** Cells/items processed per iteration. */
+  uint64_t items_;
+  /** Wall-clock latency of each timed iteration, in nanoseconds. */
+  std::vector<uint64_t> latencies_ns_;
+  /** Benchmark-specific metrics. */
+  std::map<std::string, double> metrics_;
+  /** Benchmark-specific labels. */
+  std::map<std::string, std::string> labels_;
+};
+
+/** A list of benchmarks. */
+typedef std::vector<std::unique_ptr<Benchmark>> BenchmarkList;
+
+/** Adds the dense and sparse array benchmarks to `benchmarks`. */
+void add_array_benchmarks(const Params& params, BenchmarkList* benchmarks);
+
+/** Adds the key-value store benchmarks to `benchmarks`. */
+void add_kv_benchmarks(const Params& params, BenchmarkList* benchmarks);
+
+/** Adds the consolidation benchmarks to `benchmarks`. */
+void add_consolidation_benchmarks(
+    const Params& params, BenchmarkList* benchmarks);
+
+/**
+ * Adds the compressor benchmarks to `benchmarks`, one compression and one
+ * decompression benchmark per compressor, level and corpus.
+ *
+ * @return `TILEDB_OK` on success and `TILEDB_ERR` if a corpus in
+ *     `params.corpora_` is malformed.
+ */
+int add_compressor_benchmarks(const Params& params, BenchmarkList* benchmarks);
+
+/* ********************************* */
+/*              HARNESS              */
+/* ********************************* */
+
+/**
+ * Runs a benchmark according to `params`, storing the timings in `result`.
+ *
+ * @return `TILEDB_OK` on success and `TILEDB_ERR` otherwise.
+ */
+int run_benchmark(Benchmark* benchmark, const Params& params, Result* result);
+
+/** Returns the median latency of `result`, in nanoseconds. */
+double median_latency_ns(const Result& result);
+
+/**
+ * Writes the results of a run as a JSON document. The document layout and
+ * the key order are stable across versions so that reports can be diffed.
+ */
+void write_json_report(
+    const Params& params, const std::vector<Result>& results, FILE* out);
+
+/**
+ * Writes a table with the compression ratio and the compression and
+ * decompression throughput (GB/s) of every compressor, level and corpus
+ * found in `results`.
+ */
+void write_compressor_summary(const std::vector<Result>& results, FILE* out);
+
+/* ********************************* */
+/*              HELPERS              */
+/* ********************************* */
+
+/**
+ * Checks the return code of a TileDB C API call. On failure it prints the
+ * last error of `ctx` to stderr, prefixed by `what`.
+ *
+ * @return `rc`.
+ */
+int check_rc(tiledb_ctx_t* ctx, int rc, const char* what);
+
+/**
+ * Evaluates a TileDB C API call and returns `TILEDB_ERR` from the calling
+ * function if it fails.
+ */
+#define BENCH_RETURN_NOT_OK(ctx, call)                   \
+  do {                                                   \
+    if (check_rc((ctx), (call), #call) != TILEDB_OK)     \
+      return TILEDB_ERR;                                 \
+  } while (false)
+
+/** Removes the object at `uri` if it exists. */
+int remove_if_exists(tiledb_ctx_t* ctx, const std::string& uri);
+
+/**
+ * Creates a 2D array at `uri` with `uint64_t` dimensions over
+ * `[1, dim_size]^2` and a single `int32_t` attribute `a`. Any existing
+ * object at `uri` is removed first.
+ */
+int create_array(
+    tiledb_ctx_t* ctx,
+    const std::string& uri,
+    tiledb_array_type_t type,
+    const Params& params);
+
+/**
+ * Writes `a` (and `coords`, if not `nullptr`) to the array created with
+ * `create_array`, in a single query.
+ *
+ * @param ctx The TileDB context.
+ * @param uri The array URI.
+ * @param layout The write layout.
+ * @param subarray The subarray to write (`nullptr` for none).
+ * @param a The attribute values.
+ * @param coords The coordinates, for sparse writes.
+ * @return `TILEDB_OK` on success and `TILEDB_ERR` otherwise.
+ */
+int write_array(
+    tiledb_ctx_t* ctx,
+    const std::string& uri,
+    tiledb_layout_t layout,
+    const uint64_t* subarray,
+    std::vector<int32_t>* a,
+    std::vector<uint64_t>* coords);
+
+/** Deterministic generators of synthetic benchmark data. */
+class DataGenerator {
+ public:
+  /** Constructor. */
+  explicit DataGenerator(uint64_t seed);
+
+  /** Returns `num` uniformly random values in `[low, high]`. */
+  template <class T>
+  std::vector<T> uniform(uint64_t num, T low, T high);
+
+  /**
+   * Returns `num` values of a slowly increasing series, where a new value
+   * is produced every `run_len` values on average (suitable for RLE-like
+   * and delta-like compressors).
+   */
+  template <class T>
+  std::vector<T> runs(uint64_t num, uint64_t run_len);
+
+  /** Returns `num` sorted uniformly random values in `[low, high]`. */
+  template <class T>
+  std::vector<T> sorted(uint64_t num, T low, T high);
+
+  /**
+   * Returns `num` increasing timestamps starting at `start`, spaced by
+   * `step` plus a random jitter in `[0, jitter]`.
+   */
+  std::vector<int64_t> timestamps(
+      uint64_t num, int64_t start, int64_t step, int64_t jitter);
+
+  /**
+   * Returns `num` slowly varying sensor readings starting at `start`, each
+   * staying the same or moving by `step` from the previous one.
+   */
+  std::vector<double> readings(uint64_t num, double start, double step);
+
+  /**
+   * Returns `nbytes` bytes of concatenated strings drawn from a vocabulary
+   * of `cardinality` random lower-case words of 4 to 12 characters.
+   */
+  std::vector<char> strings(uint64_t nbytes, uint64_t cardinality);
+
+  /** Returns `num` random 2D coordinates within `[1, dim_size]^2`. */
+  std::vector<uint64_t> coords_2d(uint64_t num, uint64_t dim_size);
+
+ private:
+  /** The pseudo-random engine. */
+  std::mt19937_64 engine_;
+};
+
+}  // namespace bench
+}  // namespace tiledb
+
+#endif  // TILEDB_BENCH_H
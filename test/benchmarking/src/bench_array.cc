@@ -0,0 +1,553 @@
+/**
+ * @file   bench_array.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2017-2018 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * Dense and sparse array write/read benchmarks. All arrays are 2D with
+ * `uint64_t` dimensions over `[1, dim_size]^2` and a single `int32_t`
+ * attribute `a`.
+ */
+
+#include "bench.h"
+
+#include <climits>
+
+namespace tiledb {
+namespace bench {
+
+/* ****************************** */
+/*             HELPERS            */
+/* ****************************** */
+
+int create_array(
+    tiledb_ctx_t* ctx,
+    const std::string& uri,
+    tiledb_array_type_t type,
+    const Params& params) {
+  uint64_t dim_domain[] = {1, params.dim_size_, 1, params.dim_size_};
+  uint64_t tile_extent = params.tile_extent_;
+
+  tiledb_dimension_t *d1 = nullptr, *d2 = nullptr;
+  tiledb_domain_t* domain = nullptr;
+  tiledb_attribute_t* a = nullptr;
+  tiledb_array_schema_t* schema = nullptr;
+
+  int rc = check_rc(
+      ctx,
+      tiledb_dimension_create(
+          ctx, &d1, "d1", TILEDB_UINT64, &dim_domain[0], &tile_extent),
+      "tiledb_dimension_create");
+  if (rc == TILEDB_OK)
+    rc = check_rc(
+        ctx,
+        tiledb_dimension_create(
+            ctx, &d2, "d2", TILEDB_UINT64, &dim_domain[2], &tile_extent),
+        "tiledb_dimension_create");
+  if (rc == TILEDB_OK)
+    rc = check_rc(
+        ctx, tiledb_domain_create(ctx, &domain), "tiledb_domain_create");
+  if (rc == TILEDB_OK)
+    rc = check_rc(
+        ctx,
+        tiledb_domain_add_dimension(ctx, domain, d1),
+        "tiledb_domain_add_dimension");
+  if (rc == TILEDB_OK)
+    rc = check_rc(
+        ctx,
+        tiledb_domain_add_dimension(ctx, domain, d2),
+        "tiledb_domain_add_dimension");
+  if (rc == TILEDB_OK)
+    rc = check_rc(
+        ctx,
+        tiledb_attribute_create(ctx, &a, "a", TILEDB_INT32),
+        "tiledb_attribute_create");
+  if (rc == TILEDB_OK)
+    rc = check_rc(
+        ctx,
+        tiledb_array_schema_create(ctx, &schema, type),
+        "tiledb_array_schema_create");
+  if (rc == TILEDB_OK)
+    rc = check_rc(
+        ctx,
+        tiledb_array_schema_set_domain(ctx, schema, domain),
+        "tiledb_array_schema_set_domain");
+  if (rc == TILEDB_OK)
+    rc = check_rc(
+        ctx,
+        tiledb_array_schema_add_attribute(ctx, schema, a),
+        "tiledb_array_schema_add_attribute");
+  if (rc == TILEDB_OK && type == TILEDB_SPARSE)
+    rc = check_rc(
+        ctx,
+        tiledb_array_schema_set_capacity(
+            ctx, schema, params.sparse_capacity_),
+        "tiledb_array_schema_set_capacity");
+  if (rc == TILEDB_OK)
+    rc = remove_if_exists(ctx, uri);
+  if (rc == TILEDB_OK)
+    rc = check_rc(
+        ctx,
+        tiledb_array_create(ctx, uri.c_str(), schema),
+        "tiledb_array_create");
+
+  if (a != nullptr)
+    tiledb_attribute_free(ctx, &a);
+  if (d1 != nullptr)
+    tiledb_dimension_free(ctx, &d1);
+  if (d2 != nullptr)
+    tiledb_dimension_free(ctx, &d2);
+  if (domain != nullptr)
+    tiledb_domain_free(ctx, &domain);
+  if (schema != nullptr)
+    tiledb_array_schema_free(ctx, &schema);
+
+  return rc;
+}
+
+int write_array(
+    tiledb_ctx_t* ctx,
+    const std::string& uri,
+    tiledb_layout_t layout,
+    const uint64_t* subarray,
+    std::vector<int32_t>* a,
+    std::vector<uint64_t>* coords) {
+  const char* attributes[] = {"a", TILEDB_COORDS};
+  void* buffers[] = {a->data(), nullptr};
+  uint64_t buffer_sizes[] = {a->size() * sizeof(int32_t), 0};
+  unsigned attribute_num = 1;
+  if (coords != nullptr) {
+    buffers[1] = coords->data();
+    buffer_sizes[1] = coords->size() * sizeof(uint64_t);
+    attribute_num = 2;
+  }
+
+  tiledb_query_t* query;
+  BENCH_RETURN_NOT_OK(
+      ctx, tiledb_query_create(ctx, &query, uri.c_str(), TILEDB_WRITE));
+  int rc = check_rc(
+      ctx, tiledb_query_set_layout(ctx, query, layout), "set_layout");
+  if (rc == TILEDB_OK && subarray != nullptr)
+    rc = check_rc(
+        ctx, tiledb_query_set_subarray(ctx, query, subarray), "set_subarray");
+  if (rc == TILEDB_OK)
+    rc = check_rc(
+        ctx,
+        tiledb_query_set_buffers(
+            ctx, query, attributes, attribute_num, buffers, buffer_sizes),
+        "set_buffers");
+  if (rc == TILEDB_OK)
+    rc = check_rc(ctx, tiledb_query_submit(ctx, query), "tiledb_query_submit");
+  if (rc == TILEDB_OK)
+    rc = check_rc(
+        ctx, tiledb_query_finalize(ctx, query), "tiledb_query_finalize");
+  tiledb_query_free(ctx, &query);
+
+  return rc;
+}
+
+/** Returns the string representation of a layout. */
+static const char* layout_str(tiledb_layout_t layout) {
+  switch (layout) {
+    case TILEDB_ROW_MAJOR:
+      return "row_major";
+    case TILEDB_COL_MAJOR:
+      return "col_major";
+    case TILEDB_GLOBAL_ORDER:
+      return "global_order";
+    case TILEDB_UNORDERED:
+      return "unordered";
+  }
+  return "";
+}
+
+/* ****************************** */
+/*         ARRAY BENCHMARK        */
+/* ****************************** */
+
+/** Base class of the array benchmarks, owning a context and an array URI. */
+class ArrayBenchmark : public Benchmark {
+ public:
+  ArrayBenchmark(
+      const std::string& name,
+      const Params& params,
+      tiledb_array_type_t array_type,
+      tiledb_layout_t layout)
+      : Benchmark(name, params)
+      , array_type_(array_type)
+      , ctx_(nullptr)
+      , layout_(layout)
+      , uri_(params.dir_ + "/" + name) {
+  }
+
+  ~ArrayBenchmark() {
+    if (ctx_ != nullptr)
+      tiledb_ctx_free(&ctx_);
+  }
+
+  std::map<std::string, std::string> labels() const override {
+    std::map<std::string, std::string> ret;
+    ret["array_type"] = (array_type_ == TILEDB_DENSE) ? "dense" : "sparse";
+    ret["layout"] = layout_str(layout_);
+    return ret;
+  }
+
+  int setup() override {
+    if (tiledb_ctx_create(&ctx_, nullptr) != TILEDB_OK)
+      return TILEDB_ERR;
+    return TILEDB_OK;
+  }
+
+  int teardown() override {
+    return remove_if_exists(ctx_, uri_);
+  }
+
+ protected:
+  /** The array type. */
+  tiledb_array_type_t array_type_;
+
+  /** The TileDB context. */
+  tiledb_ctx_t* ctx_;
+
+  /** The query layout. */
+  tiledb_layout_t layout_;
+
+  /** The array URI. */
+  std::string uri_;
+
+  /** Returns the full array domain as a subarray. */
+  std::vector<uint64_t> full_domain() const {
+    return {1, params_.dim_size_, 1, params_.dim_size_};
+  }
+};
+
+/* ****************************** */
+/*         DENSE BENCHMARKS       */
+/* ****************************** */
+
+/** Writes the entire dense array with a given layout. */
+class DenseWrite : public ArrayBenchmark {
+ public:
+  DenseWrite(const Params& params, tiledb_layout_t layout)
+      : ArrayBenchmark(
+            std::string("dense_write_") + layout_str(layout),
+            params,
+            TILEDB_DENSE,
+            layout) {
+  }
+
+  uint64_t bytes() const override {
+    return a_.size() * sizeof(int32_t);
+  }
+
+  uint64_t items() const override {
+    return a_.size();
+  }
+
+  int setup() override {
+    if (ArrayBenchmark::setup() != TILEDB_OK)
+      return TILEDB_ERR;
+    DataGenerator gen(params_.seed_);
+    uint64_t cell_num = params_.dim_size_ * params_.dim_size_;
+    a_ = gen.uniform<int32_t>(cell_num, INT_MIN, INT_MAX);
+    return TILEDB_OK;
+  }
+
+  int pre_run() override {
+    return create_array(ctx_, uri_, TILEDB_DENSE, params_);
+  }
+
+  int run() override {
+    auto subarray = full_domain();
+    return write_array(
+        ctx_,
+        uri_,
+        layout_,
+        (layout_ == TILEDB_GLOBAL_ORDER) ? nullptr : subarray.data(),
+        &a_,
+        nullptr);
+  }
+
+ private:
+  /** The attribute values. */
+  std::vector<int32_t> a_;
+};
+
+/** Reads the entire dense array with a given layout. */
+class DenseRead : public ArrayBenchmark {
+ public:
+  DenseRead(const Params& params, tiledb_layout_t layout)
+      : ArrayBenchmark(
+            std::string("dense_read_") + layout_str(layout),
+            params,
+            TILEDB_DENSE,
+            layout) {
+  }
+
+  uint64_t bytes() const override {
+    return a_.size() * sizeof(int32_t);
+  }
+
+  uint64_t items() const override {
+    return a_.size();
+  }
+
+  int setup() override {
+    if (ArrayBenchmark::setup() != TILEDB_OK)
+      return TILEDB_ERR;
+    DataGenerator gen(params_.seed_);
+    uint64_t cell_num = params_.dim_size_ * params_.dim_size_;
+    a_ = gen.uniform<int32_t>(cell_num, INT_MIN, INT_MAX);
+    if (create_array(ctx_, uri_, TILEDB_DENSE, params_) != TILEDB_OK)
+      return TILEDB_ERR;
+    auto subarray = full_domain();
+    return write_array(
+        ctx_, uri_, TILEDB_ROW_MAJOR, subarray.data(), &a_, nullptr);
+  }
+
+  int run() override {
+    auto subarray = full_domain();
+    const char* attributes[] = {"a"};
+    void* buffers[] = {a_.data()};
+    uint64_t buffer_sizes[] = {a_.size() * sizeof(int32_t)};
+
+    tiledb_query_t* query;
+    BENCH_RETURN_NOT_OK(
+        ctx_, tiledb_query_create(ctx_, &query, uri_.c_str(), TILEDB_READ));
+    int rc = check_rc(
+        ctx_, tiledb_query_set_layout(ctx_, query, layout_), "set_layout");
+    if (rc == TILEDB_OK)
+      rc = check_rc(
+          ctx_,
+          tiledb_query_set_subarray(ctx_, query, subarray.data()),
+          "set_subarray");
+    if (rc == TILEDB_OK)
+      rc = check_rc(
+          ctx_,
+          tiledb_query_set_buffers(
+              ctx_, query, attributes, 1, buffers, buffer_sizes),
+          "set_buffers");
+    if (rc == TILEDB_OK)
+      rc = check_rc(
+          ctx_, tiledb_query_submit(ctx_, query), "tiledb_query_submit");
+    tiledb_query_free(ctx_, &query);
+
+    return rc;
+  }
+
+ private:
+  /** The attribute values (also used as the read buffer). */
+  std::vector<int32_t> a_;
+};
+
+/* ****************************** */
+/*        SPARSE BENCHMARKS       */
+/* ****************************** */
+
+/** Writes random cells to a sparse array in unordered layout. */
+class SparseWriteUnordered : public ArrayBenchmark {
+ public:
+  explicit SparseWriteUnordered(const Params& params)
+      : ArrayBenchmark(
+            "sparse_write_unordered", params, TILEDB_SPARSE, TILEDB_UNORDERED) {
+  }
+
+  uint64_t bytes() const override {
+    return a_.size() * sizeof(int32_t) + coords_.size() * sizeof(uint64_t);
+  }
+
+  uint64_t items() const override {
+    return a_.size();
+  }
+
+  int setup() override {
+    if (ArrayBenchmark::setup() != TILEDB_OK)
+      return TILEDB_ERR;
+    DataGenerator gen(params_.seed_);
+    a_ = gen.uniform<int32_t>(params_.sparse_cells_, INT_MIN, INT_MAX);
+    coords_ = gen.coords_2d(params_.sparse_cells_, params_.dim_size_);
+    return TILEDB_OK;
+  }
+
+  int pre_run() override {
+    return create_array(ctx_, uri_, TILEDB_SPARSE, params_);
+  }
+
+  int run() override {
+    // The write sorts the input buffers in place, so write copies
+    auto a = a_;
+    auto coords = coords_;
+    return write_array(ctx_, uri_, TILEDB_UNORDERED, nullptr, &a, &coords);
+  }
+
+ private:
+  /** The attribute values. */
+  std::vector<int32_t> a_;
+
+  /** The coordinates. */
+  std::vector<uint64_t> coords_;
+};
+
+/**
+ * Reads the central subarray (a quarter of the domain) of a sparse array
+ * populated with random cells.
+ */
+class SparseReadSubarray : public ArrayBenchmark {
+ public:
+  SparseReadSubarray(const Params& params, tiledb_layout_t layout)
+      : ArrayBenchmark(
+            std::string("sparse_read_subarray_") + layout_str(layout),
+            params,
+            TILEDB_SPARSE,
+            layout)
+      , result_bytes_(0)
+      , result_num_(0) {
+  }
+
+  uint64_t bytes() const override {
+    return result_bytes_;
+  }
+
+  uint64_t items() const override {
+    return result_num_;
+  }
+
+  int setup() override {
+    if (ArrayBenchmark::setup() != TILEDB_OK)
+      return TILEDB_ERR;
+    DataGenerator gen(params_.seed_);
+    auto a = gen.uniform<int32_t>(params_.sparse_cells_, INT_MIN, INT_MAX);
+    auto coords = gen.coords_2d(params_.sparse_cells_, params_.dim_size_);
+    if (create_array(ctx_, uri_, TILEDB_SPARSE, params_) != TILEDB_OK)
+      return TILEDB_ERR;
+    if (write_array(ctx_, uri_, TILEDB_UNORDERED, nullptr, &a, &coords) !=
+        TILEDB_OK)
+      return TILEDB_ERR;
+
+    uint64_t quarter = params_.dim_size_ / 4;
+    subarray_ = {quarter + 1,
+                 params_.dim_size_ - quarter,
+                 quarter + 1,
+                 params_.dim_size_ - quarter};
+
+    const char* attributes[] = {"a", TILEDB_COORDS};
+    uint64_t buffer_sizes[2];
+    BENCH_RETURN_NOT_OK(
+        ctx_,
+        tiledb_array_compute_max_read_buffer_sizes(
+            ctx_, uri_.c_str(), subarray_.data(), attributes, 2, buffer_sizes));
+    a_.resize(buffer_sizes[0] / sizeof(int32_t) + 1);
+    coords_.resize(buffer_sizes[1] / sizeof(uint64_t) + 2);
+
+    return TILEDB_OK;
+  }
+
+  int run() override {
+    const char* attributes[] = {"a", TILEDB_COORDS};
+    void* buffers[] = {a_.data(), coords_.data()};
+    uint64_t buffer_sizes[] = {a_.size() * sizeof(int32_t),
+                               coords_.size() * sizeof(uint64_t)};
+
+    tiledb_query_t* query;
+    BENCH_RETURN_NOT_OK(
+        ctx_, tiledb_query_create(ctx_, &query, uri_.c_str(), TILEDB_READ));
+    int rc = check_rc(
+        ctx_, tiledb_query_set_layout(ctx_, query, layout_), "set_layout");
+    if (rc == TILEDB_OK)
+      rc = check_rc(
+          ctx_,
+          tiledb_query_set_subarray(ctx_, query, subarray_.data()),
+          "set_subarray");
+    if (rc == TILEDB_OK)
+      rc = check_rc(
+          ctx_,
+          tiledb_query_set_buffers(
+              ctx_, query, attributes, 2, buffers, buffer_sizes),
+          "set_buffers");
+
+    // Resubmit until all results are retrieved
+    result_bytes_ = 0;
+    result_num_ = 0;
+    tiledb_query_status_t status = TILEDB_INCOMPLETE;
+    while (rc == TILEDB_OK && status == TILEDB_INCOMPLETE) {
+      rc = check_rc(
+          ctx_, tiledb_query_submit(ctx_, query), "tiledb_query_submit");
+      if (rc == TILEDB_OK)
+        rc = check_rc(
+            ctx_,
+            tiledb_query_get_status(ctx_, query, &status),
+            "tiledb_query_get_status");
+      result_bytes_ += buffer_sizes[0] + buffer_sizes[1];
+      result_num_ += buffer_sizes[0] / sizeof(int32_t);
+      buffer_sizes[0] = a_.size() * sizeof(int32_t);
+      buffer_sizes[1] = coords_.size() * sizeof(uint64_t);
+      if (rc == TILEDB_OK && status == TILEDB_INCOMPLETE)
+        rc = check_rc(
+            ctx_,
+            tiledb_query_reset_buffers(ctx_, query, buffers, buffer_sizes),
+            "tiledb_query_reset_buffers");
+    }
+    tiledb_query_free(ctx_, &query);
+
+    return rc;
+  }
+
+ private:
+  /** The attribute read buffer. */
+  std::vector<int32_t> a_;
+
+  /** The coordinates read buffer. */
+  std::vector<uint64_t> coords_;
+
+  /** Number of result bytes of the last run. */
+  uint64_t result_bytes_;
+
+  /** Number of result cells of the last run. */
+  uint64_t result_num_;
+
+  /** The subarray to read. */
+  std::vector<uint64_t> subarray_;
+};
+
+/* ****************************** */
+/*          REGISTRATION          */
+/* ****************************** */
+
+void add_array_benchmarks(const Params& params, BenchmarkList* benchmarks) {
+  tiledb_layout_t dense_layouts[] = {
+      TILEDB_ROW_MAJOR, TILEDB_COL_MAJOR, TILEDB_GLOBAL_ORDER};
+  for (auto layout : dense_layouts)
+    benchmarks->emplace_back(new DenseWrite(params, layout));
+  for (auto layout : dense_layouts)
+    benchmarks->emplace_back(new DenseRead(params, layout));
+  benchmarks->emplace_back(new SparseWriteUnordered(params));
+  benchmarks->emplace_back(new SparseReadSubarray(params, TILEDB_ROW_MAJOR));
+  benchmarks->emplace_back(
+      new SparseReadSubarray(params, TILEDB_GLOBAL_ORDER));
+}
+
+}  // namespace bench
+}  // namespace tiledb
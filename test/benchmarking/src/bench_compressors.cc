@@ -0,0 +1,479 @@
+/**
+ * @file   bench_compressors.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2017-2018 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * Compressor benchmarks. Every compressor is run at every level in
+ * `Params::compressor_levels_` over a set of corpora, going through
+ * `TileIO::compress_one_tile` and `TileIO::decompress_one_tile` so that the
+ * chunking and framing overhead of the storage format is included. Each
+ * corpus is either synthetic (sorted integers, random floats,
+ * low-cardinality strings, timestamps, sensor readings, and short and long
+ * runs) or read from a file. It is compressed once as a single tile, and
+ * once as a sequence of `Params::compressor_tile_bytes_` tiles, which
+ * exposes the per-tile setup cost of the compressors.
+ */
+
+#include "bench.h"
+#include "tiledb/sm/buffer/buffer.h"
+#include "tiledb/sm/enums/compressor.h"
+#include "tiledb/sm/enums/datatype.h"
+#include "tiledb/sm/misc/status.h"
+#include "tiledb/sm/tile/tile.h"
+#include "tiledb/sm/tile/tile_io.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+using namespace tiledb::sm;
+
+namespace tiledb {
+namespace bench {
+
+/** A compressor corpus. */
+struct Corpus {
+  /** The corpus name, used in the benchmark names. */
+  std::string name_;
+  /** The file the corpus is read from (empty for synthetic corpora). */
+  std::string path_;
+  /** The datatype of the corpus values. */
+  Datatype type_;
+};
+
+/** Returns a lower-case copy of `str`. */
+static std::string lower(std::string str) {
+  std::transform(str.begin(), str.end(), str.begin(), ::tolower);
+  return str;
+}
+
+/** Returns `true` if `compressor` takes a compression level. */
+static bool has_levels(Compressor compressor) {
+  switch (compressor) {
+    case Compressor::LZ4:
+    case Compressor::RLE:
+    case Compressor::DOUBLE_DELTA:
+    case Compressor::AUTO:
+      return false;
+    default:
+      return true;
+  }
+}
+
+/**
+ * Parses a user corpus of the form `path[:DATATYPE]`.
+ *
+ * @return `TILEDB_OK` on success and `TILEDB_ERR` otherwise.
+ */
+static int parse_corpus(const std::string& spec, Corpus* corpus) {
+  corpus->path_ = spec;
+  corpus->type_ = Datatype::UINT8;
+
+  auto colon = spec.rfind(':');
+  if (colon != std::string::npos) {
+    auto type_str = spec.substr(colon + 1);
+    bool found = false;
+    for (int t = (int)Datatype::INT32; t <= (int)Datatype::ANY; ++t) {
+      if (lower(datatype_str((Datatype)t)) == lower(type_str)) {
+        corpus->type_ = (Datatype)t;
+        found = true;
+        break;
+      }
+    }
+    if (!found) {
+      fprintf(
+          stderr,
+          "[tiledb_bench] Unknown datatype '%s' in corpus '%s'\n",
+          type_str.c_str(),
+          spec.c_str());
+      return TILEDB_ERR;
+    }
+    corpus->path_ = spec.substr(0, colon);
+  }
+
+  if (corpus->path_.empty()) {
+    fprintf(stderr, "[tiledb_bench] Empty path in corpus '%s'\n", spec.c_str());
+    return TILEDB_ERR;
+  }
+  auto slash = corpus->path_.find_last_of('/');
+  corpus->name_ = (slash == std::string::npos) ?
+                      corpus->path_ :
+                      corpus->path_.substr(slash + 1);
+
+  return TILEDB_OK;
+}
+
+/** Appends the raw bytes of `values` to `data`. */
+template <class T>
+static void append(const std::vector<T>& values, std::vector<char>* data) {
+  auto bytes = (const char*)values.data();
+  data->insert(data->end(), bytes, bytes + values.size() * sizeof(T));
+}
+
+/**
+ * Loads the contents of `corpus` into `data`. User corpora are truncated to
+ * a multiple of the datatype size.
+ *
+ * @return `TILEDB_OK` on success and `TILEDB_ERR` otherwise.
+ */
+static int load_corpus(
+    const Corpus& corpus, const Params& params, std::vector<char>* data) {
+  data->clear();
+
+  if (!corpus.path_.empty()) {
+    std::ifstream file(corpus.path_, std::ios::binary);
+    data->assign(
+        std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    if (!file.good() && !file.eof()) {
+      fprintf(
+          stderr, "[tiledb_bench] Cannot read '%s'\n", corpus.path_.c_str());
+      return TILEDB_ERR;
+    }
+    data->resize(
+        data->size() / datatype_size(corpus.type_) *
+        datatype_size(corpus.type_));
+    if (data->empty()) {
+      fprintf(
+          stderr,
+          "[tiledb_bench] Corpus '%s' is empty\n",
+          corpus.path_.c_str());
+      return TILEDB_ERR;
+    }
+    return TILEDB_OK;
+  }
+
+  DataGenerator gen(params.seed_);
+  auto nbytes = std::max<uint64_t>(params.compressor_bytes_, sizeof(int64_t));
+  if (corpus.name_ == "sorted_int64") {
+    append(
+        gen.sorted<int64_t>(nbytes / sizeof(int64_t), 0, 1000000000000LL),
+        data);
+  } else if (corpus.name_ == "random_float64") {
+    append(gen.uniform<double>(nbytes / sizeof(double), -1e6, 1e6), data);
+  } else if (corpus.name_ == "low_card_strings") {
+    *data = gen.strings(nbytes, 16);
+  } else if (corpus.name_ == "timestamps") {
+    // Nanosecond timestamps about a second apart, with millisecond jitter
+    append(
+        gen.timestamps(
+            nbytes / sizeof(int64_t),
+            1500000000000000000LL,
+            1000000000LL,
+            1000000LL),
+        data);
+  } else if (corpus.name_ == "sensor_float64") {
+    append(gen.readings(nbytes / sizeof(double), 20.0, 0.1), data);
+  } else if (corpus.name_ == "runs_int32") {
+    append(gen.runs<int32_t>(nbytes / sizeof(int32_t), 8), data);
+  } else if (corpus.name_ == "long_runs_int32") {
+    append(gen.runs<int32_t>(nbytes / sizeof(int32_t), 1000), data);
+  } else {
+    return TILEDB_ERR;
+  }
+
+  return TILEDB_OK;
+}
+
+/** Returns the benchmark name suffix of a tile size (empty for none). */
+static std::string tile_bytes_str(uint64_t tile_bytes) {
+  if (tile_bytes == 0)
+    return "";
+  if (tile_bytes % 1024 == 0)
+    return "_" + std::to_string(tile_bytes / 1024) + "k";
+  return "_" + std::to_string(tile_bytes);
+}
+
+/** Compresses or decompresses a corpus with a single compressor and level. */
+class CompressorBenchmark : public Benchmark {
+ public:
+  CompressorBenchmark(
+      const Params& params,
+      const Corpus& corpus,
+      Compressor compressor,
+      int level,
+      uint64_t tile_bytes,
+      bool decompress)
+      : Benchmark(
+            std::string(decompress ? "decompress_" : "compress_") +
+                lower(compressor_str(compressor)) +
+                ((level < 0) ? "" : "_l" + std::to_string(level)) +
+                tile_bytes_str(tile_bytes) + "_" + corpus.name_,
+            params)
+      , compressor_(compressor)
+      , corpus_(corpus)
+      , decompress_(decompress)
+      , level_(level)
+      , tile_bytes_(tile_bytes) {
+  }
+
+  uint64_t bytes() const override {
+    return data_.size();
+  }
+
+  uint64_t items() const override {
+    return data_.size() / datatype_size(corpus_.type_);
+  }
+
+  std::map<std::string, double> metrics() const override {
+    std::map<std::string, double> ret;
+    auto compressed_size = tile_io_.buffer()->size();
+    ret["compression_ratio"] =
+        (compressed_size == 0) ? 0.0 : (double)bytes() / compressed_size;
+    return ret;
+  }
+
+  std::map<std::string, std::string> labels() const override {
+    std::map<std::string, std::string> ret;
+    ret["compressor"] = compressor_str(compressor_);
+    ret["corpus"] = corpus_.name_;
+    ret["datatype"] = datatype_str(corpus_.type_);
+    ret["level"] = (level_ < 0) ? "default" : std::to_string(level_);
+    ret["op"] = decompress_ ? "decompress" : "compress";
+    ret["tile_bytes"] =
+        (tile_bytes_ == 0) ? "all" : std::to_string(tile_bytes_);
+    return ret;
+  }
+
+  int setup() override {
+    if (load_corpus(corpus_, params_, &data_) != TILEDB_OK)
+      return TILEDB_ERR;
+
+    // Split the corpus into tiles of whole cells
+    auto type = corpus_.type_;
+    auto cell_size = datatype_size(type);
+    uint64_t tile_bytes = (tile_bytes_ == 0) ? data_.size() : tile_bytes_;
+    tile_bytes = std::max<uint64_t>(tile_bytes / cell_size, 1) * cell_size;
+    for (uint64_t offset = 0; offset < data_.size(); offset += tile_bytes) {
+      auto nbytes = std::min<uint64_t>(tile_bytes, data_.size() - offset);
+      tiles_.emplace_back(new Tile(
+          type,
+          compressor_,
+          level_,
+          cell_size,
+          0,
+          new Buffer(&data_[offset], nbytes, false),
+          true));
+    }
+    decompressed_tile_.reset(
+        new Tile(type, compressor_, level_, cell_size, 0, new Buffer(), true));
+    if (!check(decompressed_tile_->realloc(data_.size())))
+      return TILEDB_ERR;
+
+    // Compress once so that the decompression benchmark has input, and
+    // verify the round trip
+    if (compress() != TILEDB_OK || decompress() != TILEDB_OK)
+      return TILEDB_ERR;
+    if (decompressed_tile_->size() != data_.size() ||
+        std::memcmp(
+            decompressed_tile_->data(), data_.data(), data_.size()) != 0) {
+      fprintf(stderr, "[tiledb_bench] %s: round trip failed\n", name_.c_str());
+      return TILEDB_ERR;
+    }
+
+    return TILEDB_OK;
+  }
+
+  int run() override {
+    return decompress_ ? decompress() : compress();
+  }
+
+  int teardown() override {
+    tiles_.clear();
+    decompressed_tile_.reset();
+    tile_io_.buffer()->clear();
+    std::vector<char>().swap(data_);
+    return TILEDB_OK;
+  }
+
+ private:
+  /** The compressor. */
+  Compressor compressor_;
+
+  /** The corpus. */
+  Corpus corpus_;
+
+  /** The corpus data. */
+  std::vector<char> data_;
+
+  /** Whether this benchmark times decompression instead of compression. */
+  bool decompress_;
+
+  /** The tile the compressed data are decompressed into. */
+  std::unique_ptr<Tile> decompressed_tile_;
+
+  /** The compression level. */
+  int level_;
+
+  /** The tile size (`0` means that the corpus is a single tile). */
+  uint64_t tile_bytes_;
+
+  /** The tiles wrapping the corpus data. */
+  std::vector<std::unique_ptr<Tile>> tiles_;
+
+  /** Holds the compressed data in its internal buffer. */
+  TileIO tile_io_;
+
+  /** Prints `st` if it is an error, and returns `st.ok()`. */
+  static bool check(const Status& st) {
+    if (!st.ok())
+      fprintf(stderr, "[tiledb_bench] %s\n", st.to_string().c_str());
+    return st.ok();
+  }
+
+  /** Compresses the corpus tiles into the `TileIO` buffer. */
+  int compress() {
+    auto buffer = tile_io_.buffer();
+    buffer->reset_size();
+    buffer->reset_offset();
+    for (auto& tile : tiles_) {
+      tile->reset_offset();
+      if (!check(tile_io_.compress_one_tile(tile.get())))
+        return TILEDB_ERR;
+    }
+    return TILEDB_OK;
+  }
+
+  /** Decompresses the `TileIO` buffer into `decompressed_tile_`. */
+  int decompress() {
+    tile_io_.buffer()->reset_offset();
+    decompressed_tile_->reset_size();
+    decompressed_tile_->reset_offset();
+    for (size_t i = 0; i < tiles_.size(); ++i) {
+      if (!check(tile_io_.decompress_one_tile(decompressed_tile_.get())))
+        return TILEDB_ERR;
+    }
+    return TILEDB_OK;
+  }
+};
+
+int add_compressor_benchmarks(const Params& params, BenchmarkList* benchmarks) {
+  std::vector<Corpus> corpora = {
+      {"sorted_int64", "", Datatype::INT64},
+      {"random_float64", "", Datatype::FLOAT64},
+      {"low_card_strings", "", Datatype::CHAR},
+      {"timestamps", "", Datatype::INT64},
+      {"sensor_float64", "", Datatype::FLOAT64},
+      {"runs_int32", "", Datatype::INT32},
+      {"long_runs_int32", "", Datatype::INT32}};
+  for (const auto& spec : params.corpora_) {
+    Corpus corpus;
+    if (parse_corpus(spec, &corpus) != TILEDB_OK)
+      return TILEDB_ERR;
+    corpora.push_back(corpus);
+  }
+
+  std::vector<uint64_t> tile_bytes = {0};
+  if (params.compressor_tile_bytes_ > 0)
+    tile_bytes.push_back(params.compressor_tile_bytes_);
+  for (int op = 0; op < 2; ++op) {
+    for (auto t : tile_bytes) {
+      for (const auto& corpus : corpora) {
+        for (int c = (int)Compressor::GZIP; c <= (int)Compressor::AUTO; ++c) {
+          auto compressor = (Compressor)c;
+          if (!has_levels(compressor)) {
+            benchmarks->emplace_back(new CompressorBenchmark(
+                params, corpus, compressor, -1, t, op == 1));
+            continue;
+          }
+          for (auto level : params.compressor_levels_)
+            benchmarks->emplace_back(new CompressorBenchmark(
+                params, corpus, compressor, level, t, op == 1));
+        }
+      }
+    }
+  }
+
+  return TILEDB_OK;
+}
+
+void write_compressor_summary(const std::vector<Result>& results, FILE* out) {
+  /** A row of the summary table. */
+  struct Row {
+    std::map<std::string, std::string> labels_;
+    double ratio_;
+    double compress_gb_per_sec_;
+    double decompress_gb_per_sec_;
+  };
+
+  // Pair the compression and decompression results, keeping the run order
+  std::vector<std::string> keys;
+  std::map<std::string, Row> rows;
+  for (const auto& result : results) {
+    auto op = result.labels_.find("op");
+    if (op == result.labels_.end())
+      continue;
+    const auto& labels = result.labels_;
+    auto key = labels.at("corpus") + "/" + labels.at("compressor") + "/" +
+               labels.at("level") + "/" + labels.at("tile_bytes");
+    if (rows.find(key) == rows.end()) {
+      keys.push_back(key);
+      rows[key] = {labels, 0.0, 0.0, 0.0};
+    }
+
+    // Bytes per nanosecond is GB/s
+    auto median_ns = median_latency_ns(result);
+    double gb_per_sec = (median_ns > 0) ? result.bytes_ / median_ns : 0.0;
+    auto& row = rows[key];
+    row.ratio_ = result.metrics_.at("compression_ratio");
+    if (op->second == "compress")
+      row.compress_gb_per_sec_ = gb_per_sec;
+    else
+      row.decompress_gb_per_sec_ = gb_per_sec;
+  }
+
+  if (keys.empty())
+    return;
+
+  fprintf(
+      out,
+      "%-20s %-12s %-14s %-8s %-10s %10s %14s %16s\n",
+      "corpus",
+      "datatype",
+      "compressor",
+      "level",
+      "tile bytes",
+      "ratio",
+      "compress GB/s",
+      "decompress GB/s");
+  for (const auto& key : keys) {
+    const auto& row = rows[key];
+    fprintf(
+        out,
+        "%-20s %-12s %-14s %-8s %-10s %10.3f %14.3f %16.3f\n",
+        row.labels_.at("corpus").c_str(),
+        row.labels_.at("datatype").c_str(),
+        row.labels_.at("compressor").c_str(),
+        row.labels_.at("level").c_str(),
+        row.labels_.at("tile_bytes").c_str(),
+        row.ratio_,
+        row.compress_gb_per_sec_,
+        row.decompress_gb_per_sec_);
+  }
+}
+
+}  // namespace bench
+}  // namespace tiledb
@@ -0,0 +1,169 @@
+/**
+ * @file   bench_consolidation.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2017-2018 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * Consolidation benchmarks. Before every iteration an array is populated
+ * with `fragment_num` fragments; the timed part consolidates them.
+ */
+
+#include "bench.h"
+
+#include <algorithm>
+#include <climits>
+
+namespace tiledb {
+namespace bench {
+
+/** Consolidates a dense or sparse array made of several fragments. */
+class Consolidate : public Benchmark {
+ public:
+  Consolidate(const Params& params, tiledb_array_type_t array_type)
+      : Benchmark(
+            (array_type == TILEDB_DENSE) ? "consolidate_dense" :
+                                           "consolidate_sparse",
+            params)
+      , array_type_(array_type)
+      , ctx_(nullptr)
+      , uri_(params.dir_ + "/" + name_) {
+  }
+
+  ~Consolidate() {
+    if (ctx_ != nullptr)
+      tiledb_ctx_free(&ctx_);
+  }
+
+  uint64_t bytes() const override {
+    uint64_t ret = 0;
+    for (const auto& a : a_)
+      ret += a.size() * sizeof(int32_t);
+    for (const auto& coords : coords_)
+      ret += coords.size() * sizeof(uint64_t);
+    return ret;
+  }
+
+  uint64_t items() const override {
+    uint64_t ret = 0;
+    for (const auto& a : a_)
+      ret += a.size();
+    return ret;
+  }
+
+  std::map<std::string, std::string> labels() const override {
+    std::map<std::string, std::string> ret;
+    ret["array_type"] = (array_type_ == TILEDB_DENSE) ? "dense" : "sparse";
+    return ret;
+  }
+
+  int setup() override {
+    if (tiledb_ctx_create(&ctx_, nullptr) != TILEDB_OK)
+      return TILEDB_ERR;
+
+    // Dense fragments are horizontal bands of the domain; sparse fragments
+    // are random cells over the entire domain
+    DataGenerator gen(params_.seed_);
+    uint64_t fragment_num = std::max<uint64_t>(params_.fragment_num_, 1);
+    uint64_t band = params_.dim_size_ / fragment_num;
+    for (uint64_t f = 0; f < fragment_num; ++f) {
+      if (array_type_ == TILEDB_DENSE) {
+        uint64_t low = f * band + 1;
+        uint64_t high =
+            (f == fragment_num - 1) ? params_.dim_size_ : (f + 1) * band;
+        subarrays_.push_back({low, high, 1, params_.dim_size_});
+        a_.push_back(gen.uniform<int32_t>(
+            (high - low + 1) * params_.dim_size_, INT_MIN, INT_MAX));
+      } else {
+        uint64_t cell_num = params_.sparse_cells_ / fragment_num;
+        a_.push_back(gen.uniform<int32_t>(cell_num, INT_MIN, INT_MAX));
+        coords_.push_back(gen.coords_2d(cell_num, params_.dim_size_));
+      }
+    }
+
+    return TILEDB_OK;
+  }
+
+  int pre_run() override {
+    if (create_array(ctx_, uri_, array_type_, params_) != TILEDB_OK)
+      return TILEDB_ERR;
+
+    for (size_t f = 0; f < a_.size(); ++f) {
+      // The writes may reorganize the input buffers, so write copies
+      auto a = a_[f];
+      int rc;
+      if (array_type_ == TILEDB_DENSE) {
+        rc = write_array(
+            ctx_, uri_, TILEDB_ROW_MAJOR, subarrays_[f].data(), &a, nullptr);
+      } else {
+        auto coords = coords_[f];
+        rc = write_array(ctx_, uri_, TILEDB_UNORDERED, nullptr, &a, &coords);
+      }
+      if (rc != TILEDB_OK)
+        return TILEDB_ERR;
+    }
+
+    return TILEDB_OK;
+  }
+
+  int run() override {
+    return check_rc(
+        ctx_,
+        tiledb_array_consolidate(ctx_, uri_.c_str()),
+        "tiledb_array_consolidate");
+  }
+
+  int teardown() override {
+    return remove_if_exists(ctx_, uri_);
+  }
+
+ private:
+  /** The attribute values of each fragment. */
+  std::vector<std::vector<int32_t>> a_;
+
+  /** The array type. */
+  tiledb_array_type_t array_type_;
+
+  /** The coordinates of each (sparse) fragment. */
+  std::vector<std::vector<uint64_t>> coords_;
+
+  /** The TileDB context. */
+  tiledb_ctx_t* ctx_;
+
+  /** The subarray of each (dense) fragment. */
+  std::vector<std::vector<uint64_t>> subarrays_;
+
+  /** The array URI. */
+  std::string uri_;
+};
+
+void add_consolidation_benchmarks(
+    const Params& params, BenchmarkList* benchmarks) {
+  benchmarks->emplace_back(new Consolidate(params, TILEDB_DENSE));
+  benchmarks->emplace_back(new Consolidate(params, TILEDB_SPARSE));
+}
+
+}  // namespace bench
+}  // namespace tiledb
@@ -0,0 +1,239 @@
+/**
+ * @file   bench_kv.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2017-2018 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * Key-value store put/get benchmarks. The store has `int64_t` keys and a
+ * single `int32_t` attribute `v`.
+ */
+
+#include "bench.h"
+
+#include <climits>
+
+namespace tiledb {
+namespace bench {
+
+/** Base class of the key-value benchmarks. */
+class KVBenchmark : public Benchmark {
+ public:
+  KVBenchmark(const std::string& name, const Params& params)
+      : Benchmark(name, params)
+      , ctx_(nullptr)
+      , uri_(params.dir_ + "/" + name) {
+  }
+
+  ~KVBenchmark() {
+    if (ctx_ != nullptr)
+      tiledb_ctx_free(&ctx_);
+  }
+
+  uint64_t bytes() const override {
+    return keys_.size() * (sizeof(int64_t) + sizeof(int32_t));
+  }
+
+  uint64_t items() const override {
+    return keys_.size();
+  }
+
+  int setup() override {
+    if (tiledb_ctx_create(&ctx_, nullptr) != TILEDB_OK)
+      return TILEDB_ERR;
+    DataGenerator gen(params_.seed_);
+    keys_ = gen.uniform<int64_t>(params_.kv_items_, 0, INT64_MAX);
+    values_ = gen.uniform<int32_t>(params_.kv_items_, INT_MIN, INT_MAX);
+    return TILEDB_OK;
+  }
+
+  int teardown() override {
+    return remove_if_exists(ctx_, uri_);
+  }
+
+ protected:
+  /** The TileDB context. */
+  tiledb_ctx_t* ctx_;
+
+  /** The keys. */
+  std::vector<int64_t> keys_;
+
+  /** The key-value store URI. */
+  std::string uri_;
+
+  /** The values. */
+  std::vector<int32_t> values_;
+
+  /** Creates an empty key-value store. */
+  int create_kv() {
+    if (remove_if_exists(ctx_, uri_) != TILEDB_OK)
+      return TILEDB_ERR;
+
+    tiledb_attribute_t* v;
+    BENCH_RETURN_NOT_OK(
+        ctx_, tiledb_attribute_create(ctx_, &v, "v", TILEDB_INT32));
+    tiledb_kv_schema_t* schema;
+    int rc = check_rc(
+        ctx_, tiledb_kv_schema_create(ctx_, &schema), "kv_schema_create");
+    if (rc == TILEDB_OK) {
+      rc = check_rc(
+          ctx_,
+          tiledb_kv_schema_add_attribute(ctx_, schema, v),
+          "kv_schema_add_attribute");
+      if (rc == TILEDB_OK)
+        rc = check_rc(
+            ctx_,
+            tiledb_kv_create(ctx_, uri_.c_str(), schema),
+            "tiledb_kv_create");
+      tiledb_kv_schema_free(ctx_, &schema);
+    }
+    tiledb_attribute_free(ctx_, &v);
+
+    return rc;
+  }
+
+  /** Writes all items to the key-value store and flushes it. */
+  int put_items() {
+    tiledb_kv_t* kv;
+    BENCH_RETURN_NOT_OK(
+        ctx_, tiledb_kv_open(ctx_, &kv, uri_.c_str(), nullptr, 0));
+    BENCH_RETURN_NOT_OK(
+        ctx_, tiledb_kv_set_max_buffered_items(ctx_, kv, keys_.size()));
+
+    int rc = TILEDB_OK;
+    for (uint64_t i = 0; rc == TILEDB_OK && i < keys_.size(); ++i) {
+      tiledb_kv_item_t* item;
+      rc = check_rc(ctx_, tiledb_kv_item_create(ctx_, &item), "item_create");
+      if (rc != TILEDB_OK)
+        break;
+      rc = check_rc(
+          ctx_,
+          tiledb_kv_item_set_key(
+              ctx_, item, &keys_[i], TILEDB_INT64, sizeof(int64_t)),
+          "item_set_key");
+      if (rc == TILEDB_OK)
+        rc = check_rc(
+            ctx_,
+            tiledb_kv_item_set_value(
+                ctx_, item, "v", &values_[i], TILEDB_INT32, sizeof(int32_t)),
+            "item_set_value");
+      if (rc == TILEDB_OK)
+        rc = check_rc(ctx_, tiledb_kv_add_item(ctx_, kv, item), "add_item");
+      tiledb_kv_item_free(ctx_, &item);
+    }
+
+    if (rc == TILEDB_OK)
+      rc = check_rc(ctx_, tiledb_kv_flush(ctx_, kv), "tiledb_kv_flush");
+    if (check_rc(ctx_, tiledb_kv_close(ctx_, &kv), "tiledb_kv_close") !=
+        TILEDB_OK)
+      rc = TILEDB_ERR;
+
+    return rc;
+  }
+};
+
+/** Puts all items in a fresh key-value store. */
+class KVPut : public KVBenchmark {
+ public:
+  explicit KVPut(const Params& params)
+      : KVBenchmark("kv_put", params) {
+  }
+
+  int pre_run() override {
+    return create_kv();
+  }
+
+  int run() override {
+    return put_items();
+  }
+};
+
+/** Looks up all items of a populated key-value store in random order. */
+class KVGet : public KVBenchmark {
+ public:
+  explicit KVGet(const Params& params)
+      : KVBenchmark("kv_get", params) {
+  }
+
+  int setup() override {
+    if (KVBenchmark::setup() != TILEDB_OK || create_kv() != TILEDB_OK ||
+        put_items() != TILEDB_OK)
+      return TILEDB_ERR;
+
+    // Look keys up in an order different from the insertion order
+    DataGenerator gen(params_.seed_ + 1);
+    auto perm = gen.uniform<uint64_t>(keys_.size(), 0, keys_.size() - 1);
+    lookup_keys_.resize(keys_.size());
+    for (uint64_t i = 0; i < keys_.size(); ++i)
+      lookup_keys_[i] = keys_[perm[i]];
+
+    return TILEDB_OK;
+  }
+
+  int run() override {
+    tiledb_kv_t* kv;
+    BENCH_RETURN_NOT_OK(
+        ctx_, tiledb_kv_open(ctx_, &kv, uri_.c_str(), nullptr, 0));
+
+    int rc = TILEDB_OK;
+    for (uint64_t i = 0; rc == TILEDB_OK && i < lookup_keys_.size(); ++i) {
+      tiledb_kv_item_t* item = nullptr;
+      rc = check_rc(
+          ctx_,
+          tiledb_kv_get_item(
+              ctx_,
+              kv,
+              &item,
+              &lookup_keys_[i],
+              TILEDB_INT64,
+              sizeof(int64_t)),
+          "tiledb_kv_get_item");
+      if (item == nullptr) {
+        fprintf(stderr, "[tiledb_bench] kv_get: missing key\n");
+        rc = TILEDB_ERR;
+      } else {
+        tiledb_kv_item_free(ctx_, &item);
+      }
+    }
+
+    if (check_rc(ctx_, tiledb_kv_close(ctx_, &kv), "tiledb_kv_close") !=
+        TILEDB_OK)
+      rc = TILEDB_ERR;
+
+    return rc;
+  }
+
+ private:
+  /** The keys to look up, in lookup order. */
+  std::vector<int64_t> lookup_keys_;
+};
+
+void add_kv_benchmarks(const Params& params, BenchmarkList* benchmarks) {
+  benchmarks->emplace_back(new KVPut(params));
+  benchmarks->emplace_back(new KVGet(params));
+}
+
+}  // namespace bench
+}  // namespace tiledb
@@ -0,0 +1,271 @@
+/**
+ * @file   bench_main.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2017-2018 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * Entry point of `tiledb_bench`. Run `tiledb_bench --help` for the options.
+ */
+
+#include "bench.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+using namespace tiledb::bench;
+
+/** Prints the command-line usage. */
+static void print_usage() {
+  std::cout
+      << "Usage: tiledb_bench [options]\n"
+      << "\n"
+      << "Options:\n"
+      << "  --list                 List the benchmarks and exit\n"
+      << "  --filter <str>         Run only benchmarks whose name contains "
+         "<str>\n"
+      << "  --iterations <n>       Timed iterations per benchmark\n"
+      << "  --warmup <n>           Untimed warm-up iterations per benchmark\n"
+      << "  --seed <n>             Seed of the synthetic data generators\n"
+      << "  --dim-size <n>         Cells per dimension of the 2D arrays\n"
+      << "  --tile-extent <n>      Tile extent of the 2D arrays\n"
+      << "  --sparse-cells <n>     Cells written in the sparse benchmarks\n"
+      << "  --sparse-capacity <n>  Tile capacity of the sparse arrays\n"
+      << "  --fragment-num <n>     Fragments per consolidation benchmark\n"
+      << "  --kv-items <n>         Items in the key-value benchmarks\n"
+      << "  --compressor-bytes <n> Bytes per synthetic compressor corpus\n"
+      << "  --compressor-tile-bytes <n>\n"
+      << "                         Bytes per tile when the compressor corpora "
+         "are\n"
+      << "                         also split into tiles (0 disables it)\n"
+      << "  --compressor-levels <l,...>\n"
+      << "                         Compression levels to run (-1 is the "
+         "default level)\n"
+      << "  --corpus <path>[:<datatype>]\n"
+      << "                         Also run the compressors over the file "
+         "at <path>,\n"
+      << "                         read as a single tile of <datatype> "
+         "(default UINT8).\n"
+      << "                         May be given multiple times\n"
+      << "  --dir <uri>            Directory holding the benchmark arrays\n"
+      << "  --output <file>        Write the JSON report to <file> instead of "
+         "stdout\n"
+      << "  --help                 Print this message\n";
+}
+
+/** Parses `str` as an unsigned integer into `value`. */
+static bool parse_uint64(const char* str, uint64_t* value) {
+  char* end;
+  errno = 0;
+  auto v = strtoull(str, &end, 10);
+  if (errno != 0 || end == str || *end != '\0' || str[0] == '-')
+    return false;
+  *value = (uint64_t)v;
+  return true;
+}
+
+/** Parses a comma-separated list of integers into `values`. */
+static bool parse_int_list(const char* str, std::vector<int>* values) {
+  values->clear();
+  std::string list = str;
+  size_t start = 0;
+  while (start <= list.size()) {
+    auto end = list.find(',', start);
+    if (end == std::string::npos)
+      end = list.size();
+    auto item = list.substr(start, end - start);
+    char* item_end;
+    errno = 0;
+    auto v = strtol(item.c_str(), &item_end, 10);
+    if (item.empty() || errno != 0 || *item_end != '\0' || v < -1 ||
+        v > 100)
+      return false;
+    values->push_back((int)v);
+    start = end + 1;
+  }
+  return !values->empty();
+}
+
+/**
+ * Parses the command line into `params`.
+ *
+ * @return `0` on success, `1` if the program should exit successfully (e.g.,
+ *     after `--help`) and `-1` on error.
+ */
+static int parse_args(int argc, char** argv, Params* params, bool* list) {
+  std::map<std::string, uint64_t*> uint_opts = {
+      {"--iterations", &params->iterations_},
+      {"--warmup", &params->warmup_},
+      {"--seed", &params->seed_},
+      {"--dim-size", &params->dim_size_},
+      {"--tile-extent", &params->tile_extent_},
+      {"--sparse-cells", &params->sparse_cells_},
+      {"--sparse-capacity", &params->sparse_capacity_},
+      {"--fragment-num", &params->fragment_num_},
+      {"--kv-items", &params->kv_items_},
+      {"--compressor-bytes", &params->compressor_bytes_},
+      {"--compressor-tile-bytes", &params->compressor_tile_bytes_}};
+  std::map<std::string, std::string*> str_opts = {
+      {"--filter", &params->filter_},
+      {"--dir", &params->dir_},
+      {"--output", &params->output_}};
+
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    if (arg == "--help" || arg == "-h") {
+      print_usage();
+      return 1;
+    }
+    if (arg == "--list") {
+      *list = true;
+      continue;
+    }
+    if ((arg == "--compressor-levels" || arg == "--corpus") && i + 1 == argc) {
+      std::cerr << "[tiledb_bench] Missing value for '" << arg << "'\n";
+      return -1;
+    }
+    if (arg == "--compressor-levels") {
+      if (!parse_int_list(argv[++i], &params->compressor_levels_)) {
+        std::cerr << "[tiledb_bench] Invalid value '" << argv[i]
+                  << "' for '" << arg << "'\n";
+        return -1;
+      }
+      continue;
+    }
+    if (arg == "--corpus") {
+      params->corpora_.push_back(argv[++i]);
+      continue;
+    }
+
+    auto uint_it = uint_opts.find(arg);
+    auto str_it = str_opts.find(arg);
+    if (uint_it == uint_opts.end() && str_it == str_opts.end()) {
+      std::cerr << "[tiledb_bench] Unknown option '" << arg << "'\n";
+      return -1;
+    }
+    if (i + 1 == argc) {
+      std::cerr << "[tiledb_bench] Missing value for '" << arg << "'\n";
+      return -1;
+    }
+    const char* value = argv[++i];
+    if (str_it != str_opts.end()) {
+      *str_it->second = value;
+    } else if (!parse_uint64(value, uint_it->second)) {
+      std::cerr << "[tiledb_bench] Invalid value '" << value << "' for '"
+                << arg << "'\n";
+      return -1;
+    }
+  }
+
+  if (params->iterations_ == 0 || params->dim_size_ == 0 ||
+      params->tile_extent_ == 0 || params->sparse_capacity_ == 0 ||
+      params->kv_items_ == 0) {
+    std::cerr << "[tiledb_bench] Sizes and iterations must be positive\n";
+    return -1;
+  }
+  if (params->dim_size_ % params->tile_extent_ != 0) {
+    std::cerr << "[tiledb_bench] --dim-size must be a multiple of "
+                 "--tile-extent\n";
+    return -1;
+  }
+
+  return 0;
+}
+
+int main(int argc, char** argv) {
+  Params params;
+  bool list = false;
+  int parsed = parse_args(argc, argv, &params, &list);
+  if (parsed != 0)
+    return (parsed > 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+
+  BenchmarkList benchmarks;
+  add_array_benchmarks(params, &benchmarks);
+  add_kv_benchmarks(params, &benchmarks);
+  add_consolidation_benchmarks(params, &benchmarks);
+  if (add_compressor_benchmarks(params, &benchmarks) != TILEDB_OK)
+    return EXIT_FAILURE;
+
+  if (list) {
+    for (const auto& benchmark : benchmarks)
+      std::cout << benchmark->name() << "\n";
+    return EXIT_SUCCESS;
+  }
+
+  // Create the directory holding the benchmark arrays
+  tiledb_ctx_t* ctx;
+  if (tiledb_ctx_create(&ctx, nullptr) != TILEDB_OK) {
+    std::cerr << "[tiledb_bench] Cannot create TileDB context\n";
+    return EXIT_FAILURE;
+  }
+  if (remove_if_exists(ctx, params.dir_) != TILEDB_OK ||
+      check_rc(
+          ctx,
+          tiledb_group_create(ctx, params.dir_.c_str()),
+          "tiledb_group_create") != TILEDB_OK) {
+    tiledb_ctx_free(&ctx);
+    return EXIT_FAILURE;
+  }
+
+  // Run the benchmarks
+  std::vector<Result> results;
+  bool failed = false;
+  for (const auto& benchmark : benchmarks) {
+    if (benchmark->name().find(params.filter_) == std::string::npos)
+      continue;
+    std::cerr << "[tiledb_bench] Running " << benchmark->name() << "\n";
+    Result result;
+    if (run_benchmark(benchmark.get(), params, &result) != TILEDB_OK) {
+      std::cerr << "[tiledb_bench] " << benchmark->name() << " failed\n";
+      failed = true;
+      continue;
+    }
+    results.push_back(result);
+  }
+
+  remove_if_exists(ctx, params.dir_);
+  tiledb_ctx_free(&ctx);
+
+  // Write the report
+  FILE* out = stdout;
+  if (!params.output_.empty()) {
+    out = fopen(params.output_.c_str(), "w");
+    if (out == nullptr) {
+      std::cerr << "[tiledb_bench] Cannot open '" << params.output_ << "'\n";
+      return EXIT_FAILURE;
+    }
+  }
+  write_json_report(params, results, out);
+  if (out != stdout)
+    fclose(out);
+
+  // Summarize the compressor results for human consumption
+  write_compressor_summary(results, stderr);
+
+  return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -33,6 +33,8 @@
 
 #include <catch.hpp>
 #include "tiledb/sm/buffer/buffer.h"
+#include "tiledb/sm/buffer/buffer_pool.h"
+#include "tiledb/sm/misc/memory_tracker.h"
 
 using namespace tiledb::sm;
 
@@ -74,3 +76,66 @@ TEST_CASE("Buffer: Test default constructor with write void*", "[buffer]") {
 
   delete buff;
 }
+
+TEST_CASE("BufferPool: Test size classes", "[buffer]") {
+  CHECK(BufferPool::size_class(0) == 0);
+  CHECK(BufferPool::size_class(3) == 3);
+  CHECK(BufferPool::size_class(65536) == 65536);
+  CHECK(BufferPool::size_class(65537) == 65536 + 16384);
+  CHECK(BufferPool::size_class(100000) == 114688);
+  CHECK(BufferPool::size_class(131071) == 131072);
+}
+
+TEST_CASE("BufferPool: Test recycling", "[buffer]") {
+  BufferPool pool(200000);
+  uint64_t size_1, size_2, size_3;
+  auto block_1 = pool.allocate(100000, &size_1);
+  auto block_2 = pool.allocate(100000, &size_2);
+  REQUIRE(block_1 != nullptr);
+  REQUIRE(block_2 != nullptr);
+  CHECK(size_1 == 114688);
+
+  // Only one of the blocks fits in the pool
+  pool.release(block_1, size_1);
+  pool.release(block_2, size_2);
+  CHECK(pool.cached_size() == size_1);
+
+  // A request of the same size class reuses the cached block
+  auto block_3 = pool.allocate(110000, &size_3);
+  CHECK(block_3 == block_1);
+  CHECK(size_3 == size_1);
+  CHECK(pool.cached_size() == 0);
+  pool.release(block_3, size_3);
+}
+
+TEST_CASE("Buffer: Test allocation from a buffer pool", "[buffer]") {
+  auto tracker = std::make_shared<MemoryTracker>(nullptr);
+  tracker->set_buffer_pool(std::make_shared<BufferPool>(1000000));
+  ScopedMemoryTracker scoped_tracker(tracker);
+
+  // Small buffers are not drawn from the pool
+  Buffer small_buff;
+  REQUIRE(small_buff.realloc(100).ok());
+  CHECK(tracker->current() == 100);
+  small_buff.clear();
+
+  // Growing a pooled buffer preserves its contents
+  uint64_t value = 12345;
+  auto buff = new Buffer();
+  REQUIRE(buff->write(&value, sizeof(value)).ok());
+  REQUIRE(buff->realloc(70000).ok());
+  CHECK(buff->alloced_size() == 70000);
+  CHECK(tracker->current() == 81920);
+  REQUIRE(buff->realloc(200000).ok());
+  CHECK(*(uint64_t*)buff->data() == value);
+  CHECK(tracker->current() == 229376);
+  auto data = buff->data();
+  delete buff;
+  CHECK(tracker->current() == 0);
+  CHECK(tracker->buffer_pool()->cached_size() == 81920 + 229376);
+
+  // A new buffer of the same size class reuses the memory
+  Buffer buff_2;
+  REQUIRE(buff_2.realloc(210000).ok());
+  CHECK(buff_2.data() == data);
+}
@@ -182,8 +182,31 @@ void check_save_to_file() {
 
   std::stringstream ss;
   ss << "sm.array_schema_cache_size 10000000\n";
+  ss << "sm.auto_compression_objective balanced\n";
+  ss << "sm.auto_consolidation_fragment_num 16\n";
+  ss << "sm.auto_consolidation_interval_ms 0\n";
+  ss << "sm.auto_consolidation_io_budget 0\n";
+  ss << "sm.auto_consolidation_read_amplification 8\n";
+  ss << "sm.auto_consolidation_small_fragment_size 10000000\n";
+  ss << "sm.buffer_pool_size 100000000\n";
+  ss << "sm.consolidation_max_fragments 16\n";
+  ss << "sm.consolidation_memory_budget 1000000000\n";
+  ss << "sm.consolidation_min_fragments 4\n";
+  ss << "sm.consolidation_policy full\n";
+  ss << "sm.consolidation_size_ratio 4\n";
+  ss << "sm.consolidation_threads " << std::thread::hardware_concurrency()
+     << "\n";
+  ss << "sm.external_sort_memory 0\n";
   ss << "sm.fragment_metadata_cache_size 10000000\n";
+  ss << "sm.memory_budget 0\n";
+  ss << "sm.memory_budget_timeout_ms 0\n";
+  ss << "sm.num_compute_threads " << std::thread::hardware_concurrency()
+     << "\n";
   ss << "sm.tile_cache_size 10000000\n";
+  ss << "sm.tile_slab_num 2\n";
+  ss << "sm.write_buffer_flush_ms 10000\n";
+  ss << "sm.write_buffer_size 0\n";
+  ss << "sm.zstd_dictionary_size 0\n";
   ss << "vfs.max_parallel_ops " << std::thread::hardware_concurrency() << "\n";
   ss << "vfs.min_parallel_size 10485760\n";
   ss << "vfs.s3.connect_max_tries 5\n";
@@ -306,6 +329,22 @@ TEST_CASE("C API: Test config", "[capi], [config]") {
   CHECK(rc == TILEDB_OK);
   CHECK(error == nullptr);
 
+  // Check the values of a string parameter
+  rc = tiledb_config_set(
+      config, "sm.auto_compression_objective", "speed", &error);
+  CHECK(rc == TILEDB_OK);
+  CHECK(error == nullptr);
+  rc = tiledb_config_set(
+      config, "sm.auto_compression_objective", "fastest", &error);
+  CHECK(rc == TILEDB_ERR);
+  CHECK(error != nullptr);
+  check_error(
+      error,
+      "[TileDB::Config] Error: Cannot set parameter; Invalid AUTO compression "
+      "objective");
+  rc = tiledb_error_free(&error);
+  CHECK(rc == TILEDB_OK);
+
   // Check out of range argument for correct parameter
   rc = tiledb_config_set(
       config, "sm.tile_cache_size", "100000000000000000000", &error);
@@ -349,8 +388,32 @@ TEST_CASE("C API: Test config iter", "[capi], [config]") {
   // Prepare maps
   std::map<std::string, std::string> all_param_values;
   all_param_values["sm.tile_cache_size"] = "100";
+  all_param_values["sm.tile_slab_num"] = "2";
   all_param_values["sm.array_schema_cache_size"] = "1000";
   all_param_values["sm.fragment_metadata_cache_size"] = "10000000";
+  all_param_values["sm.buffer_pool_size"] = "100000000";
+  all_param_values["sm.memory_budget"] = "0";
+  all_param_values["sm.memory_budget_timeout_ms"] = "0";
+  all_param_values["sm.auto_compression_objective"] = "balanced";
+  all_param_values["sm.zstd_dictionary_size"] = "0";
+  all_param_values["sm.num_compute_threads"] =
+      std::to_string(std::thread::hardware_concurrency());
+  all_param_values["sm.write_buffer_size"] = "0";
+  all_param_values["sm.write_buffer_flush_ms"] = "10000";
+  all_param_values["sm.external_sort_memory"] = "0";
+  all_param_values["sm.external_sort_scratch_dir"] = "";
+  all_param_values["sm.consolidation_policy"] = "full";
+  all_param_values["sm.consolidation_min_fragments"] = "4";
+  all_param_values["sm.consolidation_max_fragments"] = "16";
+  all_param_values["sm.consolidation_size_ratio"] = "4";
+  all_param_values["sm.consolidation_memory_budget"] = "1000000000";
+  all_param_values["sm.consolidation_threads"] =
+      std::to_string(std::thread::hardware_concurrency());
+  all_param_values["sm.auto_consolidation_interval_ms"] = "0";
+  all_param_values["sm.auto_consolidation_fragment_num"] = "16";
+  all_param_values["sm.auto_consolidation_small_fragment_size"] = "10000000";
+  all_param_values["sm.auto_consolidation_read_amplification"] = "8";
+  all_param_values["sm.auto_consolidation_io_budget"] = "0";
   all_param_values["vfs.max_parallel_ops"] =
       std::to_string(std::thread::hardware_concurrency());
   all_param_values["vfs.min_parallel_size"] = "10485760";
@@ -0,0 +1,165 @@
+/**
+ * @file   unit-compression-auto.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2018 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * Tests the AUTO compressor, which selects the compressor of each tile.
+ */
+
+#include "catch.hpp"
+#include "tiledb/sm/filter/filter_pipeline.h"
+#include "tiledb/sm/tile/tile_io.h"
+
+#include <cstring>
+#include <random>
+#include <vector>
+
+using namespace tiledb::sm;
+
+/** The offset of the selected compressor in a single-chunk tile. */
+static const uint64_t selected_offset = 3 * sizeof(uint64_t);
+
+/**
+ * Compresses `data` with the AUTO compressor into `tile_io`, checks that
+ * decompression reproduces `data` and returns the selected compressor.
+ */
+template <class T>
+static Compressor check_auto_roundtrip(
+    TileIO* tile_io,
+    Datatype type,
+    const std::vector<T>& data,
+    const FilterPipeline* filters = nullptr) {
+  uint64_t nbytes = data.size() * sizeof(T);
+  Tile tile(
+      type,
+      Compressor::AUTO,
+      -1,
+      sizeof(T),
+      0,
+      new Buffer((void*)data.data(), nbytes, false),
+      true);
+  tile.set_filters(filters);
+  auto buffer = tile_io->buffer();
+  buffer->reset_size();
+  buffer->reset_offset();
+  REQUIRE(tile_io->compress_one_tile(&tile).ok());
+  REQUIRE(buffer->size() > selected_offset);
+
+  Tile decompressed(
+      type, Compressor::AUTO, -1, sizeof(T), 0, new Buffer(), true);
+  decompressed.set_filters(filters);
+  REQUIRE(decompressed.realloc(nbytes).ok());
+  buffer->reset_offset();
+  REQUIRE(tile_io->decompress_one_tile(&decompressed).ok());
+  REQUIRE(decompressed.size() == nbytes);
+  CHECK(std::memcmp(decompressed.data(), data.data(), nbytes) == 0);
+
+  return (Compressor) * (const char*)buffer->data(selected_offset);
+}
+
+TEST_CASE("Compression-AUTO: Test compressor selection", "[compression]") {
+  TileIO tile_io;
+  std::mt19937_64 gen(0);
+
+  SECTION("- Random values are not compressed") {
+    std::vector<uint64_t> data(100000);
+    for (auto& v : data)
+      v = gen();
+    CHECK(
+        check_auto_roundtrip(&tile_io, Datatype::UINT64, data) ==
+        Compressor::NO_COMPRESSION);
+  }
+
+  SECTION("- Long runs") {
+    std::vector<int32_t> data(100000);
+    for (size_t i = 0; i < data.size(); ++i)
+      data[i] = (int32_t)(i / 5000) * 7919;
+    CHECK(
+        check_auto_roundtrip(&tile_io, Datatype::INT32, data) ==
+        Compressor::RLE);
+  }
+
+  SECTION("- Timestamps") {
+    std::vector<int64_t> data(100000);
+    for (size_t i = 0; i < data.size(); ++i)
+      data[i] = 1500000000000LL + (int64_t)i * 1000 + (int64_t)(gen() % 16);
+    CHECK(
+        check_auto_roundtrip(&tile_io, Datatype::INT64, data) ==
+        Compressor::DOUBLE_DELTA);
+  }
+
+  SECTION("- Text") {
+    std::string text;
+    for (int i = 0; i < 10000; ++i)
+      text += "value_" + std::to_string(gen() % 100) + ";";
+    std::vector<char> data(text.begin(), text.end());
+    auto selected = check_auto_roundtrip(&tile_io, Datatype::CHAR, data);
+    CHECK((selected == Compressor::LZ4 || selected == Compressor::ZSTD));
+  }
+
+  SECTION("- Tiles smaller than the sample") {
+    std::vector<int16_t> data(100, 3);
+    check_auto_roundtrip(&tile_io, Datatype::INT16, data);
+    std::vector<int16_t> one(1, 3);
+    check_auto_roundtrip(&tile_io, Datatype::INT16, one);
+  }
+
+  SECTION("- Filtered tiles") {
+    // RLE and double delta do not apply to filtered data
+    FilterPipeline filters;
+    REQUIRE(filters.add_filter(FilterType::FILTER_BYTESHUFFLE).ok());
+    std::vector<int32_t> data(100000);
+    for (size_t i = 0; i < data.size(); ++i)
+      data[i] = (int32_t)(i / 5000);
+    auto selected =
+        check_auto_roundtrip(&tile_io, Datatype::INT32, data, &filters);
+    CHECK(selected != Compressor::RLE);
+    CHECK(selected != Compressor::DOUBLE_DELTA);
+  }
+}
+
+TEST_CASE("Compression-AUTO: Test invalid compressor", "[compression]") {
+  TileIO tile_io;
+  std::vector<int32_t> data(1000, 5);
+  check_auto_roundtrip(&tile_io, Datatype::INT32, data);
+
+  auto buffer = tile_io.buffer();
+  for (auto invalid : {Compressor::GZIP, Compressor::AUTO, (Compressor)100}) {
+    *(char*)buffer->data(selected_offset) = (char)invalid;
+    Tile decompressed(
+        Datatype::INT32,
+        Compressor::AUTO,
+        -1,
+        sizeof(int32_t),
+        0,
+        new Buffer(),
+        true);
+    REQUIRE(decompressed.realloc(data.size() * sizeof(int32_t)).ok());
+    buffer->reset_offset();
+    CHECK(!tile_io.decompress_one_tile(&decompressed).ok());
+  }
+}
@@ -0,0 +1,120 @@
+/**
+ * @file   unit-compression-contexts.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2018 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * Tests the reuse of the zstd contexts and zlib streams across chunks.
+ */
+
+#include "catch.hpp"
+#include "tiledb/sm/compressors/gzip_compressor.h"
+#include "tiledb/sm/compressors/zstd_compressor.h"
+
+#include <cstring>
+#include <random>
+#include <thread>
+#include <vector>
+
+using namespace tiledb::sm;
+
+/** Compresses and decompresses `data` with `compressor` at `level`. */
+template <class Compressor>
+static bool roundtrip(int level, const std::vector<uint32_t>& data) {
+  uint64_t nbytes = data.size() * sizeof(uint32_t);
+  ConstBuffer input(data.data(), nbytes);
+  Buffer compressed;
+  if (!compressed.realloc(nbytes + Compressor::overhead(nbytes)).ok() ||
+      !Compressor::compress(level, &input, &compressed).ok())
+    return false;
+
+  ConstBuffer compressed_input(compressed.data(), compressed.size());
+  Buffer decompressed;
+  if (!decompressed.realloc(nbytes).ok() ||
+      !Compressor::decompress(&compressed_input, &decompressed).ok())
+    return false;
+  return decompressed.size() == nbytes &&
+         std::memcmp(decompressed.data(), data.data(), nbytes) == 0;
+}
+
+/** Round trips chunks of various sizes and levels, returning the failures. */
+template <class Compressor>
+static int roundtrip_chunks(uint64_t seed) {
+  std::mt19937_64 gen(seed);
+  int failures = 0;
+  for (int i = 0; i < 50; ++i) {
+    std::vector<uint32_t> data(1 + gen() % 20000);
+    for (auto& v : data)
+      v = (uint32_t)(gen() % 64);
+    int level = (i % 3 == 0) ? -1 : (int)(1 + i % 9);
+    failures += roundtrip<Compressor>(level, data) ? 0 : 1;
+  }
+  return failures;
+}
+
+/** Checks that a corrupt chunk does not affect the following ones. */
+template <class Compressor>
+static void check_corrupt_chunk() {
+  std::vector<uint32_t> data(10000, 7);
+  CHECK(roundtrip<Compressor>(-1, data));
+
+  std::vector<char> garbage(1000, 'x');
+  ConstBuffer input(garbage.data(), garbage.size());
+  Buffer decompressed;
+  REQUIRE(decompressed.realloc(100000).ok());
+  CHECK(!Compressor::decompress(&input, &decompressed).ok());
+
+  CHECK(roundtrip<Compressor>(-1, data));
+}
+
+TEST_CASE(
+    "Compression-contexts: Test reuse across chunks and threads",
+    "[compression]") {
+  SECTION("- ZStd") {
+    CHECK(roundtrip_chunks<ZStd>(0) == 0);
+    check_corrupt_chunk<ZStd>();
+  }
+
+  SECTION("- GZip") {
+    CHECK(roundtrip_chunks<GZip>(0) == 0);
+    check_corrupt_chunk<GZip>();
+  }
+
+  SECTION("- Multiple threads") {
+    std::vector<int> failures(8, 0);
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < failures.size(); ++t) {
+      threads.emplace_back([t, &failures]() {
+        failures[t] = (t % 2 == 0) ? roundtrip_chunks<ZStd>(t) :
+                                     roundtrip_chunks<GZip>(t);
+      });
+    }
+    for (auto& t : threads)
+      t.join();
+    for (auto f : failures)
+      CHECK(f == 0);
+  }
+}
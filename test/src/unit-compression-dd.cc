@@ -34,7 +34,37 @@
 #include "catch.hpp"
 #include "tiledb/sm/compressors/dd_compressor.h"
 
+#include <cmath>
+#include <cstring>
 #include <iostream>
+#include <limits>
+#include <random>
+#include <vector>
+
+using namespace tiledb::sm;
+
+/**
+ * Compresses `data` with double delta, checks that the compressed size is
+ * within the reported overhead, and that decompression reproduces `data`.
+ * Returns the compressed size.
+ */
+template <class T>
+static uint64_t check_dd_roundtrip(Datatype type, const std::vector<T>& data) {
+  uint64_t nbytes = data.size() * sizeof(T);
+  ConstBuffer input(data.data(), nbytes);
+  Buffer compressed;
+  REQUIRE(DoubleDelta::compress(type, &input, &compressed).ok());
+  CHECK(compressed.size() <= nbytes + DoubleDelta::overhead(nbytes));
+
+  ConstBuffer compressed_input(compressed.data(), compressed.size());
+  Buffer decompressed;
+  REQUIRE(DoubleDelta::decompress(type, &compressed_input, &decompressed).ok());
+  CHECK(compressed_input.end());
+  REQUIRE(decompressed.size() == nbytes);
+  CHECK(std::memcmp(decompressed.data(), data.data(), nbytes) == 0);
+
+  return compressed.size();
+}
 
 TEST_CASE(
     "Compression-DoubleDelta: Test 1-element case",
@@ -205,3 +235,141 @@ TEST_CASE(
   delete decomp_out_buff;
   delete[] data;
 }
+
+TEST_CASE(
+    "Compression-DoubleDelta: Test integer types and block boundaries",
+    "[compression], [double-delta]") {
+  std::mt19937_64 gen(7);
+  for (uint64_t num : {0, 1, 2, 3, 127, 129, 130, 131, 258, 1000}) {
+    std::vector<int8_t> i8(num);
+    std::vector<uint16_t> u16(num);
+    std::vector<int32_t> i32(num);
+    std::vector<int64_t> i64(num);
+    std::vector<uint64_t> u64(num);
+    for (uint64_t i = 0; i < num; ++i) {
+      i8[i] = (int8_t)gen();
+      u16[i] = (uint16_t)(i * 3 + gen() % 4);
+      i32[i] = (int32_t)(1000 * i - gen() % 10);
+      i64[i] = (gen() % 2) ? std::numeric_limits<int64_t>::max() :
+                             std::numeric_limits<int64_t>::min();
+      u64[i] = gen();
+    }
+    check_dd_roundtrip(Datatype::INT8, i8);
+    check_dd_roundtrip(Datatype::UINT16, u16);
+    check_dd_roundtrip(Datatype::INT32, i32);
+    check_dd_roundtrip(Datatype::INT64, i64);
+    check_dd_roundtrip(Datatype::UINT64, u64);
+  }
+}
+
+TEST_CASE(
+    "Compression-DoubleDelta: Test timestamps",
+    "[compression], [double-delta]") {
+  // Nanosecond timestamps a second apart with microsecond jitter
+  std::mt19937_64 gen(7);
+  std::vector<int64_t> data(10000);
+  int64_t t = 1500000000000000000LL;
+  for (auto& v : data) {
+    v = t;
+    t += 1000000000LL + (int64_t)(gen() % 1000);
+  }
+  auto size = check_dd_roundtrip(Datatype::INT64, data);
+
+  // The double deltas need at most 11 bits each
+  CHECK(size < data.size() * 12 / 8 + 2 * data.size() / 128 + 100);
+}
+
+TEST_CASE(
+    "Compression-DoubleDelta: Test real values",
+    "[compression], [double-delta]") {
+  // Slowly varying readings compress
+  std::mt19937_64 gen(7);
+  std::vector<double> readings(10000);
+  int64_t steps = 0;
+  for (auto& v : readings) {
+    v = 20.0 + steps * 0.5;
+    steps += (int64_t)(gen() % 3) - 1;
+  }
+  auto size = check_dd_roundtrip(Datatype::FLOAT64, readings);
+  CHECK(size < readings.size() * sizeof(double) / 2);
+
+  // Special values are restored bit by bit
+  std::vector<float> special = {0.0f,
+                                -0.0f,
+                                1.5f,
+                                std::numeric_limits<float>::infinity(),
+                                -std::numeric_limits<float>::infinity(),
+                                std::numeric_limits<float>::quiet_NaN(),
+                                std::numeric_limits<float>::denorm_min(),
+                                std::numeric_limits<float>::max()};
+  check_dd_roundtrip(Datatype::FLOAT32, special);
+
+  std::vector<double> random(1000);
+  for (auto& v : random) {
+    uint64_t bits = gen();
+    std::memcpy(&v, &bits, sizeof(double));
+  }
+  check_dd_roundtrip(Datatype::FLOAT64, random);
+}
+
+TEST_CASE(
+    "Compression-DoubleDelta: Test format of earlier versions",
+    "[compression], [double-delta]") {
+  // Values {100, 300, 200, 600} have double deltas {-300, 500}, written
+  // with a fixed bitsize of 9 as a sign bit and 9 bits each from the MSB
+  std::vector<unsigned char> legacy;
+  uint8_t bitsize = 9;
+  uint64_t num = 4;
+  int first[] = {100, 300};
+  uint64_t chunk =
+      (uint64_t(1) << 63) | (uint64_t(300) << 54) | (uint64_t(500) << 44);
+  legacy.insert(legacy.end(), &bitsize, &bitsize + 1);
+  legacy.insert(
+      legacy.end(), (unsigned char*)&num, (unsigned char*)(&num + 1));
+  legacy.insert(
+      legacy.end(), (unsigned char*)first, (unsigned char*)(first + 2));
+  legacy.insert(
+      legacy.end(), (unsigned char*)&chunk, (unsigned char*)(&chunk + 1));
+
+  ConstBuffer input(legacy.data(), legacy.size());
+  Buffer decompressed;
+  REQUIRE(decompressed.realloc(num * sizeof(int)).ok());
+  REQUIRE(DoubleDelta::decompress(Datatype::INT32, &input, &decompressed).ok());
+  auto values = (int*)decompressed.data();
+  CHECK(values[0] == 100);
+  CHECK(values[1] == 300);
+  CHECK(values[2] == 200);
+  CHECK(values[3] == 600);
+}
+
+TEST_CASE(
+    "Compression-DoubleDelta: Test corrupt input",
+    "[compression], [double-delta]") {
+  std::vector<int32_t> data(300);
+  for (size_t i = 0; i < data.size(); ++i)
+    data[i] = (int32_t)(i * i);
+  ConstBuffer input(data.data(), data.size() * sizeof(int32_t));
+  Buffer compressed;
+  REQUIRE(DoubleDelta::compress(Datatype::INT32, &input, &compressed).ok());
+
+  // Truncated input
+  ConstBuffer truncated(compressed.data(), compressed.size() - 1);
+  Buffer decompressed;
+  CHECK(!DoubleDelta::decompress(Datatype::INT32, &truncated, &decompressed)
+             .ok());
+
+  // Bitsize wider than the type
+  uint64_t first_block = 1 + sizeof(uint64_t) + 2 * sizeof(int32_t);
+  ((unsigned char*)compressed.data())[first_block + 1] = 33;
+  ConstBuffer corrupt(compressed.data(), compressed.size());
+  decompressed.reset_size();
+  decompressed.reset_offset();
+  CHECK(
+      !DoubleDelta::decompress(Datatype::INT32, &corrupt, &decompressed).ok());
+
+  // Input size not a multiple of the type size
+  ConstBuffer odd(data.data(), 5);
+  compressed.reset_size();
+  compressed.reset_offset();
+  CHECK(!DoubleDelta::compress(Datatype::INT32, &odd, &compressed).ok());
+}
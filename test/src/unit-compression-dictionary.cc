@@ -0,0 +1,183 @@
+/**
+ * @file   unit-compression-dictionary.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2018 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * Tests the zstd dictionaries trained for small tiles.
+ */
+
+#include "catch.hpp"
+#include "tiledb/sm/compressors/zstd_compressor.h"
+#include "tiledb/sm/tile/tile_io.h"
+
+#include <cstring>
+#include <random>
+#include <string>
+
+using namespace tiledb::sm;
+
+/** Returns `num` JSON-like records with the same keys and varying values. */
+static std::string json_records(int num, std::mt19937_64* gen) {
+  static const char* cities[] = {"Boston", "Athens", "Chicago", "Lyon"};
+  std::string records;
+  for (int i = 0; i < num; ++i) {
+    records += "{\"id\": " + std::to_string((*gen)() % 1000000) +
+               ", \"name\": \"user_" + std::to_string((*gen)() % 5000) +
+               "\", \"city\": \"" + cities[(*gen)() % 4] +
+               "\", \"active\": " + (((*gen)() % 2) ? "true" : "false") +
+               ", \"score\": " + std::to_string((*gen)() % 100) + "}";
+  }
+  return records;
+}
+
+/**
+ * Compresses `data` as a ZSTD tile into the buffer of `tile_io` and returns
+ * the compressed size.
+ */
+static uint64_t compress(TileIO* tile_io, const std::string& data) {
+  Tile tile(
+      Datatype::CHAR,
+      Compressor::ZSTD,
+      1,
+      1,
+      0,
+      new Buffer((void*)data.data(), data.size(), false),
+      true);
+  auto buffer = tile_io->buffer();
+  buffer->reset_size();
+  buffer->reset_offset();
+  REQUIRE(tile_io->compress_one_tile(&tile).ok());
+  return buffer->size();
+}
+
+/**
+ * Decompresses the input compressed tile with `tile_io` and returns *true*
+ * if it reproduces `data`.
+ */
+static bool decompress(
+    TileIO* tile_io, const Buffer& compressed, const std::string& data) {
+  auto buffer = tile_io->buffer();
+  buffer->reset_size();
+  buffer->reset_offset();
+  REQUIRE(buffer->write(compressed.data(), compressed.size()).ok());
+  buffer->reset_offset();
+
+  Tile tile(Datatype::CHAR, Compressor::ZSTD, 1, 1, 0, new Buffer(), true);
+  REQUIRE(tile.realloc(data.size()).ok());
+  if (!tile_io->decompress_one_tile(&tile).ok())
+    return false;
+  return tile.size() == data.size() &&
+         std::memcmp(tile.data(), data.data(), data.size()) == 0;
+}
+
+TEST_CASE(
+    "Compression-dictionary: Test zstd dictionaries",
+    "[compression], [zstd-dictionary]") {
+  std::mt19937_64 gen(0);
+  auto data = json_records(20000, &gen);
+  uint64_t tile_size = 1024;
+  uint64_t capacity = 16384;
+  Tile tile;
+  REQUIRE(
+      tile.init(Datatype::CHAR, Compressor::ZSTD, 1, tile_size, 1, 0).ok());
+  TileIO tile_io;
+  TileIO plain;
+
+  SECTION("- Small tiles") {
+    REQUIRE(tile_io
+                .train_dictionary(
+                    &tile, data.data(), data.size(), tile_size, capacity)
+                .ok());
+    REQUIRE(tile_io.dictionary() != nullptr);
+    CHECK(!tile_io.dictionary()->data().empty());
+    CHECK(tile_io.dictionary()->data().size() <= capacity);
+
+    // Compare with compression without a dictionary on tiles across the data
+    uint64_t size = 0, plain_size = 0;
+    Buffer compressed;
+    for (uint64_t offset = 0; offset + tile_size <= data.size();
+         offset += 37 * tile_size) {
+      auto tile_data = data.substr(offset, tile_size);
+      size += compress(&tile_io, tile_data);
+      compressed.reset_size();
+      compressed.reset_offset();
+      auto buffer = tile_io.buffer();
+      REQUIRE(compressed.write(buffer->data(), buffer->size()).ok());
+      CHECK(decompress(&tile_io, compressed, tile_data));
+      plain_size += compress(&plain, tile_data);
+    }
+    CHECK(size * 4 < plain_size * 3);
+  }
+
+  SECTION("- Random data") {
+    std::string random(data.size(), '\0');
+    for (auto& c : random)
+      c = (char)gen();
+    REQUIRE(tile_io
+                .train_dictionary(
+                    &tile, random.data(), random.size(), tile_size, capacity)
+                .ok());
+    CHECK(tile_io.dictionary() == nullptr);
+  }
+
+  SECTION("- Too little data") {
+    REQUIRE(
+        tile_io.train_dictionary(&tile, data.data(), 10, tile_size, capacity)
+            .ok());
+    CHECK(tile_io.dictionary() == nullptr);
+  }
+
+  SECTION("- Tiles compressed with and without a dictionary") {
+    REQUIRE(tile_io
+                .train_dictionary(
+                    &tile, data.data(), data.size(), tile_size, capacity)
+                .ok());
+    REQUIRE(tile_io.dictionary() != nullptr);
+    auto tile_data = data.substr(0, tile_size);
+    Buffer compressed;
+
+    // Tiles compressed without a dictionary are decompressed with one
+    compress(&plain, tile_data);
+    REQUIRE(compressed.write(plain.buffer()->data(), plain.buffer()->size())
+                .ok());
+    CHECK(decompress(&tile_io, compressed, tile_data));
+
+    // Tiles compressed with a dictionary need it
+    compressed.reset_size();
+    compressed.reset_offset();
+    compress(&tile_io, tile_data);
+    REQUIRE(
+        compressed.write(tile_io.buffer()->data(), tile_io.buffer()->size())
+            .ok());
+    CHECK(!decompress(&plain, compressed, tile_data));
+    CHECK(decompress(&tile_io, compressed, tile_data));
+
+    // The dictionary is removed with an empty one
+    tile_io.set_dictionary(nullptr, 0);
+    CHECK(tile_io.dictionary() == nullptr);
+  }
+}
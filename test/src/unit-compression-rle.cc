@@ -31,8 +31,11 @@
  * Tests for the RLE compression.
  */
 
+#include <algorithm>
 #include <cstring>
 #include <iostream>
+#include <random>
+#include <vector>
 
 #include "catch.hpp"
 #include "tiledb/sm/compressors/rle_compressor.h"
@@ -70,6 +73,28 @@ TEST_CASE("Compression-RLE: Test invalid format", "[compression], [rle]") {
   delete buff;
 }
 
+TEST_CASE("Compression-RLE: Test zero-length runs", "[compression], [rle]") {
+  // Runs (7, 2), (8, 0), (9, 1), (10, 0) of `int` values
+  Buffer runs;
+  unsigned char run_lens[] = {2, 0, 1, 0};
+  for (int i = 0; i < 4; ++i) {
+    int v = 7 + i;
+    unsigned char len[2] = {0, run_lens[i]};
+    REQUIRE(runs.write(&v, sizeof(int)).ok());
+    REQUIRE(runs.write(len, sizeof(len)).ok());
+  }
+
+  // The zero-length runs write nothing
+  Buffer decompressed;
+  ConstBuffer input(runs.data(), runs.size());
+  REQUIRE(RLE::decompress(sizeof(int), &input, &decompressed).ok());
+  REQUIRE(decompressed.size() == 3 * sizeof(int));
+  auto values = (int*)decompressed.data();
+  CHECK(values[0] == 7);
+  CHECK(values[1] == 7);
+  CHECK(values[2] == 9);
+}
+
 TEST_CASE("Compression-RLE: Test all values unique", "[compression], [rle]") {
   // Populate data
   int data[100];
@@ -280,3 +305,71 @@ TEST_CASE(
   delete compressed;
   delete decompressed;
 }
+
+/** Reference encoder producing the RLE format value by value. */
+static void rle_reference_compress(
+    const unsigned char* data,
+    uint64_t value_num,
+    uint64_t value_size,
+    std::vector<unsigned char>* out) {
+  uint64_t i = 0;
+  while (i < value_num) {
+    uint64_t run_len = 1;
+    while (i + run_len < value_num && run_len < 65535 &&
+           !memcmp(
+               data + i * value_size,
+               data + (i + run_len) * value_size,
+               value_size))
+      ++run_len;
+    out->insert(
+        out->end(), data + i * value_size, data + (i + 1) * value_size);
+    out->push_back((unsigned char)(run_len >> 8));
+    out->push_back((unsigned char)(run_len % 256));
+    i += run_len;
+  }
+}
+
+TEST_CASE(
+    "Compression-RLE: Test random runs against the reference format",
+    "[compression], [rle]") {
+  std::mt19937 gen(42);
+  for (uint64_t value_size : {1, 2, 4, 8, 12, 16}) {
+    for (uint64_t max_run_len : {1, 3, 17, 200, 70000}) {
+      // Runs of random length, each differing from the previous run in a
+      // single random byte so that mismatches land anywhere within a value
+      uint64_t value_num = 150000;
+      std::vector<unsigned char> data(value_num * value_size);
+      std::vector<unsigned char> value(value_size, 0);
+      std::uniform_int_distribution<uint64_t> run_dist(1, max_run_len);
+      std::uniform_int_distribution<uint64_t> byte_dist(0, value_size - 1);
+      for (uint64_t i = 0; i < value_num;) {
+        value[byte_dist(gen)]++;
+        uint64_t run_len = std::min(run_dist(gen), value_num - i);
+        for (uint64_t j = 0; j < run_len; ++j, ++i)
+          memcpy(&data[i * value_size], &value[0], value_size);
+      }
+
+      // Compress, appending to data already in the output buffer
+      Buffer compressed;
+      uint64_t prefix = 3;
+      REQUIRE(compressed.write("abc", prefix).ok());
+      ConstBuffer input(&data[0], data.size());
+      REQUIRE(RLE::compress(value_size, &input, &compressed).ok());
+      CHECK(compressed.offset() == compressed.size());
+      CHECK(!memcmp(compressed.data(), "abc", prefix));
+
+      std::vector<unsigned char> expected;
+      rle_reference_compress(&data[0], value_num, value_size, &expected);
+      REQUIRE(compressed.size() == prefix + expected.size());
+      CHECK(!memcmp(compressed.data(prefix), &expected[0], expected.size()));
+
+      // Decompress into an unallocated buffer
+      Buffer decompressed;
+      ConstBuffer compressed_input(compressed.data(prefix), expected.size());
+      REQUIRE(
+          RLE::decompress(value_size, &compressed_input, &decompressed).ok());
+      REQUIRE(decompressed.size() == data.size());
+      CHECK(!memcmp(decompressed.data(), &data[0], data.size()));
+    }
+  }
+}
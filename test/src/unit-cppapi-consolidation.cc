@@ -0,0 +1,601 @@
+/**
+ * @file   unit-cppapi-consolidation.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2018 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * Tests the consolidation policies through the C++ API.
+ */
+
+#include "catch.hpp"
+#include "tiledb/sm/cpp_api/tiledb"
+#include "tiledb/sm/fragment/fragment_metadata.h"
+#include "tiledb/sm/misc/constants.h"
+#include "tiledb/sm/query/query.h"
+#include "tiledb/sm/storage_manager/config.h"
+#include "tiledb/sm/storage_manager/consolidator.h"
+#include "tiledb/sm/storage_manager/storage_manager.h"
+#include "tiledb/sm/tile/tile_io.h"
+#ifdef _WIN32
+#include "tiledb/sm/filesystem/win_filesystem.h"
+namespace fs = tiledb::sm::win;
+#else
+#include "tiledb/sm/filesystem/posix_filesystem.h"
+namespace fs = tiledb::sm::posix;
+#endif
+
+#include <chrono>
+#include <thread>
+
+using namespace tiledb;
+
+struct CPPConsolidationFx {
+  const std::string array_name = "cpp_unit_consolidation";
+
+  Context ctx;
+  VFS vfs;
+  tiledb_array_type_t array_type;
+
+  CPPConsolidationFx()
+      : vfs(ctx) {
+    remove_array();
+  }
+
+  ~CPPConsolidationFx() {
+    remove_array();
+  }
+
+  void remove_array() {
+    if (vfs.is_dir(array_name))
+      vfs.remove_dir(array_name);
+  }
+
+  void create_array(tiledb_array_type_t type, uint64_t capacity = 10000) {
+    array_type = type;
+    Domain domain(ctx);
+    domain.add_dimension(Dimension::create<int>(ctx, "dim", {{1, 1000}}, 10));
+    ArraySchema schema(ctx, type);
+    schema.set_domain(domain);
+    schema.set_capacity(capacity);
+    schema.add_attribute(Attribute::create<int>(ctx, "a"));
+    Array::create(array_name, schema);
+  }
+
+  /** Returns a context with the tiered consolidation policy. */
+  static Context tiered_ctx() {
+    Config config;
+    config["sm.consolidation_policy"] = "tiered";
+    return Context(config);
+  }
+
+  /**
+   * Returns a context that consolidates partitions of 100 cells per buffer,
+   * four at a time.
+   */
+  static Context partitioned_ctx(unsigned int buffer_num) {
+    Config config;
+    config["sm.consolidation_threads"] = "4";
+    config["sm.consolidation_memory_budget"] =
+        std::to_string(4 * buffer_num * 100 * sizeof(int));
+    return Context(config);
+  }
+
+  /** Writes `a` = `value` to the cells in `[first, last]`. */
+  void write(int first, int last, int value) {
+    std::vector<int> coords, a;
+    for (int i = first; i <= last; ++i) {
+      coords.push_back(i);
+      a.push_back(value);
+    }
+    Query query(ctx, array_name, TILEDB_WRITE);
+    query.set_buffer("a", a);
+    if (array_type == TILEDB_DENSE) {
+      query.set_layout(TILEDB_ROW_MAJOR);
+      query.set_subarray<int>({first, last});
+    } else {
+      query.set_layout(TILEDB_UNORDERED);
+      query.set_coordinates(coords);
+    }
+    REQUIRE(query.submit() == Query::Status::COMPLETE);
+
+    // Fragments are ordered by their timestamp in milliseconds
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+  }
+
+  /** Returns the number of fragments of the array. */
+  uint64_t fragment_num() {
+    std::vector<std::string> paths;
+    REQUIRE(fs::ls(array_name, &paths).ok());
+    uint64_t ret = 0;
+    for (const auto& path : paths)
+      ret += fs::is_dir(path) ? 1 : 0;
+    return ret;
+  }
+
+  /** Writes `a` = `value` to the cells `i` in `[1, 1000]` with `i % 4 == r`. */
+  void write_strided(int r, int value) {
+    std::vector<int> coords, a;
+    for (int i = 1; i <= 1000; ++i) {
+      if (i % 4 == r) {
+        coords.push_back(i);
+        a.push_back(value);
+      }
+    }
+    Query query(ctx, array_name, TILEDB_WRITE);
+    query.set_layout(TILEDB_UNORDERED);
+    query.set_buffer("a", a);
+    query.set_coordinates(coords);
+    REQUIRE(query.submit() == Query::Status::COMPLETE);
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+  }
+
+  /** Returns the values of `a` in `[1, 1000]` in global order. */
+  std::vector<int> read_all() {
+    std::vector<int> coords(1000), a(1000);
+    Query query(ctx, array_name, TILEDB_READ);
+    query.set_layout(TILEDB_GLOBAL_ORDER);
+    query.set_subarray<int>({1, 1000});
+    query.set_buffer("a", a);
+    if (array_type == TILEDB_SPARSE)
+      query.set_coordinates(coords);
+    REQUIRE(query.submit() == Query::Status::COMPLETE);
+    a.resize(query.result_buffer_elements()["a"].second);
+    return a;
+  }
+
+  /** Returns the value of `a` of the input cell, or `0` if it is empty. */
+  int read(int cell) {
+    std::vector<int> coords(1), a(1);
+    Query query(ctx, array_name, TILEDB_READ);
+    query.set_layout(TILEDB_ROW_MAJOR);
+    query.set_subarray<int>({cell, cell});
+    query.set_buffer("a", a);
+    if (array_type == TILEDB_SPARSE)
+      query.set_coordinates(coords);
+    REQUIRE(query.submit() == Query::Status::COMPLETE);
+    return query.result_buffer_elements()["a"].second == 0 ? 0 : a[0];
+  }
+};
+
+TEST_CASE_METHOD(
+    CPPConsolidationFx,
+    "C++ API: Test tiered consolidation",
+    "[cppapi], [consolidation]") {
+  SECTION("- Sparse array") {
+    create_array(TILEDB_SPARSE);
+    for (int i = 0; i < 4; ++i)
+      write(200 * i + 1, 200 * i + 200, i + 1);
+    for (int i = 0; i < 4; ++i)
+      write(800 + 10 * i + 1, 800 + 10 * i + 10, i + 10);
+    CHECK(fragment_num() == 8);
+
+    // The small fragments are consolidated first
+    Array::consolidate(tiered_ctx(), array_name);
+    CHECK(fragment_num() == 5);
+    CHECK(read(805) == 10);
+    CHECK(read(835) == 13);
+    CHECK(read(500) == 3);
+
+    // Then the large ones
+    Array::consolidate(tiered_ctx(), array_name);
+    CHECK(fragment_num() == 2);
+    CHECK(read(805) == 10);
+    CHECK(read(500) == 3);
+
+    // Too few fragments are left for a tier
+    Array::consolidate(tiered_ctx(), array_name);
+    CHECK(fragment_num() == 2);
+
+    // The full policy consolidates everything
+    Array::consolidate(ctx, array_name);
+    CHECK(fragment_num() == 1);
+    CHECK(read(1) == 1);
+    CHECK(read(805) == 10);
+  }
+
+  SECTION("- Dense array") {
+    create_array(TILEDB_DENSE);
+    write(1, 500, 1);
+    for (int i = 0; i < 4; ++i)
+      write(2 * i + 1, 2 * i + 2, i + 10);
+    CHECK(fragment_num() == 5);
+
+    // The small fragments would fill the tiles of the older one
+    Array::consolidate(tiered_ctx(), array_name);
+    CHECK(fragment_num() == 5);
+
+    // Small fragments outside the older one are consolidated
+    for (int i = 0; i < 4; ++i)
+      write(600 + 2 * i + 1, 600 + 2 * i + 2, i + 20);
+    Array::consolidate(tiered_ctx(), array_name);
+    CHECK(fragment_num() == 6);
+    CHECK(read(1) == 10);
+    CHECK(read(9) == 1);
+    CHECK(read(601) == 20);
+    CHECK(read(608) == 23);
+  }
+}
+
+TEST_CASE_METHOD(
+    CPPConsolidationFx,
+    "C++ API: Test partitioned consolidation",
+    "[cppapi], [consolidation]") {
+  std::vector<int> expected;
+  SECTION("- Sparse array") {
+    create_array(TILEDB_SPARSE, 10);
+    for (int r = 0; r < 4; ++r)
+      write_strided(r, r + 1);
+    for (int i = 1; i <= 1000; ++i)
+      expected.push_back(i % 4 + 1);
+
+    // The buffers hold the coordinates and `a`
+    Array::consolidate(partitioned_ctx(2), array_name);
+  }
+
+  SECTION("- Dense array") {
+    // The fragments overlap, so their cells are rewritten
+    create_array(TILEDB_DENSE);
+    write(1, 1000, 0);
+    for (int i = 0; i < 10; ++i)
+      write(100 * i + 1, 100 * i + 100, i + 1);
+    for (int i = 1; i <= 1000; ++i)
+      expected.push_back((i - 1) / 100 + 1);
+
+    Array::consolidate(partitioned_ctx(1), array_name);
+  }
+
+  CHECK(fragment_num() == 1);
+  CHECK(read_all() == expected);
+}
+
+TEST_CASE_METHOD(
+    CPPConsolidationFx,
+    "C++ API: Test partitioned consolidation with a real domain",
+    "[cppapi], [consolidation]") {
+  Domain domain(ctx);
+  domain.add_dimension(Dimension::create<float>(ctx, "x", {{0, 100}}, 10));
+  domain.add_dimension(Dimension::create<float>(ctx, "y", {{0, 100}}, 10));
+  ArraySchema schema(ctx, TILEDB_SPARSE);
+  schema.set_domain(domain);
+  schema.set_capacity(10);
+  schema.add_attribute(Attribute::create<int>(ctx, "a"));
+  Array::create(array_name, schema);
+
+  // Cells every 5 units, half of them on tile boundaries, in two fragments
+  for (int f = 0; f < 2; ++f) {
+    std::vector<float> coords;
+    std::vector<int> a;
+    for (int x = 0; x < 100; x += 5) {
+      for (int y = 0; y < 100; y += 5) {
+        if ((x + y) / 5 % 2 == f) {
+          coords.push_back((float)x);
+          coords.push_back((float)y);
+          a.push_back(x * 100 + y);
+        }
+      }
+    }
+    Query query(ctx, array_name, TILEDB_WRITE);
+    query.set_layout(TILEDB_UNORDERED);
+    query.set_buffer("a", a);
+    query.set_coordinates(coords);
+    REQUIRE(query.submit() == Query::Status::COMPLETE);
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+  }
+
+  // Each cell is read once, in global order, after the consolidation
+  auto read_all_coords = [&]() {
+    std::vector<float> coords(1000);
+    std::vector<int> a(500);
+    Query query(ctx, array_name, TILEDB_READ);
+    query.set_layout(TILEDB_GLOBAL_ORDER);
+    query.set_subarray<float>({0, 100, 0, 100});
+    query.set_buffer("a", a);
+    query.set_coordinates(coords);
+    REQUIRE(query.submit() == Query::Status::COMPLETE);
+    REQUIRE(query.result_buffer_elements()["a"].second == 400);
+    coords.resize(800);
+    return coords;
+  };
+  auto expected = read_all_coords();
+
+  // Partitions of 100 coordinates split the domain on the tile boundaries
+  Array::consolidate(partitioned_ctx(4), array_name);
+  CHECK(fragment_num() == 1);
+  CHECK(read_all_coords() == expected);
+}
+
+TEST_CASE_METHOD(
+    CPPConsolidationFx,
+    "C++ API: Test tile copy consolidation",
+    "[cppapi], [consolidation]") {
+  SECTION("- Sparse array") {
+    create_array(TILEDB_SPARSE, 10);
+
+    // Appends of full tiles are copied, regardless of their write order
+    write(101, 200, 2);
+    write(1, 100, 1);
+    write(201, 300, 3);
+    Array::consolidate(ctx, array_name);
+    CHECK(fragment_num() == 1);
+    std::vector<int> expected;
+    for (int i = 1; i <= 300; ++i)
+      expected.push_back((i - 1) / 100 + 1);
+    CHECK(read_all() == expected);
+
+    // A partial tile in the middle is rewritten
+    write(301, 395, 4);
+    write(396, 400, 5);
+    Array::consolidate(ctx, array_name);
+    CHECK(fragment_num() == 1);
+    CHECK(read(300) == 3);
+    CHECK(read(395) == 4);
+    CHECK(read(396) == 5);
+  }
+
+  SECTION("- Sparse array with a variable-sized attribute") {
+    Domain domain(ctx);
+    domain.add_dimension(Dimension::create<int>(ctx, "dim", {{1, 1000}}, 10));
+    ArraySchema schema(ctx, TILEDB_SPARSE);
+    schema.set_domain(domain);
+    schema.set_capacity(10);
+    schema.add_attribute(
+        Attribute::create<std::string>(ctx, "b").set_compressor(
+            {TILEDB_GZIP, -1}));
+    Array::create(array_name, schema);
+
+    // Each cell `i` holds `i % 7 + 1` characters
+    for (int f = 1; f >= 0; --f) {
+      std::vector<int> coords;
+      std::vector<std::string> b;
+      for (int i = 100 * f + 1; i <= 100 * f + 100; ++i) {
+        coords.push_back(i);
+        b.push_back(std::string(i % 7 + 1, 'a' + f));
+      }
+      auto b_buf = ungroup_var_buffer(b);
+      Query query(ctx, array_name, TILEDB_WRITE);
+      query.set_layout(TILEDB_UNORDERED);
+      query.set_buffer("b", b_buf);
+      query.set_coordinates(coords);
+      REQUIRE(query.submit() == Query::Status::COMPLETE);
+      std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    Array::consolidate(ctx, array_name);
+    CHECK(fragment_num() == 1);
+
+    std::vector<int> coords(200);
+    std::vector<uint64_t> offsets(200);
+    std::string data(2000, 0);
+    Query query(ctx, array_name, TILEDB_READ);
+    query.set_layout(TILEDB_GLOBAL_ORDER);
+    query.set_subarray<int>({1, 1000});
+    query.set_buffer("b", offsets, data);
+    query.set_coordinates(coords);
+    REQUIRE(query.submit() == Query::Status::COMPLETE);
+    auto result_num = query.result_buffer_elements()["b"];
+    REQUIRE(result_num.first == 200);
+    offsets.push_back(result_num.second);
+    for (int i = 1; i <= 200; ++i) {
+      CHECK(coords[i - 1] == i);
+      CHECK(
+          data.substr(offsets[i - 1], offsets[i] - offsets[i - 1]) ==
+          std::string(i % 7 + 1, (i <= 100) ? 'a' : 'b'));
+    }
+  }
+
+  SECTION("- Dense array") {
+    create_array(TILEDB_DENSE);
+    write(101, 200, 2);
+    write(1, 100, 1);
+    Array::consolidate(ctx, array_name);
+    CHECK(fragment_num() == 1);
+
+    // Copied tiles keep the non-empty domain of the fragments
+    auto non_empty_domain = Array::non_empty_domain<int>(ctx, array_name);
+    CHECK(non_empty_domain[0].second.first == 1);
+    CHECK(non_empty_domain[0].second.second == 200);
+    CHECK(read(1) == 1);
+    CHECK(read(100) == 1);
+    CHECK(read(101) == 2);
+    CHECK(read(200) == 2);
+  }
+}
+
+TEST_CASE_METHOD(
+    CPPConsolidationFx,
+    "C++ API: Test auto-consolidation",
+    "[cppapi], [consolidation]") {
+  Config config;
+  config["sm.auto_consolidation_interval_ms"] = "10";
+  config["sm.auto_consolidation_fragment_num"] = "4";
+  ctx = Context(config);
+  create_array(TILEDB_SPARSE);
+  for (int i = 0; i < 4; ++i)
+    write(100 * i + 1, 100 * i + 100, i + 1);
+
+  // The array may be consolidated in the background at any point
+  for (int i = 0; i < 500 && fragment_num() > 1; ++i)
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  CHECK(read(1) == 1);
+  CHECK(read(150) == 2);
+  CHECK(read(400) == 4);
+}
+
+TEST_CASE_METHOD(
+    CPPConsolidationFx,
+    "C++ API: Test auto-consolidation thresholds",
+    "[cppapi], [consolidation]") {
+  create_array(TILEDB_SPARSE);
+
+  // Returns whether the array is due for auto-consolidation
+  auto due = [this](const std::map<std::string, std::string>& params) {
+    sm::Config config;
+    config.set("sm.auto_consolidation_fragment_num", "0");
+    config.set("sm.auto_consolidation_small_fragment_size", "0");
+    config.set("sm.auto_consolidation_read_amplification", "0");
+    for (const auto& param : params)
+      REQUIRE(config.set(param.first, param.second).ok());
+    sm::StorageManager storage_manager;
+    REQUIRE(storage_manager.init(&config).ok());
+    sm::Consolidator consolidator(&storage_manager);
+    bool ret = false;
+    uint64_t size = 0;
+    REQUIRE(
+        consolidator.consolidation_due(array_name.c_str(), &ret, &size).ok());
+    return ret;
+  };
+
+  // Each fragment overlaps two others
+  for (int i = 0; i < 3; ++i)
+    write(1, 100, i + 1);
+  CHECK(!due({}));
+  CHECK(!due({{"sm.auto_consolidation_fragment_num", "4"}}));
+  CHECK(due({{"sm.auto_consolidation_fragment_num", "3"}}));
+  CHECK(!due({{"sm.auto_consolidation_read_amplification", "3"}}));
+  CHECK(due({{"sm.auto_consolidation_read_amplification", "2"}}));
+  CHECK(due({{"sm.auto_consolidation_small_fragment_size", "1000000"},
+             {"sm.consolidation_min_fragments", "3"}}));
+  CHECK(!due({{"sm.auto_consolidation_small_fragment_size", "1000000"},
+              {"sm.consolidation_min_fragments", "4"}}));
+
+  // A fragment outside the others overlaps none of them
+  write(201, 300, 4);
+  CHECK(!due({{"sm.auto_consolidation_read_amplification", "3"}}));
+  write(1, 100, 5);
+  CHECK(due({{"sm.auto_consolidation_read_amplification", "3"}}));
+}
+
+TEST_CASE_METHOD(
+    CPPConsolidationFx,
+    "C++ API: Test metadata consolidation",
+    "[cppapi], [consolidation]") {
+  SECTION("- Sparse array") {
+    create_array(TILEDB_SPARSE);
+  }
+
+  SECTION("- Dense array") {
+    create_array(TILEDB_DENSE);
+  }
+
+  for (int i = 0; i < 3; ++i)
+    write(100 * i + 1, 100 * i + 100, i + 1);
+  Array::consolidate_metadata(ctx, array_name);
+  CHECK(vfs.is_file(array_name + "/__consolidated_fragment_metadata.tdb"));
+
+  // The metadata of the fragments is read from the consolidated file
+  std::vector<std::string> paths;
+  REQUIRE(fs::ls(array_name, &paths).ok());
+  for (const auto& path : paths) {
+    if (fs::is_dir(path))
+      vfs.remove_file(path + "/__fragment_metadata.tdb");
+  }
+  CHECK(read(1) == 1);
+  CHECK(read(150) == 2);
+  CHECK(read(300) == 3);
+
+  // Newer fragments are read from their own metadata file
+  write(301, 400, 4);
+  CHECK(read(1) == 1);
+  CHECK(read(400) == 4);
+}
+
+TEST_CASE_METHOD(
+    CPPConsolidationFx,
+    "C++ API: Test metadata consolidation with consolidated fragments",
+    "[cppapi], [consolidation]") {
+  create_array(TILEDB_SPARSE);
+  for (int i = 0; i < 3; ++i)
+    write(100 * i + 1, 100 * i + 100, i + 1);
+  Array::consolidate_metadata(ctx, array_name);
+
+  // The entries of the consolidated fragments are ignored
+  Array::consolidate(ctx, array_name);
+  CHECK(fragment_num() == 1);
+  CHECK(read(1) == 1);
+  CHECK(read(300) == 3);
+
+  Array::consolidate_metadata(ctx, array_name);
+  CHECK(read(150) == 2);
+}
+
+TEST_CASE_METHOD(
+    CPPConsolidationFx,
+    "C++ API: Test metadata consolidation with fragments without "
+    "dictionaries",
+    "[cppapi], [consolidation]") {
+  create_array(TILEDB_SPARSE);
+  for (int i = 0; i < 3; ++i)
+    write(100 * i + 1, 100 * i + 100, i + 1);
+
+  // Strip the (empty) dictionary of `a` from the metadata files, as in the
+  // fragments written before the dictionaries were introduced
+  sm::StorageManager storage_manager;
+  REQUIRE(storage_manager.init(nullptr).ok());
+  std::vector<std::string> paths;
+  REQUIRE(fs::ls(array_name, &paths).ok());
+  for (const auto& path : paths) {
+    if (!fs::is_dir(path))
+      continue;
+    auto uri = sm::URI(path).join_path(
+        std::string(sm::constants::fragment_metadata_filename));
+    auto tile = (sm::Tile*)nullptr;
+    REQUIRE(sm::TileIO(&storage_manager, uri).read_generic(&tile, 0).ok());
+    auto size = tile->buffer()->size() - sizeof(uint64_t);
+    CHECK(*(uint64_t*)tile->buffer()->data(size) == 0);
+    sm::Buffer buff;
+    REQUIRE(buff.write(tile->buffer()->data(), size).ok());
+    delete tile;
+
+    REQUIRE(storage_manager.vfs()->remove_file(uri).ok());
+    buff.reset_offset();
+    sm::Tile stripped(
+        sm::constants::generic_tile_datatype,
+        sm::constants::generic_tile_compressor,
+        sm::constants::generic_tile_compression_level,
+        sm::constants::generic_tile_cell_size,
+        0,
+        &buff,
+        false);
+    REQUIRE(sm::TileIO(&storage_manager, uri).write_generic(&stripped).ok());
+    REQUIRE(storage_manager.close_file(uri).ok());
+  }
+
+  // Each entry is deserialized from its own bytes, not the ones of the
+  // entries that follow it
+  Array::consolidate_metadata(ctx, array_name);
+  sm::StorageManager reader;
+  REQUIRE(reader.init(nullptr).ok());
+  sm::Query query;
+  REQUIRE(
+      reader.query_init(&query, array_name.c_str(), sm::QueryType::READ).ok());
+  CHECK(query.fragment_metadata().size() == 3);
+  for (auto metadata : query.fragment_metadata())
+    CHECK(metadata->zstd_dictionary(0).empty());
+  REQUIRE(reader.query_finalize(&query).ok());
+
+  CHECK(read(1) == 1);
+  CHECK(read(150) == 2);
+  CHECK(read(300) == 3);
+}
@@ -0,0 +1,192 @@
+/**
+ * @file   unit-cppapi-external_sort.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2018 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * Tests out-of-core unordered sparse writes through the C++ API.
+ */
+
+#include "catch.hpp"
+#include "tiledb/sm/cpp_api/tiledb"
+#ifdef _WIN32
+#include "tiledb/sm/filesystem/win_filesystem.h"
+namespace fs = tiledb::sm::win;
+#else
+#include "tiledb/sm/filesystem/posix_filesystem.h"
+namespace fs = tiledb::sm::posix;
+#endif
+
+#include <algorithm>
+#include <array>
+
+using namespace tiledb;
+
+struct CPPExternalSortFx {
+  const std::string array_name = "cpp_unit_external_sort";
+  const std::string scratch_dir = "cpp_unit_external_sort_scratch";
+
+  Context ctx;
+  VFS vfs;
+
+  CPPExternalSortFx()
+      : vfs(ctx) {
+    remove_dirs();
+
+    Domain domain(ctx);
+    domain.add_dimension(Dimension::create<int>(ctx, "d1", {{1, 40}}, 10))
+        .add_dimension(Dimension::create<int>(ctx, "d2", {{1, 40}}, 10));
+    ArraySchema schema(ctx, TILEDB_SPARSE);
+    schema.set_domain(domain).set_capacity(64);
+    schema.add_attribute(Attribute::create<int>(ctx, "a"));
+    schema.add_attribute(Attribute::create<std::string>(ctx, "b"));
+    Array::create(array_name, schema);
+    vfs.create_dir(scratch_dir);
+  }
+
+  ~CPPExternalSortFx() {
+    remove_dirs();
+  }
+
+  void remove_dirs() {
+    if (vfs.is_dir(array_name))
+      vfs.remove_dir(array_name);
+    if (vfs.is_dir(scratch_dir))
+      vfs.remove_dir(scratch_dir);
+  }
+
+  /** Returns a context that sorts unordered writes within `memory`. */
+  Context sort_ctx(uint64_t memory) {
+    Config config;
+    config["sm.external_sort_memory"] = std::to_string(memory);
+    config["sm.external_sort_scratch_dir"] = scratch_dir;
+    return Context(config);
+  }
+
+  /** Returns the value of `a` of the cell with the input coordinates. */
+  static int value(int d1, int d2) {
+    return 100 * d1 + d2;
+  }
+
+  /**
+   * Writes all the cells of the domain in a scattered order, in batches
+   * of 100 cells submitted through a single query.
+   */
+  void write(const Context& ctx) {
+    Query query(ctx, array_name, TILEDB_WRITE);
+    query.set_layout(TILEDB_UNORDERED);
+    for (int batch = 0; batch < 16; ++batch) {
+      std::vector<int> coords, a;
+      std::vector<uint64_t> b_off;
+      std::string b;
+      for (int i = 0; i < 100; ++i) {
+        int cell = (97 * (100 * batch + i)) % 1600;
+        int d1 = cell / 40 + 1, d2 = cell % 40 + 1;
+        coords.push_back(d1);
+        coords.push_back(d2);
+        a.push_back(value(d1, d2));
+        b_off.push_back(b.size());
+        b += std::to_string(value(d1, d2));
+      }
+      query.reset_buffers();
+      query.set_buffer("a", a);
+      query.set_buffer("b", b_off, b);
+      query.set_coordinates(coords);
+      REQUIRE(query.submit() == Query::Status::COMPLETE);
+    }
+  }
+
+  /** Returns the number of entries of the input directory. */
+  static uint64_t entry_num(const std::string& dir) {
+    std::vector<std::string> paths;
+    REQUIRE(fs::ls(dir, &paths).ok());
+    return paths.size();
+  }
+
+  /** Returns the number of fragments of the array. */
+  uint64_t fragment_num() {
+    std::vector<std::string> paths;
+    REQUIRE(fs::ls(array_name, &paths).ok());
+    uint64_t ret = 0;
+    for (const auto& path : paths)
+      ret += fs::is_dir(path) ? 1 : 0;
+    return ret;
+  }
+
+  /** Checks that the array holds all the cells in the global order. */
+  void check_read() {
+    std::vector<int> coords(2 * 1600), a(1600);
+    std::vector<uint64_t> b_off(1600);
+    std::string b(8 * 1600, '\0');
+    Query query(ctx, array_name, TILEDB_READ);
+    query.set_layout(TILEDB_GLOBAL_ORDER);
+    query.set_subarray<int>({1, 40, 1, 40});
+    query.set_buffer("a", a);
+    query.set_buffer("b", b_off, b);
+    query.set_coordinates(coords);
+    REQUIRE(query.submit() == Query::Status::COMPLETE);
+
+    // Tiles and cells are both in row-major order
+    std::vector<std::array<int, 4>> expected;
+    for (int d1 = 1; d1 <= 40; ++d1)
+      for (int d2 = 1; d2 <= 40; ++d2)
+        expected.push_back({{(d1 - 1) / 10, (d2 - 1) / 10, d1, d2}});
+    std::sort(expected.begin(), expected.end());
+
+    auto elements = query.result_buffer_elements();
+    REQUIRE(elements["a"].second == 1600);
+    std::string expected_b;
+    for (int i = 0; i < 1600; ++i) {
+      int d1 = expected[i][2], d2 = expected[i][3];
+      CHECK(coords[2 * i] == d1);
+      CHECK(coords[2 * i + 1] == d2);
+      CHECK(a[i] == value(d1, d2));
+      expected_b += std::to_string(value(d1, d2));
+    }
+    CHECK(b.substr(0, elements["b"].second) == expected_b);
+  }
+};
+
+TEST_CASE_METHOD(
+    CPPExternalSortFx,
+    "C++ API: Test external sort",
+    "[cppapi], [external-sort]") {
+  SECTION("- In memory") {
+    // The run fits, but the sorted cells are written in several parts
+    write(sort_ctx(65536));
+    CHECK(fragment_num() == 1);
+    CHECK(entry_num(scratch_dir) == 0);
+    check_read();
+  }
+
+  SECTION("- Spilled runs") {
+    // Each batch takes about 100 * (8 + 4 + 8 + 4 + 8) bytes in memory
+    write(sort_ctx(8192));
+    CHECK(fragment_num() == 1);
+    CHECK(entry_num(scratch_dir) == 0);
+    check_read();
+  }
+}
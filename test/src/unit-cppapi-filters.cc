@@ -0,0 +1,356 @@
+/**
+ * @file   unit-cppapi-filters.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2018 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * Tests attribute filter pipelines through the C++ API.
+ */
+
+#include "catch.hpp"
+#include "tiledb/sm/cpp_api/tiledb"
+
+#include <cmath>
+#include <random>
+
+using namespace tiledb;
+
+struct CPPFiltersFx {
+  CPPFiltersFx()
+      : vfs(ctx) {
+    if (vfs.is_dir("cpp_unit_filters"))
+      vfs.remove_dir("cpp_unit_filters");
+  }
+
+  ~CPPFiltersFx() {
+    if (vfs.is_dir("cpp_unit_filters"))
+      vfs.remove_dir("cpp_unit_filters");
+  }
+
+  /**
+   * Creates a dense array with a fixed-sized `int64_t` attribute `a` and a
+   * variable-sized string attribute `b`, both with the input filters and
+   * compressor.
+   */
+  void create_array(
+      const std::vector<tiledb_filter_type_t>& filters,
+      tiledb_compressor_t compressor) {
+    Domain domain(ctx);
+    auto d = Dimension::create<int>(ctx, "d", {{1, 1000}}, 250);
+    domain.add_dimension(d);
+    auto a = Attribute::create<int64_t>(ctx, "a");
+    auto b = Attribute::create<std::string>(ctx, "b");
+    for (auto f : filters) {
+      a.add_filter(f);
+      b.add_filter(f);
+    }
+    a.set_compressor({compressor, -1});
+    b.set_compressor({compressor, -1});
+    ArraySchema schema(ctx, TILEDB_DENSE);
+    schema.set_domain(domain);
+    schema.add_attribute(a).add_attribute(b);
+    Array::create("cpp_unit_filters", schema);
+  }
+
+  /** Writes and reads back the entire array, checking the values. */
+  void check_write_read() {
+    std::vector<int64_t> a(1000);
+    std::vector<uint64_t> b_off(1000);
+    std::string b;
+    for (int i = 0; i < 1000; ++i) {
+      a[i] = 1000000 + 7 * i - (i % 3);
+      b_off[i] = b.size();
+      b += "cell_" + std::to_string(i % 17);
+    }
+
+    Query write(ctx, "cpp_unit_filters", TILEDB_WRITE);
+    write.set_layout(TILEDB_ROW_MAJOR);
+    write.set_buffer("a", a);
+    write.set_buffer("b", b_off, b);
+    REQUIRE(write.submit() == Query::Status::COMPLETE);
+
+    std::vector<int64_t> a_read(1000);
+    std::vector<uint64_t> b_off_read(1000);
+    std::string b_read(b.size(), '\0');
+    Query read(ctx, "cpp_unit_filters", TILEDB_READ);
+    read.set_layout(TILEDB_ROW_MAJOR);
+    read.set_subarray<int>({1, 1000});
+    read.set_buffer("a", a_read);
+    read.set_buffer("b", b_off_read, b_read);
+    REQUIRE(read.submit() == Query::Status::COMPLETE);
+    CHECK(a_read == a);
+    CHECK(b_off_read == b_off);
+    CHECK(b_read == b);
+  }
+
+  Context ctx;
+  VFS vfs;
+};
+
+TEST_CASE_METHOD(
+    CPPFiltersFx,
+    "C++ API: Attribute filters",
+    "[cppapi], [filter]") {
+  SECTION("- Filters are persisted in the schema") {
+    create_array(
+        {TILEDB_FILTER_DELTA, TILEDB_FILTER_BYTESHUFFLE},
+        TILEDB_NO_COMPRESSION);
+    ArraySchema schema(ctx, "cpp_unit_filters");
+    auto filters = schema.attribute("a").filters();
+    REQUIRE(filters.size() == 2);
+    CHECK(filters[0] == TILEDB_FILTER_DELTA);
+    CHECK(filters[1] == TILEDB_FILTER_BYTESHUFFLE);
+    CHECK(schema.attribute("b").filters().size() == 2);
+  }
+
+  SECTION("- Filters without compressor") {
+    create_array(
+        {TILEDB_FILTER_DELTA, TILEDB_FILTER_BIT_WIDTH_REDUCTION},
+        TILEDB_NO_COMPRESSION);
+    check_write_read();
+  }
+
+  SECTION("- Filters with compressor") {
+    create_array(
+        {TILEDB_FILTER_DELTA,
+         TILEDB_FILTER_BIT_WIDTH_REDUCTION,
+         TILEDB_FILTER_BITSHUFFLE},
+        TILEDB_ZSTD);
+    check_write_read();
+  }
+
+  SECTION("- Byte shuffle with RLE") {
+    create_array({TILEDB_FILTER_BYTESHUFFLE}, TILEDB_RLE);
+    check_write_read();
+  }
+
+  SECTION("- AUTO compressor") {
+    create_array({}, TILEDB_AUTO);
+    check_write_read();
+  }
+
+  SECTION("- Filters with AUTO compressor") {
+    create_array({TILEDB_FILTER_DELTA, TILEDB_FILTER_BYTESHUFFLE}, TILEDB_AUTO);
+    check_write_read();
+  }
+
+  SECTION("- Filters with AUTO compressor on random values") {
+    create_array({TILEDB_FILTER_BYTESHUFFLE}, TILEDB_AUTO);
+    std::mt19937_64 gen(0);
+    std::vector<int64_t> a(1000);
+    for (auto& v : a)
+      v = (int64_t)gen();
+    Query write(ctx, "cpp_unit_filters", TILEDB_WRITE);
+    write.set_layout(TILEDB_ROW_MAJOR);
+    write.set_subarray<int>({1, 1000});
+    write.set_buffer("a", a);
+    REQUIRE(write.submit() == Query::Status::COMPLETE);
+
+    std::vector<int64_t> a_read(1000);
+    Query read(ctx, "cpp_unit_filters", TILEDB_READ);
+    read.set_layout(TILEDB_ROW_MAJOR);
+    read.set_subarray<int>({1, 1000});
+    read.set_buffer("a", a_read);
+    REQUIRE(read.submit() == Query::Status::COMPLETE);
+    CHECK(a_read == a);
+  }
+
+  SECTION("- Bit-width reduction with RLE is rejected") {
+    CHECK_THROWS(
+        create_array({TILEDB_FILTER_BIT_WIDTH_REDUCTION}, TILEDB_RLE));
+  }
+
+  SECTION("- Invalid filter") {
+    auto a = Attribute::create<int>(ctx, "a");
+    CHECK_THROWS(a.add_filter((tiledb_filter_type_t)100));
+    CHECK(a.filters().empty());
+  }
+}
+
+TEST_CASE_METHOD(
+    CPPFiltersFx,
+    "C++ API: Lossy filters",
+    "[cppapi], [filter], [lossy]") {
+  SECTION("- Values are read back within the error bounds") {
+    Domain domain(ctx);
+    domain.add_dimension(Dimension::create<int>(ctx, "d", {{1, 1000}}, 250));
+    auto a = Attribute::create<double>(ctx, "a");
+    a.add_filter(TILEDB_FILTER_QUANTIZE, 1e-3)
+        .add_filter(TILEDB_FILTER_DELTA)
+        .add_filter(TILEDB_FILTER_BIT_WIDTH_REDUCTION)
+        .set_compressor({TILEDB_ZSTD, -1});
+    auto b = Attribute::create<float>(ctx, "b");
+    b.add_filter(TILEDB_FILTER_MANTISSA_TRUNCATION, 1e-2)
+        .add_filter(TILEDB_FILTER_BYTESHUFFLE)
+        .set_compressor({TILEDB_LZ4, -1});
+    ArraySchema schema(ctx, TILEDB_DENSE);
+    schema.set_domain(domain);
+    schema.add_attribute(a).add_attribute(b);
+    Array::create("cpp_unit_filters", schema);
+
+    ArraySchema loaded(ctx, "cpp_unit_filters");
+    REQUIRE(loaded.attribute("a").filters().size() == 3);
+    CHECK(loaded.attribute("a").filters()[0] == TILEDB_FILTER_QUANTIZE);
+    CHECK(loaded.attribute("a").filter_error_bound(0) == 1e-3);
+    CHECK(loaded.attribute("a").filter_error_bound(1) == 0);
+    CHECK(loaded.attribute("b").filter_error_bound(0) == 1e-2);
+
+    std::vector<double> a_data(1000);
+    std::vector<float> b_data(1000);
+    for (int i = 0; i < 1000; ++i) {
+      a_data[i] = 15 + 10 * std::sin(i / 40.0);
+      b_data[i] = (float)(i * 0.37 - 100);
+    }
+    Query write(ctx, "cpp_unit_filters", TILEDB_WRITE);
+    write.set_layout(TILEDB_ROW_MAJOR);
+    write.set_buffer("a", a_data);
+    write.set_buffer("b", b_data);
+    REQUIRE(write.submit() == Query::Status::COMPLETE);
+
+    std::vector<double> a_read(1000);
+    std::vector<float> b_read(1000);
+    Query read(ctx, "cpp_unit_filters", TILEDB_READ);
+    read.set_layout(TILEDB_ROW_MAJOR);
+    read.set_subarray<int>({1, 1000});
+    read.set_buffer("a", a_read);
+    read.set_buffer("b", b_read);
+    REQUIRE(read.submit() == Query::Status::COMPLETE);
+    for (int i = 0; i < 1000; ++i) {
+      CHECK(std::fabs(a_read[i] - a_data[i]) <= 1e-3);
+      CHECK(std::fabs(b_read[i] - b_data[i]) <= 1e-2 * std::fabs(b_data[i]));
+    }
+  }
+
+  SECTION("- Integer attribute is rejected") {
+    Domain domain(ctx);
+    domain.add_dimension(Dimension::create<int>(ctx, "d", {{1, 1000}}, 250));
+    auto a = Attribute::create<int64_t>(ctx, "a");
+    a.add_filter(TILEDB_FILTER_QUANTIZE, 1);
+    ArraySchema schema(ctx, TILEDB_DENSE);
+    schema.set_domain(domain);
+    schema.add_attribute(a);
+    CHECK_THROWS(Array::create("cpp_unit_filters", schema));
+  }
+
+  SECTION("- Quantization with RLE or double delta is rejected") {
+    for (auto compressor : {TILEDB_RLE, TILEDB_DOUBLE_DELTA}) {
+      Domain domain(ctx);
+      domain.add_dimension(
+          Dimension::create<int>(ctx, "d", {{1, 1000}}, 250));
+      auto a = Attribute::create<double>(ctx, "a");
+      a.add_filter(TILEDB_FILTER_QUANTIZE, 1e-3)
+          .set_compressor({compressor, -1});
+      ArraySchema schema(ctx, TILEDB_DENSE);
+      schema.set_domain(domain);
+      schema.add_attribute(a);
+      CHECK_THROWS(Array::create("cpp_unit_filters", schema));
+      CHECK(!vfs.is_dir("cpp_unit_filters"));
+    }
+  }
+
+  SECTION("- Missing error bound is rejected") {
+    auto a = Attribute::create<double>(ctx, "a");
+    CHECK_THROWS(a.add_filter(TILEDB_FILTER_QUANTIZE));
+    CHECK_THROWS(a.add_filter(TILEDB_FILTER_MANTISSA_TRUNCATION, 2));
+    CHECK(a.filters().empty());
+  }
+}
+
+TEST_CASE_METHOD(
+    CPPFiltersFx,
+    "C++ API: Dictionary filter",
+    "[cppapi], [filter], [dictionary]") {
+  SECTION("- Dense array") {
+    Domain domain(ctx);
+    domain.add_dimension(Dimension::create<int>(ctx, "d", {{1, 1000}}, 250));
+    auto a = Attribute::create<int64_t>(ctx, "a");
+    auto b = Attribute::create<std::string>(ctx, "b");
+    b.add_filter(TILEDB_FILTER_DICTIONARY);
+    ArraySchema schema(ctx, TILEDB_DENSE);
+    schema.set_domain(domain);
+    schema.add_attribute(a).add_attribute(b);
+    Array::create("cpp_unit_filters", schema);
+    check_write_read();
+
+    // Partial subarray crossing a tile boundary
+    std::vector<uint64_t> b_off(100);
+    std::string b_read(1000, '\0');
+    Query read(ctx, "cpp_unit_filters", TILEDB_READ);
+    read.set_subarray<int>({201, 300});
+    read.set_buffer("b", b_off, b_read);
+    REQUIRE(read.submit() == Query::Status::COMPLETE);
+    auto sizes = read.result_buffer_elements()["b"];
+    REQUIRE(sizes.first == 100);
+    b_read.resize(sizes.second);
+    std::string expected;
+    for (int i = 200; i < 300; ++i) {
+      CHECK(b_off[i - 200] == expected.size());
+      expected += "cell_" + std::to_string(i % 17);
+    }
+    CHECK(b_read == expected);
+  }
+
+  SECTION("- Sparse array") {
+    Domain domain(ctx);
+    domain.add_dimension(Dimension::create<int>(ctx, "d", {{1, 1000}}, 250));
+    auto b = Attribute::create<std::string>(ctx, "b");
+    b.add_filter(TILEDB_FILTER_DICTIONARY);
+    b.add_filter(TILEDB_FILTER_BYTESHUFFLE);
+    b.set_compressor({TILEDB_ZSTD, -1});
+    ArraySchema schema(ctx, TILEDB_SPARSE);
+    schema.set_domain(domain).set_capacity(100);
+    schema.add_attribute(b);
+    Array::create("cpp_unit_filters", schema);
+
+    std::vector<int> coords;
+    std::vector<uint64_t> b_off;
+    std::string b_data;
+    for (int i = 1; i <= 1000; i += 2) {
+      coords.push_back(i);
+      b_off.push_back(b_data.size());
+      b_data += (i % 3) ? "red" : "a much longer value";
+    }
+    Query write(ctx, "cpp_unit_filters", TILEDB_WRITE);
+    write.set_layout(TILEDB_UNORDERED);
+    write.set_buffer("b", b_off, b_data);
+    write.set_coordinates(coords);
+    REQUIRE(write.submit() == Query::Status::COMPLETE);
+
+    std::vector<uint64_t> b_off_read(500);
+    std::string b_read(b_data.size(), '\0');
+    Query read(ctx, "cpp_unit_filters", TILEDB_READ);
+    read.set_layout(TILEDB_GLOBAL_ORDER);
+    read.set_subarray<int>({1, 1000});
+    read.set_buffer("b", b_off_read, b_read);
+    REQUIRE(read.submit() == Query::Status::COMPLETE);
+    CHECK(b_off_read == b_off);
+    CHECK(b_read == b_data);
+  }
+
+  SECTION("- Fixed-sized attribute is rejected") {
+    CHECK_THROWS(create_array({TILEDB_FILTER_DICTIONARY}, TILEDB_ZSTD));
+  }
+}
@@ -0,0 +1,139 @@
+/**
+ * @file   unit-cppapi-schema.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2017 TileDB Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * Tests the memory budget of the storage manager through the C++ API.
+ */
+
+#include "catch.hpp"
+#include "tiledb/sm/cpp_api/tiledb"
+
+#include <thread>
+
+using namespace tiledb;
+
+struct CPPMemoryBudgetFx {
+  CPPMemoryBudgetFx()
+      : vfs(ctx) {
+    if (vfs.is_dir("cpp_unit_memory_budget"))
+      vfs.remove_dir("cpp_unit_memory_budget");
+
+    Domain domain(ctx);
+    auto d = Dimension::create<int>(ctx, "d", {{1, 1000}}, 100);
+    domain.add_dimension(d);
+    auto a = Attribute::create<int>(ctx, "a");
+    ArraySchema schema(ctx, TILEDB_DENSE);
+    schema.set_domain(domain);
+    schema.add_attribute(a);
+    Array::create("cpp_unit_memory_budget", schema);
+
+    std::vector<int> data(1000, 1);
+    Query query(ctx, "cpp_unit_memory_budget", TILEDB_WRITE);
+    query.set_buffer("a", data);
+    query.set_layout(TILEDB_ROW_MAJOR);
+    REQUIRE(query.submit() == Query::Status::COMPLETE);
+  }
+
+  ~CPPMemoryBudgetFx() {
+    if (vfs.is_dir("cpp_unit_memory_budget"))
+      vfs.remove_dir("cpp_unit_memory_budget");
+  }
+
+  /** Reads `a` in `[1, 1000]` and returns the query status. */
+  static Query::Status read(Query* query, std::vector<int>* a) {
+    query->set_subarray<int>({1, 1000});
+    query->set_buffer("a", *a);
+    query->set_layout(TILEDB_ROW_MAJOR);
+    return query->submit();
+  }
+
+  Context ctx;
+  VFS vfs;
+};
+
+TEST_CASE_METHOD(
+    CPPMemoryBudgetFx, "C++ API: Memory budget", "[cppapi], [memory-budget]") {
+  // The read needs the 4000 bytes of the result, plus one tile of 400 bytes
+  std::vector<int> a(1000);
+
+  SECTION("- Enough budget") {
+    Config config;
+    config["sm.memory_budget"] = "4400";
+    Context budget_ctx(config);
+    Query query(budget_ctx, "cpp_unit_memory_budget", TILEDB_READ);
+    CHECK(read(&query, &a) == Query::Status::COMPLETE);
+    CHECK(a[999] == 1);
+  }
+
+  SECTION("- Query larger than the budget") {
+    Config config;
+    config["sm.memory_budget"] = "4399";
+    Context budget_ctx(config);
+    Query query(budget_ctx, "cpp_unit_memory_budget", TILEDB_READ);
+    CHECK_THROWS(read(&query, &a));
+  }
+
+  SECTION("- Budget held by another query") {
+    Config config;
+    config["sm.memory_budget"] = "8000";
+    Context budget_ctx(config);
+    std::vector<int> b(1000);
+    {
+      Query query_1(budget_ctx, "cpp_unit_memory_budget", TILEDB_READ);
+      CHECK(read(&query_1, &a) == Query::Status::COMPLETE);
+
+      // Fails fast, as the first query has not released its reservation
+      Query query_2(budget_ctx, "cpp_unit_memory_budget", TILEDB_READ);
+      CHECK_THROWS(read(&query_2, &b));
+    }
+
+    // Succeeds once the first query is freed
+    Query query_3(budget_ctx, "cpp_unit_memory_budget", TILEDB_READ);
+    CHECK(read(&query_3, &b) == Query::Status::COMPLETE);
+  }
+
+  SECTION("- Wait for budget") {
+    Config config;
+    config["sm.memory_budget"] = "8000";
+    config["sm.memory_budget_timeout_ms"] = "10000";
+    Context budget_ctx(config);
+    std::unique_ptr<Query> query_1(
+        new Query(budget_ctx, "cpp_unit_memory_budget", TILEDB_READ));
+    CHECK(read(query_1.get(), &a) == Query::Status::COMPLETE);
+
+    // The first query is freed while the second one waits
+    std::thread t([&query_1]() {
+      std::this_thread::sleep_for(std::chrono::milliseconds(100));
+      query_1.reset();
+    });
+    std::vector<int> b(1000);
+    Query query_2(budget_ctx, "cpp_unit_memory_budget", TILEDB_READ);
+    CHECK(read(&query_2, &b) == Query::Status::COMPLETE);
+    t.join();
+  }
+}
@@ -0,0 +1,177 @@
+/**
+ * @file   unit-cppapi-ordered_query.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2018 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * Tests row- and column-major reads and writes through the C++ API, for
+ * various numbers of pipelined tile slabs.
+ */
+
+#include "catch.hpp"
+#include "tiledb/sm/cpp_api/tiledb"
+
+using namespace tiledb;
+
+struct CPPOrderedQueryFx {
+  /** The size of each dimension of the array domain. */
+  const int dim_size = 20;
+
+  /** The name of the array. */
+  const std::string array_name = "cpp_unit_ordered_query";
+
+  Context ctx;
+  VFS vfs;
+
+  CPPOrderedQueryFx()
+      : vfs(ctx) {
+    if (vfs.is_dir(array_name))
+      vfs.remove_dir(array_name);
+  }
+
+  ~CPPOrderedQueryFx() {
+    if (vfs.is_dir(array_name))
+      vfs.remove_dir(array_name);
+  }
+
+  /** The fixed-sized value of the cell at the input coordinates. */
+  static int a_value(int r, int c) {
+    return r * 100 + c;
+  }
+
+  /** The variable-sized value of the cell at the input coordinates. */
+  static std::string b_value(int r, int c) {
+    return std::string((size_t)(r % 3 + 1), (char)('a' + c % 26));
+  }
+
+  /** Creates a dense array whose cell order differs from the tile order. */
+  void create_array() {
+    Domain domain(ctx);
+    domain.add_dimension(
+        Dimension::create<int>(ctx, "d1", {{1, dim_size}}, 4));
+    domain.add_dimension(
+        Dimension::create<int>(ctx, "d2", {{1, dim_size}}, 4));
+    ArraySchema schema(ctx, TILEDB_DENSE);
+    schema.set_domain(domain);
+    schema.set_tile_order(TILEDB_ROW_MAJOR).set_cell_order(TILEDB_COL_MAJOR);
+    schema.add_attribute(Attribute::create<int>(ctx, "a"));
+    schema.add_attribute(Attribute::create<std::string>(ctx, "b"));
+    Array::create(array_name, schema);
+  }
+
+  /** Writes all the cells of the array in row-major order. */
+  void write(const Context& ctx) {
+    std::vector<int> a_data;
+    std::vector<uint64_t> b_off;
+    std::string b_data;
+    for (int r = 1; r <= dim_size; ++r) {
+      for (int c = 1; c <= dim_size; ++c) {
+        a_data.push_back(a_value(r, c));
+        b_off.push_back(b_data.size());
+        b_data += b_value(r, c);
+      }
+    }
+
+    Query query(ctx, array_name, TILEDB_WRITE);
+    query.set_layout(TILEDB_ROW_MAJOR);
+    query.set_subarray<int>({1, dim_size, 1, dim_size});
+    query.set_buffer("a", a_data);
+    query.set_buffer("b", b_off, b_data);
+    REQUIRE(query.submit() == Query::Status::COMPLETE);
+  }
+
+  /**
+   * Reads a subarray in the input layout with small buffers, so that the
+   * query must be resubmitted, and checks the results.
+   */
+  void check_read(const Context& ctx, tiledb_layout_t layout) {
+    const int r_lo = 2, r_hi = 19, c_lo = 3, c_hi = 18;
+
+    // Compute the expected results
+    std::vector<int> a_expected;
+    std::string b_expected;
+    int outer_lo = (layout == TILEDB_ROW_MAJOR) ? r_lo : c_lo;
+    int outer_hi = (layout == TILEDB_ROW_MAJOR) ? r_hi : c_hi;
+    int inner_lo = (layout == TILEDB_ROW_MAJOR) ? c_lo : r_lo;
+    int inner_hi = (layout == TILEDB_ROW_MAJOR) ? c_hi : r_hi;
+    for (int i = outer_lo; i <= outer_hi; ++i) {
+      for (int j = inner_lo; j <= inner_hi; ++j) {
+        int r = (layout == TILEDB_ROW_MAJOR) ? i : j;
+        int c = (layout == TILEDB_ROW_MAJOR) ? j : i;
+        a_expected.push_back(a_value(r, c));
+        b_expected += b_value(r, c);
+      }
+    }
+
+    // Read in batches
+    std::vector<int> a_read(37);
+    std::vector<uint64_t> b_off_read(37);
+    std::string b_data_read(37 * 3, '\0');
+    std::vector<int> a_all;
+    std::string b_all;
+    Query query(ctx, array_name, TILEDB_READ);
+    query.set_layout(layout);
+    query.set_subarray<int>({r_lo, r_hi, c_lo, c_hi});
+    query.set_buffer("a", a_read);
+    query.set_buffer("b", b_off_read, b_data_read);
+    Query::Status status;
+    do {
+      status = query.submit();
+      REQUIRE(status != Query::Status::FAILED);
+      auto elements = query.result_buffer_elements();
+      auto a_num = elements["a"].second;
+      auto b_size = elements["b"].second;
+      a_all.insert(a_all.end(), a_read.begin(), a_read.begin() + a_num);
+      b_all += b_data_read.substr(0, b_size);
+    } while (status == Query::Status::INCOMPLETE);
+
+    CHECK(a_all == a_expected);
+    CHECK(b_all == b_expected);
+  }
+};
+
+TEST_CASE_METHOD(
+    CPPOrderedQueryFx,
+    "C++ API: Test ordered queries with pipelined tile slabs",
+    "[cppapi], [ordered-query]") {
+  for (auto tile_slab_num : {"2", "3", "5"}) {
+    if (vfs.is_dir(array_name))
+      vfs.remove_dir(array_name);
+    create_array();
+
+    Config config;
+    config["sm.tile_slab_num"] = tile_slab_num;
+    Context slab_ctx(config);
+    write(slab_ctx);
+    check_read(slab_ctx, TILEDB_ROW_MAJOR);
+    check_read(slab_ctx, TILEDB_COL_MAJOR);
+  }
+}
+
+TEST_CASE("C++ API: Test invalid number of tile slabs", "[cppapi]") {
+  Config config;
+  CHECK_THROWS(config["sm.tile_slab_num"] = "1");
+}
@@ -0,0 +1,223 @@
+/**
+ * @file   unit-cppapi-parallel_write.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2018 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * Tests writing the attributes of a fragment in parallel through the C++ API.
+ */
+
+#include "catch.hpp"
+#include "tiledb/sm/cpp_api/tiledb"
+#ifdef _WIN32
+#include "tiledb/sm/filesystem/win_filesystem.h"
+namespace fs = tiledb::sm::win;
+#else
+#include "tiledb/sm/filesystem/posix_filesystem.h"
+namespace fs = tiledb::sm::posix;
+#endif
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <random>
+
+using namespace tiledb;
+
+struct CPPParallelWriteFx {
+  /** The number of cells written. */
+  const int cell_num = 10000;
+
+  Context ctx;
+  VFS vfs;
+
+  /** The cell values of the attributes. */
+  std::vector<int64_t> a_data;
+  std::vector<double> b_data;
+  std::vector<uint64_t> c_off;
+  std::string c_data;
+  std::vector<float> d_data;
+
+  CPPParallelWriteFx()
+      : vfs(ctx) {
+    remove_arrays();
+
+    std::mt19937_64 gen(0);
+    for (int i = 0; i < cell_num; ++i) {
+      a_data.push_back((int64_t)(gen() % 1000));
+      b_data.push_back(i * 0.5 + (gen() % 100) / 100.0);
+      c_off.push_back(c_data.size());
+      c_data += "value_" + std::to_string(gen() % 100);
+      d_data.push_back((float)(gen() % 10000));
+    }
+  }
+
+  ~CPPParallelWriteFx() {
+    remove_arrays();
+  }
+
+  void remove_arrays() {
+    for (auto array : {"cpp_unit_parallel_1", "cpp_unit_parallel_4"}) {
+      if (vfs.is_dir(array))
+        vfs.remove_dir(array);
+    }
+  }
+
+  /** Returns a context with the input number of compute threads. */
+  static Context threads_ctx(int threads) {
+    Config config;
+    config["sm.num_compute_threads"] = std::to_string(threads);
+    return Context(config);
+  }
+
+  /** Creates an array with four differently compressed attributes. */
+  void create_array(const std::string& array_name, tiledb_array_type_t type) {
+    Domain domain(ctx);
+    domain.add_dimension(
+        Dimension::create<int>(ctx, "dim", {{1, cell_num}}, 500));
+    auto a = Attribute::create<int64_t>(ctx, "a");
+    a.add_filter(TILEDB_FILTER_DELTA).set_compressor({TILEDB_ZSTD, -1});
+    auto b = Attribute::create<double>(ctx, "b");
+    b.set_compressor({TILEDB_GZIP, -1});
+    auto c = Attribute::create<std::string>(ctx, "c");
+    c.set_compressor({TILEDB_LZ4, -1});
+    auto d = Attribute::create<float>(ctx, "d");
+    ArraySchema schema(ctx, type);
+    schema.set_domain(domain).set_capacity(500);
+    schema.add_attribute(a).add_attribute(b).add_attribute(c).add_attribute(d);
+    Array::create(array_name, schema);
+  }
+
+  /** Writes all the cells to the array in two queries. */
+  void write(
+      const Context& ctx,
+      const std::string& array_name,
+      tiledb_array_type_t type) {
+    std::vector<int> coords(cell_num);
+    for (int i = 0; i < cell_num; ++i)
+      coords[i] = cell_num - i;
+    Query write(ctx, array_name, TILEDB_WRITE);
+    write.set_layout(
+        (type == TILEDB_DENSE) ? TILEDB_GLOBAL_ORDER : TILEDB_UNORDERED);
+    write.set_buffer("a", a_data);
+    write.set_buffer("b", b_data);
+    write.set_buffer("c", c_off, c_data);
+    write.set_buffer("d", d_data);
+    if (type == TILEDB_SPARSE)
+      write.set_coordinates(coords);
+    REQUIRE(write.submit() == Query::Status::COMPLETE);
+  }
+
+  /** Returns the contents of the files of the single fragment of an array. */
+  static std::map<std::string, std::string> fragment_files(
+      const std::string& array_name) {
+    std::vector<std::string> paths;
+    REQUIRE(fs::ls(array_name, &paths).ok());
+    std::vector<std::string> fragments;
+    for (const auto& path : paths) {
+      if (fs::is_dir(path))
+        fragments.push_back(path);
+    }
+    REQUIRE(fragments.size() == 1);
+
+    std::map<std::string, std::string> ret;
+    paths.clear();
+    REQUIRE(fs::ls(fragments[0], &paths).ok());
+    for (const auto& path : paths) {
+      std::ifstream file(path, std::ios::binary);
+      ret[path.substr(path.find_last_of('/') + 1)] = std::string(
+          std::istreambuf_iterator<char>(file),
+          std::istreambuf_iterator<char>());
+    }
+    return ret;
+  }
+
+  /** Reads all the cells of the array and checks them. */
+  void check_read(const std::string& array_name, tiledb_array_type_t type) {
+    std::vector<int64_t> a_read(cell_num);
+    std::vector<double> b_read(cell_num);
+    std::vector<uint64_t> c_off_read(cell_num);
+    std::string c_read(c_data.size(), '\0');
+    std::vector<float> d_read(cell_num);
+    Query read(ctx, array_name, TILEDB_READ);
+    read.set_layout(TILEDB_GLOBAL_ORDER);
+    read.set_subarray<int>({1, cell_num});
+    read.set_buffer("a", a_read);
+    read.set_buffer("b", b_read);
+    read.set_buffer("c", c_off_read, c_read);
+    read.set_buffer("d", d_read);
+    REQUIRE(read.submit() == Query::Status::COMPLETE);
+
+    // The sparse cells are written in reverse order
+    if (type == TILEDB_SPARSE) {
+      std::reverse(a_read.begin(), a_read.end());
+      std::reverse(b_read.begin(), b_read.end());
+      std::reverse(d_read.begin(), d_read.end());
+      std::string c;
+      for (int i = cell_num - 1; i >= 0; --i) {
+        uint64_t end = (i + 1 < cell_num) ? c_off_read[i + 1] : c_read.size();
+        c += c_read.substr(c_off_read[i], end - c_off_read[i]);
+      }
+      c_read = c;
+    }
+    CHECK(a_read == a_data);
+    CHECK(b_read == b_data);
+    CHECK(c_read == c_data);
+    CHECK(d_read == d_data);
+  }
+};
+
+TEST_CASE_METHOD(
+    CPPParallelWriteFx,
+    "C++ API: Test parallel attribute writes",
+    "[cppapi], [parallel-write]") {
+  tiledb_array_type_t type = TILEDB_DENSE;
+  SECTION("- Dense array") {
+    type = TILEDB_DENSE;
+  }
+  SECTION("- Sparse array") {
+    type = TILEDB_SPARSE;
+  }
+
+  create_array("cpp_unit_parallel_1", type);
+  create_array("cpp_unit_parallel_4", type);
+  write(threads_ctx(1), "cpp_unit_parallel_1", type);
+  write(threads_ctx(4), "cpp_unit_parallel_4", type);
+  check_read("cpp_unit_parallel_4", type);
+
+  // The fragments are identical regardless of the number of threads
+  auto files_1 = fragment_files("cpp_unit_parallel_1");
+  auto files_4 = fragment_files("cpp_unit_parallel_4");
+  CHECK(files_1.size() == files_4.size());
+  for (const auto& file : files_1)
+    CHECK(files_4[file.first] == file.second);
+}
+
+TEST_CASE("C++ API: Test invalid number of compute threads", "[cppapi]") {
+  Config config;
+  CHECK_THROWS(config["sm.num_compute_threads"] = "0");
+}
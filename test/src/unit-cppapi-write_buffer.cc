@@ -0,0 +1,222 @@
+/**
+ * @file   unit-cppapi-write_buffer.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2018 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * Tests buffering small unordered sparse writes through the C++ API.
+ */
+
+#include "catch.hpp"
+#include "tiledb/sm/cpp_api/tiledb"
+#ifdef _WIN32
+#include "tiledb/sm/filesystem/win_filesystem.h"
+namespace fs = tiledb::sm::win;
+#else
+#include "tiledb/sm/filesystem/posix_filesystem.h"
+namespace fs = tiledb::sm::posix;
+#endif
+
+#include <chrono>
+#include <thread>
+
+using namespace tiledb;
+
+struct CPPWriteBufferFx {
+  const std::string array_name = "cpp_unit_write_buffer";
+
+  Context ctx;
+  VFS vfs;
+
+  CPPWriteBufferFx()
+      : vfs(ctx) {
+    remove_array();
+
+    Domain domain(ctx);
+    domain.add_dimension(Dimension::create<int>(ctx, "dim", {{1, 1000}}, 100));
+    ArraySchema schema(ctx, TILEDB_SPARSE);
+    schema.set_domain(domain);
+    schema.add_attribute(Attribute::create<int>(ctx, "a"));
+    schema.add_attribute(Attribute::create<std::string>(ctx, "b"));
+    Array::create(array_name, schema);
+  }
+
+  ~CPPWriteBufferFx() {
+    remove_array();
+  }
+
+  void remove_array() {
+    if (vfs.is_dir(array_name))
+      vfs.remove_dir(array_name);
+  }
+
+  /** Returns a context that buffers up to the input number of bytes. */
+  static Context buffer_ctx(uint64_t size, uint64_t flush_ms = 0) {
+    Config config;
+    config["sm.write_buffer_size"] = std::to_string(size);
+    config["sm.write_buffer_flush_ms"] = std::to_string(flush_ms);
+    return Context(config);
+  }
+
+  /**
+   * Writes the cells with the input coordinates in reverse order, with
+   * `a` set to the coordinate plus `value` and `b` to its string.
+   */
+  void write(const Context& ctx, int first, int last, int value) {
+    std::vector<int> coords, a;
+    std::vector<uint64_t> b_off;
+    std::string b;
+    for (int i = last; i >= first; --i) {
+      coords.push_back(i);
+      a.push_back(i + value);
+      b_off.push_back(b.size());
+      b += std::to_string(i + value);
+    }
+    Query query(ctx, array_name, TILEDB_WRITE);
+    query.set_layout(TILEDB_UNORDERED);
+    query.set_buffer("a", a);
+    query.set_buffer("b", b_off, b);
+    query.set_coordinates(coords);
+    REQUIRE(query.submit() == Query::Status::COMPLETE);
+  }
+
+  /** Returns the number of fragments of the array. */
+  uint64_t fragment_num() {
+    std::vector<std::string> paths;
+    REQUIRE(fs::ls(array_name, &paths).ok());
+    uint64_t ret = 0;
+    for (const auto& path : paths)
+      ret += fs::is_dir(path) ? 1 : 0;
+    return ret;
+  }
+
+  /** Checks that the array holds cells 1..last with `a` as written. */
+  void check_read(const Context& ctx, int last, int value) {
+    std::vector<int> coords(2 * last), a(2 * last);
+    std::vector<uint64_t> b_off(2 * last);
+    std::string b(20 * last, '\0');
+    Query query(ctx, array_name, TILEDB_READ);
+    query.set_layout(TILEDB_GLOBAL_ORDER);
+    query.set_subarray<int>({1, 1000});
+    query.set_buffer("a", a);
+    query.set_buffer("b", b_off, b);
+    query.set_coordinates(coords);
+    REQUIRE(query.submit() == Query::Status::COMPLETE);
+
+    auto elements = query.result_buffer_elements();
+    REQUIRE(elements["a"].second == (uint64_t)last);
+    std::string expected_b;
+    for (int i = 0; i < last; ++i) {
+      CHECK(coords[i] == i + 1);
+      CHECK(a[i] == i + 1 + value);
+      expected_b += std::to_string(i + 1 + value);
+    }
+    CHECK(b.substr(0, elements["b"].second) == expected_b);
+  }
+};
+
+TEST_CASE_METHOD(
+    CPPWriteBufferFx,
+    "C++ API: Test write buffer",
+    "[cppapi], [write-buffer]") {
+  SECTION("- Disabled") {
+    auto ctx = buffer_ctx(0);
+    for (int i = 0; i < 5; ++i)
+      write(ctx, 10 * i + 1, 10 * i + 10, 0);
+    CHECK(fragment_num() == 5);
+    check_read(ctx, 50, 0);
+  }
+
+  SECTION("- Flushed upon read") {
+    auto ctx = buffer_ctx(1 << 20);
+    for (int i = 0; i < 5; ++i)
+      write(ctx, 10 * i + 1, 10 * i + 10, 0);
+    CHECK(fragment_num() == 0);
+    check_read(ctx, 50, 0);
+    CHECK(fragment_num() == 1);
+
+    // New writes go to a new fragment
+    write(ctx, 51, 60, 0);
+    check_read(ctx, 60, 0);
+    CHECK(fragment_num() == 2);
+  }
+
+  SECTION("- Flushed when full") {
+    // Each write of 10 cells takes 10 * (4 + 8 + 4) bytes plus 10-20 bytes
+    auto ctx = buffer_ctx(400);
+    for (int i = 0; i < 5; ++i)
+      write(ctx, 10 * i + 1, 10 * i + 10, 0);
+    CHECK(fragment_num() == 2);
+    check_read(ctx, 50, 0);
+    CHECK(fragment_num() == 3);
+  }
+
+  SECTION("- Flushed when old") {
+    auto ctx = buffer_ctx(1 << 20, 50);
+    write(ctx, 1, 10, 0);
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    write(ctx, 11, 20, 0);
+    CHECK(fragment_num() == 1);
+    check_read(ctx, 20, 0);
+  }
+
+  SECTION("- Large writes land after the buffered cells") {
+    auto ctx = buffer_ctx(400);
+    write(ctx, 1, 10, 0);
+    write(ctx, 1, 50, 100);
+    CHECK(fragment_num() == 2);
+    check_read(ctx, 50, 100);
+  }
+
+  SECTION("- Later writes of the same cells win") {
+    auto ctx = buffer_ctx(1 << 20);
+    write(ctx, 1, 20, 0);
+    write(ctx, 11, 20, 100);
+    CHECK(fragment_num() == 1);
+    write(ctx, 1, 10, 100);
+    check_read(ctx, 20, 100);
+    CHECK(fragment_num() == 2);
+  }
+
+  SECTION("- Flushed explicitly") {
+    auto ctx = buffer_ctx(1 << 20);
+    write(ctx, 1, 30, 0);
+    CHECK(fragment_num() == 0);
+    Array::flush_writes(ctx, array_name);
+    CHECK(fragment_num() == 1);
+    check_read(ctx, 30, 0);
+  }
+
+  SECTION("- Flushed when the context is freed") {
+    {
+      auto ctx = buffer_ctx(1 << 20);
+      write(ctx, 1, 30, 0);
+      CHECK(fragment_num() == 0);
+    }
+    CHECK(fragment_num() == 1);
+    check_read(ctx, 30, 0);
+  }
+}
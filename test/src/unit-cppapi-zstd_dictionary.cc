@@ -0,0 +1,217 @@
+/**
+ * @file   unit-cppapi-zstd_dictionary.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2018 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * Tests the zstd dictionaries trained upon writes and consolidation through
+ * the C++ API.
+ */
+
+#include "catch.hpp"
+#include "tiledb/sm/cpp_api/tiledb"
+#ifdef _WIN32
+#include "tiledb/sm/filesystem/win_filesystem.h"
+namespace fs = tiledb::sm::win;
+#else
+#include "tiledb/sm/filesystem/posix_filesystem.h"
+namespace fs = tiledb::sm::posix;
+#endif
+
+#include <random>
+
+using namespace tiledb;
+
+struct CPPZStdDictionaryFx {
+  /** The number of cells written. */
+  const int cell_num = 20000;
+
+  /** The array capacity and tile extent. */
+  const int tile_cell_num = 10;
+
+  Context ctx;
+  VFS vfs;
+
+  /** The cell values of the fixed and var-sized attribute. */
+  std::vector<int64_t> a_data;
+  std::vector<uint64_t> b_off;
+  std::string b_data;
+
+  CPPZStdDictionaryFx()
+      : vfs(ctx) {
+    remove_arrays();
+
+    // JSON-like records with the same keys and varying values
+    static const char* cities[] = {"Boston", "Athens", "Chicago", "Lyon"};
+    std::mt19937_64 gen(0);
+    for (int i = 0; i < cell_num; ++i) {
+      a_data.push_back(1500000000 + i * 60 + (int64_t)(gen() % 60));
+      b_off.push_back(b_data.size());
+      b_data += "{\"id\": " + std::to_string(gen() % 1000000) +
+                ", \"name\": \"user_" + std::to_string(gen() % 5000) +
+                "\", \"city\": \"" + cities[gen() % 4] +
+                "\", \"active\": " + ((gen() % 2) ? "true" : "false") + "}";
+    }
+  }
+
+  ~CPPZStdDictionaryFx() {
+    remove_arrays();
+  }
+
+  void remove_arrays() {
+    for (auto array : {"cpp_unit_zstd_dict", "cpp_unit_zstd_plain"}) {
+      if (vfs.is_dir(array))
+        vfs.remove_dir(array);
+    }
+  }
+
+  /** Returns a context that trains dictionaries of the input size. */
+  static Context dictionary_ctx(uint64_t size) {
+    Config config;
+    config["sm.zstd_dictionary_size"] = std::to_string(size);
+    return Context(config);
+  }
+
+  /** Creates an array with ZSTD compressed attributes `a` and `b`. */
+  void create_array(const std::string& array_name, tiledb_array_type_t type) {
+    Domain domain(ctx);
+    domain.add_dimension(
+        Dimension::create<int>(ctx, "d", {{1, cell_num}}, tile_cell_num));
+    auto a = Attribute::create<int64_t>(ctx, "a");
+    a.set_compressor({TILEDB_ZSTD, -1});
+    auto b = Attribute::create<std::string>(ctx, "b");
+    b.set_compressor({TILEDB_ZSTD, -1});
+    ArraySchema schema(ctx, type);
+    schema.set_domain(domain).set_capacity(tile_cell_num);
+    schema.add_attribute(a).add_attribute(b);
+    Array::create(array_name, schema);
+  }
+
+  /** Writes all the cells to a sparse array. */
+  void write_sparse(const Context& ctx, const std::string& array_name) {
+    std::vector<int> coords(cell_num);
+    for (int i = 0; i < cell_num; ++i)
+      coords[i] = i + 1;
+    Query write(ctx, array_name, TILEDB_WRITE);
+    write.set_layout(TILEDB_UNORDERED);
+    write.set_buffer("a", a_data);
+    write.set_buffer("b", b_off, b_data);
+    write.set_coordinates(coords);
+    REQUIRE(write.submit() == Query::Status::COMPLETE);
+  }
+
+  /** Writes the cells in `[first, last]` to a dense array. */
+  void write_dense(
+      const Context& ctx, const std::string& array_name, int first, int last) {
+    std::vector<int64_t> a(a_data.begin() + first - 1, a_data.begin() + last);
+    std::vector<uint64_t> off;
+    std::string b;
+    for (int i = first - 1; i < last; ++i) {
+      off.push_back(b.size());
+      uint64_t end = (i + 1 < cell_num) ? b_off[i + 1] : b_data.size();
+      b += b_data.substr(b_off[i], end - b_off[i]);
+    }
+    Query write(ctx, array_name, TILEDB_WRITE);
+    write.set_layout(TILEDB_ROW_MAJOR);
+    write.set_subarray<int>({first, last});
+    write.set_buffer("a", a);
+    write.set_buffer("b", off, b);
+    REQUIRE(write.submit() == Query::Status::COMPLETE);
+  }
+
+  /** Reads all the cells of the array and checks them. */
+  void check_read(const std::string& array_name) {
+    std::vector<int64_t> a_read(cell_num);
+    std::vector<uint64_t> b_off_read(cell_num);
+    std::string b_read(b_data.size(), '\0');
+    Query read(ctx, array_name, TILEDB_READ);
+    read.set_layout(TILEDB_GLOBAL_ORDER);
+    read.set_subarray<int>({1, cell_num});
+    read.set_buffer("a", a_read);
+    read.set_buffer("b", b_off_read, b_read);
+    REQUIRE(read.submit() == Query::Status::COMPLETE);
+    CHECK(a_read == a_data);
+    CHECK(b_off_read == b_off);
+    CHECK(b_read == b_data);
+  }
+
+  /** Returns the total size of the files under the input directory. */
+  static uint64_t dir_size(const std::string& dir) {
+    std::vector<std::string> paths;
+    REQUIRE(fs::ls(dir, &paths).ok());
+    uint64_t size = 0;
+    for (const auto& path : paths) {
+      if (fs::is_dir(path)) {
+        size += dir_size(path);
+      } else {
+        uint64_t file_size;
+        REQUIRE(fs::file_size(path, &file_size).ok());
+        size += file_size;
+      }
+    }
+    return size;
+  }
+};
+
+TEST_CASE_METHOD(
+    CPPZStdDictionaryFx,
+    "C++ API: Test zstd dictionaries",
+    "[cppapi], [zstd-dictionary]") {
+  SECTION("- Sparse array") {
+    create_array("cpp_unit_zstd_dict", TILEDB_SPARSE);
+    create_array("cpp_unit_zstd_plain", TILEDB_SPARSE);
+    write_sparse(dictionary_ctx(16384), "cpp_unit_zstd_dict");
+    write_sparse(ctx, "cpp_unit_zstd_plain");
+    check_read("cpp_unit_zstd_dict");
+    check_read("cpp_unit_zstd_plain");
+
+    // The dictionaries more than pay for themselves on small tiles
+    CHECK(
+        dir_size("cpp_unit_zstd_dict") * 8 <
+        dir_size("cpp_unit_zstd_plain") * 7);
+  }
+
+  SECTION("- Dense array with consolidation") {
+    create_array("cpp_unit_zstd_dict", TILEDB_DENSE);
+    auto dictionary_ctx = CPPZStdDictionaryFx::dictionary_ctx(16384);
+    write_dense(ctx, "cpp_unit_zstd_dict", 1, cell_num / 2);
+    write_dense(
+        dictionary_ctx, "cpp_unit_zstd_dict", cell_num / 2 + 1, cell_num);
+    check_read("cpp_unit_zstd_dict");
+    uint64_t size = dir_size("cpp_unit_zstd_dict");
+
+    // The consolidated fragment has dictionaries for all its cells
+    Array::consolidate(dictionary_ctx, "cpp_unit_zstd_dict");
+    check_read("cpp_unit_zstd_dict");
+    CHECK(dir_size("cpp_unit_zstd_dict") < size);
+  }
+
+  SECTION("- Too small dictionaries are not trained") {
+    create_array("cpp_unit_zstd_dict", TILEDB_SPARSE);
+    write_sparse(dictionary_ctx(1), "cpp_unit_zstd_dict");
+    check_read("cpp_unit_zstd_dict");
+  }
+}
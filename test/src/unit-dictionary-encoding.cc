@@ -0,0 +1,166 @@
+/**
+ * @file   unit-dictionary-encoding.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2018 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * Tests the dictionary encoding of var-sized string tiles.
+ */
+
+#include "catch.hpp"
+#include "tiledb/sm/filter/dictionary_encoding.h"
+#include "tiledb/sm/misc/constants.h"
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace tiledb::sm;
+
+/** Dictionary encodes the input cell values into `encoded`. */
+static void encode(const std::vector<std::string>& cells, Buffer* encoded) {
+  std::vector<uint64_t> offsets;
+  std::string values;
+  for (const auto& c : cells) {
+    offsets.push_back(values.size());
+    values += c;
+  }
+
+  Tile tile, tile_var;
+  REQUIRE(tile.init(
+                  Datatype::UINT64,
+                  Compressor::NO_COMPRESSION,
+                  constants::cell_var_offset_size,
+                  0)
+              .ok());
+  REQUIRE(
+      tile_var.init(Datatype::CHAR, Compressor::NO_COMPRESSION, 1, 0).ok());
+  ConstBuffer offsets_buff(
+      offsets.data(), offsets.size() * constants::cell_var_offset_size);
+  ConstBuffer values_buff(values.data(), values.size());
+  REQUIRE(tile.write(&offsets_buff, offsets_buff.size()).ok());
+  REQUIRE(tile_var.write(&values_buff, values_buff.size()).ok());
+  REQUIRE(DictionaryEncoding::encode(&tile, &tile_var, encoded).ok());
+}
+
+/**
+ * Encodes the input cell values, checks that they are decoded back both as
+ * a whole and cell by cell, and returns the size of the encoded tile.
+ */
+static uint64_t check_roundtrip(const std::vector<std::string>& cells) {
+  std::string values;
+  for (const auto& c : cells)
+    values += c;
+
+  Buffer encoded;
+  encode(cells, &encoded);
+
+  // Whole tile
+  Buffer decoded;
+  ConstBuffer input(encoded.data(), encoded.size());
+  REQUIRE(DictionaryEncoding::decode(&input, &decoded).ok());
+  REQUIRE(decoded.size() == values.size());
+  CHECK(std::memcmp(decoded.data(), values.data(), values.size()) == 0);
+
+  // Individual cells
+  DictionaryEncoding encoding;
+  REQUIRE(encoding.init(encoded.data(), encoded.size()).ok());
+  if (encoding.plain()) {
+    REQUIRE(encoding.plain_size() == values.size());
+    CHECK(
+        std::memcmp(encoding.plain_data(), values.data(), values.size()) == 0);
+  } else {
+    REQUIRE(encoding.cell_num() == cells.size());
+    const unsigned char* value;
+    uint64_t size;
+    for (uint64_t i = 0; i < cells.size(); ++i) {
+      REQUIRE(encoding.cell(i, &value, &size).ok());
+      CHECK(std::string((const char*)value, size) == cells[i]);
+    }
+    CHECK(!encoding.cell(cells.size(), &value, &size).ok());
+  }
+
+  return encoded.size();
+}
+
+TEST_CASE("Dictionary encoding: Test roundtrip", "[filter], [dictionary]") {
+  SECTION("- Low cardinality") {
+    std::vector<std::string> cells;
+    for (int i = 0; i < 1000; ++i)
+      cells.push_back("category_" + std::to_string(i % 5));
+    CHECK(check_roundtrip(cells) < 1000 * 10 / 4);
+  }
+
+  SECTION("- Code widths") {
+    // Code widths around word boundaries, including codes spanning words
+    for (int value_num : {1, 2, 3, 7, 8, 9, 255, 256, 257, 5000}) {
+      std::vector<std::string> cells;
+      for (int i = 0; i < 20000; ++i)
+        cells.push_back(std::to_string((i * 7919) % value_num) + "_value");
+      check_roundtrip(cells);
+    }
+  }
+
+  SECTION("- Empty values") {
+    std::vector<std::string> cells;
+    for (int i = 0; i < 300; ++i)
+      cells.push_back((i % 3 == 0) ? "" : "abcdefgh");
+    check_roundtrip(cells);
+    check_roundtrip(std::vector<std::string>(100, ""));
+  }
+
+  SECTION("- High cardinality falls back to the plain form") {
+    std::vector<std::string> cells;
+    uint64_t values_size = 0;
+    for (int i = 0; i < 1000; ++i) {
+      cells.push_back(std::to_string(i * 7919));
+      values_size += cells.back().size();
+    }
+    CHECK(check_roundtrip(cells) == values_size + 1);
+  }
+
+  SECTION("- Empty tile") {
+    CHECK(check_roundtrip({}) == 1);
+  }
+}
+
+TEST_CASE("Dictionary encoding: Test corrupt input", "[filter], [dictionary]") {
+  DictionaryEncoding encoding;
+  CHECK(!encoding.init(nullptr, 0).ok());
+
+  unsigned char form = 7;
+  CHECK(!encoding.init(&form, 1).ok());
+
+  // A dictionary form tile truncated at every possible position
+  std::vector<std::string> cells;
+  for (int i = 0; i < 100; ++i)
+    cells.push_back((i % 2) ? "odd" : "even");
+  Buffer encoded;
+  encode(cells, &encoded);
+  REQUIRE(encoded.size() < 350);
+  for (uint64_t size = 1; size < encoded.size(); ++size)
+    CHECK(!encoding.init(encoded.data(), size).ok());
+}
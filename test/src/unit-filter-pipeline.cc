@@ -0,0 +1,431 @@
+/**
+ * @file   unit-filter-pipeline.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2018 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * Tests the filter pipeline.
+ */
+
+#include "catch.hpp"
+#include "tiledb/sm/array_schema/array_schema.h"
+#include "tiledb/sm/filter/filter_pipeline.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <vector>
+
+using namespace tiledb::sm;
+
+/**
+ * Runs `pipeline` forward and in reverse on `nbytes` bytes of `data`,
+ * checking that the original data are reconstructed. The size of the
+ * filtered data is returned in `filtered_size`.
+ */
+static void check_roundtrip(
+    const FilterPipeline& pipeline,
+    Datatype type,
+    const void* data,
+    uint64_t nbytes,
+    uint64_t* filtered_size = nullptr) {
+  Buffer filtered, unfiltered, scratch;
+
+  // Data already in the output buffer must be preserved
+  uint64_t prefix = 0xdeadbeef;
+  REQUIRE(filtered.write(&prefix, sizeof(prefix)).ok());
+  ConstBuffer input(data, nbytes);
+  REQUIRE(pipeline.run_forward(type, &input, &filtered, &scratch).ok());
+  REQUIRE(filtered.size() >= sizeof(prefix));
+  CHECK(std::memcmp(filtered.data(), &prefix, sizeof(prefix)) == 0);
+  CHECK(
+      filtered.size() - sizeof(prefix) <=
+      nbytes + pipeline.overhead(type, nbytes));
+  if (filtered_size != nullptr)
+    *filtered_size = filtered.size() - sizeof(prefix);
+
+  ConstBuffer filtered_input(
+      filtered.data(sizeof(prefix)), filtered.size() - sizeof(prefix));
+  REQUIRE(pipeline.run_reverse(type, &filtered_input, &unfiltered, &scratch)
+              .ok());
+  REQUIRE(unfiltered.size() == nbytes);
+  CHECK(std::memcmp(unfiltered.data(), data, nbytes) == 0);
+}
+
+/** Returns a pipeline with the input filters. */
+static FilterPipeline make_pipeline(const std::vector<FilterType>& filters) {
+  FilterPipeline pipeline;
+  for (auto f : filters)
+    REQUIRE(pipeline.add_filter(f).ok());
+  return pipeline;
+}
+
+/** All the filter combinations that are tested. */
+static std::vector<std::vector<FilterType>> test_pipelines() {
+  return {{},
+          {FilterType::FILTER_BYTESHUFFLE},
+          {FilterType::FILTER_BITSHUFFLE},
+          {FilterType::FILTER_DELTA},
+          {FilterType::FILTER_BIT_WIDTH_REDUCTION},
+          {FilterType::FILTER_DELTA, FilterType::FILTER_BYTESHUFFLE},
+          {FilterType::FILTER_DELTA,
+           FilterType::FILTER_BIT_WIDTH_REDUCTION,
+           FilterType::FILTER_BITSHUFFLE},
+          {FilterType::FILTER_BYTESHUFFLE,
+           FilterType::FILTER_BITSHUFFLE,
+           FilterType::FILTER_DELTA,
+           FilterType::FILTER_BIT_WIDTH_REDUCTION}};
+}
+
+/** Checks the roundtrip of all test pipelines on values of type T. */
+template <class T>
+static void check_type(Datatype type) {
+  std::mt19937_64 gen(0);
+  std::vector<T> random(1000), sorted(1000), constant(1000, (T)7);
+  for (auto& v : random)
+    v = (T)gen();
+  for (size_t i = 0; i < sorted.size(); ++i)
+    sorted[i] = (T)(i * 3 + (gen() % 3));
+
+  for (const auto& filters : test_pipelines()) {
+    auto pipeline = make_pipeline(filters);
+    for (const auto* values : {&random, &sorted, &constant}) {
+      // Whole values, a number of values that is not a multiple of 8, a
+      // number of bytes that is not a multiple of the value size, and
+      // no values at all
+      check_roundtrip(pipeline, type, values->data(), 1000 * sizeof(T));
+      check_roundtrip(pipeline, type, values->data(), 13 * sizeof(T));
+      check_roundtrip(pipeline, type, values->data(), 13 * sizeof(T) + 1);
+      check_roundtrip(pipeline, type, values->data(), 0);
+    }
+  }
+}
+
+TEST_CASE("Filter pipeline: Test roundtrip", "[filter]") {
+  check_type<int8_t>(Datatype::INT8);
+  check_type<uint8_t>(Datatype::UINT8);
+  check_type<int16_t>(Datatype::INT16);
+  check_type<uint16_t>(Datatype::UINT16);
+  check_type<int32_t>(Datatype::INT32);
+  check_type<uint32_t>(Datatype::UINT32);
+  check_type<int64_t>(Datatype::INT64);
+  check_type<uint64_t>(Datatype::UINT64);
+  check_type<float>(Datatype::FLOAT32);
+  check_type<double>(Datatype::FLOAT64);
+  check_type<char>(Datatype::CHAR);
+}
+
+TEST_CASE("Filter pipeline: Test filter output", "[filter]") {
+  SECTION("- Byte shuffle") {
+    uint16_t data[] = {0x0102, 0x0304, 0x0506};
+    Buffer out, scratch;
+    ConstBuffer in(data, sizeof(data));
+    auto pipeline = make_pipeline({FilterType::FILTER_BYTESHUFFLE});
+    REQUIRE(pipeline.run_forward(Datatype::UINT16, &in, &out, &scratch).ok());
+    unsigned char expected[] = {0x02, 0x04, 0x06, 0x01, 0x03, 0x05};
+    REQUIRE(out.size() == sizeof(expected));
+    CHECK(std::memcmp(out.data(), expected, sizeof(expected)) == 0);
+  }
+
+  SECTION("- Delta") {
+    int32_t data[] = {10, 12, 11, 20};
+    Buffer out, scratch;
+    ConstBuffer in(data, sizeof(data));
+    auto pipeline = make_pipeline({FilterType::FILTER_DELTA});
+    REQUIRE(pipeline.run_forward(Datatype::INT32, &in, &out, &scratch).ok());
+    int32_t expected[] = {10, 2, -1, 9};
+    REQUIRE(out.size() == sizeof(expected));
+    CHECK(std::memcmp(out.data(), expected, sizeof(expected)) == 0);
+  }
+
+  SECTION("- Bit-width reduction") {
+    // 1000 values in [-100, -97] need 2 bits each
+    std::vector<int64_t> data(1000);
+    for (size_t i = 0; i < data.size(); ++i)
+      data[i] = -100 + (int64_t)(i % 4);
+    auto pipeline = make_pipeline({FilterType::FILTER_BIT_WIDTH_REDUCTION});
+    uint64_t filtered_size;
+    check_roundtrip(
+        pipeline,
+        Datatype::INT64,
+        data.data(),
+        data.size() * sizeof(int64_t),
+        &filtered_size);
+    uint64_t window_num = 4;
+    CHECK(
+        filtered_size ==
+        sizeof(uint64_t) + window_num * (sizeof(int64_t) + 1) + 1000 * 2 / 8);
+  }
+
+  SECTION("- Bit-width reduction of full-width values") {
+    uint64_t data[] = {0, UINT64_MAX, 1, UINT64_MAX - 1};
+    auto pipeline = make_pipeline({FilterType::FILTER_BIT_WIDTH_REDUCTION});
+    check_roundtrip(pipeline, Datatype::UINT64, data, sizeof(data));
+    int64_t sdata[] = {INT64_MIN, INT64_MAX, 0, -1};
+    check_roundtrip(pipeline, Datatype::INT64, sdata, sizeof(sdata));
+  }
+}
+
+TEST_CASE("Filter pipeline: Test serialization", "[filter]") {
+  auto pipeline = make_pipeline({FilterType::FILTER_DELTA,
+                                 FilterType::FILTER_BIT_WIDTH_REDUCTION,
+                                 FilterType::FILTER_BYTESHUFFLE});
+  Buffer buff;
+  REQUIRE(pipeline.serialize(&buff).ok());
+
+  FilterPipeline pipeline_2;
+  ConstBuffer cbuff(&buff);
+  REQUIRE(pipeline_2.deserialize(&cbuff).ok());
+  REQUIRE(pipeline_2.filter_num() == 3);
+  CHECK(pipeline_2.filter(0) == FilterType::FILTER_DELTA);
+  CHECK(pipeline_2.filter(1) == FilterType::FILTER_BIT_WIDTH_REDUCTION);
+  CHECK(pipeline_2.filter(2) == FilterType::FILTER_BYTESHUFFLE);
+  CHECK(cbuff.end());
+
+  // Invalid filter types are rejected
+  FilterPipeline pipeline_3;
+  CHECK(!pipeline_3.add_filter((FilterType)100).ok());
+  CHECK(pipeline_3.empty());
+}
+
+TEST_CASE("Filter pipeline: Test array schema versions", "[filter]") {
+  Dimension dim("d", Datatype::INT32);
+  int dim_domain[] = {1, 100};
+  int tile_extent = 10;
+  REQUIRE(dim.set_domain(dim_domain).ok());
+  REQUIRE(dim.set_tile_extent(&tile_extent).ok());
+  Domain domain;
+  REQUIRE(domain.add_dimension(&dim).ok());
+  Attribute attr("a", Datatype::INT32);
+  attr.set_filters(make_pipeline({FilterType::FILTER_DELTA,
+                                  FilterType::FILTER_BYTESHUFFLE}));
+  ArraySchema schema(ArrayType::DENSE);
+  REQUIRE(schema.set_domain(&domain).ok());
+  REQUIRE(schema.add_attribute(&attr).ok());
+  REQUIRE(schema.init().ok());
+
+  Buffer buff;
+  REQUIRE(schema.serialize(&buff).ok());
+  auto version = (int*)buff.data();
+  CHECK(std::equal(version, version + 3, constants::array_schema_version));
+
+  // The filters are kept
+  {
+    ArraySchema schema_2;
+    ConstBuffer cbuff(&buff);
+    REQUIRE(schema_2.deserialize(&cbuff, false).ok());
+    REQUIRE(schema_2.attribute(0)->filters().filter_num() == 2);
+    CHECK(cbuff.end());
+  }
+
+  // Schemas of a newer format version are rejected
+  {
+    int newer[] = {99, 0, 0};
+    std::memcpy(version, newer, sizeof(newer));
+    ArraySchema schema_2;
+    ConstBuffer cbuff(&buff);
+    CHECK(!schema_2.deserialize(&cbuff, false).ok());
+  }
+
+  // Schemas written before filters existed have no filter pipelines
+  {
+    Buffer pipeline;
+    REQUIRE(attr.filters().serialize(&pipeline).ok());
+    int older[] = {1, 3, 0};
+    std::memcpy(version, older, sizeof(older));
+    ArraySchema schema_2;
+    ConstBuffer cbuff(buff.data(), buff.size() - pipeline.size());
+    REQUIRE(schema_2.deserialize(&cbuff, false).ok());
+    CHECK(schema_2.attribute(0)->filters().empty());
+    CHECK(cbuff.end());
+  }
+}
+
+/**
+ * Runs `pipeline` forward and in reverse on `values`, checking that every
+ * value is reconstructed within `error_bound` (relative to the value if
+ * `relative` is *true*), and that non-finite values are kept as they are.
+ */
+template <class T>
+static void check_lossy_roundtrip(
+    const FilterPipeline& pipeline,
+    Datatype type,
+    const std::vector<T>& values,
+    double error_bound,
+    bool relative) {
+  Buffer filtered, unfiltered, scratch;
+  auto nbytes = values.size() * sizeof(T);
+  ConstBuffer input(values.data(), nbytes);
+  REQUIRE(pipeline.run_forward(type, &input, &filtered, &scratch).ok());
+  CHECK(filtered.size() <= nbytes + pipeline.overhead(type, nbytes));
+  ConstBuffer filtered_input(filtered.data(), filtered.size());
+  REQUIRE(pipeline.run_reverse(type, &filtered_input, &unfiltered, &scratch)
+              .ok());
+  REQUIRE(unfiltered.size() == nbytes);
+
+  auto result = (const T*)unfiltered.data();
+  for (size_t i = 0; i < values.size(); ++i) {
+    if (std::isnan(values[i])) {
+      CHECK(std::isnan(result[i]));
+    } else if (std::isinf(values[i])) {
+      CHECK(result[i] == values[i]);
+    } else {
+      auto bound = relative ? error_bound * std::fabs(values[i]) : error_bound;
+      CHECK(std::fabs((double)result[i] - values[i]) <= bound);
+    }
+  }
+}
+
+/** Checks the lossy filters on values of type T. */
+template <class T>
+static void check_lossy_type(Datatype type) {
+  std::mt19937_64 gen(0);
+  std::uniform_real_distribution<T> dist(-1000, 1000);
+  std::vector<T> random(1000), smooth(1000);
+  for (auto& v : random)
+    v = dist(gen);
+  for (size_t i = 0; i < smooth.size(); ++i)
+    smooth[i] = (T)(100 * std::sin(i / 50.0));
+  auto special = smooth;
+  special[10] = std::numeric_limits<T>::quiet_NaN();
+  special[20] = std::numeric_limits<T>::infinity();
+  special[30] = -std::numeric_limits<T>::infinity();
+  special[40] = std::numeric_limits<T>::denorm_min();
+  special[50] = std::numeric_limits<T>::max();
+  special[60] = 0;
+
+  for (double bound : {1e-3, 0.5}) {
+    FilterPipeline quantize;
+    REQUIRE(quantize.add_filter(FilterType::FILTER_QUANTIZE, bound).ok());
+    FilterPipeline quantize_delta;
+    REQUIRE(
+        quantize_delta.add_filter(FilterType::FILTER_QUANTIZE, bound).ok());
+    REQUIRE(quantize_delta.add_filter(FilterType::FILTER_DELTA).ok());
+    REQUIRE(
+        quantize_delta.add_filter(FilterType::FILTER_BIT_WIDTH_REDUCTION).ok());
+    for (const auto* values : {&random, &smooth, &special}) {
+      check_lossy_roundtrip(quantize, type, *values, bound, false);
+      check_lossy_roundtrip(quantize_delta, type, *values, bound, false);
+    }
+  }
+
+  for (double bound : {1e-6, 1e-3, 0.25, 0.9}) {
+    FilterPipeline truncate;
+    REQUIRE(
+        truncate.add_filter(FilterType::FILTER_MANTISSA_TRUNCATION, bound)
+            .ok());
+    for (const auto* values : {&random, &smooth, &special})
+      check_lossy_roundtrip(truncate, type, *values, bound, true);
+  }
+}
+
+TEST_CASE("Filter pipeline: Test lossy filters", "[filter]") {
+  SECTION("- Error bounds") {
+    check_lossy_type<float>(Datatype::FLOAT32);
+    check_lossy_type<double>(Datatype::FLOAT64);
+  }
+
+  SECTION("- Quantized values compress") {
+    std::vector<double> values(1000);
+    for (size_t i = 0; i < values.size(); ++i)
+      values[i] = 20 + std::sin(i / 100.0);
+    FilterPipeline pipeline;
+    REQUIRE(pipeline.add_filter(FilterType::FILTER_QUANTIZE, 1e-3).ok());
+    REQUIRE(pipeline.add_filter(FilterType::FILTER_DELTA).ok());
+    REQUIRE(pipeline.add_filter(FilterType::FILTER_BIT_WIDTH_REDUCTION).ok());
+    Buffer filtered, scratch;
+    ConstBuffer input(values.data(), values.size() * sizeof(double));
+    REQUIRE(
+        pipeline.run_forward(Datatype::FLOAT64, &input, &filtered, &scratch)
+            .ok());
+    CHECK(filtered.size() * 4 < input.size());
+  }
+
+  SECTION("- Mantissa truncation zeroes the dropped bits") {
+    float value = 1.2345678f;
+    FilterPipeline pipeline;
+    REQUIRE(
+        pipeline.add_filter(FilterType::FILTER_MANTISSA_TRUNCATION, 1e-2)
+            .ok());
+    Buffer filtered, scratch;
+    ConstBuffer input(&value, sizeof(value));
+    REQUIRE(
+        pipeline.run_forward(Datatype::FLOAT32, &input, &filtered, &scratch)
+            .ok());
+    uint32_t bits;
+    std::memcpy(&bits, filtered.data(), sizeof(bits));
+    CHECK((bits & ((1u << 17) - 1)) == 0);
+  }
+
+  SECTION("- Invalid error bounds") {
+    FilterPipeline pipeline;
+    CHECK(!pipeline.add_filter(FilterType::FILTER_QUANTIZE).ok());
+    CHECK(!pipeline.add_filter(FilterType::FILTER_QUANTIZE, 0).ok());
+    CHECK(!pipeline.add_filter(FilterType::FILTER_QUANTIZE, -1).ok());
+    CHECK(!pipeline
+               .add_filter(
+                   FilterType::FILTER_QUANTIZE,
+                   std::numeric_limits<double>::infinity())
+               .ok());
+    CHECK(!pipeline.add_filter(FilterType::FILTER_MANTISSA_TRUNCATION, 1).ok());
+    CHECK(pipeline.empty());
+  }
+
+  SECTION("- Integer values are rejected") {
+    int32_t values[] = {1, 2, 3};
+    FilterPipeline pipeline;
+    REQUIRE(pipeline.add_filter(FilterType::FILTER_QUANTIZE, 1).ok());
+    Buffer filtered, scratch;
+    ConstBuffer input(values, sizeof(values));
+    CHECK(!pipeline.run_forward(Datatype::INT32, &input, &filtered, &scratch)
+               .ok());
+  }
+
+  SECTION("- Serialization") {
+    FilterPipeline pipeline;
+    REQUIRE(pipeline.add_filter(FilterType::FILTER_QUANTIZE, 0.125).ok());
+    REQUIRE(pipeline.add_filter(FilterType::FILTER_DELTA).ok());
+    REQUIRE(
+        pipeline.add_filter(FilterType::FILTER_MANTISSA_TRUNCATION, 1e-4)
+            .ok());
+    Buffer buff;
+    REQUIRE(pipeline.serialize(&buff).ok());
+
+    FilterPipeline pipeline_2;
+    ConstBuffer cbuff(&buff);
+    REQUIRE(pipeline_2.deserialize(&cbuff).ok());
+    REQUIRE(pipeline_2.filter_num() == 3);
+    CHECK(pipeline_2.filter(0) == FilterType::FILTER_QUANTIZE);
+    CHECK(pipeline_2.error_bound(0) == 0.125);
+    CHECK(pipeline_2.filter(1) == FilterType::FILTER_DELTA);
+    CHECK(pipeline_2.error_bound(1) == 0);
+    CHECK(pipeline_2.filter(2) == FilterType::FILTER_MANTISSA_TRUNCATION);
+    CHECK(pipeline_2.error_bound(2) == 1e-4);
+    CHECK(cbuff.end());
+  }
+}
@@ -0,0 +1,104 @@
+/**
+ * @file   unit-memory-tracker.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2018 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * Tests the `MemoryTracker` class.
+ */
+
+#include <catch.hpp>
+#include "tiledb/sm/buffer/buffer.h"
+#include "tiledb/sm/misc/memory_tracker.h"
+
+#include <thread>
+
+using namespace tiledb::sm;
+
+TEST_CASE("MemoryTracker: Test hierarchy", "[memory-tracker]") {
+  auto parent = std::make_shared<MemoryTracker>(nullptr);
+  auto child = std::make_shared<MemoryTracker>(parent);
+  CHECK(child->parent() == parent);
+
+  child->record_alloc(100);
+  parent->record_alloc(10);
+  CHECK(child->current() == 100);
+  CHECK(parent->current() == 110);
+
+  child->record_free(60);
+  CHECK(child->current() == 40);
+  CHECK(child->peak() == 100);
+  CHECK(parent->current() == 50);
+  CHECK(parent->peak() == 110);
+
+  // Destroying a tracker releases its memory from the parent
+  child.reset();
+  CHECK(parent->current() == 10);
+  CHECK(parent->peak() == 110);
+}
+
+TEST_CASE("MemoryTracker: Test scoped usage", "[memory-tracker]") {
+  auto tracker = std::make_shared<MemoryTracker>(nullptr);
+  {
+    ScopedMemoryUsage usage(tracker);
+    usage.set(64);
+    CHECK(tracker->current() == 64);
+    usage.set(16);
+    CHECK(tracker->current() == 16);
+  }
+  CHECK(tracker->current() == 0);
+  CHECK(tracker->peak() == 64);
+}
+
+TEST_CASE("MemoryTracker: Test buffer allocations", "[memory-tracker]") {
+  auto tracker = std::make_shared<MemoryTracker>(nullptr);
+  CHECK(MemoryTracker::thread_tracker() == MemoryTracker::global());
+
+  Buffer buff;
+  {
+    ScopedMemoryTracker scoped_tracker(tracker);
+    CHECK(MemoryTracker::thread_tracker() == tracker);
+
+    // Other threads are not affected by the scope
+    std::thread t([]() {
+      CHECK(MemoryTracker::thread_tracker() == MemoryTracker::global());
+    });
+    t.join();
+
+    REQUIRE(buff.realloc(100).ok());
+    CHECK(tracker->current() == 100);
+    REQUIRE(buff.realloc(300).ok());
+    CHECK(tracker->current() == 300);
+  }
+  CHECK(MemoryTracker::thread_tracker() == MemoryTracker::global());
+
+  // The buffer remains attributed to the tracker it was allocated in
+  REQUIRE(buff.realloc(500).ok());
+  CHECK(tracker->current() == 500);
+  buff.clear();
+  CHECK(tracker->current() == 0);
+  CHECK(tracker->peak() == 500);
+}
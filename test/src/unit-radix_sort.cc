@@ -0,0 +1,182 @@
+/**
+ * @file   unit-radix_sort.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2018 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * Tests the parallel radix sort and the sorting of unordered sparse writes.
+ */
+
+#include "catch.hpp"
+#include "tiledb/sm/cpp_api/tiledb"
+#include "tiledb/sm/misc/constants.h"
+#include "tiledb/sm/misc/radix_sort.h"
+#include "tiledb/sm/misc/thread_pool.h"
+#include "tiledb/sm/misc/utils.h"
+
+#include <algorithm>
+#include <random>
+#include <set>
+#include <tuple>
+
+TEST_CASE("Radix sort: Test bit width", "[radix-sort]") {
+  using tiledb::sm::utils::bit_width;
+  CHECK(bit_width(0) == 0);
+  CHECK(bit_width(1) == 1);
+  CHECK(bit_width(255) == 8);
+  CHECK(bit_width(256) == 9);
+  CHECK(bit_width(UINT64_MAX) == 64);
+}
+
+TEST_CASE("Radix sort: Test sort", "[radix-sort]") {
+  using namespace tiledb::sm;
+
+  unsigned key_bits = 64;
+  uint64_t n = 0;
+  SECTION("- Empty") {
+    n = 0;
+  }
+  SECTION("- Small") {
+    n = 1000;
+  }
+  SECTION("- Parallel") {
+    n = 4 * constants::parallel_sort_min_chunk_size + 17;
+  }
+  SECTION("- Parallel, narrow keys") {
+    n = 3 * constants::parallel_sort_min_chunk_size;
+    key_bits = 20;
+  }
+
+  // Many duplicate keys, to check that the sort is stable
+  std::mt19937_64 gen(0);
+  std::vector<uint64_t> keys(n), values(n);
+  uint64_t mask = (key_bits == 64) ? UINT64_MAX : (1ull << key_bits) - 1;
+  for (uint64_t i = 0; i < n; ++i) {
+    keys[i] = (gen() % 2 == 0) ? (gen() & mask) : (gen() % 100);
+    values[i] = i;
+  }
+
+  std::vector<uint64_t> expected(n);
+  for (uint64_t i = 0; i < n; ++i)
+    expected[i] = i;
+  std::stable_sort(
+      expected.begin(), expected.end(), [&keys](uint64_t a, uint64_t b) {
+        return keys[a] < keys[b];
+      });
+  std::vector<uint64_t> expected_keys(n);
+  for (uint64_t i = 0; i < n; ++i)
+    expected_keys[i] = keys[expected[i]];
+
+  for (ThreadPool* tp : {(ThreadPool*)nullptr, new ThreadPool(4)}) {
+    auto sorted_keys = keys;
+    auto sorted_values = values;
+    CHECK(utils::radix_sort(tp, key_bits, &sorted_keys, &sorted_values).ok());
+    CHECK(sorted_keys == expected_keys);
+    CHECK(sorted_values == expected);
+    delete tp;
+  }
+
+  std::vector<uint64_t> too_few(n + 1);
+  CHECK(!utils::radix_sort(nullptr, key_bits, &keys, &too_few).ok());
+}
+
+TEST_CASE(
+    "Radix sort: Test unordered sparse writes", "[cppapi], [radix-sort]") {
+  using namespace tiledb;
+
+  const std::string array_name = "cpp_unit_radix_sort";
+  const int cell_num = 3 * (int)sm::constants::parallel_sort_min_chunk_size;
+  Config config;
+  config["sm.num_compute_threads"] = "4";
+  Context ctx(config);
+  VFS vfs(ctx);
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+
+  tiledb_layout_t cell_order = TILEDB_ROW_MAJOR;
+  SECTION("- Row-major cells") {
+    cell_order = TILEDB_ROW_MAJOR;
+  }
+  SECTION("- Col-major cells") {
+    cell_order = TILEDB_COL_MAJOR;
+  }
+
+  // Negative coordinates in a 2D domain of 20x20 tiles
+  Domain domain(ctx);
+  domain.add_dimension(Dimension::create<int>(ctx, "x", {{-1000, 999}}, 100))
+      .add_dimension(Dimension::create<int>(ctx, "y", {{-1000, 999}}, 100));
+  ArraySchema schema(ctx, TILEDB_SPARSE);
+  schema.set_domain(domain).set_capacity(1000);
+  schema.set_tile_order(TILEDB_ROW_MAJOR).set_cell_order(cell_order);
+  schema.add_attribute(Attribute::create<int>(ctx, "a"));
+  Array::create(array_name, schema);
+
+  // Distinct random coordinates, with the attribute identifying each cell
+  std::mt19937 gen(0);
+  std::set<std::pair<int, int>> cells;
+  std::vector<int> coords, a_data;
+  while ((int)cells.size() < cell_num) {
+    int x = (int)(gen() % 2000) - 1000;
+    int y = (int)(gen() % 2000) - 1000;
+    if (!cells.insert({x, y}).second)
+      continue;
+    coords.push_back(x);
+    coords.push_back(y);
+    a_data.push_back(x * 2000 + y);
+  }
+
+  {
+    Query write(ctx, array_name, TILEDB_WRITE);
+    write.set_layout(TILEDB_UNORDERED);
+    write.set_buffer("a", a_data);
+    write.set_coordinates(coords);
+    REQUIRE(write.submit() == Query::Status::COMPLETE);
+  }
+
+  std::vector<int> coords_read(2 * cell_num), a_read(cell_num);
+  Query read(ctx, array_name, TILEDB_READ);
+  read.set_layout(TILEDB_GLOBAL_ORDER);
+  read.set_subarray<int>({-1000, 999, -1000, 999});
+  read.set_buffer("a", a_read);
+  read.set_coordinates(coords_read);
+  REQUIRE(read.submit() == Query::Status::COMPLETE);
+
+  // The cells must be in global order: by tile id, then by the cell order
+  auto order = [cell_order](int x, int y) {
+    int tile_id = ((x + 1000) / 100) * 20 + (y + 1000) / 100;
+    return (cell_order == TILEDB_ROW_MAJOR) ? std::make_tuple(tile_id, x, y) :
+                                              std::make_tuple(tile_id, y, x);
+  };
+  for (int i = 0; i < cell_num; ++i) {
+    int x = coords_read[2 * i], y = coords_read[2 * i + 1];
+    REQUIRE(a_read[i] == x * 2000 + y);
+    if (i > 0)
+      REQUIRE(order(coords_read[2 * i - 2], coords_read[2 * i - 1]) <
+              order(x, y));
+  }
+
+  vfs.remove_dir(array_name);
+}
@@ -0,0 +1,78 @@
+/**
+ * @file   unit-tile.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2018 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * Tests the splitting and zipping of coordinate tiles.
+ */
+
+#include "catch.hpp"
+#include "tiledb/sm/tile/tile.h"
+
+#include <cstring>
+#include <vector>
+
+using namespace tiledb::sm;
+
+TEST_CASE("Tile: Test splitting and zipping coordinates", "[tile]") {
+  // Coordinates of the numeric type sizes and of an arbitrary size, over
+  // more cells than are transposed at a time
+  uint64_t cell_num = 2500;
+  Buffer scratch;
+  for (uint64_t coord_size : {1, 2, 4, 8, 3}) {
+    for (unsigned int dim_num : {1, 2, 3}) {
+      uint64_t cell_size = coord_size * dim_num;
+      std::vector<char> zipped(cell_num * cell_size);
+      for (uint64_t i = 0; i < zipped.size(); ++i)
+        zipped[i] = (char)(i * 7 + i / 251);
+
+      // The values of each dimension must appear contiguously
+      std::vector<char> split;
+      for (unsigned int j = 0; j < dim_num; ++j) {
+        for (uint64_t i = 0; i < cell_num; ++i) {
+          auto coord = &zipped[i * cell_size + j * coord_size];
+          split.insert(split.end(), coord, coord + coord_size);
+        }
+      }
+
+      auto buffer = new Buffer();
+      REQUIRE(buffer->write(zipped.data(), zipped.size()).ok());
+      Tile tile(
+          Datatype::CHAR,
+          Compressor::NO_COMPRESSION,
+          -1,
+          cell_size,
+          dim_num,
+          buffer,
+          true);
+      REQUIRE(tile.split_coordinates(&scratch).ok());
+      CHECK(std::memcmp(tile.data(), split.data(), split.size()) == 0);
+      REQUIRE(tile.zip_coordinates(&scratch).ok());
+      CHECK(std::memcmp(tile.data(), zipped.data(), zipped.size()) == 0);
+    }
+  }
+}
@@ -35,6 +35,7 @@
 #include "tiledb/sm/buffer/const_buffer.h"
 #include "tiledb/sm/misc/logger.h"
 
+#include <algorithm>
 #include <cassert>
 #include <iostream>
 #include <set>
@@ -61,7 +62,7 @@ ArraySchema::ArraySchema() {
   is_kv_ = false;
   domain_ = nullptr;
   tile_order_ = Layout::ROW_MAJOR;
-  std::memcpy(version_, constants::version, sizeof(version_));
+  std::memcpy(version_, constants::array_schema_version, sizeof(version_));
 }
 
 ArraySchema::ArraySchema(ArrayType array_type)
@@ -78,7 +79,7 @@ ArraySchema::ArraySchema(ArrayType array_type)
   is_kv_ = false;
   domain_ = nullptr;
   tile_order_ = Layout::ROW_MAJOR;
-  std::memcpy(version_, constants::version, sizeof(version_));
+  std::memcpy(version_, constants::array_schema_version, sizeof(version_));
 }
 
 ArraySchema::ArraySchema(const ArraySchema* array_schema) {
@@ -287,10 +288,20 @@ Status ArraySchema::check() const {
     }
   }
 
-  if (!check_double_delta_compressor())
+  if (!check_filters())
     return LOG_STATUS(Status::ArraySchemaError(
-        "Array schema check failed; Double delta compression can be used "
-        "only with integer values"));
+        "Array schema check failed; The bit-width reduction and quantization "
+        "filters cannot be combined with RLE or double delta compression"));
+
+  if (!check_dictionary_filter())
+    return LOG_STATUS(Status::ArraySchemaError(
+        "Array schema check failed; The dictionary filter can be used only "
+        "with variable-sized string attributes"));
+
+  if (!check_lossy_filters())
+    return LOG_STATUS(Status::ArraySchemaError(
+        "Array schema check failed; The quantization and mantissa truncation "
+        "filters can be used only with fixed-sized real attributes"));
 
   if (!check_attribute_dimension_names())
     return LOG_STATUS(
@@ -374,6 +385,15 @@ void ArraySchema::dump(FILE* out) const {
   }
 }
 
+const FilterPipeline* ArraySchema::filters(unsigned int attribute_id) const {
+  assert(attribute_id <= attribute_num_);
+
+  if (attribute_id == attribute_num_)
+    return nullptr;
+
+  return &attributes_[attribute_id]->filters();
+}
+
 bool ArraySchema::is_kv() const {
   return is_kv_;
 }
@@ -395,7 +415,7 @@ Status ArraySchema::get_attribute_ids(
 }
 
 // ===== FORMAT =====
-// version (int[3])
+// version (int[3], see constants::array_schema_version)
 // array_type (char)
 // is_kv (bool)
 // tile_order (char)
@@ -410,9 +430,14 @@ Status ArraySchema::get_attribute_ids(
 //   attribute #1
 //   attribute #2
 //   ...
+// filter pipeline of attribute #1
+// filter pipeline of attribute #2
+// ...
 Status ArraySchema::serialize(Buffer* buff) const {
   // Write version
-  RETURN_NOT_OK(buff->write(constants::version, sizeof(constants::version)));
+  RETURN_NOT_OK(buff->write(
+      constants::array_schema_version,
+      sizeof(constants::array_schema_version)));
 
   // Write array type
   auto array_type = (char)array_type_;
@@ -445,6 +470,10 @@ Status ArraySchema::serialize(Buffer* buff) const {
   for (auto& attr : attributes_)
     RETURN_NOT_OK(attr->serialize(buff));
 
+  // Write filter pipelines
+  for (auto& attr : attributes_)
+    RETURN_NOT_OK(attr->filters().serialize(buff));
+
   return Status::Ok();
 }
 
@@ -503,7 +532,7 @@ Status ArraySchema::add_attribute(const Attribute* attr) {
 }
 
 // ===== FORMAT =====
-// version (int[3])
+// version (int[3], see constants::array_schema_version)
 // array_type (char)
 // is_kv (bool)
 // tile_order (char)
@@ -518,11 +547,22 @@ Status ArraySchema::add_attribute(const Attribute* attr) {
 //   attribute #1
 //   attribute #2
 //   ...
+// filter pipeline of attribute #1
+// filter pipeline of attribute #2
+// ...
 Status ArraySchema::deserialize(ConstBuffer* buff, bool is_kv) {
   is_kv_ = is_kv;
 
   // Load version
   RETURN_NOT_OK(buff->read(version_, sizeof(version_)));
+  if (std::lexicographical_compare(
+          constants::array_schema_version,
+          constants::array_schema_version + 3,
+          version_,
+          version_ + 3))
+    return LOG_STATUS(Status::ArraySchemaError(
+        "Cannot deserialize array schema; The schema was written in a newer "
+        "format version"));
 
   // Load array type
   char array_type;
@@ -566,6 +606,19 @@ Status ArraySchema::deserialize(ConstBuffer* buff, bool is_kv) {
     attributes_.emplace_back(attr);
   }
 
+  // Load filter pipelines (absent in schemas written before filters existed)
+  if (!std::lexicographical_compare(
+          version_,
+          version_ + 3,
+          constants::array_schema_filters_version,
+          constants::array_schema_filters_version + 3)) {
+    for (auto& attr : attributes_) {
+      FilterPipeline filters;
+      RETURN_NOT_OK(filters.deserialize(buff));
+      attr->set_filters(filters);
+    }
+  }
+
   // Initialize the rest of the object members
   RETURN_NOT_OK(init());
 
@@ -723,18 +776,45 @@ bool ArraySchema::check_attribute_dimension_names() const {
   return (names.size() == attribute_num_ + dim_num);
 }
 
-bool ArraySchema::check_double_delta_compressor() const {
-  // Check coordinates
-  if ((domain_->type() == Datatype::FLOAT32 ||
-       domain_->type() == Datatype::FLOAT64) &&
-      coords_compression_ == Compressor::DOUBLE_DELTA)
-    return false;
+bool ArraySchema::check_dictionary_filter() const {
+  for (auto attr : attributes_) {
+    if (!attr->filters().contains(FilterType::FILTER_DICTIONARY))
+      continue;
+    auto type = attr->type();
+    if (!attr->var_size() ||
+        (type != Datatype::CHAR && type != Datatype::STRING_ASCII &&
+         type != Datatype::STRING_UTF8))
+      return false;
+  }
+
+  return true;
+}
+
+bool ArraySchema::check_filters() const {
+  for (auto attr : attributes_) {
+    if (attr->compressor() != Compressor::RLE &&
+        attr->compressor() != Compressor::DOUBLE_DELTA)
+      continue;
+    const auto& filters = attr->filters();
+    for (unsigned int i = 0; i < filters.filter_num(); ++i) {
+      if (filters.filter(i) == FilterType::FILTER_BIT_WIDTH_REDUCTION ||
+          filters.filter(i) == FilterType::FILTER_QUANTIZE)
+        return false;
+    }
+  }
+
+  return true;
+}
 
-  // Check attributes
+bool ArraySchema::check_lossy_filters() const {
   for (auto attr : attributes_) {
-    if ((attr->type() == Datatype::FLOAT32 ||
-         attr->type() == Datatype::FLOAT64) &&
-        attr->compressor() == Compressor::DOUBLE_DELTA)
+    const auto& filters = attr->filters();
+    if (!filters.contains(FilterType::FILTER_QUANTIZE) &&
+        !filters.contains(FilterType::FILTER_MANTISSA_TRUNCATION))
+      continue;
+    auto type = attr->type();
+    if (attr->var_size() ||
+        (type != Datatype::FLOAT32 && type != Datatype::FLOAT64))
       return false;
   }
 
@@ -203,6 +203,12 @@ class ArraySchema {
   /** Dumps the array schema in ASCII format in the selected output. */
   void dump(FILE* out) const;
 
+  /**
+   * Returns the filter pipeline of the attribute with the input id, or
+   * `nullptr` for the coordinates, which are not filtered.
+   */
+  const FilterPipeline* filters(unsigned int attribute_id) const;
+
   /**
    * Gets the ids of the input attributes.
    *
@@ -382,10 +388,25 @@ class ArraySchema {
   bool check_attribute_dimension_names() const;
 
   /**
-   * Returns false if double delta compression is used with real attributes
-   * or coordinates and true otherwise.
+   * Returns false if an attribute that is not a variable-sized string of
+   * single-byte characters (i.e., `CHAR`, `STRING_ASCII` or `STRING_UTF8`)
+   * has the dictionary filter, and true otherwise.
+   */
+  bool check_dictionary_filter() const;
+
+  /**
+   * Returns false if an attribute combines the bit-width reduction or
+   * quantization filter with a compressor that expects whole values of the
+   * attribute type (i.e., RLE or double delta), and true otherwise.
+   */
+  bool check_filters() const;
+
+  /**
+   * Returns false if an attribute that is not a fixed-sized `FLOAT32` or
+   * `FLOAT64` attribute has a lossy filter (quantization or mantissa
+   * truncation), and true otherwise.
    */
-  bool check_double_delta_compressor() const;
+  bool check_lossy_filters() const;
 
   /** Clears all members. Use with caution! */
   void clear();
@@ -63,6 +63,7 @@ Attribute::Attribute(const Attribute* attr) {
   cell_val_num_ = attr->cell_val_num();
   compressor_ = attr->compressor();
   compression_level_ = attr->compression_level();
+  filters_ = attr->filters();
 }
 
 Attribute::~Attribute() = default;
@@ -71,6 +72,14 @@ Attribute::~Attribute() = default;
 /*                API                */
 /* ********************************* */
 
+Status Attribute::add_filter(FilterType type) {
+  return filters_.add_filter(type);
+}
+
+Status Attribute::add_filter(FilterType type, double error_bound) {
+  return filters_.add_filter(type, error_bound);
+}
+
 uint64_t Attribute::cell_size() const {
   if (var_size())
     return constants::var_size;
@@ -132,6 +141,8 @@ void Attribute::dump(FILE* out) const {
   fprintf(out, "- Type: %s\n", type_s);
   fprintf(out, "- Compressor: %s\n", compressor_s);
   fprintf(out, "- Compression level: %d\n", compression_level_);
+  if (!filters_.empty())
+    filters_.dump(out);
 
   if (!var_size())
     fprintf(out, "- Cell val num: %u\n", cell_val_num_);
@@ -139,6 +150,10 @@ void Attribute::dump(FILE* out) const {
     fprintf(out, "- Cell val num: var\n");
 }
 
+const FilterPipeline& Attribute::filters() const {
+  return filters_;
+}
+
 const std::string& Attribute::name() const {
   return name_;
 }
@@ -195,6 +210,10 @@ void Attribute::set_compression_level(int compression_level) {
   compression_level_ = compression_level;
 }
 
+void Attribute::set_filters(const FilterPipeline& filters) {
+  filters_ = filters;
+}
+
 void Attribute::set_name(const std::string& name) {
   name_ = name;
 }
@@ -38,6 +38,8 @@
 #include "tiledb/sm/buffer/buffer.h"
 #include "tiledb/sm/enums/compressor.h"
 #include "tiledb/sm/enums/datatype.h"
+#include "tiledb/sm/enums/filter_type.h"
+#include "tiledb/sm/filter/filter_pipeline.h"
 #include "tiledb/sm/misc/status.h"
 
 namespace tiledb {
@@ -78,6 +80,25 @@ class Attribute {
   /*                 API               */
   /* ********************************* */
 
+  /**
+   * Appends a filter to the attribute filter pipeline. The filters are
+   * applied in the order they are added, before the attribute compressor.
+   *
+   * @param type The filter type.
+   * @return Status
+   */
+  Status add_filter(FilterType type);
+
+  /**
+   * Appends a lossy filter with the input error bound to the attribute
+   * filter pipeline (see `FilterPipeline::add_filter`).
+   *
+   * @param type The filter type.
+   * @param error_bound The error bound of the filter.
+   * @return Status
+   */
+  Status add_filter(FilterType type, double error_bound);
+
   /**
    * Returns the size in bytes of one cell for this attribute. If the attribute
    * is variable-sized, this function returns the size in bytes of an offset.
@@ -104,6 +125,9 @@ class Attribute {
   /** Dumps the attribute contents in ASCII form in the selected output. */
   void dump(FILE* out) const;
 
+  /** Returns the attribute filter pipeline. */
+  const FilterPipeline& filters() const;
+
   /** Returns the attribute name. */
   const std::string& name() const;
 
@@ -133,6 +157,9 @@ class Attribute {
   /** Sets the attribute compression level. */
   void set_compression_level(int compression_level);
 
+  /** Sets the attribute filter pipeline. */
+  void set_filters(const FilterPipeline& filters);
+
   /** Sets the attribute name. */
   void set_name(const std::string& name);
 
@@ -159,6 +186,9 @@ class Attribute {
   /** The attribute compression level. */
   int compression_level_;
 
+  /** The filters applied to the attribute values before compression. */
+  FilterPipeline filters_;
+
   /** The attribute name. */
   std::string name_;
 
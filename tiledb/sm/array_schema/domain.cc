@@ -35,6 +35,7 @@
 #include "tiledb/sm/misc/logger.h"
 
 #include <cassert>
+#include <cmath>
 #include <iostream>
 #include <sstream>
 
@@ -192,8 +193,8 @@ Status Domain::split_subarray_global(
   if (tile_extents != nullptr) {
     if (tile_order_ == Layout::ROW_MAJOR) {
       for (int i = 0; i < (int)dim_num_; ++i) {
-        if ((s[2 * i] - domain[2 * i]) / tile_extents[i] !=
-            (s[2 * i + 1] - domain[2 * i]) / tile_extents[i]) {
+        if ((uint64_t)((s[2 * i] - domain[2 * i]) / tile_extents[i]) !=
+            (uint64_t)((s[2 * i + 1] - domain[2 * i]) / tile_extents[i])) {
           // Not in the same tile - can split
           dim_to_split = i;
           break;
@@ -201,8 +202,8 @@ Status Domain::split_subarray_global(
       }
     } else {
       for (int i = (int)dim_num_ - 1;; --i) {
-        if ((s[2 * i] - domain[2 * i]) / tile_extents[i] !=
-            (s[2 * i + 1] - domain[2 * i]) / tile_extents[i]) {
+        if ((uint64_t)((s[2 * i] - domain[2 * i]) / tile_extents[i]) !=
+            (uint64_t)((s[2 * i + 1] - domain[2 * i]) / tile_extents[i])) {
           // Not in the same tile - can split
           dim_to_split = i;
           break;
@@ -232,10 +233,6 @@ Status Domain::split_subarray_global(
   }
   auto s1 = (T*)(*subarray_1);
   auto s2 = (T*)(*subarray_2);
-  T e = (std::numeric_limits<T>::is_integer) ?
-            1 :
-            std::numeric_limits<T>::epsilon();
-  T tile_diff;
   for (int i = 0; i < (int)dim_num_; ++i) {
     if (i != dim_to_split) {
       s1[2 * i] = s[2 * i];
@@ -243,23 +240,18 @@ Status Domain::split_subarray_global(
       s2[2 * i] = s[2 * i];
       s2[2 * i + 1] = s[2 * i + 1];
     } else {
+      // Split at the tile boundary in the middle of the subarray
+      auto tile_lo =
+          (uint64_t)((s[2 * i] - domain[2 * i]) / tile_extents[i]);
+      auto tile_hi =
+          (uint64_t)((s[2 * i + 1] - domain[2 * i]) / tile_extents[i]);
+      auto tile_mid = tile_lo + (tile_hi - tile_lo) / 2;
+      T boundary = domain[2 * i] + (T)(tile_mid + 1) * tile_extents[i];
       s1[2 * i] = s[2 * i];
-      tile_diff = (s[2 * i + 1] - domain[2 * i]) -
-                  (s[2 * i + 1] - domain[2 * i]) / tile_extents[i];
-      if (type_ == Datatype::FLOAT32 || type_ == Datatype::FLOAT64)
-        s1[2 * i + 1] = floor(
-                            ((s1[2 * i] + ((tile_diff / 2) * tile_extents[i])) -
-                             domain[2 * i]) /
-                            tile_extents[i]) *
-                            tile_extents[i] +
-                        domain[2 * i];
-      else
-        s1[2 * i + 1] = (((s1[2 * i] + ((tile_diff / 2) * tile_extents[i])) -
-                          domain[2 * i]) /
-                         tile_extents[i]) *
-                            tile_extents[i] +
-                        domain[2 * i] - 1;
-      s2[2 * i] = s1[2 * i + 1] + e;
+      s1[2 * i + 1] = (std::numeric_limits<T>::is_integer) ?
+                          boundary - 1 :
+                          (T)std::nextafter(boundary, domain[2 * i]);
+      s2[2 * i] = boundary;
       s2[2 * i + 1] = s[2 * i + 1];
     }
   }
@@ -315,9 +307,6 @@ Status Domain::split_subarray_cell(
   }
   auto s1 = (T*)(*subarray_1);
   auto s2 = (T*)(*subarray_2);
-  T e = (std::numeric_limits<T>::is_integer) ?
-            1 :
-            std::numeric_limits<T>::epsilon();
   for (int i = 0; i < (int)dim_num_; ++i) {
     if (i != dim_to_split) {
       s1[2 * i] = s[2 * i];
@@ -325,9 +314,16 @@ Status Domain::split_subarray_cell(
       s2[2 * i] = s[2 * i];
       s2[2 * i + 1] = s[2 * i + 1];
     } else {
+      // For real domains, the second half starts at the next representable
+      // value, and the middle of two adjacent values is the lower one
+      T mid = s[2 * i] + (s[2 * i + 1] - s[2 * i]) / 2;
+      if (mid == s[2 * i + 1])
+        mid = s[2 * i];
       s1[2 * i] = s[2 * i];
-      s1[2 * i + 1] = s[2 * i] + (s[2 * i + 1] - s[2 * i]) / 2;
-      s2[2 * i] = s1[2 * i + 1] + e;
+      s1[2 * i + 1] = mid;
+      s2[2 * i] = (std::numeric_limits<T>::is_integer) ?
+                      mid + 1 :
+                      (T)std::nextafter(mid, s[2 * i + 1]);
       s2[2 * i + 1] = s[2 * i + 1];
     }
   }
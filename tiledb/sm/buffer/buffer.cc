@@ -31,8 +31,11 @@
  */
 
 #include "tiledb/sm/buffer/buffer.h"
+#include "tiledb/sm/buffer/buffer_pool.h"
 #include "tiledb/sm/buffer/const_buffer.h"
+#include "tiledb/sm/misc/constants.h"
 #include "tiledb/sm/misc/logger.h"
+#include "tiledb/sm/misc/memory_tracker.h"
 
 #include <iostream>
 
@@ -51,6 +54,7 @@ namespace sm {
 
 Buffer::Buffer() {
   alloced_size_ = 0;
+  capacity_ = 0;
   data_ = nullptr;
   size_ = 0;
   offset_ = 0;
@@ -63,6 +67,7 @@ Buffer::Buffer(void* data, uint64_t size, bool owns_data)
     , size_(size) {
   offset_ = 0;
   alloced_size_ = 0;
+  capacity_ = 0;
   owns_data_ = false;
 }
 
@@ -87,8 +92,14 @@ uint64_t Buffer::alloced_size() const {
 }
 
 void Buffer::clear() {
-  if (data_ != nullptr && owns_data_)
-    std::free(data_);
+  if (data_ != nullptr && owns_data_) {
+    if (buffer_pool_ != nullptr)
+      buffer_pool_->release(data_, capacity_);
+    else
+      std::free(data_);
+  }
+  buffer_pool_.reset();
+  untrack();
 
   data_ = nullptr;
   offset_ = 0;
@@ -109,7 +120,11 @@ void* Buffer::data(uint64_t offset) const {
 }
 
 void Buffer::disown_data() {
+  // The new owner frees the data with `std::free`, which is valid also
+  // for the blocks of a buffer pool
   owns_data_ = false;
+  buffer_pool_.reset();
+  untrack();
 }
 
 uint64_t Buffer::free_space() const {
@@ -137,19 +152,41 @@ Status Buffer::realloc(uint64_t nbytes) {
         "Cannot reallocate buffer; Buffer does not own data"));
   }
 
-  if (data_ == nullptr) {
-    data_ = std::malloc(nbytes);
-    if (data_ == nullptr) {
-      return LOG_STATUS(Status::BufferError(
-          "Cannot allocate buffer; Memory allocation failed"));
-    }
-  } else if (nbytes > alloced_size_) {
-    auto new_data = std::realloc(data_, nbytes);
+  if (data_ == nullptr || nbytes > capacity_) {
+    // Large buffers are drawn from the pool of the thread memory tracker
+    if (memory_tracker_ == nullptr)
+      memory_tracker_ = MemoryTracker::thread_tracker();
+    auto buffer_pool = memory_tracker_->buffer_pool();
+    bool pooled = buffer_pool != nullptr && buffer_pool->max_size() > 0 &&
+                  nbytes >= constants::buffer_pool_min_alloc_size;
+
+    uint64_t capacity = nbytes;
+    void* new_data;
+    if (pooled)
+      new_data = buffer_pool->allocate(nbytes, &capacity);
+    else if (buffer_pool_ == nullptr)
+      new_data = std::realloc(data_, nbytes);
+    else
+      new_data = std::malloc(nbytes);
     if (new_data == nullptr) {
       return LOG_STATUS(Status::BufferError(
-          "Cannot reallocate buffer; Memory allocation failed"));
+          (data_ == nullptr) ?
+              "Cannot allocate buffer; Memory allocation failed" :
+              "Cannot reallocate buffer; Memory allocation failed"));
     }
+
+    // Move the data if it was not reallocated in place
+    if (data_ != nullptr && (pooled || buffer_pool_ != nullptr)) {
+      std::memcpy(new_data, data_, capacity_);
+      if (buffer_pool_ != nullptr)
+        buffer_pool_->release(data_, capacity_);
+      else
+        std::free(data_);
+    }
+
     data_ = new_data;
+    buffer_pool_ = pooled ? buffer_pool : nullptr;
+    track(capacity);
   }
 
   alloced_size_ = nbytes;
@@ -237,7 +274,10 @@ Status Buffer::write_with_shift(ConstBuffer* buff, uint64_t offset) {
   uint64_t bytes_left_to_read = buff->nbytes_left_to_read();
   uint64_t bytes_to_copy = std::min(bytes_left_to_write, bytes_left_to_read);
 
-  buff->read_with_shift(static_cast<uint64_t*>(data_), bytes_to_copy, offset);
+  buff->read_with_shift(
+      reinterpret_cast<uint64_t*>(static_cast<char*>(data_) + offset_),
+      bytes_to_copy,
+      offset);
   offset_ += bytes_to_copy;
   size_ = offset_;
 
@@ -247,5 +287,23 @@ Status Buffer::write_with_shift(ConstBuffer* buff, uint64_t offset) {
 /* ****************************** */
 /*          PRIVATE METHODS       */
 /* ****************************** */
+
+void Buffer::track(uint64_t capacity) {
+  if (memory_tracker_ == nullptr)
+    memory_tracker_ = MemoryTracker::thread_tracker();
+
+  if (capacity > capacity_)
+    memory_tracker_->record_alloc(capacity - capacity_);
+  else if (capacity < capacity_)
+    memory_tracker_->record_free(capacity_ - capacity);
+  capacity_ = capacity;
+}
+
+void Buffer::untrack() {
+  if (capacity_ > 0)
+    memory_tracker_->record_free(capacity_);
+  capacity_ = 0;
+}
+
 }  // namespace sm
 }  // namespace tiledb
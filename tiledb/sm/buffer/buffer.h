@@ -34,13 +34,16 @@
 #define TILEDB_BUFFER_H
 
 #include <cinttypes>
+#include <memory>
 
 #include "tiledb/sm/misc/status.h"
 
 namespace tiledb {
 namespace sm {
 
+class BufferPool;
 class ConstBuffer;
+class MemoryTracker;
 
 /** Enables reading from and writing to a buffer. */
 class Buffer {
@@ -212,9 +215,25 @@ class Buffer {
   /** The allocated buffer size. */
   uint64_t alloced_size_;
 
+  /** The pool the buffer data was drawn from (`nullptr` if none). */
+  std::shared_ptr<BufferPool> buffer_pool_;
+
+  /**
+   * The size of the memory block backing `data_`, which is recorded in
+   * `memory_tracker_`. It is `0` if the buffer does not own its data, and
+   * it may exceed `alloced_size_`.
+   */
+  uint64_t capacity_;
+
   /** The buffer data. */
   void* data_;
 
+  /**
+   * The tracker the allocated memory is recorded in. This is the tracker
+   * of the thread that first allocated the buffer.
+   */
+  std::shared_ptr<MemoryTracker> memory_tracker_;
+
   /** The current buffer offset. */
   uint64_t offset_;
 
@@ -226,6 +245,16 @@ class Buffer {
 
   /** Size of the buffer useful data. */
   uint64_t size_;
+
+  /* ********************************* */
+  /*          PRIVATE METHODS          */
+  /* ********************************* */
+
+  /** Records that the buffer data is now backed by `capacity` bytes. */
+  void track(uint64_t capacity);
+
+  /** Records that the buffer data is no longer allocated by this object. */
+  void untrack();
 };
 
 }  // namespace sm
@@ -0,0 +1,119 @@
+/**
+ * @file   buffer_pool.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2018 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file implements class BufferPool.
+ */
+
+#include "tiledb/sm/buffer/buffer_pool.h"
+#include "tiledb/sm/misc/stats.h"
+
+#include <cstdlib>
+
+namespace tiledb {
+namespace sm {
+
+/* ****************************** */
+/*   CONSTRUCTORS & DESTRUCTORS   */
+/* ****************************** */
+
+BufferPool::BufferPool(uint64_t max_size)
+    : cached_size_(0)
+    , max_size_(max_size) {
+}
+
+BufferPool::~BufferPool() {
+  for (auto& it : blocks_) {
+    for (auto block : it.second)
+      std::free(block);
+  }
+}
+
+/* ****************************** */
+/*               API              */
+/* ****************************** */
+
+void* BufferPool::allocate(uint64_t nbytes, uint64_t* size) {
+  *size = size_class(nbytes);
+
+  {
+    std::unique_lock<std::mutex> lck(mtx_);
+    auto it = blocks_.find(*size);
+    if (it != blocks_.end() && !it->second.empty()) {
+      auto block = it->second.back();
+      it->second.pop_back();
+      cached_size_ -= *size;
+      STATS_COUNTER_ADD(buffer_pool_hits, 1);
+      STATS_COUNTER_ADD(buffer_pool_hit_bytes, *size);
+      return block;
+    }
+  }
+
+  STATS_COUNTER_ADD(buffer_pool_misses, 1);
+  STATS_COUNTER_ADD(buffer_pool_miss_bytes, *size);
+  return std::malloc(*size);
+}
+
+uint64_t BufferPool::cached_size() const {
+  std::unique_lock<std::mutex> lck(mtx_);
+  return cached_size_;
+}
+
+uint64_t BufferPool::max_size() const {
+  return max_size_;
+}
+
+void BufferPool::release(void* data, uint64_t size) {
+  {
+    std::unique_lock<std::mutex> lck(mtx_);
+    if (cached_size_ + size <= max_size_) {
+      blocks_[size].push_back(data);
+      cached_size_ += size;
+      return;
+    }
+  }
+
+  std::free(data);
+}
+
+uint64_t BufferPool::size_class(uint64_t nbytes) {
+  if (nbytes <= 4)
+    return nbytes;
+
+  // Find the largest power of two that is not larger than `nbytes`
+  uint64_t pow2 = 1;
+  while (pow2 <= nbytes / 2)
+    pow2 *= 2;
+
+  // Round up to a multiple of a quarter of it
+  uint64_t step = pow2 / 4;
+  return ((nbytes + step - 1) / step) * step;
+}
+
+}  // namespace sm
+}  // namespace tiledb
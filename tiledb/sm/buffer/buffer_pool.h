@@ -0,0 +1,131 @@
+/**
+ * @file   buffer_pool.h
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2018 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file defines class BufferPool.
+ */
+
+#ifndef TILEDB_BUFFER_POOL_H
+#define TILEDB_BUFFER_POOL_H
+
+#include <cinttypes>
+#include <map>
+#include <mutex>
+#include <vector>
+
+namespace tiledb {
+namespace sm {
+
+/**
+ * A cache of freed memory blocks, from which `Buffer` objects draw their
+ * data so that large allocations are recycled across tiles and queries
+ * instead of being returned to the system allocator.
+ *
+ * Blocks are grouped in size classes: a request of `n` bytes is rounded up
+ * to the next multiple of a quarter of the largest power of two that is not
+ * larger than `n`, so that at most 25% of a block is wasted. The blocks are
+ * allocated with `std::malloc`, hence a block may be freed with `std::free`
+ * instead of being released to the pool.
+ */
+class BufferPool {
+ public:
+  /* ********************************* */
+  /*     CONSTRUCTORS & DESTRUCTORS    */
+  /* ********************************* */
+
+  /**
+   * Constructor.
+   *
+   * @param max_size The maximum number of bytes cached in the pool. A pool
+   *     with `max_size == 0` caches nothing.
+   */
+  explicit BufferPool(uint64_t max_size);
+
+  /** Destructor. Frees all cached blocks. */
+  ~BufferPool();
+
+  BufferPool(const BufferPool&) = delete;
+  BufferPool& operator=(const BufferPool&) = delete;
+
+  /* ********************************* */
+  /*                API                */
+  /* ********************************* */
+
+  /**
+   * Returns a block of at least `nbytes` bytes, reusing a cached block of
+   * the same size class if there is one.
+   *
+   * @param nbytes The requested number of bytes.
+   * @param size Set to the actual size of the block.
+   * @return The block, or `nullptr` if the allocation failed.
+   */
+  void* allocate(uint64_t nbytes, uint64_t* size);
+
+  /** Returns the number of bytes currently cached in the pool. */
+  uint64_t cached_size() const;
+
+  /** Returns the maximum number of bytes cached in the pool. */
+  uint64_t max_size() const;
+
+  /**
+   * Returns a block obtained by `allocate` to the pool. The block is freed
+   * if caching it would exceed the maximum pool size.
+   *
+   * @param data The block.
+   * @param size The block size, as returned by `allocate`.
+   */
+  void release(void* data, uint64_t size);
+
+  /**
+   * Returns the size class of a request of `nbytes` bytes, i.e., the size
+   * of the block `allocate` returns for it.
+   */
+  static uint64_t size_class(uint64_t nbytes);
+
+ private:
+  /* ********************************* */
+  /*         PRIVATE ATTRIBUTES        */
+  /* ********************************* */
+
+  /** The cached blocks, indexed by size class. */
+  std::map<uint64_t, std::vector<void*>> blocks_;
+
+  /** The number of bytes currently cached. */
+  uint64_t cached_size_;
+
+  /** The maximum number of bytes cached. */
+  uint64_t max_size_;
+
+  /** Protects the pool state. */
+  mutable std::mutex mtx_;
+};
+
+}  // namespace sm
+}  // namespace tiledb
+
+#endif  // TILEDB_BUFFER_POOL_H
@@ -816,6 +816,32 @@ int tiledb_attribute_set_compressor(
   return TILEDB_OK;
 }
 
+int tiledb_attribute_add_filter(
+    tiledb_ctx_t* ctx, tiledb_attribute_t* attr, tiledb_filter_type_t filter) {
+  if (sanity_check(ctx) == TILEDB_ERR || sanity_check(ctx, attr) == TILEDB_ERR)
+    return TILEDB_ERR;
+  if (save_error(
+          ctx,
+          attr->attr_->add_filter(static_cast<tiledb::sm::FilterType>(filter))))
+    return TILEDB_ERR;
+  return TILEDB_OK;
+}
+
+int tiledb_attribute_add_lossy_filter(
+    tiledb_ctx_t* ctx,
+    tiledb_attribute_t* attr,
+    tiledb_filter_type_t filter,
+    double error_bound) {
+  if (sanity_check(ctx) == TILEDB_ERR || sanity_check(ctx, attr) == TILEDB_ERR)
+    return TILEDB_ERR;
+  if (save_error(
+          ctx,
+          attr->attr_->add_filter(
+              static_cast<tiledb::sm::FilterType>(filter), error_bound)))
+    return TILEDB_ERR;
+  return TILEDB_OK;
+}
+
 int tiledb_attribute_set_cell_val_num(
     tiledb_ctx_t* ctx, tiledb_attribute_t* attr, unsigned int cell_val_num) {
   if (sanity_check(ctx) == TILEDB_ERR || sanity_check(ctx, attr) == TILEDB_ERR)
@@ -855,6 +881,58 @@ int tiledb_attribute_get_compressor(
   return TILEDB_OK;
 }
 
+int tiledb_attribute_get_filter_num(
+    tiledb_ctx_t* ctx,
+    const tiledb_attribute_t* attr,
+    unsigned int* filter_num) {
+  if (sanity_check(ctx) == TILEDB_ERR || sanity_check(ctx, attr) == TILEDB_ERR)
+    return TILEDB_ERR;
+  *filter_num = attr->attr_->filters().filter_num();
+  return TILEDB_OK;
+}
+
+int tiledb_attribute_get_filter(
+    tiledb_ctx_t* ctx,
+    const tiledb_attribute_t* attr,
+    unsigned int index,
+    tiledb_filter_type_t* filter) {
+  if (sanity_check(ctx) == TILEDB_ERR || sanity_check(ctx, attr) == TILEDB_ERR)
+    return TILEDB_ERR;
+  const auto& filters = attr->attr_->filters();
+  if (index >= filters.filter_num()) {
+    std::ostringstream errmsg;
+    errmsg << "Filter " << index << " out of bounds, attribute has "
+           << filters.filter_num() << " filters";
+    auto st = tiledb::sm::Status::AttributeError(errmsg.str());
+    LOG_STATUS(st);
+    save_error(ctx, st);
+    return TILEDB_ERR;
+  }
+  *filter = static_cast<tiledb_filter_type_t>(filters.filter(index));
+  return TILEDB_OK;
+}
+
+int tiledb_attribute_get_filter_error_bound(
+    tiledb_ctx_t* ctx,
+    const tiledb_attribute_t* attr,
+    unsigned int index,
+    double* error_bound) {
+  if (sanity_check(ctx) == TILEDB_ERR || sanity_check(ctx, attr) == TILEDB_ERR)
+    return TILEDB_ERR;
+  const auto& filters = attr->attr_->filters();
+  if (index >= filters.filter_num()) {
+    std::ostringstream errmsg;
+    errmsg << "Filter " << index << " out of bounds, attribute has "
+           << filters.filter_num() << " filters";
+    auto st = tiledb::sm::Status::AttributeError(errmsg.str());
+    LOG_STATUS(st);
+    save_error(ctx, st);
+    return TILEDB_ERR;
+  }
+  *error_bound = filters.error_bound(index);
+  return TILEDB_OK;
+}
+
 int tiledb_attribute_get_cell_val_num(
     tiledb_ctx_t* ctx,
     const tiledb_attribute_t* attr,
@@ -1844,6 +1922,30 @@ int tiledb_array_consolidate(tiledb_ctx_t* ctx, const char* array_uri) {
   return TILEDB_OK;
 }
 
+int tiledb_array_consolidate_metadata(
+    tiledb_ctx_t* ctx, const char* array_uri) {
+  // Sanity checks
+  if (sanity_check(ctx) == TILEDB_ERR)
+    return TILEDB_ERR;
+
+  if (save_error(
+          ctx, ctx->storage_manager_->array_consolidate_metadata(array_uri)))
+    return TILEDB_ERR;
+
+  return TILEDB_OK;
+}
+
+int tiledb_array_flush_writes(tiledb_ctx_t* ctx, const char* array_uri) {
+  // Sanity checks
+  if (sanity_check(ctx) == TILEDB_ERR)
+    return TILEDB_ERR;
+
+  if (save_error(ctx, ctx->storage_manager_->array_flush_writes(array_uri)))
+    return TILEDB_ERR;
+
+  return TILEDB_OK;
+}
+
 int tiledb_array_get_non_empty_domain(
     tiledb_ctx_t* ctx, const char* array_uri, void* domain, int* is_empty) {
   if (sanity_check(ctx) == TILEDB_ERR)
@@ -140,6 +140,25 @@
     TILEDB_COMPRESSOR_ENUM(BZIP2),
     /** Double-delta compressor */
     TILEDB_COMPRESSOR_ENUM(DOUBLE_DELTA),
+    /** Compressor selected per tile from a sample of its data */
+    TILEDB_COMPRESSOR_ENUM(AUTO),
+#endif
+
+#ifdef TILEDB_FILTER_TYPE_ENUM
+    /** Byte shuffle: groups the i-th byte of every value together */
+    TILEDB_FILTER_TYPE_ENUM(FILTER_BYTESHUFFLE),
+    /** Bit shuffle: groups the i-th bit of every value together */
+    TILEDB_FILTER_TYPE_ENUM(FILTER_BITSHUFFLE),
+    /** Delta: replaces every value with its difference from the previous */
+    TILEDB_FILTER_TYPE_ENUM(FILTER_DELTA),
+    /** Bit-width reduction: packs windows of values in fewer bits */
+    TILEDB_FILTER_TYPE_ENUM(FILTER_BIT_WIDTH_REDUCTION),
+    /** Dictionary: stores the distinct var-sized strings of a tile once */
+    TILEDB_FILTER_TYPE_ENUM(FILTER_DICTIONARY),
+    /** Quantization: rounds real values within an absolute error bound */
+    TILEDB_FILTER_TYPE_ENUM(FILTER_QUANTIZE),
+    /** Mantissa truncation: rounds real values within a relative error bound */
+    TILEDB_FILTER_TYPE_ENUM(FILTER_MANTISSA_TRUNCATION),
 #endif
 
 #ifdef TILEDB_QUERY_STATUS_ENUM
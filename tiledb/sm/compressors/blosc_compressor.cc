@@ -50,7 +50,9 @@ Status Blosc::compress(
     return LOG_STATUS(Status::CompressionError(
         "Failed compressing with Blosc; invalid buffer format"));
 
-  // Compress
+  // Compress. Blosc 1.x offers no reusable contexts; the `_ctx` functions
+  // set up a context for every call, but unlike the global one it is not
+  // shared among threads.
   int rc = blosc_compress_ctx(
       level < 0 ? Blosc::default_level() : level,
       1,  // shuffle
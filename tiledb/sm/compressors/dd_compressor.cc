@@ -30,21 +30,163 @@
  * This file implements the double delta compressor class.
  */
 
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define TILEDB_DD_SSE2
+#include <emmintrin.h>
+#endif
+
 #include "tiledb/sm/compressors/dd_compressor.h"
 #include "tiledb/sm/misc/logger.h"
+#include "tiledb/sm/misc/utils.h"
 
 /* ****************************** */
 /*             MACROS             */
 /* ****************************** */
 
-#define ABS(x) ((x) < 0) ? uint64_t(-(x)) : uint64_t(x)
 #define MIN(a, b) ((a) < (b) ? (a) : (b))
-#define MAX(a, b) ((a) > (b) ? (a) : (b))
 
 namespace tiledb {
 namespace sm {
 
-const uint64_t DoubleDelta::OVERHEAD = 17;
+const uint64_t DoubleDelta::OVERHEAD = 25;
+
+const uint64_t DoubleDelta::BLOCK_SIZE = 128;
+
+const uint8_t DoubleDelta::FORMAT_DOUBLE_DELTA = 0x80;
+
+const uint8_t DoubleDelta::FORMAT_XOR = 0x81;
+
+/* ****************************** */
+/*        STATIC FUNCTIONS        */
+/* ****************************** */
+
+/** Returns the number of trailing zero bits of `v`, which must not be 0. */
+static inline unsigned dd_trailing_zeros(uint64_t v) {
+  unsigned bits = 0;
+  for (; (v & 1) == 0; v >>= 1)
+    ++bits;
+  return bits;
+}
+
+/**
+ * Returns the number of 64-bit words of each of the two streams of a block
+ * packing `num` values with `bitsize` bits each.
+ */
+static inline uint64_t dd_stream_words(uint64_t num, unsigned bitsize) {
+  return ((num + 1) / 2 * bitsize + 63) / 64;
+}
+
+/**
+ * Packs `num` values from `in` into the two interleaved word streams of a
+ * block at `out`, after shifting them right by `shift` bits. If `num` is
+ * odd, `in` must be padded with a zero value, and `out` must be zeroed.
+ */
+static void dd_pack(
+    const uint64_t* in,
+    uint64_t num,
+    unsigned shift,
+    unsigned bitsize,
+    uint64_t* out) {
+  if (bitsize == 0)
+    return;
+
+  uint64_t pair_num = (num + 1) / 2;
+  uint64_t bit = 0;
+#ifdef TILEDB_DD_SSE2
+  __m128i shift_v = _mm_cvtsi32_si128((int)shift);
+  for (uint64_t j = 0; j < pair_num; ++j, bit += bitsize) {
+    auto word = (__m128i*)(out + 2 * (bit / 64));
+    auto off = (int)(bit % 64);
+    __m128i v = _mm_srl_epi64(
+        _mm_loadu_si128((const __m128i*)(in + 2 * j)), shift_v);
+    _mm_storeu_si128(
+        word,
+        _mm_or_si128(
+            _mm_loadu_si128(word), _mm_sll_epi64(v, _mm_cvtsi32_si128(off))));
+    if (off + bitsize > 64)
+      _mm_storeu_si128(
+          word + 1, _mm_srl_epi64(v, _mm_cvtsi32_si128(64 - off)));
+  }
+#else
+  for (uint64_t j = 0; j < pair_num; ++j, bit += bitsize) {
+    auto word = out + 2 * (bit / 64);
+    auto off = (unsigned)(bit % 64);
+    for (int l = 0; l < 2; ++l) {
+      uint64_t v = in[2 * j + l] >> shift;
+      word[l] |= v << off;
+      if (off + bitsize > 64)
+        word[2 + l] = v >> (64 - off);
+    }
+  }
+#endif
+}
+
+/**
+ * Unpacks `num` values from the two interleaved word streams of a block at
+ * `in` into `out`, shifting them left by `shift` bits. If `num` is odd, an
+ * extra padding value is written to `out`.
+ */
+static void dd_unpack(
+    const uint64_t* in,
+    uint64_t num,
+    unsigned shift,
+    unsigned bitsize,
+    uint64_t* out) {
+  uint64_t pair_num = (num + 1) / 2;
+  if (bitsize == 0) {
+    std::memset(out, 0, 2 * pair_num * sizeof(uint64_t));
+    return;
+  }
+
+  uint64_t mask = (bitsize == 64) ? std::numeric_limits<uint64_t>::max() :
+                                    ((uint64_t(1) << bitsize) - 1);
+  uint64_t bit = 0;
+#ifdef TILEDB_DD_SSE2
+  __m128i shift_v = _mm_cvtsi32_si128((int)shift);
+  __m128i mask_v = _mm_set1_epi64x((long long)mask);
+  for (uint64_t j = 0; j < pair_num; ++j, bit += bitsize) {
+    auto word = (const __m128i*)(in + 2 * (bit / 64));
+    auto off = (int)(bit % 64);
+    __m128i v = _mm_srl_epi64(_mm_loadu_si128(word), _mm_cvtsi32_si128(off));
+    if (off + bitsize > 64)
+      v = _mm_or_si128(
+          v,
+          _mm_sll_epi64(
+              _mm_loadu_si128(word + 1), _mm_cvtsi32_si128(64 - off)));
+    _mm_storeu_si128(
+        (__m128i*)(out + 2 * j),
+        _mm_sll_epi64(_mm_and_si128(v, mask_v), shift_v));
+  }
+#else
+  for (uint64_t j = 0; j < pair_num; ++j, bit += bitsize) {
+    auto word = in + 2 * (bit / 64);
+    auto off = (unsigned)(bit % 64);
+    for (int l = 0; l < 2; ++l) {
+      uint64_t v = word[l] >> off;
+      if (off + bitsize > 64)
+        v |= word[2 + l] << (64 - off);
+      out[2 * j + l] = (v & mask) << shift;
+    }
+  }
+#endif
+}
+
+/** Zigzag encodes a two's complement value `v` of the width of `T`. */
+template <class T>
+static inline uint64_t dd_zigzag(T v) {
+  return (T)((T)(v << 1) ^ (T)(0 - (v >> (8 * sizeof(T) - 1))));
+}
+
+/** Decodes a zigzag encoded value `v` of the width of `T`. */
+template <class T>
+static inline T dd_unzigzag(T v) {
+  return (T)((T)(v >> 1) ^ (T)(0 - (v & 1)));
+}
 
 /* ****************************** */
 /*               API              */
@@ -54,23 +196,8 @@ Status DoubleDelta::compress(
     Datatype type, ConstBuffer* input_buffer, Buffer* output_buffer) {
   switch (type) {
     case Datatype::INT8:
-      return DoubleDelta::compress<int8_t>(input_buffer, output_buffer);
     case Datatype::UINT8:
-      return DoubleDelta::compress<uint8_t>(input_buffer, output_buffer);
-    case Datatype::INT16:
-      return DoubleDelta::compress<int16_t>(input_buffer, output_buffer);
-    case Datatype::UINT16:
-      return DoubleDelta::compress<uint16_t>(input_buffer, output_buffer);
-    case Datatype::INT32:
-      return DoubleDelta::compress<int>(input_buffer, output_buffer);
-    case Datatype::UINT32:
-      return DoubleDelta::compress<uint32_t>(input_buffer, output_buffer);
-    case Datatype::INT64:
-      return DoubleDelta::compress<int64_t>(input_buffer, output_buffer);
-    case Datatype::UINT64:
-      return DoubleDelta::compress<uint64_t>(input_buffer, output_buffer);
     case Datatype::CHAR:
-      return DoubleDelta::compress<char>(input_buffer, output_buffer);
     case Datatype::STRING_ASCII:
     case Datatype::STRING_UTF8:
     case Datatype::STRING_UTF16:
@@ -78,12 +205,26 @@ Status DoubleDelta::compress(
     case Datatype::STRING_UCS2:
     case Datatype::STRING_UCS4:
     case Datatype::ANY:
-      return DoubleDelta::compress<uint8_t>(input_buffer, output_buffer);
+      return DoubleDelta::compress<uint8_t>(
+          FORMAT_DOUBLE_DELTA, input_buffer, output_buffer);
+    case Datatype::INT16:
+    case Datatype::UINT16:
+      return DoubleDelta::compress<uint16_t>(
+          FORMAT_DOUBLE_DELTA, input_buffer, output_buffer);
+    case Datatype::INT32:
+    case Datatype::UINT32:
+      return DoubleDelta::compress<uint32_t>(
+          FORMAT_DOUBLE_DELTA, input_buffer, output_buffer);
+    case Datatype::INT64:
+    case Datatype::UINT64:
+      return DoubleDelta::compress<uint64_t>(
+          FORMAT_DOUBLE_DELTA, input_buffer, output_buffer);
     case Datatype::FLOAT32:
+      return DoubleDelta::compress<uint32_t>(
+          FORMAT_XOR, input_buffer, output_buffer);
     case Datatype::FLOAT64:
-      return LOG_STATUS(
-          Status::TileIOError("Cannot compress tile with DoubleDelta; Float "
-                              "datatypes are not supported"));
+      return DoubleDelta::compress<uint64_t>(
+          FORMAT_XOR, input_buffer, output_buffer);
   }
 
   assert(false);
@@ -93,25 +234,55 @@ Status DoubleDelta::compress(
 
 Status DoubleDelta::decompress(
     Datatype type, ConstBuffer* input_buffer, Buffer* output_buffer) {
+  // Earlier versions start with a bitsize instead of a format tag
+  bool legacy = input_buffer->nbytes_left_to_read() > 0 &&
+                input_buffer->value<uint8_t>() < FORMAT_DOUBLE_DELTA;
+
   switch (type) {
     case Datatype::INT8:
-      return DoubleDelta::decompress<int8_t>(input_buffer, output_buffer);
+      if (legacy)
+        return DoubleDelta::decompress_legacy<int8_t>(
+            input_buffer, output_buffer);
+      return DoubleDelta::decompress<uint8_t>(input_buffer, output_buffer);
     case Datatype::UINT8:
+      if (legacy)
+        return DoubleDelta::decompress_legacy<uint8_t>(
+            input_buffer, output_buffer);
       return DoubleDelta::decompress<uint8_t>(input_buffer, output_buffer);
     case Datatype::INT16:
-      return DoubleDelta::decompress<int16_t>(input_buffer, output_buffer);
+      if (legacy)
+        return DoubleDelta::decompress_legacy<int16_t>(
+            input_buffer, output_buffer);
+      return DoubleDelta::decompress<uint16_t>(input_buffer, output_buffer);
     case Datatype::UINT16:
+      if (legacy)
+        return DoubleDelta::decompress_legacy<uint16_t>(
+            input_buffer, output_buffer);
       return DoubleDelta::decompress<uint16_t>(input_buffer, output_buffer);
     case Datatype::INT32:
-      return DoubleDelta::decompress<int>(input_buffer, output_buffer);
+      if (legacy)
+        return DoubleDelta::decompress_legacy<int>(input_buffer, output_buffer);
+      return DoubleDelta::decompress<uint32_t>(input_buffer, output_buffer);
     case Datatype::UINT32:
+      if (legacy)
+        return DoubleDelta::decompress_legacy<uint32_t>(
+            input_buffer, output_buffer);
       return DoubleDelta::decompress<uint32_t>(input_buffer, output_buffer);
     case Datatype::INT64:
-      return DoubleDelta::decompress<int64_t>(input_buffer, output_buffer);
+      if (legacy)
+        return DoubleDelta::decompress_legacy<int64_t>(
+            input_buffer, output_buffer);
+      return DoubleDelta::decompress<uint64_t>(input_buffer, output_buffer);
     case Datatype::UINT64:
+      if (legacy)
+        return DoubleDelta::decompress_legacy<uint64_t>(
+            input_buffer, output_buffer);
       return DoubleDelta::decompress<uint64_t>(input_buffer, output_buffer);
     case Datatype::CHAR:
-      return DoubleDelta::decompress<char>(input_buffer, output_buffer);
+      if (legacy)
+        return DoubleDelta::decompress_legacy<char>(
+            input_buffer, output_buffer);
+      return DoubleDelta::decompress<uint8_t>(input_buffer, output_buffer);
     case Datatype::STRING_ASCII:
     case Datatype::STRING_UTF8:
     case Datatype::STRING_UTF16:
@@ -119,23 +290,27 @@ Status DoubleDelta::decompress(
     case Datatype::STRING_UCS2:
     case Datatype::STRING_UCS4:
     case Datatype::ANY:
+      if (legacy)
+        return DoubleDelta::decompress_legacy<uint8_t>(
+            input_buffer, output_buffer);
       return DoubleDelta::decompress<uint8_t>(input_buffer, output_buffer);
     case Datatype::FLOAT32:
+      if (legacy)
+        break;
+      return DoubleDelta::decompress<uint32_t>(input_buffer, output_buffer);
     case Datatype::FLOAT64:
-      return LOG_STATUS(
-          Status::TileIOError("Cannot decompress tile with DoubleDelta; Float "
-                              "datatypes are not supported"));
+      if (legacy)
+        break;
+      return DoubleDelta::decompress<uint64_t>(input_buffer, output_buffer);
   }
 
-  assert(false);
-  return LOG_STATUS(Status::TileIOError(
+  return LOG_STATUS(Status::CompressionError(
       "Cannot decompress tile with DoubleDelta; Not supported datatype"));
 }
 
 uint64_t DoubleDelta::overhead(uint64_t nbytes) {
-  // DoubleDelta has a fixed size overhead
-  (void)nbytes;
-  return DoubleDelta::OVERHEAD;
+  // Besides a constant overhead, each block adds its shift and bitsize
+  return DoubleDelta::OVERHEAD + 2 * (nbytes / BLOCK_SIZE + 1);
 }
 
 /* ****************************** */
@@ -143,94 +318,147 @@ uint64_t DoubleDelta::overhead(uint64_t nbytes) {
 /* ****************************** */
 
 template <class T>
-Status DoubleDelta::compress(ConstBuffer* input_buffer, Buffer* output_buffer) {
-  // Calculate number of values and handle trivial case
+Status DoubleDelta::compress(
+    uint8_t format, ConstBuffer* input_buffer, Buffer* output_buffer) {
+  // Sanity check
   uint64_t value_size = sizeof(T);
+  if (input_buffer->size() % value_size != 0)
+    return LOG_STATUS(Status::CompressionError(
+        "Cannot compress with DoubleDelta; Invalid input buffer format"));
   uint64_t num = input_buffer->size() / value_size;
-  assert(num > 0 && (input_buffer->size() % value_size == 0));
-
-  // Calculate bitsize (ignoring the sign bit)
-  auto in = (T*)input_buffer->data();
-  unsigned int bitsize;
-  RETURN_NOT_OK(compute_bitsize(in, num, &bitsize));
-  assert(bitsize <= std::numeric_limits<uint8_t>::max());
-  auto bitsize_c = static_cast<uint8_t>(bitsize);
-
-  // Write bitsize and number of values
-  RETURN_NOT_OK(output_buffer->write(&bitsize_c, sizeof(uint8_t)));
-  RETURN_NOT_OK(output_buffer->write(&num, sizeof(uint64_t)));
-
-  // Trivial case - no compression
-  if (bitsize >= sizeof(T) * 8 - 1) {
-    RETURN_NOT_OK(output_buffer->write(in, input_buffer->size()));
-    return Status::Ok();
-  }
-
-  // Write first value
-  RETURN_NOT_OK(output_buffer->write(&in[0], value_size));
-  if (num == 1)
-    return Status::Ok();
-
-  // Write second value
-  RETURN_NOT_OK(output_buffer->write(&in[1], value_size));
-  if (num == 2)
-    return Status::Ok();
-
-  // Write double deltas
-  int64_t prev_delta = int64_t(in[1]) - int64_t(in[0]);
-  int bit_in_chunk = 63;  // Leftmost bit (MSB)
-  uint64_t chunk = 0;
-  for (uint64_t i = 2; i < num; ++i) {
-    int64_t cur_delta = int64_t(in[i]) - int64_t(in[i - 1]);
-    int64_t dd = cur_delta - prev_delta;
-    RETURN_NOT_OK(
-        write_double_delta(output_buffer, dd, bitsize, &chunk, &bit_in_chunk));
-    prev_delta = cur_delta;
+  auto in = (const T*)input_buffer->data();
+  bool xor_format = (format == FORMAT_XOR);
+
+  // The first value (and the second for double deltas) is stored as is
+  uint64_t head_num = std::min<uint64_t>(xor_format ? 1 : 2, num);
+  uint64_t block_num = (num - head_num + BLOCK_SIZE - 1) / BLOCK_SIZE;
+
+  // Reserve the worst case output size, in which each block packs values of
+  // the full width of T
+  uint64_t offset = output_buffer->offset();
+  uint64_t max_size = offset + sizeof(uint8_t) + sizeof(uint64_t) +
+                      num * value_size + 2 * block_num + 16;
+  if (output_buffer->data() == nullptr ||
+      output_buffer->alloced_size() < max_size)
+    RETURN_NOT_OK(output_buffer->realloc(max_size));
+  auto out_start = (unsigned char*)output_buffer->data(offset);
+  auto out = out_start;
+
+  // Write format, number of values and the values stored as is
+  *(out++) = format;
+  std::memcpy(out, &num, sizeof(uint64_t));
+  out += sizeof(uint64_t);
+  std::memcpy(out, in, head_num * value_size);
+  out += head_num * value_size;
+
+  // Write blocks
+  uint64_t values[BLOCK_SIZE];
+  uint64_t words[BLOCK_SIZE];
+  T prev = (head_num > 0) ? in[head_num - 1] : T(0);
+  T prev_delta = (head_num > 1) ? T(in[1] - in[0]) : T(0);
+  for (uint64_t i = head_num; i < num; i += BLOCK_SIZE) {
+    // Compute the values to pack
+    uint64_t block_values = std::min(BLOCK_SIZE, num - i);
+    uint64_t all = 0;
+    for (uint64_t j = 0; j < block_values; ++j) {
+      T cur = in[i + j];
+      if (xor_format) {
+        values[j] = (T)(cur ^ prev);
+      } else {
+        T delta = T(cur - prev);
+        values[j] = dd_zigzag<T>(T(delta - prev_delta));
+        prev_delta = delta;
+      }
+      all |= values[j];
+      prev = cur;
+    }
+    if (block_values % 2 != 0)
+      values[block_values] = 0;
+
+    // Write block header and packed values
+    unsigned shift = (all == 0) ? 0 : dd_trailing_zeros(all);
+    unsigned bitsize = utils::bit_width(all >> shift);
+    *(out++) = (uint8_t)shift;
+    *(out++) = (uint8_t)bitsize;
+    uint64_t word_num = 2 * dd_stream_words(block_values, bitsize);
+    std::memset(words, 0, word_num * sizeof(uint64_t));
+    dd_pack(values, block_values, shift, bitsize, words);
+    std::memcpy(out, words, word_num * sizeof(uint64_t));
+    out += word_num * sizeof(uint64_t);
   }
 
-  // Write whatever is left in the chunk
-  if (bit_in_chunk < 63)
-    RETURN_NOT_OK(output_buffer->write(&chunk, sizeof(uint64_t)));
+  output_buffer->advance_offset(out - out_start);
+  output_buffer->set_size(output_buffer->offset());
 
   return Status::Ok();
 }
 
 template <class T>
-Status DoubleDelta::compute_bitsize(
-    T* in, uint64_t num, unsigned int* bitsize) {
-  // Find maximum absolute double delta
-  *bitsize = 0;
-  int64_t max = 0;
-  if (num <= 2) {
-    *bitsize = 0;
-    return Status::Ok();
-  }
-  int64_t prev_delta = int64_t(in[1]) - int64_t(in[0]);
-  char delta_out_of_bounds = 0;
-  for (uint64_t i = 2; i < num; ++i) {
-    int64_t cur_delta = int64_t(in[i]) - int64_t(in[i - 1]);
-    int64_t dd = cur_delta - prev_delta;
-    delta_out_of_bounds |= (char)(cur_delta < 0 && prev_delta > 0 && dd > 0);
-    delta_out_of_bounds |= (char)(cur_delta > 0 && prev_delta < 0 && dd < 0);
-    max = MAX(std::abs(dd), max);
-    prev_delta = cur_delta;
-  }
-  // Handle error
-  if (delta_out_of_bounds) {
-    return LOG_STATUS(
-        Status::CompressionError("Cannot compress with DoubleDelta; Some "
-                                 "negative double delta is out of bounds"));
+Status DoubleDelta::decompress(
+    ConstBuffer* input_buffer, Buffer* output_buffer) {
+  // Read format and number of values
+  uint8_t format = 0;
+  uint64_t num = 0;
+  uint64_t value_size = sizeof(T);
+  RETURN_NOT_OK(input_buffer->read(&format, sizeof(uint8_t)));
+  RETURN_NOT_OK(input_buffer->read(&num, sizeof(uint64_t)));
+  if (format != FORMAT_DOUBLE_DELTA && format != FORMAT_XOR)
+    return LOG_STATUS(Status::CompressionError(
+        "Cannot decompress with DoubleDelta; Unknown format"));
+  bool xor_format = (format == FORMAT_XOR);
+
+  // Size the output once
+  uint64_t offset = output_buffer->offset();
+  uint64_t size = offset + num * value_size;
+  if (output_buffer->data() == nullptr || output_buffer->alloced_size() < size)
+    RETURN_NOT_OK(output_buffer->realloc(size));
+  auto out = (T*)output_buffer->data(offset);
+
+  // Read the values stored as is
+  uint64_t head_num = std::min<uint64_t>(xor_format ? 1 : 2, num);
+  RETURN_NOT_OK(input_buffer->read(out, head_num * value_size));
+
+  // Read blocks
+  uint64_t values[BLOCK_SIZE];
+  uint64_t words[BLOCK_SIZE];
+  T prev = (head_num > 0) ? out[head_num - 1] : T(0);
+  T prev_delta = (head_num > 1) ? T(out[1] - out[0]) : T(0);
+  for (uint64_t i = head_num; i < num; i += BLOCK_SIZE) {
+    // Read block header and packed values
+    uint8_t shift = 0, bitsize = 0;
+    RETURN_NOT_OK(input_buffer->read(&shift, sizeof(uint8_t)));
+    RETURN_NOT_OK(input_buffer->read(&bitsize, sizeof(uint8_t)));
+    if (shift >= 8 * value_size || shift + bitsize > 8 * value_size)
+      return LOG_STATUS(Status::CompressionError(
+          "Cannot decompress with DoubleDelta; Invalid block bitsize"));
+    uint64_t block_values = std::min(BLOCK_SIZE, num - i);
+    uint64_t word_num = 2 * dd_stream_words(block_values, bitsize);
+    RETURN_NOT_OK(input_buffer->read(words, word_num * sizeof(uint64_t)));
+    dd_unpack(words, block_values, shift, bitsize, values);
+
+    // Reconstruct the values
+    for (uint64_t j = 0; j < block_values; ++j) {
+      T cur;
+      if (xor_format) {
+        cur = T(prev ^ (T)values[j]);
+      } else {
+        T delta = T(prev_delta + dd_unzigzag<T>((T)values[j]));
+        cur = T(prev + delta);
+        prev_delta = delta;
+      }
+      out[i + j] = cur;
+      prev = cur;
+    }
   }
-  // Calculate bitsize of the maximum absolute double delta
-  do {
-    ++(*bitsize);
-    max >>= 1;
-  } while (max);
+
+  output_buffer->advance_offset(num * value_size);
+  output_buffer->set_size(output_buffer->offset());
+
   return Status::Ok();
 }
 
 template <class T>
-Status DoubleDelta::decompress(
+Status DoubleDelta::decompress_legacy(
     ConstBuffer* input_buffer, Buffer* output_buffer) {
   // Read bitsize and number of values
   uint8_t bitsize_c = 0;
@@ -326,92 +554,43 @@ Status DoubleDelta::read_double_delta(
   return Status::Ok();
 }
 
-Status DoubleDelta::write_double_delta(
-    Buffer* buff,
-    int64_t double_delta,
-    int bitsize,
-    uint64_t* chunk,
-    int* bit_in_chunk) {
-  // Write sign
-  uint64_t to_or = (double_delta < 0) ? 1 : 0;
-  to_or <<= (*bit_in_chunk);
-  (*chunk) |= to_or;
-  --(*bit_in_chunk);
-
-  // Write chunk and reset
-  if (*bit_in_chunk < 0) {
-    RETURN_NOT_OK(buff->write(chunk, sizeof(uint64_t)));
-    *bit_in_chunk = 63;
-    *chunk = 0;
-  }
-
-  // Write rest of bits
-  int bits_left_to_write = bitsize;
-  int bit_in_dd = bitsize - 1;
-  int bits_to_fill_in_chunk = MIN((*bit_in_chunk) + 1, bits_left_to_write);
-  uint64_t abs_dd = ABS(double_delta);
-  uint64_t tmp_abs_dd;
-
-  while (bits_left_to_write > 0) {
-    if (bits_to_fill_in_chunk > 0) {
-      tmp_abs_dd = (abs_dd << (63 - bit_in_dd));
-      tmp_abs_dd >>= (63 - (*bit_in_chunk));
-      (*chunk) |= tmp_abs_dd;
-      (*bit_in_chunk) -= bits_to_fill_in_chunk;
-      bit_in_dd -= bits_to_fill_in_chunk;
-      bits_left_to_write -= bits_to_fill_in_chunk;
-    }
-
-    // Write chunk and reset
-    if (*bit_in_chunk < 0) {
-      RETURN_NOT_OK(buff->write(chunk, sizeof(uint64_t)));
-      *bit_in_chunk = 63;
-      *chunk = 0;
-      bits_to_fill_in_chunk = MIN((*bit_in_chunk) + 1, bits_left_to_write);
-    }
-  }
-
-  return Status::Ok();
-}
-
 // Explicit template instantiations
 
-template Status DoubleDelta::compress<char>(
-    ConstBuffer* input_buffer, Buffer* output_buffer);
-template Status DoubleDelta::compress<int8_t>(
-    ConstBuffer* input_buffer, Buffer* output_buffer);
 template Status DoubleDelta::compress<uint8_t>(
-    ConstBuffer* input_buffer, Buffer* output_buffer);
-template Status DoubleDelta::compress<int16_t>(
-    ConstBuffer* input_buffer, Buffer* output_buffer);
+    uint8_t format, ConstBuffer* input_buffer, Buffer* output_buffer);
 template Status DoubleDelta::compress<uint16_t>(
-    ConstBuffer* input_buffer, Buffer* output_buffer);
-template Status DoubleDelta::compress<int>(
-    ConstBuffer* input_buffer, Buffer* output_buffer);
+    uint8_t format, ConstBuffer* input_buffer, Buffer* output_buffer);
 template Status DoubleDelta::compress<uint32_t>(
+    uint8_t format, ConstBuffer* input_buffer, Buffer* output_buffer);
+template Status DoubleDelta::compress<uint64_t>(
+    uint8_t format, ConstBuffer* input_buffer, Buffer* output_buffer);
+
+template Status DoubleDelta::decompress<uint8_t>(
     ConstBuffer* input_buffer, Buffer* output_buffer);
-template Status DoubleDelta::compress<int64_t>(
+template Status DoubleDelta::decompress<uint16_t>(
     ConstBuffer* input_buffer, Buffer* output_buffer);
-template Status DoubleDelta::compress<uint64_t>(
+template Status DoubleDelta::decompress<uint32_t>(
+    ConstBuffer* input_buffer, Buffer* output_buffer);
+template Status DoubleDelta::decompress<uint64_t>(
     ConstBuffer* input_buffer, Buffer* output_buffer);
 
-template Status DoubleDelta::decompress<char>(
+template Status DoubleDelta::decompress_legacy<char>(
     ConstBuffer* input_buffer, Buffer* output_buffer);
-template Status DoubleDelta::decompress<int8_t>(
+template Status DoubleDelta::decompress_legacy<int8_t>(
     ConstBuffer* input_buffer, Buffer* output_buffer);
-template Status DoubleDelta::decompress<uint8_t>(
+template Status DoubleDelta::decompress_legacy<uint8_t>(
     ConstBuffer* input_buffer, Buffer* output_buffer);
-template Status DoubleDelta::decompress<int16_t>(
+template Status DoubleDelta::decompress_legacy<int16_t>(
     ConstBuffer* input_buffer, Buffer* output_buffer);
-template Status DoubleDelta::decompress<uint16_t>(
+template Status DoubleDelta::decompress_legacy<uint16_t>(
     ConstBuffer* input_buffer, Buffer* output_buffer);
-template Status DoubleDelta::decompress<int>(
+template Status DoubleDelta::decompress_legacy<int>(
     ConstBuffer* input_buffer, Buffer* output_buffer);
-template Status DoubleDelta::decompress<uint32_t>(
+template Status DoubleDelta::decompress_legacy<uint32_t>(
     ConstBuffer* input_buffer, Buffer* output_buffer);
-template Status DoubleDelta::decompress<int64_t>(
+template Status DoubleDelta::decompress_legacy<int64_t>(
     ConstBuffer* input_buffer, Buffer* output_buffer);
-template Status DoubleDelta::decompress<uint64_t>(
+template Status DoubleDelta::decompress_legacy<uint64_t>(
     ConstBuffer* input_buffer, Buffer* output_buffer);
 
 };  // namespace sm
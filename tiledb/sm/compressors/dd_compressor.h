@@ -45,11 +45,21 @@ namespace sm {
 class DoubleDelta {
  public:
   /**
-   * Constant overhead (equal to 1 byte for the bitsize, 8 bytes for
-   * the number of cells, and 8 bytes for a potential extra 64-bit chunk).
+   * Constant overhead (equal to 1 byte for the format, 8 bytes for the
+   * number of cells, and 16 bytes for the potentially almost empty last
+   * 64-bit words of the last block).
    */
   static const uint64_t OVERHEAD;
 
+  /** The number of values packed together with a common bitsize. */
+  static const uint64_t BLOCK_SIZE;
+
+  /** Format tag of integer values compressed as blocked double deltas. */
+  static const uint8_t FORMAT_DOUBLE_DELTA;
+
+  /** Format tag of real values compressed as blocked XORs. */
+  static const uint8_t FORMAT_XOR;
+
   /* ****************************** */
   /*               API              */
   /* ****************************** */
@@ -61,47 +71,54 @@ class DoubleDelta {
    *
    * in_0 | in_1 | in_2 |      ...      | in_n
    *
-   * The output buffer will contain the following after compression:
+   * For integer types, the output buffer will contain the following after
+   * compression:
    *
-   * bitsize | n | in_0 | in_1 | b_2 | abs(dd_2) | b_3 | abs(dd_3) | ...
-   *   ...   | b_n | abs(dd_n)
+   * FORMAT_DOUBLE_DELTA | n | in_0 | in_1 | block_0 | block_1 | ...
    *
    * where:
-   *  - *bitsize* (char) is the minimum number of bits required to represent
-   *    any abs(dd_i).
    *  - *n* (uint64_t) is the number of values in the input buffer.
-   *  - **b_i** is the sign of dd_i
-   *  - **dd_i** is equal to (in_{i} - in_{i-1}) - (in_{i-1} - in_{i-2})
+   *  - **block_j** packs the zigzag encoded double deltas
+   *    dd_i = (in_{i} - in_{i-1}) - (in_{i-1} - in_{i-2}) of the values
+   *    in_{2 + j * BLOCK_SIZE}, ..., in_{2 + (j + 1) * BLOCK_SIZE - 1}.
+   *    The deltas are computed modulo the width of the data type, so that no
+   *    double delta can overflow.
+   *
+   * For real types, which are compressed bitwise in the spirit of Facebook's
+   * Gorilla, the output buffer will instead contain:
    *
-   *  In case the bitsize is equal to the size of the data type plus one (for
-   *  the sign), then it does not make sense to compress and, thus, the
-   *  algorithm simply copies the input to the output, though after *bitsize*
-   *  and *n* that are always written to the output buffer.
+   * FORMAT_XOR | n | in_0 | block_0 | block_1 | ...
    *
-   *  The algorithm populates and writes to the output buffer a 64-bit chunk
-   *  at a time. Therefore, the output buffer may end up having a worst-case
-   *  overhead of 1 (bitsize) + 8 (n) + 8 (last, potentially almost empty chunk)
-   *  bytes.
+   * where **block_j** packs the XORs of the bit patterns of consecutive
+   * values in_{i} ^ in_{i-1}, starting from i = 1. Slowly varying values
+   * share their sign, exponent and leading mantissa bits and, thus, XOR to
+   * values with many leading zeros.
+   *
+   * Each block has the following form:
+   *
+   * shift (uint8_t) | bitsize (uint8_t) | packed values
+   *
+   * where *shift* is the number of trailing zero bits common to all values
+   * of the block, and *bitsize* is the number of bits required to represent
+   * any value of the block after dropping those bits. The values are packed
+   * with *bitsize* bits each into two interleaved streams of 64-bit words,
+   * the first holding the even and the second the odd values of the block,
+   * so that the two streams can be packed and unpacked in parallel with
+   * 128-bit SIMD instructions. A full block takes exactly 2 * *bitsize*
+   * words, whereas the last block may be partial.
    *
    * @param type The type of the input values.
    * @param input_buffer Input buffer to read from.
    * @param output_buffer Output buffer to write to the compressed data.
    * @return Status
-   *
-   * @note The function will fail with an error in two cases: (i) the output
-   *     buffer incurs a memory allocation error, and (ii) some double delta
-   *     value is out of bounds. Note that all double deltas are represented
-   *     as int64_t. Therefore, the out of bounds case occurs when adding
-   *     two huge positive numbers (e.g., INT64_MAX) resulting in a negative
-   *     value, or adding to very small negative numbers (e.g., -INT64_MAX),
-   *     resulting in a positive number. However, both these two cases are
-   *     extreme.
    */
   static Status compress(
       Datatype type, ConstBuffer* input_buffer, Buffer* output_buffer);
 
   /**
-   * Decompression function.
+   * Decompression function. Besides the formats produced by `compress`, it
+   * decompresses the format of earlier versions, which starts with a single
+   * fixed bitsize for all double deltas instead of a format tag.
    *
    * @param type The type of the original decompressed values.
    * @param input_buffer Input buffer to read from.
@@ -119,25 +136,35 @@ class DoubleDelta {
   /*         PRIVATE METHODS        */
   /* ****************************** */
 
-  /** Templated version of *compress* on the type of buffer values. */
+  /**
+   * Templated version of *compress* on the unsigned type with the width of
+   * the buffer values.
+   *
+   * @tparam T The unsigned type with the width of the values.
+   * @param format The format to compress with, i.e., FORMAT_DOUBLE_DELTA or
+   *     FORMAT_XOR.
+   * @param input_buffer Input buffer to read from.
+   * @param output_buffer Output buffer to write to the compressed data.
+   * @return Status
+   */
   template <class T>
-  static Status compress(ConstBuffer* input_buffer, Buffer* output_buffer);
+  static Status compress(
+      uint8_t format, ConstBuffer* input_buffer, Buffer* output_buffer);
 
   /**
-   * Calculates the bitsize all the double deltas will have. Note that
-   * the sign bit is not counted.
+   * Templated version of *decompress* on the unsigned type with the width of
+   * the buffer values, for the formats produced by `compress`.
    *
-   * @tparam The datatype of the values.
-   * @param in The input buffer.
-   * @param num The number of values in the buffer.
-   * @param bitsize The bitsize of the double deltas to be retrieved.
+   * @tparam T The unsigned type with the width of the values.
+   * @param input_buffer Input buffer to read from.
+   * @param output_buffer Output buffer to write the decompressed data to.
    * @return Status
    */
   template <class T>
-  static Status compute_bitsize(T* in, uint64_t num, unsigned int* bitsize);
+  static Status decompress(ConstBuffer* input_buffer, Buffer* output_buffer);
 
   /**
-   * Decompression function.
+   * Decompression function for the format of earlier versions.
    *
    * @tparam The datatype of the values.
    * @param input_buffer Input buffer to read from.
@@ -145,10 +172,12 @@ class DoubleDelta {
    * @return Status
    */
   template <class T>
-  static Status decompress(ConstBuffer* input_buffer, Buffer* output_buffer);
+  static Status decompress_legacy(
+      ConstBuffer* input_buffer, Buffer* output_buffer);
 
   /**
-   * Reads/reconstructs a double delta value from a compressed buffer.
+   * Reads/reconstructs a double delta value from a buffer in the format of
+   * earlier versions.
    *
    * @param buff The input buffer.
    * @param double_delta The double delta value to be retrieved.
@@ -165,30 +194,9 @@ class DoubleDelta {
       int bitsize,
       uint64_t* chunk,
       int* bit_in_chunk);
-
-  /**
-   * Writes a double delta value to a buffer, after reducing its bitsize
-   * to match the input one.
-   *
-   * @param buff The output buffer.
-   * @param double_delta The double delta value to write.
-   * @param bitsize The bitsize the double delta value will reduce to
-   *     before being written to the buffer.
-   * @param chunk The function writes to the buffer in whole 64-bit chunks.
-   *     This parameters represents some state about the current chunk.
-   * @param bit_in_chunk Part of the chunk state. Stores the current bit
-   *     in the chunk the next write will start from.
-   * @return Status
-   */
-  static Status write_double_delta(
-      Buffer* buff,
-      int64_t double_delta,
-      int bitsize,
-      uint64_t* chunk,
-      int* bit_in_chunk);
 };
 
 }  // namespace sm
 }  // namespace tiledb
 
-#endif  // TILEDB_GZIP_H
+#endif  // TILEDB_DOUBLE_DELTA_H
@@ -39,6 +39,35 @@
 namespace tiledb {
 namespace sm {
 
+/**
+ * The zlib streams of a thread. They are initialized upon first use and
+ * reset for every subsequent chunk the thread (de)compresses, which saves
+ * allocating and setting up the zlib state for every chunk.
+ */
+struct GZipStreams {
+  z_stream deflate_;
+  bool deflate_init_;
+  int deflate_level_;
+  z_stream inflate_;
+  bool inflate_init_;
+
+  GZipStreams()
+      : deflate_init_(false)
+      , deflate_level_(0)
+      , inflate_init_(false) {
+  }
+
+  ~GZipStreams() {
+    if (deflate_init_)
+      (void)deflateEnd(&deflate_);
+    if (inflate_init_)
+      (void)inflateEnd(&inflate_);
+  }
+};
+
+/** The zlib streams of the calling thread. */
+static thread_local GZipStreams gzip_streams;
+
 Status GZip::compress(
     int level, ConstBuffer* input_buffer, Buffer* output_buffer) {
   // Sanity check
@@ -47,19 +76,34 @@ Status GZip::compress(
         "Failed compressing with GZip; invalid buffer format"));
 
   int ret;
-  z_stream strm;
+  auto& strm = gzip_streams.deflate_;
+  level = level < 0 ? GZip::default_level() : level;
 
-  // Allocate deflate state
-  strm.zalloc = Z_NULL;
-  strm.zfree = Z_NULL;
-  strm.opaque = Z_NULL;
-  ret = deflateInit(&strm, level < 0 ? GZip::default_level() : level);
-
-  if (ret != Z_OK) {
+  // A stream is bound to its compression level
+  if (gzip_streams.deflate_init_ && gzip_streams.deflate_level_ != level) {
     (void)deflateEnd(&strm);
-    return LOG_STATUS(Status::GZipError("Cannot compress with GZIP"));
+    gzip_streams.deflate_init_ = false;
+  }
+
+  // Allocate deflate state, or reset the state of the previous chunk
+  if (gzip_streams.deflate_init_) {
+    ret = deflateReset(&strm);
+    if (ret != Z_OK) {
+      (void)deflateEnd(&strm);
+      gzip_streams.deflate_init_ = false;
+    }
+  } else {
+    strm.zalloc = Z_NULL;
+    strm.zfree = Z_NULL;
+    strm.opaque = Z_NULL;
+    ret = deflateInit(&strm, level);
+    gzip_streams.deflate_init_ = ret == Z_OK;
+    gzip_streams.deflate_level_ = level;
   }
 
+  if (ret != Z_OK)
+    return LOG_STATUS(Status::GZipError("Cannot compress with GZIP"));
+
   // Compress
   strm.next_in = (unsigned char*)input_buffer->data();
   strm.next_out = (unsigned char*)output_buffer->cur_data();
@@ -67,9 +111,6 @@ Status GZip::compress(
   strm.avail_out = (uInt)output_buffer->free_space();
   ret = deflate(&strm, Z_FINISH);
 
-  // Clean up
-  (void)deflateEnd(&strm);
-
   // Return
   if (ret == Z_STREAM_ERROR || strm.avail_in != 0)
     return LOG_STATUS(Status::GZipError("Cannot compress with GZIP"));
@@ -89,15 +130,24 @@ Status GZip::decompress(ConstBuffer* input_buffer, Buffer* output_buffer) {
         "Failed decompressing with GZip; invalid buffer format"));
 
   int ret;
-  z_stream strm;
-
-  // Allocate deflate state
-  strm.zalloc = Z_NULL;
-  strm.zfree = Z_NULL;
-  strm.opaque = Z_NULL;
-  strm.avail_in = 0;
-  strm.next_in = Z_NULL;
-  ret = inflateInit(&strm);
+  auto& strm = gzip_streams.inflate_;
+
+  // Allocate inflate state, or reset the state of the previous chunk
+  if (gzip_streams.inflate_init_) {
+    ret = inflateReset(&strm);
+    if (ret != Z_OK) {
+      (void)inflateEnd(&strm);
+      gzip_streams.inflate_init_ = false;
+    }
+  } else {
+    strm.zalloc = Z_NULL;
+    strm.zfree = Z_NULL;
+    strm.opaque = Z_NULL;
+    strm.avail_in = 0;
+    strm.next_in = Z_NULL;
+    ret = inflateInit(&strm);
+    gzip_streams.inflate_init_ = ret == Z_OK;
+  }
 
   if (ret != Z_OK) {
     return LOG_STATUS(Status::GZipError("Cannot decompress with GZIP"));
@@ -120,9 +170,6 @@ Status GZip::decompress(ConstBuffer* input_buffer, Buffer* output_buffer) {
   output_buffer->advance_size(compressed_size);
   output_buffer->advance_offset(compressed_size);
 
-  // Clean up
-  (void)inflateEnd(&strm);
-
   // Success
   return Status::Ok();
 }
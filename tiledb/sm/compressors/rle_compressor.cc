@@ -30,27 +30,106 @@
  * This file implements the rle compressor class.
  */
 
+#include <algorithm>
 #include <cassert>
+#include <cstring>
 #include <iostream>
 
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define TILEDB_RLE_SSE2
+#include <emmintrin.h>
+#endif
+
 #include "tiledb/sm/compressors/rle_compressor.h"
 #include "tiledb/sm/misc/logger.h"
 
 namespace tiledb {
 namespace sm {
 
+/* ********************************* */
+/*          STATIC FUNCTIONS         */
+/* ********************************* */
+
+/** Maximum run length, bounded by the two-byte run length of each run. */
+static const uint64_t rle_max_run_len = 65535;
+
+/** Size of a comparison block used when scanning runs. */
+static const uint64_t rle_block_size = 16;
+
+/** Returns `true` if the `rle_block_size` bytes at `a` and `b` are equal. */
+static inline bool rle_block_equal(
+    const unsigned char* a, const unsigned char* b) {
+#ifdef TILEDB_RLE_SSE2
+  __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a));
+  __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b));
+  return _mm_movemask_epi8(_mm_cmpeq_epi8(va, vb)) == 0xFFFF;
+#else
+  return std::memcmp(a, b, rle_block_size) == 0;
+#endif
+}
+
+/**
+ * Returns the number of consecutive values starting at `cur` that are equal
+ * to `value`, up to `max_num` values. If `pattern` is not `nullptr`, it holds
+ * `value` repeated to fill `rle_block_size` bytes, and the values are
+ * compared a block at a time.
+ */
+static inline uint64_t rle_run_len(
+    const unsigned char* value,
+    const unsigned char* pattern,
+    uint64_t value_size,
+    const unsigned char* cur,
+    uint64_t max_num) {
+  uint64_t n = 0;
+  if (pattern != nullptr) {
+    uint64_t block_values = rle_block_size / value_size;
+    while (n + block_values <= max_num &&
+           rle_block_equal(cur + n * value_size, pattern))
+      n += block_values;
+  }
+  while (n < max_num &&
+         std::memcmp(cur + n * value_size, value, value_size) == 0)
+    ++n;
+  return n;
+}
+
+/** Fills `run_len` values at `out` with copies of the value at `value`. */
+static inline void rle_fill(
+    unsigned char* out,
+    const unsigned char* value,
+    uint64_t value_size,
+    uint64_t run_len) {
+  uint64_t nbytes = run_len * value_size;
+  if (nbytes == 0)
+    return;
+  if (value_size == 1) {
+    std::memset(out, *value, nbytes);
+    return;
+  }
+
+  // Copy the value once, then keep doubling the filled prefix
+  std::memcpy(out, value, value_size);
+  uint64_t filled = value_size;
+  while (filled < nbytes) {
+    uint64_t n = std::min(filled, nbytes - filled);
+    std::memcpy(out + filled, out, n);
+    filled += n;
+  }
+}
+
+/* ********************************* */
+/*                API                */
+/* ********************************* */
+
 Status RLE::compress(
     uint64_t value_size, ConstBuffer* input_buffer, Buffer* output_buffer) {
   // Sanity check
   if (input_buffer->data() == nullptr)
     return LOG_STATUS(Status::CompressionError(
         "Failed compressing with RLE; null input buffer"));
-  unsigned int cur_run_len = 1;
-  unsigned int max_run_len = 65535;
-  auto input_cur = (const unsigned char*)input_buffer->data() + value_size;
-  auto input_prev = (const unsigned char*)input_buffer->data();
+  auto input = (const unsigned char*)input_buffer->data();
   uint64_t value_num = input_buffer->size() / value_size;
-  unsigned char byte;
 
   // Trivial case
   if (value_num == 0)
@@ -62,34 +141,52 @@ Status RLE::compress(
         "Failed compressing with RLE; invalid input buffer format"));
   }
 
+  // Reserve the worst case output size once, so that runs can be emitted
+  // without any per-run bounds checks
+  uint64_t run_size = value_size + 2 * sizeof(char);
+  uint64_t offset = output_buffer->offset();
+  uint64_t max_size = offset + value_num * run_size;
+  if (output_buffer->data() == nullptr ||
+      output_buffer->alloced_size() < max_size)
+    RETURN_NOT_OK(output_buffer->realloc(max_size));
+  auto output_start = (unsigned char*)output_buffer->data(offset);
+  auto output = output_start;
+
+  // Values that evenly divide a comparison block are compared a block at a
+  // time against the run value repeated to fill the block
+  unsigned char pattern[rle_block_size];
+  bool use_pattern =
+      value_size <= rle_block_size && rle_block_size % value_size == 0;
+
   // Make runs
-  for (uint64_t i = 1; i < value_num; ++i) {
-    if (std::memcmp(input_cur, input_prev, value_size) == 0 &&
-        cur_run_len < max_run_len) {  // Expand the run
-      ++cur_run_len;
-    } else {  // Save the run
-      // Copy to output buffer
-      RETURN_NOT_OK(output_buffer->write(input_prev, value_size));
-      byte = (unsigned char)(cur_run_len >> 8);
-      RETURN_NOT_OK(output_buffer->write(&byte, sizeof(char)));
-      byte = (unsigned char)(cur_run_len % 256);
-      RETURN_NOT_OK(output_buffer->write(&byte, sizeof(char)));
-
-      // Reset current run length
-      cur_run_len = 1;
+  uint64_t i = 0;
+  while (i < value_num) {
+    auto value = input + i * value_size;
+    uint64_t max_num = std::min(rle_max_run_len, value_num - i) - 1;
+    uint64_t run_len = 1;
+    if (max_num > 0 &&
+        std::memcmp(value + value_size, value, value_size) == 0) {
+      // Only build the comparison pattern for runs longer than one value
+      if (use_pattern)
+        rle_fill(pattern, value, value_size, rle_block_size / value_size);
+      run_len += 1 + rle_run_len(
+                         value,
+                         use_pattern ? pattern : nullptr,
+                         value_size,
+                         value + 2 * value_size,
+                         max_num - 1);
     }
 
-    // Update run info
-    input_prev = input_cur;
-    input_cur = input_prev + value_size;
+    // Save the run
+    std::memcpy(output, value, value_size);
+    output[value_size] = (unsigned char)(run_len >> 8);
+    output[value_size + 1] = (unsigned char)(run_len % 256);
+    output += run_size;
+    i += run_len;
   }
 
-  // Save final run
-  RETURN_NOT_OK(output_buffer->write(input_prev, value_size));
-  byte = (unsigned char)(cur_run_len >> 8);
-  RETURN_NOT_OK(output_buffer->write(&byte, sizeof(char)));
-  byte = (unsigned char)(cur_run_len % 256);
-  RETURN_NOT_OK(output_buffer->write(&byte, sizeof(char)));
+  output_buffer->advance_offset(output - output_start);
+  output_buffer->set_size(output_buffer->offset());
 
   return Status::Ok();
 }
@@ -101,10 +198,9 @@ Status RLE::decompress(
     return LOG_STATUS(Status::CompressionError(
         "Failed decompressing with RLE; null input buffer"));
 
-  auto input_cur = static_cast<const unsigned char*>(input_buffer->data());
+  auto input = static_cast<const unsigned char*>(input_buffer->data());
   uint64_t run_size = value_size + 2 * sizeof(char);
   uint64_t run_num = input_buffer->size() / run_size;
-  unsigned char byte;
 
   // Trivial case
   if (run_num == 0)
@@ -116,22 +212,30 @@ Status RLE::decompress(
         "Failed decompressing with RLE; invalid input buffer format"));
   }
 
+  // Size the output once from the run lengths
+  uint64_t value_num = 0;
+  for (uint64_t i = 0; i < run_num; ++i) {
+    auto run = input + i * run_size;
+    value_num += (((uint64_t)run[value_size]) << 8) + run[value_size + 1];
+  }
+  uint64_t offset = output_buffer->offset();
+  uint64_t size = offset + value_num * value_size;
+  if (output_buffer->data() == nullptr || output_buffer->alloced_size() < size)
+    RETURN_NOT_OK(output_buffer->realloc(size));
+  auto output = (unsigned char*)output_buffer->data(offset);
+
   // Decompress runs
   for (uint64_t i = 0; i < run_num; ++i) {
-    // Retrieve the current run length
-    std::memcpy(&byte, input_cur + value_size, sizeof(char));
-    uint64_t run_len = (((uint64_t)byte) << 8);
-    std::memcpy(&byte, input_cur + value_size + sizeof(char), sizeof(char));
-    run_len += (uint64_t)byte;
-
-    // Copy to output buffer
-    for (uint64_t j = 0; j < run_len; ++j)
-      RETURN_NOT_OK(output_buffer->write(input_cur, value_size))
-
-    // Update input/output tracking info
-    input_cur += run_size;
+    auto run = input + i * run_size;
+    uint64_t run_len =
+        (((uint64_t)run[value_size]) << 8) + run[value_size + 1];
+    rle_fill(output, run, value_size, run_len);
+    output += run_len * value_size;
   }
 
+  output_buffer->advance_offset(value_num * value_size);
+  output_buffer->set_size(output_buffer->offset());
+
   return Status::Ok();
 }
 
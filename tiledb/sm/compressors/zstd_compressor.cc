@@ -33,26 +33,113 @@
 #include "tiledb/sm/compressors/zstd_compressor.h"
 #include "tiledb/sm/misc/logger.h"
 
+#include <zdict.h>
 #include <zstd.h>
 #include <iostream>
 
 namespace tiledb {
 namespace sm {
 
+/**
+ * The zstd contexts of a thread. They are created upon first use and reused
+ * by all the chunks the thread (de)compresses, which saves setting up the
+ * zstd state for every chunk.
+ */
+struct ZStdContexts {
+  ZSTD_CCtx* cctx_;
+  ZSTD_DCtx* dctx_;
+
+  ZStdContexts()
+      : cctx_(nullptr)
+      , dctx_(nullptr) {
+  }
+
+  ~ZStdContexts() {
+    ZSTD_freeCCtx(cctx_);
+    ZSTD_freeDCtx(dctx_);
+  }
+};
+
+/** The zstd contexts of the calling thread. */
+static thread_local ZStdContexts zstd_contexts;
+
+/* ****************************** */
+/*         ZSTD DICTIONARY        */
+/* ****************************** */
+
+ZStdDictionary::ZStdDictionary(const void* data, uint64_t size)
+    : cdict_(nullptr)
+    , cdict_level_(0)
+    , data_((const char*)data, (const char*)data + size)
+    , ddict_(nullptr) {
+}
+
+ZStdDictionary::~ZStdDictionary() {
+  ZSTD_freeCDict(cdict_);
+  ZSTD_freeDDict(ddict_);
+}
+
+const std::vector<char>& ZStdDictionary::data() const {
+  return data_;
+}
+
+/* ****************************** */
+/*              ZSTD              */
+/* ****************************** */
+
 Status ZStd::compress(
     int level, ConstBuffer* input_buffer, Buffer* output_buffer) {
+  return compress(level, nullptr, input_buffer, output_buffer);
+}
+
+Status ZStd::compress(
+    int level,
+    ZStdDictionary* dictionary,
+    ConstBuffer* input_buffer,
+    Buffer* output_buffer) {
   // Sanity check
   if (input_buffer->data() == nullptr || output_buffer->data() == nullptr)
     return LOG_STATUS(Status::CompressionError(
         "Failed compressing with ZStd; invalid buffer format"));
 
+  // Create the compression context of the thread
+  if (zstd_contexts.cctx_ == nullptr) {
+    zstd_contexts.cctx_ = ZSTD_createCCtx();
+    if (zstd_contexts.cctx_ == nullptr)
+      return LOG_STATUS(Status::CompressionError(
+          "ZStd compression failed; Cannot create compression context"));
+  }
+
+  // Digest the dictionary for the compression level
+  level = level < 0 ? ZStd::default_level() : level;
+  if (dictionary != nullptr &&
+      (dictionary->cdict_ == nullptr || dictionary->cdict_level_ != level)) {
+    ZSTD_freeCDict(dictionary->cdict_);
+    dictionary->cdict_ = ZSTD_createCDict(
+        dictionary->data_.data(), dictionary->data_.size(), level);
+    if (dictionary->cdict_ == nullptr)
+      return LOG_STATUS(Status::CompressionError(
+          "ZStd compression failed; Cannot digest dictionary"));
+    dictionary->cdict_level_ = level;
+  }
+
   // Compress
-  uint64_t zstd_ret = ZSTD_compress(
-      output_buffer->cur_data(),
-      output_buffer->free_space(),
-      input_buffer->data(),
-      input_buffer->size(),
-      level < 0 ? ZStd::default_level() : level);
+  uint64_t zstd_ret =
+      (dictionary == nullptr) ?
+          ZSTD_compressCCtx(
+              zstd_contexts.cctx_,
+              output_buffer->cur_data(),
+              output_buffer->free_space(),
+              input_buffer->data(),
+              input_buffer->size(),
+              level) :
+          ZSTD_compress_usingCDict(
+              zstd_contexts.cctx_,
+              output_buffer->cur_data(),
+              output_buffer->free_space(),
+              input_buffer->data(),
+              input_buffer->size(),
+              dictionary->cdict_);
 
   // Handle error
   if (ZSTD_isError(zstd_ret) != 0) {
@@ -69,17 +156,51 @@ Status ZStd::compress(
 }
 
 Status ZStd::decompress(ConstBuffer* input_buffer, Buffer* output_buffer) {
+  return decompress(nullptr, input_buffer, output_buffer);
+}
+
+Status ZStd::decompress(
+    ZStdDictionary* dictionary,
+    ConstBuffer* input_buffer,
+    Buffer* output_buffer) {
   // Sanity check
   if (input_buffer->data() == nullptr || output_buffer->data() == nullptr)
     return LOG_STATUS(Status::CompressionError(
         "Failed decompressing with ZStd; invalid buffer format"));
 
+  // Create the decompression context of the thread
+  if (zstd_contexts.dctx_ == nullptr) {
+    zstd_contexts.dctx_ = ZSTD_createDCtx();
+    if (zstd_contexts.dctx_ == nullptr)
+      return LOG_STATUS(Status::CompressionError(
+          "ZStd decompression failed; Cannot create decompression context"));
+  }
+
+  // Digest the dictionary
+  if (dictionary != nullptr && dictionary->ddict_ == nullptr) {
+    dictionary->ddict_ =
+        ZSTD_createDDict(dictionary->data_.data(), dictionary->data_.size());
+    if (dictionary->ddict_ == nullptr)
+      return LOG_STATUS(Status::CompressionError(
+          "ZStd decompression failed; Cannot digest dictionary"));
+  }
+
   // Decompress
-  uint64_t zstd_ret = ZSTD_decompress(
-      output_buffer->cur_data(),
-      output_buffer->free_space(),
-      input_buffer->data(),
-      input_buffer->size());
+  uint64_t zstd_ret =
+      (dictionary == nullptr) ?
+          ZSTD_decompressDCtx(
+              zstd_contexts.dctx_,
+              output_buffer->cur_data(),
+              output_buffer->free_space(),
+              input_buffer->data(),
+              input_buffer->size()) :
+          ZSTD_decompress_usingDDict(
+              zstd_contexts.dctx_,
+              output_buffer->cur_data(),
+              output_buffer->free_space(),
+              input_buffer->data(),
+              input_buffer->size(),
+              dictionary->ddict_);
 
   // Check error
   if (ZSTD_isError(zstd_ret) != 0) {
@@ -99,5 +220,40 @@ uint64_t ZStd::overhead(uint64_t nbytes) {
   return ZSTD_compressBound(nbytes) - nbytes;
 }
 
+Status ZStd::train_dictionary(
+    const void* samples,
+    const std::vector<uint64_t>& sample_sizes,
+    uint64_t capacity,
+    Buffer* dictionary) {
+  // Sanity check
+  if (samples == nullptr || sample_sizes.empty())
+    return LOG_STATUS(Status::CompressionError(
+        "ZStd dictionary training failed; No samples"));
+
+  std::vector<size_t> sizes(sample_sizes.begin(), sample_sizes.end());
+  RETURN_NOT_OK(dictionary->realloc(dictionary->size() + capacity));
+
+  // Train
+  uint64_t zdict_ret = ZDICT_trainFromBuffer(
+      dictionary->cur_data(),
+      capacity,
+      samples,
+      sizes.data(),
+      (unsigned)sizes.size());
+
+  // Handle error
+  if (ZDICT_isError(zdict_ret) != 0) {
+    const char* msg = ZDICT_getErrorName(zdict_ret);
+    return LOG_STATUS(Status::CompressionError(
+        std::string("ZStd dictionary training failed: ") + msg));
+  }
+
+  // Set size of the dictionary
+  dictionary->advance_size(zdict_ret);
+  dictionary->advance_offset(zdict_ret);
+
+  return Status::Ok();
+}
+
 }  // namespace sm
 }  // namespace tiledb
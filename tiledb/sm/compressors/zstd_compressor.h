@@ -37,9 +37,54 @@
 #include "tiledb/sm/buffer/const_buffer.h"
 #include "tiledb/sm/misc/status.h"
 
+#include <vector>
+
+struct ZSTD_CDict_s;
+struct ZSTD_DDict_s;
+
 namespace tiledb {
 namespace sm {
 
+/**
+ * A zstd dictionary. It is digested upon first use for compression (at a
+ * given level) and decompression, and the digested forms are kept for all
+ * the chunks (de)compressed with it.
+ */
+class ZStdDictionary {
+ public:
+  /**
+   * Constructor.
+   *
+   * @param data The dictionary contents, which are copied.
+   * @param size The dictionary size.
+   */
+  ZStdDictionary(const void* data, uint64_t size);
+
+  /** Destructor. */
+  ~ZStdDictionary();
+
+  ZStdDictionary(const ZStdDictionary&) = delete;
+  ZStdDictionary& operator=(const ZStdDictionary&) = delete;
+
+  /** Returns the dictionary contents. */
+  const std::vector<char>& data() const;
+
+ private:
+  friend class ZStd;
+
+  /** The dictionary digested for compression (`nullptr` until used). */
+  ZSTD_CDict_s* cdict_;
+
+  /** The compression level `cdict_` was digested for. */
+  int cdict_level_;
+
+  /** The dictionary contents. */
+  std::vector<char> data_;
+
+  /** The dictionary digested for decompression (`nullptr` until used). */
+  ZSTD_DDict_s* ddict_;
+};
+
 /** Handles compression/decompression with the zstd library. */
 class ZStd {
  public:
@@ -54,6 +99,21 @@ class ZStd {
   static Status compress(
       int level, ConstBuffer* input_buffer, Buffer* output_buffer);
 
+  /**
+   * Compression function with a dictionary.
+   *
+   * @param level Compression level.
+   * @param dictionary The dictionary (no dictionary if `nullptr`).
+   * @param input_buffer Input buffer to read from.
+   * @param output_buffer Output buffer to write to the compressed data.
+   * @return Status
+   */
+  static Status compress(
+      int level,
+      ZStdDictionary* dictionary,
+      ConstBuffer* input_buffer,
+      Buffer* output_buffer);
+
   /**
    * Decompression function.
    *
@@ -63,6 +123,20 @@ class ZStd {
    */
   static Status decompress(ConstBuffer* input_buffer, Buffer* output_buffer);
 
+  /**
+   * Decompression function with a dictionary. Data compressed without a
+   * dictionary are decompressed as well.
+   *
+   * @param dictionary The dictionary (no dictionary if `nullptr`).
+   * @param input_buffer Input buffer to read from.
+   * @param output_buffer Output buffer to write the decompressed data to.
+   * @return Status
+   */
+  static Status decompress(
+      ZStdDictionary* dictionary,
+      ConstBuffer* input_buffer,
+      Buffer* output_buffer);
+
   /** Returns the default compression level. */
   static int default_level() {
     return 5;
@@ -70,6 +144,21 @@ class ZStd {
 
   /** Returns the compression overhead for the given input. */
   static uint64_t overhead(uint64_t nbytes);
+
+  /**
+   * Trains a dictionary on a set of samples.
+   *
+   * @param samples The samples, stored contiguously.
+   * @param sample_sizes The size of each sample.
+   * @param capacity The maximum dictionary size.
+   * @param dictionary The buffer the dictionary is written to.
+   * @return Status
+   */
+  static Status train_dictionary(
+      const void* samples,
+      const std::vector<uint64_t>& sample_sizes,
+      uint64_t capacity,
+      Buffer* dictionary);
 };
 
 }  // namespace sm
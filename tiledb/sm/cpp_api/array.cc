@@ -40,6 +40,14 @@ void Array::consolidate(const Context& ctx, const std::string& uri) {
   ctx.handle_error(tiledb_array_consolidate(ctx, uri.c_str()));
 }
 
+void Array::consolidate_metadata(const Context& ctx, const std::string& uri) {
+  ctx.handle_error(tiledb_array_consolidate_metadata(ctx, uri.c_str()));
+}
+
+void Array::flush_writes(const Context& ctx, const std::string& uri) {
+  ctx.handle_error(tiledb_array_flush_writes(ctx, uri.c_str()));
+}
+
 void Array::create(const std::string& uri, const ArraySchema& schema) {
   auto& ctx = schema.context();
   ctx.handle_error(tiledb_array_schema_check(ctx, schema));
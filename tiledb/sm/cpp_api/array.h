@@ -53,6 +53,18 @@ class TILEDB_EXPORT Array {
   /** Consolidates the fragments of an array. **/
   static void consolidate(const Context& ctx, const std::string& uri);
 
+  /**
+   * Consolidates the metadata of the fragments of an array into a single
+   * file, which is read upon opening the array.
+   */
+  static void consolidate_metadata(const Context& ctx, const std::string& uri);
+
+  /**
+   * Writes the cells of an array buffered in the memory of the context (see
+   * `sm.write_buffer_size`) to a new fragment.
+   */
+  static void flush_writes(const Context& ctx, const std::string& uri);
+
   /** Creates an array on persistent storage from a schema definition. **/
   static void create(const std::string& uri, const ArraySchema& schema);
 
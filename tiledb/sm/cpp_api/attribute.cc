@@ -102,6 +102,40 @@ Attribute& Attribute::set_compressor(Compressor c) {
   return *this;
 }
 
+Attribute& Attribute::add_filter(tiledb_filter_type_t filter) {
+  auto& ctx = ctx_.get();
+  ctx.handle_error(tiledb_attribute_add_filter(ctx, attr_.get(), filter));
+  return *this;
+}
+
+Attribute& Attribute::add_filter(
+    tiledb_filter_type_t filter, double error_bound) {
+  auto& ctx = ctx_.get();
+  ctx.handle_error(tiledb_attribute_add_lossy_filter(
+      ctx, attr_.get(), filter, error_bound));
+  return *this;
+}
+
+std::vector<tiledb_filter_type_t> Attribute::filters() const {
+  auto& ctx = ctx_.get();
+  unsigned int filter_num;
+  ctx.handle_error(
+      tiledb_attribute_get_filter_num(ctx, attr_.get(), &filter_num));
+  std::vector<tiledb_filter_type_t> ret(filter_num);
+  for (unsigned int i = 0; i < filter_num; ++i)
+    ctx.handle_error(
+        tiledb_attribute_get_filter(ctx, attr_.get(), i, &ret[i]));
+  return ret;
+}
+
+double Attribute::filter_error_bound(unsigned int index) const {
+  auto& ctx = ctx_.get();
+  double error_bound;
+  ctx.handle_error(tiledb_attribute_get_filter_error_bound(
+      ctx, attr_.get(), index, &error_bound));
+  return error_bound;
+}
+
 std::shared_ptr<tiledb_attribute_t> Attribute::ptr() const {
   return attr_;
 }
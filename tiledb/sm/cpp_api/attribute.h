@@ -47,6 +47,7 @@
 #include <functional>
 #include <memory>
 #include <type_traits>
+#include <vector>
 
 namespace tiledb {
 
@@ -124,6 +125,55 @@ class TILEDB_EXPORT Attribute {
   /** Sets the attribute compressor. */
   Attribute& set_compressor(Compressor c);
 
+  /**
+   * Appends a filter to the attribute filter pipeline. The filters are
+   * applied in the order they are added, before the compressor.
+   * `TILEDB_FILTER_DICTIONARY` is always applied first, and only to
+   * variable-sized string attributes.
+   *
+   * **Example:**
+   * @code{.cpp}
+   * auto a1 = tiledb::Attribute::create<int>(ctx, "a1");
+   * a1.add_filter(TILEDB_FILTER_DELTA)
+   *     .add_filter(TILEDB_FILTER_BYTESHUFFLE)
+   *     .set_compressor({TILEDB_LZ4, -1});
+   * @endcode
+   *
+   * @param filter The filter to append.
+   * @return Reference to this Attribute.
+   */
+  Attribute& add_filter(tiledb_filter_type_t filter);
+
+  /**
+   * Appends a lossy filter with the input error bound to the attribute
+   * filter pipeline. `TILEDB_FILTER_QUANTIZE` takes an absolute bound, and
+   * `TILEDB_FILTER_MANTISSA_TRUNCATION` a relative one. Both apply only to
+   * `float` and `double` attributes. `TILEDB_FILTER_QUANTIZE` cannot be
+   * combined with the `TILEDB_RLE` or `TILEDB_DOUBLE_DELTA` compressors.
+   *
+   * **Example:**
+   * @code{.cpp}
+   * auto a1 = tiledb::Attribute::create<double>(ctx, "a1");
+   * a1.add_filter(TILEDB_FILTER_QUANTIZE, 1e-3)
+   *     .add_filter(TILEDB_FILTER_DELTA)
+   *     .add_filter(TILEDB_FILTER_BIT_WIDTH_REDUCTION);
+   * @endcode
+   *
+   * @param filter The filter to append.
+   * @param error_bound The error bound of the filter.
+   * @return Reference to this Attribute.
+   */
+  Attribute& add_filter(tiledb_filter_type_t filter, double error_bound);
+
+  /** Returns the attribute filter pipeline, in the order it is applied. */
+  std::vector<tiledb_filter_type_t> filters() const;
+
+  /**
+   * Returns the error bound of the filter at position `index` of the
+   * pipeline (0 for lossless filters).
+   */
+  double filter_error_bound(unsigned int index) const;
+
   /** Returns the C TileDB attribute object pointer. */
   std::shared_ptr<tiledb_attribute_t> ptr() const;
 
@@ -122,6 +122,8 @@ class TILEDB_EXPORT Compressor {
         return "BZIP2";
       case TILEDB_DOUBLE_DELTA:
         return "DOUBLE_DELTA";
+      case TILEDB_AUTO:
+        return "AUTO";
     }
     return "Invalid";
   }
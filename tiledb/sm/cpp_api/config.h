@@ -115,6 +115,139 @@ class TILEDB_EXPORT Config {
    *    The fragment metadata cache size in bytes. Any `uint64_t` value is
    *    acceptable. <br>
    *    **Default**: 10,000,000
+   * - `sm.buffer_pool_size` <br>
+   *    The maximum number of bytes of freed tile and scratch buffers cached
+   *    for reuse by later allocations. `0` disables the buffer pool. <br>
+   *    **Default**: 100,000,000
+   * - `sm.memory_budget` <br>
+   *    The maximum number of bytes the queries of a context may reserve at
+   *    the same time, based on an estimate computed at query initialization.
+   *    `0` means unlimited. <br>
+   *    **Default**: 0
+   * - `sm.memory_budget_timeout_ms` <br>
+   *    How long (in ms) a query waits for memory budget to be released by
+   *    other queries before its initialization fails. `0` means that it
+   *    fails immediately. <br>
+   *    **Default**: 0
+   * - `sm.auto_compression_objective` <br>
+   *    What the `AUTO` compressor favors when it selects the compressor of
+   *    a tile: `ratio` (the smallest tile), `speed` (the fastest compressor
+   *    to decompress within 50% of the smallest tile) or `balanced` (the
+   *    fastest to decompress within 10% of the smallest tile). <br>
+   *    **Default**: balanced
+   * - `sm.zstd_dictionary_size` <br>
+   *    The maximum size in bytes of the zstd dictionary trained for each
+   *    `ZSTD` compressed attribute when a fragment is written or
+   *    consolidated. The dictionary is trained on samples of the first cells
+   *    written and stored in the fragment metadata, so that small tiles
+   *    compress almost as well as large ones. `0` disables dictionaries. <br>
+   *    **Default**: 0
+   * - `sm.num_compute_threads` <br>
+   *    The number of threads of the pool that runs the compute-heavy parts
+   *    of the queries of a context in parallel, e.g., filtering and
+   *    compressing the tiles of different attributes upon writing. <br>
+   *    **Default**: # cores
+   * - `sm.tile_slab_num` <br>
+   *    The number of tile slabs a read or write in row- or column-major order
+   *    keeps in flight over an array with a different tile order, each with
+   *    its own local buffers. While one slab is copied, the I/O of up to
+   *    `sm.tile_slab_num - 1` other slabs proceeds asynchronously. It must be
+   *    at least 2. <br>
+   *    **Default**: 2
+   * - `sm.write_buffer_size` <br>
+   *    The maximum number of bytes of cells that unordered writes to a sparse
+   *    array buffer in memory before they are written as a single fragment.
+   *    The buffer is flushed when it is full, when it is older than
+   *    `sm.write_buffer_flush_ms` upon a new write, before the array is
+   *    opened for reading or written in another way, when the context is
+   *    freed, and by `Array::flush_writes`. Writes larger than the buffer
+   *    bypass it. `0` disables write buffering. <br>
+   *    A buffered write that succeeded is held only in memory until the
+   *    buffer is flushed; no timer flushes it. A flush that fails when
+   *    the context is freed is only logged, and the cells are lost, so
+   *    flush the array explicitly to make buffered writes durable and to
+   *    get the errors. <br>
+   *    **Default**: 0
+   * - `sm.write_buffer_flush_ms` <br>
+   *    The age (in ms) of the oldest cell in the write buffer of an array
+   *    after which the next write to the array flushes the buffer. `0` means
+   *    that only the buffer size triggers flushes. <br>
+   *    **Default**: 10000
+   * - `sm.consolidation_policy` <br>
+   *    The policy that selects the fragments to consolidate. `full` merges
+   *    all the fragments of the array. `tiered` merges a bounded number of
+   *    consecutive fragments of similar size (see the following parameters),
+   *    preferring the smallest ones, so that consolidation can run
+   *    continuously behind writes. <br>
+   *    **Default**: full
+   * - `sm.consolidation_min_fragments` <br>
+   *    The minimum number of fragments of similar size that the `tiered`
+   *    consolidation policy merges at once. <br>
+   *    **Default**: 4
+   * - `sm.consolidation_max_fragments` <br>
+   *    The maximum number of fragments that the `tiered` consolidation policy
+   *    merges at once, which bounds the time and I/O of a consolidation. <br>
+   *    **Default**: 16
+   * - `sm.consolidation_size_ratio` <br>
+   *    The fragments that the `tiered` consolidation policy merges at once
+   *    differ in size by at most this factor. <br>
+   *    **Default**: 4
+   * - `sm.consolidation_memory_budget` <br>
+   *    The memory budget in bytes of the buffers of a consolidation. It is
+   *    split evenly among the partitions that are in flight at once, which
+   *    bounds the size of each partition. <br>
+   *    **Default**: 1000000000
+   * - `sm.consolidation_threads` <br>
+   *    The number of partitions of the domain that a consolidation reads
+   *    concurrently, while it writes the partitions that have been read in
+   *    global order. <br>
+   *    **Default**: number of cores
+   * - `sm.auto_consolidation_interval_ms` <br>
+   *    If it is not `0`, a background worker checks the arrays opened by the
+   *    context every this many milliseconds and consolidates the first one that
+   *    exceeds one of the `sm.auto_consolidation_*` thresholds, following
+   *    `sm.consolidation_policy`. The worker starts no consolidation while
+   *    queries of the context are in progress or the array is open in the
+   *    context. A consolidation locks the array exclusively, so reads that
+   *    open the array while it runs (e.g., from other contexts) wait for
+   *    it. <br>
+   *    **Default**: 0
+   * - `sm.auto_consolidation_fragment_num` <br>
+   *    An array with at least this many fragments is auto-consolidated
+   *    (`0` disables this threshold). <br>
+   *    **Default**: 16
+   * - `sm.auto_consolidation_small_fragment_size` <br>
+   *    An array with at least `sm.consolidation_min_fragments` fragments
+   *    smaller than this many bytes is auto-consolidated (`0` disables this
+   *    threshold). <br>
+   *    **Default**: 10000000
+   * - `sm.auto_consolidation_read_amplification` <br>
+   *    An array is auto-consolidated once the non-empty domain of one of its
+   *    fragments overlaps at least this many other fragments, all of which a
+   *    read in that domain visits (`0` disables this threshold).
+   *    <br>
+   *    **Default**: 8
+   * - `sm.auto_consolidation_io_budget` <br>
+   *    The I/O budget of the auto-consolidation in bytes per second. After
+   *    consolidating fragments of a total size, the worker waits long enough
+   *    to stay within the budget (`0` means unlimited). <br>
+   *    **Default**: 0
+   * - `sm.external_sort_memory` <br>
+   *    The memory budget in bytes of an unordered write to a sparse array
+   *    that is sorted out of core. If it is not `0`, every submission of an
+   *    unordered write query appends its cells to an in-memory run, runs
+   *    larger than the budget are sorted and spilled to scratch files in
+   *    `sm.external_sort_scratch_dir`, and finalizing the query merges them
+   *    into a single fragment. Thus a write of any size can be streamed
+   *    through the same query in batches. `0` sorts each submission in
+   *    memory into its own fragment. <br>
+   *    **Default**: 0
+   * - `sm.external_sort_scratch_dir` <br>
+   *    The local directory the runs of out-of-core unordered writes are
+   *    spilled to (see `sm.external_sort_memory`). Each query uses its own
+   *    subdirectory, which is removed when the query is finalized. An empty
+   *    value means the system temporary directory. <br>
+   *    **Default**: ""
    * - `vfs.max_parallel_ops` <br>
    *    The maximum number of VFS parallel operations.<br>
    *    **Default**: number of cores
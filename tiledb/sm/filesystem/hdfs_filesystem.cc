@@ -202,6 +202,24 @@ Status remove_file(hdfsFS fs, const URI& uri) {
 // pre-allocated buffer buffer.
 Status read(
     hdfsFS fs, const URI& uri, off_t offset, void* buffer, uint64_t length) {
+  uint64_t bytes_read;
+  RETURN_NOT_OK(read_up_to(fs, uri, offset, buffer, length, &bytes_read));
+  if (bytes_read != length) {
+    return LOG_STATUS(Status::HDFSError(
+        "Cannot read from file " + uri.to_string() + "; File reading error"));
+  }
+  return Status::Ok();
+}
+
+// Read up to length bytes from file give by path from byte offset offset
+// into pre-allocated buffer buffer, stopping early at the end of the file.
+Status read_up_to(
+    hdfsFS fs,
+    const URI& uri,
+    off_t offset,
+    void* buffer,
+    uint64_t length,
+    uint64_t* nbytes_read) {
   hdfsFile readFile =
       hdfsOpenFile(fs, uri.to_path().c_str(), O_RDONLY, length, 0, 0);
   if (!readFile) {
@@ -230,9 +248,12 @@ Status read(
       return LOG_STATUS(Status::HDFSError(
           "Cannot read from file " + uri.to_string() + "; File reading error"));
     }
+    if (bytes_read == 0)  // End of file
+      break;
     bytes_to_read -= bytes_read;
     buffptr += bytes_read;
   } while (bytes_to_read > 0);
+  *nbytes_read = length - bytes_to_read;
 
   // Close file
   if (hdfsCloseFile(fs, readFile)) {
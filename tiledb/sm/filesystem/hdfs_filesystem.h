@@ -147,6 +147,26 @@ Status read(
     void* buffer,
     uint64_t buffer_size);
 
+/**
+ * Reads up to the input number of bytes from a file into a buffer, stopping
+ * early at the end of the file.
+ *
+ * @param fs Connected hdfsFS filesystem handle.
+ * @param uri The URI of the file to be read.
+ * @param offset The offset in the file from which the read will start.
+ * @param buffer The buffer into which the data will be written.
+ * @param buffer_size The maximum size of the data to be read from the file.
+ * @param nbytes_read Set to the size of the data actually read.
+ * @return Status
+ */
+Status read_up_to(
+    hdfsFS fs,
+    const URI& uri,
+    off_t offset,
+    void* buffer,
+    uint64_t buffer_size,
+    uint64_t* nbytes_read);
+
 /**
  * Writes the input buffer to a file.
  *
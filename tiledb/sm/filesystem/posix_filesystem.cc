@@ -60,24 +60,28 @@ bool both_slashes(char a, char b) {
  * @param buffer Buffer to hold read data
  * @param nbytes Number of bytes to read
  * @param offset Offset in file to start reading from.
- * @return Number of bytes actually read (< nbytes on error).
+ * @param nread Set to the number of bytes actually read (< nbytes if the
+ *     end of the file is reached).
+ * @return Status
  */
-uint64_t read_all(int fd, void* buffer, uint64_t nbytes, uint64_t offset) {
+Status read_all(
+    int fd, void* buffer, uint64_t nbytes, uint64_t offset, uint64_t* nread) {
   auto bytes = reinterpret_cast<char*>(buffer);
-  uint64_t nread = 0;
+  *nread = 0;
   do {
     ssize_t actual_read =
-        ::pread(fd, bytes + nread, nbytes - nread, offset + nread);
+        ::pread(fd, bytes + *nread, nbytes - *nread, offset + *nread);
     if (actual_read == -1) {
-      LOG_STATUS(
+      return LOG_STATUS(
           Status::Error(std::string("POSIX pread error: ") + strerror(errno)));
-      return nread;
+    } else if (actual_read == 0) {
+      break;
     } else {
-      nread += actual_read;
+      *nread += actual_read;
     }
-  } while (nread < nbytes);
+  } while (*nread < nbytes);
 
-  return nread;
+  return Status::Ok();
 }
 
 /**
@@ -364,6 +368,22 @@ void purge_dots_from_path(std::string* path) {
 
 Status read(
     const std::string& path, uint64_t offset, void* buffer, uint64_t nbytes) {
+  uint64_t bytes_read;
+  RETURN_NOT_OK(read_up_to(path, offset, buffer, nbytes, &bytes_read));
+  if (bytes_read != nbytes) {
+    return LOG_STATUS(Status::IOError(
+        std::string("Cannot read from file '") + path.c_str() +
+        "'; File reading error"));
+  }
+  return Status::Ok();
+}
+
+Status read_up_to(
+    const std::string& path,
+    uint64_t offset,
+    void* buffer,
+    uint64_t nbytes,
+    uint64_t* nbytes_read) {
   // Open file
   int fd = open(path.c_str(), O_RDONLY);
   if (fd == -1) {
@@ -371,27 +391,24 @@ Status read(
         std::string("Cannot read from file; ") + strerror(errno)));
   }
   if (offset > std::numeric_limits<off_t>::max()) {
+    close(fd);
     return LOG_STATUS(Status::IOError(
         std::string("Cannot read from file ' ") + path.c_str() +
         "'; offset > typemax(off_t)"));
   }
   if (nbytes > SSIZE_MAX) {
+    close(fd);
     return LOG_STATUS(Status::IOError(
         std::string("Cannot read from file ' ") + path.c_str() +
         "'; nbytes > SSIZE_MAX"));
   }
-  uint64_t bytes_read = read_all(fd, buffer, nbytes, offset);
-  if (bytes_read != nbytes) {
-    return LOG_STATUS(Status::IOError(
-        std::string("Cannot read from file '") + path.c_str() +
-        "'; File reading error"));
-  }
+  Status st = read_all(fd, buffer, nbytes, offset, nbytes_read);
   // Close file
-  if (close(fd)) {
+  if (close(fd) && st.ok()) {
     return LOG_STATUS(Status::IOError(
         std::string("Cannot read from file; ") + strerror(errno)));
   }
-  return Status::Ok();
+  return st;
 }
 
 Status sync(const std::string& path) {
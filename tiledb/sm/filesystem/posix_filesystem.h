@@ -183,6 +183,24 @@ void purge_dots_from_path(std::string* path);
 Status read(
     const std::string& path, uint64_t offset, void* buffer, uint64_t nbytes);
 
+/**
+ * Reads up to the input number of bytes from a file into a buffer, stopping
+ * early at the end of the file.
+ *
+ * @param path The name of the file.
+ * @param offset The offset in the file from which the read will start.
+ * @param buffer The buffer into which the data will be written.
+ * @param nbytes The maximum size of the data to be read from the file.
+ * @param nbytes_read Set to the size of the data actually read.
+ * @return Status.
+ */
+Status read_up_to(
+    const std::string& path,
+    uint64_t offset,
+    void* buffer,
+    uint64_t nbytes,
+    uint64_t* nbytes_read);
+
 /**
  * Syncs a file or directory.
  *
@@ -192,33 +192,51 @@ Status S3::flush_object(const URI& uri) {
   RETURN_NOT_OK(get_file_buffer(uri, &buff));
   RETURN_NOT_OK(flush_file_buffer(uri, buff, true));
   delete buff;
-  file_buffers_.erase(uri.to_string());
 
   Aws::Http::URI aws_uri = uri.c_str();
   std::string path_c_str = aws_uri.GetPath().c_str();
 
-  // Do nothing - empty object
-  auto multipart_upload_it = multipart_upload_.find(path_c_str);
-  if (multipart_upload_it == multipart_upload_.end())
-    return Status::Ok();
+  // Remove the upload state of the object, as other objects may be written
+  // concurrently
+  Aws::S3::Model::CompletedMultipartUpload completed_multipart_upload;
+  Aws::S3::Model::CompleteMultipartUploadRequest
+      complete_multipart_upload_request;
+  std::map<int, Aws::S3::Model::CompletedPart> completed_parts;
+  {
+    std::unique_lock<std::mutex> lck(multipart_upload_mtx_);
+    file_buffers_.erase(uri.to_string());
 
-  // Get the completed upload object
-  auto completed_multipart_upload = multipart_upload_it->second;
+    // Do nothing - empty object
+    auto multipart_upload_it = multipart_upload_.find(path_c_str);
+    if (multipart_upload_it == multipart_upload_.end())
+      return Status::Ok();
 
-  // Add all the completed parts (sorted by part number) to the upload object.
-  auto completed_parts_it = multipart_upload_completed_parts_.find(path_c_str);
-  if (completed_parts_it == multipart_upload_completed_parts_.end()) {
-    return LOG_STATUS(Status::S3Error(
-        "Unable to find completed parts list for S3 object " +
-        uri.to_string()));
+    // Get the completed upload object
+    completed_multipart_upload = multipart_upload_it->second;
+
+    auto completed_parts_it =
+        multipart_upload_completed_parts_.find(path_c_str);
+    if (completed_parts_it == multipart_upload_completed_parts_.end()) {
+      return LOG_STATUS(Status::S3Error(
+          "Unable to find completed parts list for S3 object " +
+          uri.to_string()));
+    }
+    completed_parts = completed_parts_it->second;
+    complete_multipart_upload_request = multipart_upload_request_[path_c_str];
+
+    multipart_upload_IDs_.erase(path_c_str);
+    multipart_upload_part_number_.erase(path_c_str);
+    multipart_upload_request_.erase(path_c_str);
+    multipart_upload_.erase(multipart_upload_it);
+    multipart_upload_completed_parts_.erase(completed_parts_it);
   }
-  for (auto& tup : completed_parts_it->second) {
+
+  // Add all the completed parts (sorted by part number) to the upload object.
+  for (auto& tup : completed_parts) {
     Aws::S3::Model::CompletedPart& part = std::get<1>(tup);
     completed_multipart_upload.AddParts(part);
   }
 
-  auto multipart_upload_request_it = multipart_upload_request_.find(path_c_str);
-  auto complete_multipart_upload_request = multipart_upload_request_it->second;
   complete_multipart_upload_request.WithMultipartUpload(
       completed_multipart_upload);
   auto complete_multipart_upload_outcome =
@@ -227,11 +245,6 @@ Status S3::flush_object(const URI& uri) {
   wait_for_object_to_propagate(
       complete_multipart_upload_request.GetBucket(),
       complete_multipart_upload_request.GetKey());
-  multipart_upload_IDs_.erase(path_c_str);
-  multipart_upload_part_number_.erase(path_c_str);
-  multipart_upload_request_.erase(multipart_upload_request_it);
-  multipart_upload_.erase(multipart_upload_it);
-  multipart_upload_completed_parts_.erase(path_c_str);
 
   //  fails when flushing directories or removed files
   if (!complete_multipart_upload_outcome.IsSuccess()) {
@@ -396,11 +409,28 @@ Status S3::object_size(const URI& uri, uint64_t* nbytes) const {
 
 Status S3::read(
     const URI& uri, off_t offset, void* buffer, uint64_t length) const {
+  uint64_t length_read;
+  RETURN_NOT_OK(read_up_to(uri, offset, buffer, length, &length_read));
+  if (length_read != length) {
+    return LOG_STATUS(Status::S3Error(
+        std::string("Read operation returned different size of bytes.")));
+  }
+
+  return Status::Ok();
+}
+
+Status S3::read_up_to(
+    const URI& uri,
+    off_t offset,
+    void* buffer,
+    uint64_t length,
+    uint64_t* length_read) const {
   if (!uri.is_s3()) {
     return LOG_STATUS(Status::S3Error(
         std::string("URI is not an S3 URI: " + uri.to_string())));
   }
 
+  // A range past the end of the object returns the bytes up to its end
   Aws::Http::URI aws_uri = uri.c_str();
   Aws::S3::Model::GetObjectRequest get_object_request;
   get_object_request.WithBucket(aws_uri.GetAuthority())
@@ -422,7 +452,8 @@ Status S3::read(
         std::string("\nError message:  ") +
         get_object_outcome.GetError().GetMessage().c_str()));
   }
-  if ((uint64_t)get_object_outcome.GetResult().GetContentLength() != length) {
+  *length_read = (uint64_t)get_object_outcome.GetResult().GetContentLength();
+  if (*length_read > length) {
     return LOG_STATUS(Status::S3Error(
         std::string("Read operation returned different size of bytes.")));
   }
@@ -606,6 +637,7 @@ Status S3::flush_file_buffer(const URI& uri, Buffer* buff, bool last_part) {
 }
 
 Status S3::get_file_buffer(const URI& uri, Buffer** buff) {
+  std::unique_lock<std::mutex> lck(multipart_upload_mtx_);
   auto uri_str = uri.to_string();
   auto it = file_buffers_.find(uri_str);
   if (it == file_buffers_.end()) {
@@ -638,17 +670,16 @@ Status S3::initiate_multipart_request(Aws::Http::URI aws_uri) {
         multipart_upload_outcome.GetError().GetMessage().c_str()));
   }
 
-  multipart_upload_IDs_[path_c_str] =
-      multipart_upload_outcome.GetResult().GetUploadId();
-  multipart_upload_part_number_[path_c_str] = 1;
-
+  auto upload_id = multipart_upload_outcome.GetResult().GetUploadId();
   Aws::S3::Model::CompleteMultipartUploadRequest
       complete_multipart_upload_request;
   complete_multipart_upload_request.SetBucket(aws_uri.GetAuthority());
   complete_multipart_upload_request.SetKey(path);
-  complete_multipart_upload_request.SetUploadId(
-      multipart_upload_IDs_[path_c_str]);
+  complete_multipart_upload_request.SetUploadId(upload_id);
 
+  std::unique_lock<std::mutex> lck(multipart_upload_mtx_);
+  multipart_upload_IDs_[path_c_str] = upload_id;
+  multipart_upload_part_number_[path_c_str] = 1;
   Aws::S3::Model::CompletedMultipartUpload completed_multipart_upload;
   multipart_upload_[path_c_str] = completed_multipart_upload;
   multipart_upload_request_[path_c_str] = complete_multipart_upload_request;
@@ -736,7 +767,13 @@ Status S3::write_multipart(
   Aws::Http::URI aws_uri = uri.c_str();
   auto& path = aws_uri.GetPath();
   std::string path_c_str = path.c_str();
-  if (multipart_upload_IDs_.find(path_c_str) == multipart_upload_IDs_.end()) {
+  bool initiated;
+  {
+    std::unique_lock<std::mutex> lck(multipart_upload_mtx_);
+    initiated =
+        multipart_upload_IDs_.find(path_c_str) != multipart_upload_IDs_.end();
+  }
+  if (!initiated) {
     // Delete file if it exists (overwrite) and initiate multipart request
     if (is_object(uri))
       RETURN_NOT_OK(remove_object(uri));
@@ -746,19 +783,25 @@ Status S3::write_multipart(
     }
   }
 
-  // Get the upload ID
-  auto upload_id = multipart_upload_IDs_[path_c_str];
+  // Get the upload ID and reserve the part number(s). Other objects may be
+  // written concurrently, so the upload state is accessed under the lock.
+  Aws::String upload_id;
+  int part_num_base;
+  {
+    std::unique_lock<std::mutex> lck(multipart_upload_mtx_);
+    upload_id = multipart_upload_IDs_[path_c_str];
+    part_num_base = multipart_upload_part_number_[path_c_str];
+    multipart_upload_part_number_[path_c_str] += (int)num_ops;
+  }
 
-  // Assign the part number(s), and make the write request.
+  // Make the write request(s)
   if (num_ops == 1) {
-    int part_num = multipart_upload_part_number_[path_c_str]++;
-    return make_upload_part_req(uri, buffer, length, upload_id, part_num);
+    return make_upload_part_req(uri, buffer, length, upload_id, part_num_base);
   } else {
     STATS_COUNTER_ADD(vfs_s3_write_num_parallelized, 1);
 
     std::vector<std::future<Status>> results;
     uint64_t bytes_per_op = multipart_part_size_;
-    int part_num_base = multipart_upload_part_number_[path_c_str];
     for (uint64_t i = 0; i < num_ops; i++) {
       uint64_t begin = i * bytes_per_op,
                end = std::min((i + 1) * bytes_per_op - 1, length - 1);
@@ -771,8 +814,6 @@ Status S3::write_multipart(
                 uri, thread_buffer, thread_nbytes, upload_id, part_num);
           }));
     }
-    multipart_upload_part_number_[path_c_str] += num_ops;
-
     bool all_ok = vfs_thread_pool_->wait_all(results);
     return all_ok ?
                Status::Ok() :
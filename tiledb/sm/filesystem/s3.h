@@ -270,6 +270,24 @@ class S3 {
   Status read(
       const URI& uri, off_t offset, void* buffer, uint64_t length) const;
 
+  /**
+   * Reads up to the input number of bytes from an object into a buffer,
+   * stopping early at the end of the object.
+   *
+   * @param uri The URI of the object to be read.
+   * @param offset The offset in the object from which the read will start.
+   * @param buffer The buffer into which the data will be written.
+   * @param length The maximum size of the data to be read from the object.
+   * @param length_read Set to the size of the data actually read.
+   * @return Status
+   */
+  Status read_up_to(
+      const URI& uri,
+      off_t offset,
+      void* buffer,
+      uint64_t length,
+      uint64_t* length_read) const;
+
   /**
    * Deletes a bucket.
    *
@@ -364,7 +382,10 @@ class S3 {
   std::unordered_map<std::string, std::map<int, Aws::S3::Model::CompletedPart>>
       multipart_upload_completed_parts_;
 
-  /** Used for synchronization in async multi-part uploads. */
+  /**
+   * Protects the multi-part upload state and the file buffers, as different
+   * objects may be written concurrently.
+   */
   std::mutex multipart_upload_mtx_;
 
   /** The length of a non-terminal multipart part. */
@@ -705,6 +705,44 @@ Status VFS::read(
   STATS_FUNC_OUT(vfs_read);
 }
 
+Status VFS::read_up_to(
+    const URI& uri,
+    uint64_t offset,
+    void* buffer,
+    uint64_t nbytes,
+    uint64_t* nbytes_read) const {
+  STATS_FUNC_IN(vfs_read);
+  STATS_COUNTER_ADD(vfs_read_total_bytes, nbytes);
+
+  if (uri.is_file()) {
+#ifdef _WIN32
+    return win::read_up_to(uri.to_path(), offset, buffer, nbytes, nbytes_read);
+#else
+    return posix::read_up_to(
+        uri.to_path(), offset, buffer, nbytes, nbytes_read);
+#endif
+  }
+  if (uri.is_hdfs()) {
+#ifdef HAVE_HDFS
+    return hdfs::read_up_to(hdfs_, uri, offset, buffer, nbytes, nbytes_read);
+#else
+    return LOG_STATUS(
+        Status::VFSError("TileDB was built without HDFS support"));
+#endif
+  }
+  if (uri.is_s3()) {
+#ifdef HAVE_S3
+    return s3_.read_up_to(uri, offset, buffer, nbytes, nbytes_read);
+#else
+    return LOG_STATUS(Status::VFSError("TileDB was built without S3 support"));
+#endif
+  }
+  return LOG_STATUS(
+      Status::VFSError("Unsupported URI schemes: " + uri.to_string()));
+
+  STATS_FUNC_OUT(vfs_read);
+}
+
 Status VFS::read_impl(
     const URI& uri, uint64_t offset, void* buffer, uint64_t nbytes) const {
   if (uri.is_file()) {
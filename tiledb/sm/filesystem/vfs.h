@@ -263,6 +263,25 @@ class VFS {
   Status read(
       const URI& uri, uint64_t offset, void* buffer, uint64_t nbytes) const;
 
+  /**
+   * Reads up to the input number of bytes from a file, stopping early at the
+   * end of the file. Unlike `read()`, this issues a single request to the
+   * backend, which makes it suitable for speculative reads of small objects.
+   *
+   * @param uri The URI of the file.
+   * @param offset The offset where the read begins.
+   * @param buffer The buffer to read into.
+   * @param nbytes Maximum number of bytes to read.
+   * @param nbytes_read Set to the number of bytes actually read.
+   * @return Status
+   */
+  Status read_up_to(
+      const URI& uri,
+      uint64_t offset,
+      void* buffer,
+      uint64_t nbytes,
+      uint64_t* nbytes_read) const;
+
   /** Checks if a given filesystem is supported. */
   bool supports_fs(Filesystem fs) const;
 
@@ -332,6 +332,21 @@ Status move_path(const std::string& old_path, const std::string& new_path) {
 
 Status read(
     const std::string& path, uint64_t offset, void* buffer, uint64_t nbytes) {
+  uint64_t bytes_read;
+  RETURN_NOT_OK(read_up_to(path, offset, buffer, nbytes, &bytes_read));
+  if (bytes_read != nbytes) {
+    return LOG_STATUS(Status::IOError(
+        "Cannot read from file '" + path + "'; File read error"));
+  }
+  return Status::Ok();
+}
+
+Status read_up_to(
+    const std::string& path,
+    uint64_t offset,
+    void* buffer,
+    uint64_t nbytes,
+    uint64_t* nbytes_read) {
   // Open the file (OPEN_EXISTING with CreateFile() will only open, not create,
   // the file).
   HANDLE file_h = CreateFile(
@@ -355,13 +370,14 @@ Status read(
         "Cannot read from file '" + path + "'; File seek error"));
   }
 
+  // A read at the end of the file succeeds, reading fewer bytes
   unsigned long num_bytes_read = 0;
-  if (ReadFile(file_h, buffer, nbytes, &num_bytes_read, NULL) == 0 ||
-      num_bytes_read != nbytes) {
+  if (ReadFile(file_h, buffer, nbytes, &num_bytes_read, NULL) == 0) {
     CloseHandle(file_h);
     return LOG_STATUS(Status::IOError(
         "Cannot read from file '" + path + "'; File read error"));
   }
+  *nbytes_read = num_bytes_read;
 
   if (CloseHandle(file_h) == 0) {
     return LOG_STATUS(Status::IOError(
@@ -0,0 +1,283 @@
+/**
+ * @file   dictionary_encoding.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2018 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file implements class DictionaryEncoding.
+ */
+
+#include "tiledb/sm/filter/dictionary_encoding.h"
+#include "tiledb/sm/misc/constants.h"
+#include "tiledb/sm/misc/logger.h"
+#include "tiledb/sm/misc/utils.h"
+
+#include <cstring>
+#include <limits>
+#include <string>
+#include <unordered_map>
+
+namespace tiledb {
+namespace sm {
+
+/* ****************************** */
+/*        STATIC FUNCTIONS        */
+/* ****************************** */
+
+/** Tag of the plain form of an encoded tile. */
+static const uint8_t dictionary_form_plain = 0;
+
+/** Tag of the dictionary form of an encoded tile. */
+static const uint8_t dictionary_form_dictionary = 1;
+
+/** Returns the `i`-th (possibly unaligned) 64-bit word at `data`. */
+static inline uint64_t dictionary_word(const unsigned char* data, uint64_t i) {
+  uint64_t word;
+  std::memcpy(&word, data + i * sizeof(uint64_t), sizeof(uint64_t));
+  return word;
+}
+
+/* ****************************** */
+/*   CONSTRUCTORS & DESTRUCTORS   */
+/* ****************************** */
+
+DictionaryEncoding::DictionaryEncoding()
+    : bitsize_(0)
+    , cell_num_(0)
+    , codes_(nullptr)
+    , mask_(0)
+    , plain_(true)
+    , values_(nullptr)
+    , values_size_(0) {
+}
+
+DictionaryEncoding::~DictionaryEncoding() = default;
+
+/* ****************************** */
+/*               API              */
+/* ****************************** */
+
+Status DictionaryEncoding::cell(
+    uint64_t i, const unsigned char** value, uint64_t* size) const {
+  if (plain_ || i >= cell_num_)
+    return LOG_STATUS(Status::FilterError(
+        "Cannot retrieve dictionary encoded cell; Invalid cell position"));
+
+  // Unpack the code of the cell
+  uint64_t code = 0;
+  if (bitsize_ > 0) {
+    uint64_t bit = i * bitsize_;
+    uint64_t word = bit / 64;
+    auto off = (unsigned)(bit % 64);
+    code = dictionary_word(codes_, word) >> off;
+    if (off + bitsize_ > 64)
+      code |= dictionary_word(codes_, word + 1) << (64 - off);
+    code &= mask_;
+  }
+  if (code + 1 >= value_offsets_.size())
+    return LOG_STATUS(Status::FilterError(
+        "Cannot retrieve dictionary encoded cell; Invalid code"));
+
+  *value = values_ + value_offsets_[code];
+  *size = value_offsets_[code + 1] - value_offsets_[code];
+
+  return Status::Ok();
+}
+
+uint64_t DictionaryEncoding::cell_num() const {
+  return cell_num_;
+}
+
+Status DictionaryEncoding::decode(ConstBuffer* input, Buffer* output) {
+  DictionaryEncoding dictionary;
+  RETURN_NOT_OK(dictionary.init(
+      (const char*)input->data() + input->offset(),
+      input->nbytes_left_to_read()));
+  input->advance_offset(input->nbytes_left_to_read());
+
+  if (dictionary.plain())
+    return output->write(dictionary.plain_data(), dictionary.plain_size());
+
+  const unsigned char* value;
+  uint64_t size;
+  for (uint64_t i = 0; i < dictionary.cell_num(); ++i) {
+    RETURN_NOT_OK(dictionary.cell(i, &value, &size));
+    RETURN_NOT_OK(output->write(value, size));
+  }
+
+  return Status::Ok();
+}
+
+Status DictionaryEncoding::encode(
+    const Tile* tile, const Tile* tile_var, Buffer* output) {
+  // For easy reference
+  uint64_t cell_num = tile->size() / constants::cell_var_offset_size;
+  auto offsets = (const uint64_t*)tile->data();
+  auto data = (const char*)tile_var->data();
+  uint64_t size = tile_var->size();
+
+  // Collect the distinct values, giving up as soon as they take as much
+  // space as all the values
+  std::unordered_map<std::string, uint64_t> value_codes;
+  std::vector<uint64_t> codes(cell_num);
+  std::vector<uint64_t> value_offsets;
+  std::vector<const char*> value_data;
+  uint64_t values_size = 0;
+  bool dictionary = cell_num > 0;
+  for (uint64_t i = 0; i < cell_num && dictionary; ++i) {
+    uint64_t start = offsets[i] - offsets[0];
+    uint64_t end = (i + 1 < cell_num) ? offsets[i + 1] - offsets[0] : size;
+    if (start > end || end > size)
+      return LOG_STATUS(Status::FilterError(
+          "Cannot dictionary encode tile; Invalid cell offsets"));
+
+    std::string value(data + start, end - start);
+    auto it = value_codes.find(value);
+    if (it != value_codes.end()) {
+      codes[i] = it->second;
+      continue;
+    }
+    codes[i] = value_offsets.size();
+    value_codes.emplace(std::move(value), codes[i]);
+    value_offsets.push_back(values_size);
+    value_data.push_back(data + start);
+    values_size += end - start;
+    dictionary =
+        values_size + value_offsets.size() * sizeof(uint64_t) < size;
+  }
+
+  // Keep the plain form unless the dictionary form is smaller
+  uint64_t value_num = value_offsets.size();
+  unsigned bitsize = (value_num > 1) ? utils::bit_width(value_num - 1) : 0;
+  uint64_t word_num = (cell_num * bitsize + 63) / 64;
+  uint64_t dictionary_size = sizeof(uint8_t) + 3 * sizeof(uint64_t) +
+                             value_num * sizeof(uint64_t) + values_size +
+                             sizeof(uint8_t) + word_num * sizeof(uint64_t);
+  if (!dictionary || dictionary_size >= sizeof(uint8_t) + size) {
+    RETURN_NOT_OK(output->write(&dictionary_form_plain, sizeof(uint8_t)));
+    return output->write(data, size);
+  }
+
+  // Write the dictionary
+  RETURN_NOT_OK(output->write(&dictionary_form_dictionary, sizeof(uint8_t)));
+  RETURN_NOT_OK(output->write(&cell_num, sizeof(uint64_t)));
+  RETURN_NOT_OK(output->write(&value_num, sizeof(uint64_t)));
+  RETURN_NOT_OK(output->write(&values_size, sizeof(uint64_t)));
+  RETURN_NOT_OK(
+      output->write(value_offsets.data(), value_num * sizeof(uint64_t)));
+  for (uint64_t i = 0; i < value_num; ++i) {
+    uint64_t value_size = ((i + 1 < value_num) ? value_offsets[i + 1] :
+                                                 values_size) -
+                          value_offsets[i];
+    RETURN_NOT_OK(output->write(value_data[i], value_size));
+  }
+
+  // Write the packed codes
+  auto bitsize_c = (uint8_t)bitsize;
+  RETURN_NOT_OK(output->write(&bitsize_c, sizeof(uint8_t)));
+  std::vector<uint64_t> words(word_num, 0);
+  for (uint64_t i = 0, bit = 0; bitsize > 0 && i < cell_num;
+       ++i, bit += bitsize) {
+    uint64_t word = bit / 64;
+    auto off = (unsigned)(bit % 64);
+    words[word] |= codes[i] << off;
+    if (off + bitsize > 64)
+      words[word + 1] |= codes[i] >> (64 - off);
+  }
+  return output->write(words.data(), word_num * sizeof(uint64_t));
+}
+
+Status DictionaryEncoding::init(const void* data, uint64_t size) {
+  // Parse the form
+  auto in = (const unsigned char*)data;
+  if (size < sizeof(uint8_t) || (in[0] != dictionary_form_plain &&
+                                 in[0] != dictionary_form_dictionary))
+    return LOG_STATUS(Status::FilterError(
+        "Cannot parse dictionary encoded tile; Invalid tile format"));
+  plain_ = in[0] == dictionary_form_plain;
+  if (plain_) {
+    values_ = in + sizeof(uint8_t);
+    values_size_ = size - sizeof(uint8_t);
+    return Status::Ok();
+  }
+
+  // Parse the dictionary
+  ConstBuffer buff(data, size);
+  buff.advance_offset(sizeof(uint8_t));
+  uint64_t value_num = 0;
+  RETURN_NOT_OK(buff.read(&cell_num_, sizeof(uint64_t)));
+  RETURN_NOT_OK(buff.read(&value_num, sizeof(uint64_t)));
+  RETURN_NOT_OK(buff.read(&values_size_, sizeof(uint64_t)));
+  if (value_num > buff.nbytes_left_to_read() / sizeof(uint64_t))
+    return LOG_STATUS(Status::FilterError(
+        "Cannot parse dictionary encoded tile; Invalid number of values"));
+  value_offsets_.resize(value_num + 1);
+  RETURN_NOT_OK(
+      buff.read(value_offsets_.data(), value_num * sizeof(uint64_t)));
+  value_offsets_[value_num] = values_size_;
+  for (uint64_t i = 0; i < value_num; ++i) {
+    if (value_offsets_[i] > value_offsets_[i + 1])
+      return LOG_STATUS(Status::FilterError(
+          "Cannot parse dictionary encoded tile; Invalid value offsets"));
+  }
+  if (values_size_ > buff.nbytes_left_to_read())
+    return LOG_STATUS(Status::FilterError(
+        "Cannot parse dictionary encoded tile; Invalid values size"));
+  values_ = in + buff.offset();
+  buff.advance_offset(values_size_);
+
+  // Parse the codes
+  uint8_t bitsize = 0;
+  RETURN_NOT_OK(buff.read(&bitsize, sizeof(uint8_t)));
+  bitsize_ = bitsize;
+  uint64_t word_num = buff.nbytes_left_to_read() / sizeof(uint64_t);
+  if (bitsize_ > 64 ||
+      (bitsize_ > 0 && cell_num_ > word_num * 64 / bitsize_) ||
+      buff.nbytes_left_to_read() !=
+          (cell_num_ * bitsize_ + 63) / 64 * sizeof(uint64_t))
+    return LOG_STATUS(Status::FilterError(
+        "Cannot parse dictionary encoded tile; Invalid codes"));
+  mask_ = (bitsize_ == 64) ? std::numeric_limits<uint64_t>::max() :
+                             (uint64_t(1) << bitsize_) - 1;
+  codes_ = in + buff.offset();
+
+  return Status::Ok();
+}
+
+bool DictionaryEncoding::plain() const {
+  return plain_;
+}
+
+const unsigned char* DictionaryEncoding::plain_data() const {
+  return values_;
+}
+
+uint64_t DictionaryEncoding::plain_size() const {
+  return values_size_;
+}
+
+}  // namespace sm
+}  // namespace tiledb
@@ -0,0 +1,172 @@
+/**
+ * @file   dictionary_encoding.h
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2018 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file defines class DictionaryEncoding.
+ */
+
+#ifndef TILEDB_DICTIONARY_ENCODING_H
+#define TILEDB_DICTIONARY_ENCODING_H
+
+#include <vector>
+
+#include "tiledb/sm/buffer/buffer.h"
+#include "tiledb/sm/buffer/const_buffer.h"
+#include "tiledb/sm/misc/status.h"
+#include "tiledb/sm/tile/tile.h"
+
+namespace tiledb {
+namespace sm {
+
+/**
+ * Dictionary encoding of the values tile of a var-sized string attribute,
+ * applied when the filter pipeline of the attribute contains the dictionary
+ * filter. The offsets tile is stored unchanged, whereas the values tile is
+ * replaced by one of the following before it is filtered and compressed:
+ *
+ * PLAIN (uint8_t) | values
+ *
+ * or
+ *
+ * DICTIONARY (uint8_t) | cell_num (uint64_t) | value_num (uint64_t) |
+ * values_size (uint64_t) | value_offset_0 (uint64_t) | ... |
+ * value_offset_{value_num-1} (uint64_t) | values | bitsize (uint8_t) |
+ * code_0 | code_1 | ... | code_{cell_num-1}
+ *
+ * where *values* holds the distinct values of the tile concatenated in the
+ * order they first appear, and *code_i* is the index of the value of the
+ * i-th cell among them. The codes are packed with *bitsize* bits each into
+ * 64-bit words. The dictionary form is chosen only if it is smaller than
+ * the plain one, so tiles with many distinct values cost a single byte.
+ *
+ * Readers may either decode an encoded tile as a whole, or look up the
+ * values of individual cells directly from the encoded tile.
+ */
+class DictionaryEncoding {
+ public:
+  /* ********************************* */
+  /*     CONSTRUCTORS & DESTRUCTORS    */
+  /* ********************************* */
+
+  /** Constructor. */
+  DictionaryEncoding();
+
+  /** Destructor. */
+  ~DictionaryEncoding();
+
+  /* ********************************* */
+  /*                API                */
+  /* ********************************* */
+
+  /**
+   * Retrieves the value of a cell of a dictionary encoded tile.
+   *
+   * @param i The position of the cell in the tile.
+   * @param value Set to point to the first byte of the value.
+   * @param size Set to the size of the value in bytes.
+   * @return Status
+   */
+  Status cell(uint64_t i, const unsigned char** value, uint64_t* size) const;
+
+  /** Returns the number of cells of a dictionary encoded tile. */
+  uint64_t cell_num() const;
+
+  /**
+   * Decodes an encoded values tile as a whole.
+   *
+   * @param input The encoded tile.
+   * @param output The buffer the original values are appended to.
+   * @return Status
+   */
+  static Status decode(ConstBuffer* input, Buffer* output);
+
+  /**
+   * Encodes a values tile.
+   *
+   * @param tile The offsets tile of the cells.
+   * @param tile_var The values tile of the cells.
+   * @param output The buffer the encoded tile is appended to.
+   * @return Status
+   */
+  static Status encode(const Tile* tile, const Tile* tile_var, Buffer* output);
+
+  /**
+   * Parses an encoded values tile, which must outlive this object.
+   *
+   * @param data The encoded tile.
+   * @param size The size of the encoded tile.
+   * @return Status
+   */
+  Status init(const void* data, uint64_t size);
+
+  /** Returns *true* if the parsed tile is in the plain form. */
+  bool plain() const;
+
+  /** Returns the values of a tile in the plain form. */
+  const unsigned char* plain_data() const;
+
+  /** Returns the size of the values of a tile in the plain form. */
+  uint64_t plain_size() const;
+
+ private:
+  /* ********************************* */
+  /*         PRIVATE ATTRIBUTES        */
+  /* ********************************* */
+
+  /** The number of bits of each code. */
+  unsigned bitsize_;
+
+  /** The number of cells. */
+  uint64_t cell_num_;
+
+  /** The packed codes. */
+  const unsigned char* codes_;
+
+  /** Mask selecting the bits of a code. */
+  uint64_t mask_;
+
+  /** *true* if the tile is in the plain form. */
+  bool plain_;
+
+  /** The plain values, or the distinct values of the dictionary. */
+  const unsigned char* values_;
+
+  /**
+   * The offsets of the distinct values, followed by the size of all the
+   * values.
+   */
+  std::vector<uint64_t> value_offsets_;
+
+  /** The size of `values_`. */
+  uint64_t values_size_;
+};
+
+}  // namespace sm
+}  // namespace tiledb
+
+#endif  // TILEDB_DICTIONARY_ENCODING_H
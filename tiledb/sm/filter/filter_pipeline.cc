@@ -0,0 +1,756 @@
+/**
+ * @file   filter_pipeline.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2018 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file implements class FilterPipeline.
+ */
+
+#include "tiledb/sm/filter/filter_pipeline.h"
+#include "tiledb/sm/misc/constants.h"
+#include "tiledb/sm/misc/logger.h"
+#include "tiledb/sm/misc/utils.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+namespace tiledb {
+namespace sm {
+
+/* ****************************** */
+/*        FILTER FUNCTIONS        */
+/* ****************************** */
+
+/**
+ * Makes room for `nbytes` bytes at the end of `output` and returns a
+ * pointer to them in `dst`. The caller must then call `commit_output`.
+ */
+static Status prepare_output(
+    Buffer* output, uint64_t nbytes, unsigned char** dst) {
+  // Always allocate, so that `dst` is valid even for empty outputs
+  auto alloc_size = output->size() + std::max<uint64_t>(nbytes, 1);
+  RETURN_NOT_OK(output->realloc(alloc_size));
+  *dst = (unsigned char*)output->data(output->size());
+  return Status::Ok();
+}
+
+/** Appends `nbytes` bytes previously written by the caller to `output`. */
+static void commit_output(Buffer* output, uint64_t nbytes) {
+  output->advance_size(nbytes);
+  output->set_offset(output->size());
+}
+
+/** Byte shuffle: the i-th byte of all values is stored contiguously. */
+static Status byteshuffle(
+    bool reverse, uint64_t value_size, ConstBuffer* input, Buffer* output) {
+  auto in = (const unsigned char*)input->data();
+  auto nbytes = input->size();
+  auto value_num = nbytes / value_size;
+  unsigned char* out;
+  RETURN_NOT_OK(prepare_output(output, nbytes, &out));
+
+  for (uint64_t i = 0; i < value_num; ++i) {
+    for (uint64_t j = 0; j < value_size; ++j) {
+      if (!reverse)
+        out[j * value_num + i] = in[i * value_size + j];
+      else
+        out[i * value_size + j] = in[j * value_num + i];
+    }
+  }
+
+  auto done = value_num * value_size;
+  std::memcpy(out + done, in + done, nbytes - done);
+  commit_output(output, nbytes);
+
+  return Status::Ok();
+}
+
+/**
+ * Bit shuffle: the values are processed in groups of 8, and the i-th bit of
+ * all grouped values is stored contiguously. Any values that do not form a
+ * whole group are copied as they are.
+ */
+static Status bitshuffle(
+    bool reverse, uint64_t value_size, ConstBuffer* input, Buffer* output) {
+  auto in = (const unsigned char*)input->data();
+  auto nbytes = input->size();
+  auto group_num = nbytes / value_size / 8;
+  unsigned char* out;
+  RETURN_NOT_OK(prepare_output(output, nbytes, &out));
+
+  // Each of the (8 * value_size) bit planes stores one bit of every value
+  // and, hence, occupies `group_num` bytes
+  for (uint64_t g = 0; g < group_num; ++g) {
+    for (uint64_t j = 0; j < value_size; ++j) {
+      if (!reverse) {
+        unsigned char bytes[8];
+        for (uint64_t t = 0; t < 8; ++t)
+          bytes[t] = in[(g * 8 + t) * value_size + j];
+        for (uint64_t k = 0; k < 8; ++k) {
+          unsigned char plane = 0;
+          for (uint64_t t = 0; t < 8; ++t)
+            plane |= (unsigned char)(((bytes[t] >> k) & 1) << t);
+          out[(j * 8 + k) * group_num + g] = plane;
+        }
+      } else {
+        unsigned char bytes[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+        for (uint64_t k = 0; k < 8; ++k) {
+          unsigned char plane = in[(j * 8 + k) * group_num + g];
+          for (uint64_t t = 0; t < 8; ++t)
+            bytes[t] |= (unsigned char)(((plane >> t) & 1) << k);
+        }
+        for (uint64_t t = 0; t < 8; ++t)
+          out[(g * 8 + t) * value_size + j] = bytes[t];
+      }
+    }
+  }
+
+  auto done = group_num * 8 * value_size;
+  std::memcpy(out + done, in + done, nbytes - done);
+  commit_output(output, nbytes);
+
+  return Status::Ok();
+}
+
+/** Delta: each value is replaced by its difference from the previous one. */
+template <class T>
+static Status delta(bool reverse, ConstBuffer* input, Buffer* output) {
+  auto in = (const unsigned char*)input->data();
+  auto nbytes = input->size();
+  auto value_num = nbytes / sizeof(T);
+  unsigned char* out;
+  RETURN_NOT_OK(prepare_output(output, nbytes, &out));
+
+  T prev = 0, value;
+  for (uint64_t i = 0; i < value_num; ++i) {
+    std::memcpy(&value, in + i * sizeof(T), sizeof(T));
+    T result = reverse ? (T)(prev + value) : (T)(value - prev);
+    prev = reverse ? result : value;
+    std::memcpy(out + i * sizeof(T), &result, sizeof(T));
+  }
+
+  auto done = value_num * sizeof(T);
+  std::memcpy(out + done, in + done, nbytes - done);
+  commit_output(output, nbytes);
+
+  return Status::Ok();
+}
+
+/** Number of bytes needed to pack `num` values of `bits` bits each. */
+static uint64_t packed_size(uint64_t num, unsigned int bits) {
+  return (num * bits + 7) / 8;
+}
+
+/**
+ * ORs the `bits` lowest bits of `value` into the packed array `packed` of
+ * `nbytes` bytes, starting at bit `pos`.
+ */
+static void pack_value(
+    unsigned char* packed,
+    uint64_t nbytes,
+    uint64_t pos,
+    unsigned int bits,
+    uint64_t value) {
+  auto byte = pos / 8;
+  auto shift = (unsigned int)(pos % 8);
+  auto len = std::min<uint64_t>(sizeof(uint64_t), nbytes - byte);
+  uint64_t word = 0;
+  std::memcpy(&word, packed + byte, len);
+  word |= value << shift;
+  std::memcpy(packed + byte, &word, len);
+  if (shift + bits > 64)
+    packed[byte + 8] |= (unsigned char)(value >> (64 - shift));
+}
+
+/** Reads the `bits`-bit value starting at bit `pos` of `packed`. */
+static uint64_t unpack_value(
+    const unsigned char* packed,
+    uint64_t nbytes,
+    uint64_t pos,
+    unsigned int bits) {
+  auto byte = pos / 8;
+  auto shift = (unsigned int)(pos % 8);
+  auto len = std::min<uint64_t>(sizeof(uint64_t), nbytes - byte);
+  uint64_t word = 0;
+  std::memcpy(&word, packed + byte, len);
+  uint64_t value = word >> shift;
+  if (shift + bits > 64)
+    value |= ((uint64_t)packed[byte + 8]) << (64 - shift);
+  return (bits == 64) ? value : (value & ((((uint64_t)1) << bits) - 1));
+}
+
+/**
+ * Bit-width reduction. The output has the following format:
+ *
+ * value_num (uint64_t)
+ * window #1: min (T) | bit width (uint8_t) | packed differences from min
+ * window #2: ...
+ * trailing bytes
+ */
+template <class T>
+static Status bit_width_reduction(
+    bool reverse, ConstBuffer* input, Buffer* output) {
+  typedef typename std::make_unsigned<T>::type U;
+  auto in = (const unsigned char*)input->data();
+  auto nbytes = input->size();
+  auto window = constants::filter_bit_width_reduction_window;
+  unsigned char* out;
+
+  if (!reverse) {
+    uint64_t value_num = nbytes / sizeof(T);
+    uint64_t max_size = sizeof(uint64_t) + nbytes +
+                        (value_num / window + 1) * (sizeof(T) + 1);
+    RETURN_NOT_OK(prepare_output(output, max_size, &out));
+    auto out_start = out;
+
+    std::memcpy(out, &value_num, sizeof(uint64_t));
+    out += sizeof(uint64_t);
+    std::vector<U> diffs(std::min(window, value_num));
+    for (uint64_t start = 0; start < value_num; start += window) {
+      auto num = std::min(window, value_num - start);
+      T min, max, value;
+      std::memcpy(&min, in + start * sizeof(T), sizeof(T));
+      max = min;
+      for (uint64_t i = 1; i < num; ++i) {
+        std::memcpy(&value, in + (start + i) * sizeof(T), sizeof(T));
+        min = std::min(min, value);
+        max = std::max(max, value);
+      }
+      auto bits = (uint8_t)utils::bit_width((U)((U)max - (U)min));
+
+      std::memcpy(out, &min, sizeof(T));
+      out += sizeof(T);
+      *(out++) = bits;
+      auto len = packed_size(num, bits);
+      std::memset(out, 0, len);
+      for (uint64_t i = 0; i < num; ++i) {
+        std::memcpy(&value, in + (start + i) * sizeof(T), sizeof(T));
+        pack_value(out, len, i * bits, bits, (U)((U)value - (U)min));
+      }
+      out += len;
+    }
+
+    auto done = value_num * sizeof(T);
+    std::memcpy(out, in + done, nbytes - done);
+    out += nbytes - done;
+    commit_output(output, (uint64_t)(out - out_start));
+    return Status::Ok();
+  }
+
+  // Reverse
+  uint64_t value_num;
+  if (nbytes < sizeof(uint64_t))
+    return LOG_STATUS(Status::FilterError(
+        "Cannot reverse bit-width reduction; Invalid input buffer format"));
+  std::memcpy(&value_num, in, sizeof(uint64_t));
+  uint64_t in_offset = sizeof(uint64_t);
+
+  // Compute the size of the original data
+  uint64_t encoded_size = in_offset;
+  for (uint64_t start = 0; start < value_num; start += window) {
+    if (encoded_size + sizeof(T) + 1 > nbytes)
+      return LOG_STATUS(Status::FilterError(
+          "Cannot reverse bit-width reduction; Invalid input buffer format"));
+    auto bits = in[encoded_size + sizeof(T)];
+    encoded_size += sizeof(T) + 1 +
+                    packed_size(std::min(window, value_num - start), bits);
+  }
+  if (encoded_size > nbytes)
+    return LOG_STATUS(Status::FilterError(
+        "Cannot reverse bit-width reduction; Invalid input buffer format"));
+  auto tail = nbytes - encoded_size;
+  RETURN_NOT_OK(prepare_output(output, value_num * sizeof(T) + tail, &out));
+
+  for (uint64_t start = 0; start < value_num; start += window) {
+    auto num = std::min(window, value_num - start);
+    T min;
+    std::memcpy(&min, in + in_offset, sizeof(T));
+    in_offset += sizeof(T);
+    auto bits = (unsigned int)in[in_offset++];
+    auto len = packed_size(num, bits);
+    for (uint64_t i = 0; i < num; ++i) {
+      auto diff =
+          (bits == 0) ? 0 : unpack_value(in + in_offset, len, i * bits, bits);
+      auto value = (T)((U)min + (U)diff);
+      std::memcpy(out + (start + i) * sizeof(T), &value, sizeof(T));
+    }
+    in_offset += len;
+  }
+
+  std::memcpy(out + value_num * sizeof(T), in + in_offset, tail);
+  commit_output(output, value_num * sizeof(T) + tail);
+
+  return Status::Ok();
+}
+
+/**
+ * Invokes the bit-width reduction for the integer type that matches the
+ * input datatype. Non-integer datatypes are handled as unsigned integers
+ * of the same size.
+ */
+static Status bit_width_reduction(
+    bool reverse, Datatype type, ConstBuffer* input, Buffer* output) {
+  switch (type) {
+    case Datatype::INT8:
+      return bit_width_reduction<int8_t>(reverse, input, output);
+    case Datatype::INT16:
+      return bit_width_reduction<int16_t>(reverse, input, output);
+    case Datatype::INT32:
+      return bit_width_reduction<int32_t>(reverse, input, output);
+    case Datatype::INT64:
+      return bit_width_reduction<int64_t>(reverse, input, output);
+    default:
+      break;
+  }
+
+  switch (datatype_size(type)) {
+    case sizeof(uint16_t):
+      return bit_width_reduction<uint16_t>(reverse, input, output);
+    case sizeof(uint32_t):
+      return bit_width_reduction<uint32_t>(reverse, input, output);
+    case sizeof(uint64_t):
+      return bit_width_reduction<uint64_t>(reverse, input, output);
+    default:
+      return bit_width_reduction<uint8_t>(reverse, input, output);
+  }
+}
+
+/**
+ * Returns the datatype of the values output by the quantization filter for
+ * values of the input datatype.
+ */
+static Datatype quantized_type(Datatype type) {
+  switch (type) {
+    case Datatype::FLOAT32:
+      return Datatype::INT32;
+    case Datatype::FLOAT64:
+      return Datatype::INT64;
+    default:
+      return type;
+  }
+}
+
+/** Returns *true* if the input filter type is lossy. */
+static bool lossy(FilterType type) {
+  return type == FilterType::FILTER_QUANTIZE ||
+         type == FilterType::FILTER_MANTISSA_TRUNCATION;
+}
+
+/**
+ * Quantization: each value is replaced by the nearest integer multiple of
+ * twice the error bound, which is stored as an integer `I` of the same size
+ * as the value (so that the filters after it see integers). The output has
+ * the following format:
+ *
+ * values | trailing bytes | quantized (uint8_t)
+ *
+ * If any value of the input cannot be quantized within the error bound
+ * (e.g., because it is not finite or too large), the values are stored as
+ * they are and `quantized` is 0.
+ */
+template <class T, class I>
+static Status quantize(
+    bool reverse, double error_bound, ConstBuffer* input, Buffer* output) {
+  static_assert(sizeof(T) == sizeof(I), "Quantized values must fit in place");
+  auto in = (const unsigned char*)input->data();
+  auto nbytes = input->size();
+  double step = 2 * error_bound;
+  unsigned char* out;
+
+  if (!reverse) {
+    auto value_num = nbytes / sizeof(T);
+    RETURN_NOT_OK(prepare_output(output, nbytes + 1, &out));
+
+    // Leave headroom for filters that add or subtract quantized values
+    const double max = std::ldexp(1.0, std::numeric_limits<I>::digits - 1);
+    bool quantized = true;
+    for (uint64_t i = 0; i < value_num; ++i) {
+      T value;
+      std::memcpy(&value, in + i * sizeof(T), sizeof(T));
+      double quantum = std::round(value / step);
+      if (!(std::fabs(quantum) < max) ||
+          !(std::fabs((double)value - (T)(quantum * step)) <= error_bound)) {
+        quantized = false;
+        break;
+      }
+      auto q = (I)quantum;
+      std::memcpy(out + i * sizeof(T), &q, sizeof(T));
+    }
+
+    auto done = quantized ? value_num * sizeof(T) : 0;
+    std::memcpy(out + done, in + done, nbytes - done);
+    out[nbytes] = quantized ? 1 : 0;
+    commit_output(output, nbytes + 1);
+    return Status::Ok();
+  }
+
+  // Reverse
+  if (nbytes < 1)
+    return LOG_STATUS(Status::FilterError(
+        "Cannot reverse quantization; Invalid input buffer format"));
+  nbytes -= 1;
+  bool quantized = in[nbytes] == 1;
+  auto value_num = quantized ? nbytes / sizeof(T) : 0;
+  RETURN_NOT_OK(prepare_output(output, nbytes, &out));
+
+  for (uint64_t i = 0; i < value_num; ++i) {
+    I q;
+    std::memcpy(&q, in + i * sizeof(T), sizeof(T));
+    auto value = (T)(q * step);
+    std::memcpy(out + i * sizeof(T), &value, sizeof(T));
+  }
+
+  auto done = value_num * sizeof(T);
+  std::memcpy(out + done, in + done, nbytes - done);
+  commit_output(output, nbytes);
+
+  return Status::Ok();
+}
+
+/**
+ * Mantissa truncation: each value is rounded to the fewest mantissa bits
+ * that keep its relative error within the error bound, and the dropped bits
+ * are left zero for the compressor (typically after a shuffle filter). The
+ * values need no decoding, so the reverse filter copies the input. Zero,
+ * subnormal and non-finite values are kept as they are.
+ */
+template <class T, class U>
+static Status truncate_mantissa(
+    bool reverse, double error_bound, ConstBuffer* input, Buffer* output) {
+  static_assert(sizeof(T) == sizeof(U), "Values must be handled as bits");
+  auto in = (const unsigned char*)input->data();
+  auto nbytes = input->size();
+  unsigned char* out;
+  RETURN_NOT_OK(prepare_output(output, nbytes, &out));
+  std::memcpy(out, in, nbytes);
+
+  // Rounding to `kept` mantissa bits has a relative error of at most
+  // 2^-(kept + 1)
+  const int mantissa_bits = std::numeric_limits<T>::digits - 1;
+  int kept = std::max(0, (int)std::ceil(-std::log2(error_bound)) - 1);
+  if (!reverse && kept < mantissa_bits) {
+    auto dropped = mantissa_bits - kept;
+    auto half = (U)1 << (dropped - 1);
+    auto mask = (U) ~(((U)1 << dropped) - 1);
+    auto exponent_mask =
+        (U)(((U) ~(U)0 >> 1) & ~(((U)1 << mantissa_bits) - 1));
+    auto value_num = nbytes / sizeof(T);
+    for (uint64_t i = 0; i < value_num; ++i) {
+      U bits;
+      std::memcpy(&bits, in + i * sizeof(T), sizeof(T));
+      auto exponent = (U)(bits & exponent_mask);
+      if (exponent == 0 || exponent == exponent_mask)
+        continue;
+      auto rounded = (U)((bits + half) & mask);
+      if ((rounded & exponent_mask) == exponent_mask)  // Would overflow
+        continue;
+      std::memcpy(out + i * sizeof(T), &rounded, sizeof(T));
+    }
+  }
+
+  commit_output(output, nbytes);
+
+  return Status::Ok();
+}
+
+/**
+ * Invokes the input lossy filter for the real type that matches the input
+ * datatype.
+ */
+static Status lossy_filter(
+    FilterType filter,
+    bool reverse,
+    double error_bound,
+    Datatype type,
+    ConstBuffer* input,
+    Buffer* output) {
+  bool quantize_filter = filter == FilterType::FILTER_QUANTIZE;
+  switch (type) {
+    case Datatype::FLOAT32:
+      return quantize_filter ?
+                 quantize<float, int32_t>(reverse, error_bound, input, output) :
+                 truncate_mantissa<float, uint32_t>(
+                     reverse, error_bound, input, output);
+    case Datatype::FLOAT64:
+      return quantize_filter ?
+                 quantize<double, int64_t>(
+                     reverse, error_bound, input, output) :
+                 truncate_mantissa<double, uint64_t>(
+                     reverse, error_bound, input, output);
+    default:
+      return LOG_STATUS(Status::FilterError(
+          std::string("Cannot run filter ") + filter_type_str(filter) +
+          "; The filter applies only to real values"));
+  }
+}
+
+/* ****************************** */
+/*   CONSTRUCTORS & DESTRUCTORS   */
+/* ****************************** */
+
+FilterPipeline::FilterPipeline() = default;
+
+FilterPipeline::~FilterPipeline() = default;
+
+/* ****************************** */
+/*               API              */
+/* ****************************** */
+
+Status FilterPipeline::add_filter(FilterType type) {
+  return add_filter(type, 0);
+}
+
+Status FilterPipeline::add_filter(FilterType type, double error_bound) {
+  switch (type) {
+    case FilterType::FILTER_BYTESHUFFLE:
+    case FilterType::FILTER_BITSHUFFLE:
+    case FilterType::FILTER_DELTA:
+    case FilterType::FILTER_BIT_WIDTH_REDUCTION:
+    case FilterType::FILTER_DICTIONARY:
+      filters_.push_back(type);
+      error_bounds_.push_back(0);
+      return Status::Ok();
+    case FilterType::FILTER_QUANTIZE:
+    case FilterType::FILTER_MANTISSA_TRUNCATION:
+      break;
+    default:
+      return LOG_STATUS(
+          Status::FilterError("Cannot add filter; Invalid filter type"));
+  }
+
+  // Lossy filters
+  if (!(error_bound > 0) || std::isinf(error_bound))
+    return LOG_STATUS(Status::FilterError(
+        std::string("Cannot add filter ") + filter_type_str(type) +
+        "; The error bound must be a positive number"));
+  if (type == FilterType::FILTER_MANTISSA_TRUNCATION && error_bound >= 1)
+    return LOG_STATUS(Status::FilterError(
+        std::string("Cannot add filter ") + filter_type_str(type) +
+        "; The relative error bound must be smaller than 1"));
+  filters_.push_back(type);
+  error_bounds_.push_back(error_bound);
+
+  return Status::Ok();
+}
+
+void FilterPipeline::clear() {
+  filters_.clear();
+  error_bounds_.clear();
+}
+
+// ===== FORMAT =====
+// filter_num (unsigned int)
+// filter #1 (char) [error bound (double), for lossy filters]
+// filter #2 (char) [error bound (double), for lossy filters]
+// ...
+Status FilterPipeline::deserialize(ConstBuffer* buff) {
+  clear();
+
+  unsigned int filter_num;
+  RETURN_NOT_OK(buff->read(&filter_num, sizeof(unsigned int)));
+  for (unsigned int i = 0; i < filter_num; ++i) {
+    char type;
+    double error_bound = 0;
+    RETURN_NOT_OK(buff->read(&type, sizeof(char)));
+    if (lossy((FilterType)type))
+      RETURN_NOT_OK(buff->read(&error_bound, sizeof(double)));
+    RETURN_NOT_OK(add_filter((FilterType)type, error_bound));
+  }
+
+  return Status::Ok();
+}
+
+void FilterPipeline::dump(FILE* out) const {
+  fprintf(out, "- Filters: ");
+  for (size_t i = 0; i < filters_.size(); ++i) {
+    fprintf(out, (i == 0) ? "%s" : ", %s", filter_type_str(filters_[i]));
+    if (lossy(filters_[i]))
+      fprintf(out, " (error bound: %g)", error_bounds_[i]);
+  }
+  fprintf(out, "\n");
+}
+
+bool FilterPipeline::contains(FilterType type) const {
+  return std::find(filters_.begin(), filters_.end(), type) != filters_.end();
+}
+
+bool FilterPipeline::empty() const {
+  return filters_.empty();
+}
+
+double FilterPipeline::error_bound(unsigned int index) const {
+  return error_bounds_[index];
+}
+
+FilterType FilterPipeline::filter(unsigned int index) const {
+  return filters_[index];
+}
+
+unsigned int FilterPipeline::filter_num() const {
+  return (unsigned int)filters_.size();
+}
+
+uint64_t FilterPipeline::overhead(Datatype type, uint64_t nbytes) const {
+  auto window = constants::filter_bit_width_reduction_window;
+  auto value_size = datatype_size(type);
+  uint64_t ret = 0;
+  for (auto filter : filters_) {
+    if (filter == FilterType::FILTER_BIT_WIDTH_REDUCTION)
+      ret += sizeof(uint64_t) +
+             ((nbytes + ret) / value_size / window + 1) * (value_size + 1);
+    else if (filter == FilterType::FILTER_QUANTIZE)
+      ret += sizeof(uint8_t);
+  }
+  return ret;
+}
+
+Status FilterPipeline::run_forward(
+    Datatype type, ConstBuffer* input, Buffer* output, Buffer* scratch) const {
+  return run_filters(false, type, input, output, scratch);
+}
+
+Status FilterPipeline::run_reverse(
+    Datatype type, ConstBuffer* input, Buffer* output, Buffer* scratch) const {
+  return run_filters(true, type, input, output, scratch);
+}
+
+Status FilterPipeline::serialize(Buffer* buff) const {
+  auto filter_num = (unsigned int)filters_.size();
+  RETURN_NOT_OK(buff->write(&filter_num, sizeof(unsigned int)));
+  for (unsigned int i = 0; i < filter_num; ++i) {
+    auto type = (char)filters_[i];
+    RETURN_NOT_OK(buff->write(&type, sizeof(char)));
+    if (lossy(filters_[i]))
+      RETURN_NOT_OK(buff->write(&error_bounds_[i], sizeof(double)));
+  }
+
+  return Status::Ok();
+}
+
+/* ****************************** */
+/*         PRIVATE METHODS        */
+/* ****************************** */
+
+Status FilterPipeline::run_filters(
+    bool reverse,
+    Datatype type,
+    ConstBuffer* input,
+    Buffer* output,
+    Buffer* scratch) const {
+  // The dictionary filter encodes whole tiles before they are split into
+  // chunks (see `DictionaryEncoding`), so it is skipped here. The filters
+  // after a quantization filter see the values as integers.
+  std::vector<unsigned int> filters;
+  std::vector<Datatype> types;
+  for (unsigned int i = 0; i < filters_.size(); ++i) {
+    if (filters_[i] == FilterType::FILTER_DICTIONARY)
+      continue;
+    filters.push_back(i);
+    types.push_back(type);
+    if (filters_[i] == FilterType::FILTER_QUANTIZE)
+      type = quantized_type(type);
+  }
+
+  // No filters - copy the input as is
+  auto filter_num = filters.size();
+  if (filter_num == 0)
+    return output->write(input->data(), input->size());
+
+  // The filters alternate between the scratch buffer and the end of the
+  // output buffer, starting so that the last filter writes to the output
+  auto base = output->size();
+  bool to_output = (filter_num % 2) == 1;
+  ConstBuffer* in = input;
+  ConstBuffer* tmp = nullptr;
+  for (size_t i = 0; i < filter_num; ++i) {
+    auto pos = reverse ? filter_num - 1 - i : i;
+    auto index = filters[pos];
+    auto target = to_output ? output : scratch;
+    target->set_size(to_output ? base : 0);
+    target->set_offset(to_output ? base : 0);
+    auto st = run_filter(
+        filters_[index],
+        error_bounds_[index],
+        reverse,
+        types[pos],
+        in,
+        target);
+    delete tmp;
+    tmp = nullptr;
+    RETURN_NOT_OK(st);
+
+    if (i + 1 < filter_num) {
+      in = tmp = to_output ? new ConstBuffer(
+                                 output->data(base), output->size() - base) :
+                             new ConstBuffer(scratch);
+    }
+    to_output = !to_output;
+  }
+
+  return Status::Ok();
+}
+
+Status FilterPipeline::run_filter(
+    FilterType filter,
+    double error_bound,
+    bool reverse,
+    Datatype type,
+    ConstBuffer* input,
+    Buffer* output) {
+  auto value_size = datatype_size(type);
+  switch (filter) {
+    case FilterType::FILTER_BYTESHUFFLE:
+      return byteshuffle(reverse, value_size, input, output);
+    case FilterType::FILTER_BITSHUFFLE:
+      return bitshuffle(reverse, value_size, input, output);
+    case FilterType::FILTER_DELTA:
+      switch (value_size) {
+        case sizeof(uint16_t):
+          return delta<uint16_t>(reverse, input, output);
+        case sizeof(uint32_t):
+          return delta<uint32_t>(reverse, input, output);
+        case sizeof(uint64_t):
+          return delta<uint64_t>(reverse, input, output);
+        default:
+          return delta<uint8_t>(reverse, input, output);
+      }
+    case FilterType::FILTER_BIT_WIDTH_REDUCTION:
+      return bit_width_reduction(reverse, type, input, output);
+    case FilterType::FILTER_QUANTIZE:
+    case FilterType::FILTER_MANTISSA_TRUNCATION:
+      return lossy_filter(filter, reverse, error_bound, type, input, output);
+    default:
+      return LOG_STATUS(
+          Status::FilterError("Cannot run filter; Invalid filter type"));
+  }
+}
+
+}  // namespace sm
+}  // namespace tiledb
@@ -0,0 +1,240 @@
+/**
+ * @file   filter_pipeline.h
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2018 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file defines class FilterPipeline.
+ */
+
+#ifndef TILEDB_FILTER_PIPELINE_H
+#define TILEDB_FILTER_PIPELINE_H
+
+#include <cstdio>
+#include <vector>
+
+#include "tiledb/sm/buffer/buffer.h"
+#include "tiledb/sm/buffer/const_buffer.h"
+#include "tiledb/sm/enums/datatype.h"
+#include "tiledb/sm/enums/filter_type.h"
+#include "tiledb/sm/misc/status.h"
+
+namespace tiledb {
+namespace sm {
+
+/**
+ * An ordered list of filters that transform the data of a tile chunk before
+ * it is handed to the compressor. The filters run in the order they were
+ * added upon writing, and in reverse order upon reading. The filters operate
+ * on values of the size of the tile datatype; trailing bytes that do not
+ * form a whole value are passed through unchanged. All filters are lossless,
+ * except for quantization and mantissa truncation, which take an error
+ * bound.
+ *
+ * The supported filters are:
+ *  - *Byte shuffle*: stores the i-th byte of all values contiguously.
+ *  - *Bit shuffle*: stores the i-th bit of all values contiguously, in
+ *    groups of 8 values (any remaining values are copied as they are).
+ *  - *Delta*: replaces each value with its (wrapping) difference from the
+ *    previous value.
+ *  - *Bit-width reduction*: splits the values into windows of
+ *    `constants::filter_bit_width_reduction_window` values, and stores each
+ *    window as its minimum, followed by the differences from the minimum
+ *    packed in the fewest bits that can represent all of them.
+ *  - *Dictionary*: applies only to var-sized string attributes, and stores
+ *    the distinct values of a tile once, followed by a code per cell. Unlike
+ *    the other filters, it operates on whole tiles rather than chunks, and
+ *    it is always applied first regardless of its position in the pipeline
+ *    (see `DictionaryEncoding`).
+ *  - *Quantization*: applies only to real values, and replaces each value
+ *    with the nearest integer multiple of twice the (absolute) error bound,
+ *    stored as a signed integer of the same size. The filters that follow
+ *    it see the values as integers, which lets delta and bit-width
+ *    reduction shrink smooth real data. A chunk with values that cannot be
+ *    quantized within the bound (e.g., NaN) is stored as is. Either way, a
+ *    1-byte flag is appended to the chunk.
+ *  - *Mantissa truncation*: applies only to real values, and rounds each
+ *    value to the fewest mantissa bits that keep its error within the
+ *    (relative) error bound, zeroing the dropped bits.
+ */
+class FilterPipeline {
+ public:
+  /* ********************************* */
+  /*     CONSTRUCTORS & DESTRUCTORS    */
+  /* ********************************* */
+
+  /** Constructor. */
+  FilterPipeline();
+
+  /** Destructor. */
+  ~FilterPipeline();
+
+  /* ********************************* */
+  /*                API                */
+  /* ********************************* */
+
+  /**
+   * Appends a filter to the end of the pipeline.
+   *
+   * @param type The filter type.
+   * @return Status
+   */
+  Status add_filter(FilterType type);
+
+  /**
+   * Appends a filter that takes an error bound to the end of the pipeline.
+   * The bound is absolute for quantization, and relative (smaller than 1)
+   * for mantissa truncation. It is ignored for the lossless filters.
+   *
+   * @param type The filter type.
+   * @param error_bound The error bound.
+   * @return Status
+   */
+  Status add_filter(FilterType type, double error_bound);
+
+  /** Removes all filters from the pipeline. */
+  void clear();
+
+  /** Returns *true* if the pipeline contains a filter of the input type. */
+  bool contains(FilterType type) const;
+
+  /**
+   * Populates the object members from the data in the input binary buffer.
+   *
+   * @param buff The buffer to deserialize from.
+   * @return Status
+   */
+  Status deserialize(ConstBuffer* buff);
+
+  /** Dumps the pipeline contents in ASCII form in the selected output. */
+  void dump(FILE* out) const;
+
+  /** Returns *true* if the pipeline has no filters. */
+  bool empty() const;
+
+  /**
+   * Returns the error bound of the filter at position `index` (0 for
+   * lossless filters).
+   */
+  double error_bound(unsigned int index) const;
+
+  /** Returns the type of the filter at position `index`. */
+  FilterType filter(unsigned int index) const;
+
+  /** Returns the number of filters in the pipeline. */
+  unsigned int filter_num() const;
+
+  /**
+   * Returns the maximum number of bytes the pipeline may add to an input
+   * of `nbytes` bytes of datatype `type`.
+   */
+  uint64_t overhead(Datatype type, uint64_t nbytes) const;
+
+  /**
+   * Runs all filters in order on the input data, appending the result to
+   * the output buffer.
+   *
+   * @param type The datatype of the input values.
+   * @param input The data to be filtered.
+   * @param output The buffer the filtered data are appended to.
+   * @param scratch A buffer for intermediate results, whose contents are
+   *     overwritten.
+   * @return Status
+   */
+  Status run_forward(
+      Datatype type,
+      ConstBuffer* input,
+      Buffer* output,
+      Buffer* scratch) const;
+
+  /**
+   * Reverses all filters (from last to first) on data produced by
+   * `run_forward`, appending the original data to the output buffer.
+   *
+   * @param type The datatype of the original values.
+   * @param input The filtered data.
+   * @param output The buffer the original data are appended to.
+   * @param scratch A buffer for intermediate results, whose contents are
+   *     overwritten.
+   * @return Status
+   */
+  Status run_reverse(
+      Datatype type,
+      ConstBuffer* input,
+      Buffer* output,
+      Buffer* scratch) const;
+
+  /**
+   * Serializes the object members into a binary buffer.
+   *
+   * @param buff The buffer to serialize the data into.
+   * @return Status
+   */
+  Status serialize(Buffer* buff) const;
+
+ private:
+  /* ********************************* */
+  /*         PRIVATE ATTRIBUTES        */
+  /* ********************************* */
+
+  /** The error bounds of the filters (0 for lossless filters). */
+  std::vector<double> error_bounds_;
+
+  /** The filters, in the order they are applied upon writing. */
+  std::vector<FilterType> filters_;
+
+  /* ********************************* */
+  /*          PRIVATE METHODS          */
+  /* ********************************* */
+
+  /**
+   * Runs a single filter (or its inverse if `reverse` is *true*) on the
+   * input, appending the result to the output buffer.
+   */
+  static Status run_filter(
+      FilterType filter,
+      double error_bound,
+      bool reverse,
+      Datatype type,
+      ConstBuffer* input,
+      Buffer* output);
+
+  /**
+   * Runs all filters in order (or their inverses in reverse order if
+   * `reverse` is *true*). See `run_forward` and `run_reverse`.
+   */
+  Status run_filters(
+      bool reverse,
+      Datatype type,
+      ConstBuffer* input,
+      Buffer* output,
+      Buffer* scratch) const;
+};
+
+}  // namespace sm
+}  // namespace tiledb
+
+#endif  // TILEDB_FILTER_PIPELINE_H
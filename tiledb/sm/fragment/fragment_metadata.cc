@@ -87,6 +87,47 @@ FragmentMetadata::~FragmentMetadata() {
 /*             ACCESSORS          */
 /* ****************************** */
 
+Status FragmentMetadata::append_fragment(const FragmentMetadata* metadata) {
+  unsigned int attribute_num = array_schema_->attribute_num();
+
+  // MBRs and bounding coordinates
+  auto tile_num = metadata->tile_num();
+  if (!dense_) {
+    for (uint64_t i = 0; i < tile_num; ++i) {
+      RETURN_NOT_OK(append_mbr(metadata->mbrs_[i]));
+      append_bounding_coords(metadata->bounding_coords_[i]);
+    }
+  }
+
+  // Tile offsets, where the last tile ends at the end of the file
+  for (unsigned int i = 0; i < attribute_num + 1; ++i) {
+    const auto& tile_offsets = metadata->tile_offsets_[i];
+    auto offset_num = (uint64_t)tile_offsets.size();
+    for (uint64_t j = 0; j < offset_num; ++j) {
+      auto end = (j + 1 < offset_num) ? tile_offsets[j + 1] :
+                                        metadata->file_sizes_[i];
+      append_tile_offset(i, end - tile_offsets[j]);
+    }
+  }
+
+  // Variable tile offsets and sizes
+  for (unsigned int i = 0; i < attribute_num; ++i) {
+    const auto& tile_var_offsets = metadata->tile_var_offsets_[i];
+    auto offset_num = (uint64_t)tile_var_offsets.size();
+    for (uint64_t j = 0; j < offset_num; ++j) {
+      auto end = (j + 1 < offset_num) ? tile_var_offsets[j + 1] :
+                                        metadata->file_var_sizes_[i];
+      append_tile_var_offset(i, end - tile_var_offsets[j]);
+      append_tile_var_size(i, metadata->tile_var_sizes_[i][j]);
+    }
+  }
+
+  last_tile_cell_num_ = metadata->last_tile_cell_num_;
+  zstd_dictionaries_ = metadata->zstd_dictionaries_;
+
+  return Status::Ok();
+}
+
 void FragmentMetadata::append_bounding_coords(const void* bounding_coords) {
   // For easy reference
   uint64_t bounding_coords_size = 2 * array_schema_->coords_size();
@@ -284,6 +325,7 @@ Status FragmentMetadata::deserialize(ConstBuffer* buf) {
   RETURN_NOT_OK(load_last_tile_cell_num(buf));
   RETURN_NOT_OK(load_file_sizes(buf));
   RETURN_NOT_OK(load_file_var_sizes(buf));
+  RETURN_NOT_OK(load_zstd_dictionaries(buf));
 
   return Status::Ok();
 }
@@ -351,6 +393,9 @@ Status FragmentMetadata::init(const void* non_empty_domain) {
   // Initialize variable tile sizes
   tile_var_sizes_.resize(attribute_num);
 
+  // Initialize zstd dictionaries
+  zstd_dictionaries_.resize(attribute_num);
+
   return Status::Ok();
 }
 
@@ -377,6 +422,7 @@ Status FragmentMetadata::serialize(Buffer* buf) {
   RETURN_NOT_OK(write_last_tile_cell_num(buf));
   RETURN_NOT_OK(write_file_sizes(buf));
   RETURN_NOT_OK(write_file_var_sizes(buf));
+  RETURN_NOT_OK(write_zstd_dictionaries(buf));
 
   return Status::Ok();
 }
@@ -385,6 +431,13 @@ void FragmentMetadata::set_last_tile_cell_num(uint64_t cell_num) {
   last_tile_cell_num_ = cell_num;
 }
 
+void FragmentMetadata::set_zstd_dictionary(
+    unsigned int attribute_id, const void* data, uint64_t size) {
+  assert(attribute_id < zstd_dictionaries_.size());
+  auto data_c = static_cast<const char*>(data);
+  zstd_dictionaries_[attribute_id].assign(data_c, data_c + size);
+}
+
 uint64_t FragmentMetadata::tile_num() const {
   if (dense_)
     return array_schema_->domain()->tile_num(domain_);
@@ -424,8 +477,11 @@ uint64_t FragmentMetadata::compressed_tile_size(
     if (constants::cell_var_offsets_compression == Compressor::NO_COMPRESSION)
       return 0;  // Uncompressed offsets tile
   } else {
-    if (array_schema_->compression(attribute_id) == Compressor::NO_COMPRESSION)
-      return 0;  // Uncompressed fix-sized value tile
+    auto filters = array_schema_->filters(attribute_id);
+    if (array_schema_->compression(attribute_id) ==
+            Compressor::NO_COMPRESSION &&
+        (filters == nullptr || filters->empty()))
+      return 0;  // Uncompressed and unfiltered fix-sized value tile
   }
 
   auto tile_num = this->tile_num();
@@ -437,7 +493,8 @@ uint64_t FragmentMetadata::compressed_tile_size(
 
 uint64_t FragmentMetadata::compressed_tile_var_size(
     unsigned attribute_id, uint64_t tile_idx) const {
-  if (array_schema_->compression(attribute_id) == Compressor::NO_COMPRESSION)
+  if (array_schema_->compression(attribute_id) == Compressor::NO_COMPRESSION &&
+      array_schema_->filters(attribute_id)->empty())
     return 0;
 
   auto tile_num = this->tile_num();
@@ -476,6 +533,12 @@ const std::vector<std::vector<uint64_t>>& FragmentMetadata::tile_var_sizes()
   return tile_var_sizes_;
 }
 
+const std::vector<char>& FragmentMetadata::zstd_dictionary(
+    unsigned int attribute_id) const {
+  assert(attribute_id < zstd_dictionaries_.size());
+  return zstd_dictionaries_[attribute_id];
+}
+
 /* ****************************** */
 /*        PRIVATE METHODS         */
 /* ****************************** */
@@ -838,6 +901,47 @@ Status FragmentMetadata::load_version(ConstBuffer* buff) {
   return Status::Ok();
 }
 
+// ===== FORMAT =====
+// zstd_dictionary_size_attr#0(uint64_t) zstd_dictionary_attr#0(char[])
+// ...
+// zstd_dictionary_size_attr#<attribute_num-1>(uint64_t)
+//     zstd_dictionary_attr#<attribute_num-1>(char[])
+Status FragmentMetadata::load_zstd_dictionaries(ConstBuffer* buff) {
+  Status st;
+  unsigned int attribute_num = array_schema_->attribute_num();
+  uint64_t dictionary_size = 0;
+
+  // Allocate dictionaries
+  zstd_dictionaries_.resize(attribute_num);
+
+  // Fragments written before dictionaries were introduced end here
+  if (buff->end())
+    return Status::Ok();
+
+  // For all attributes, get the dictionary
+  for (unsigned int i = 0; i < attribute_num; ++i) {
+    // Get dictionary size
+    st = buff->read(&dictionary_size, sizeof(uint64_t));
+    if (!st.ok()) {
+      return LOG_STATUS(Status::FragmentMetadataError(
+          "Cannot load fragment metadata; Reading zstd dictionary size "
+          "failed"));
+    }
+
+    if (dictionary_size == 0)
+      continue;
+
+    // Get dictionary
+    zstd_dictionaries_[i].resize(dictionary_size);
+    st = buff->read(&zstd_dictionaries_[i][0], dictionary_size);
+    if (!st.ok()) {
+      return LOG_STATUS(Status::FragmentMetadataError(
+          "Cannot load fragment metadata; Reading zstd dictionary failed"));
+    }
+  }
+  return Status::Ok();
+}
+
 // ===== FORMAT =====
 // bounding_coords_num(uint64_t)
 // bounding_coords_#1(void*) bounding_coords_#2(void*) ...
@@ -1086,6 +1190,40 @@ Status FragmentMetadata::write_version(Buffer* buff) {
   return Status::Ok();
 }
 
+// ===== FORMAT =====
+// zstd_dictionary_size_attr#0(uint64_t) zstd_dictionary_attr#0(char[])
+// ...
+// zstd_dictionary_size_attr#<attribute_num-1>(uint64_t)
+//     zstd_dictionary_attr#<attribute_num-1>(char[])
+Status FragmentMetadata::write_zstd_dictionaries(Buffer* buff) {
+  Status st;
+  unsigned int attribute_num = array_schema_->attribute_num();
+
+  // Write the dictionary of each attribute
+  for (unsigned int i = 0; i < attribute_num; ++i) {
+    // Write dictionary size
+    uint64_t dictionary_size = zstd_dictionaries_[i].size();
+    st = buff->write(&dictionary_size, sizeof(uint64_t));
+    if (!st.ok()) {
+      return LOG_STATUS(Status::FragmentMetadataError(
+          "Cannot serialize fragment metadata; Writing zstd dictionary size "
+          "failed"));
+    }
+
+    if (dictionary_size == 0)
+      continue;
+
+    // Write dictionary
+    st = buff->write(&zstd_dictionaries_[i][0], dictionary_size);
+    if (!st.ok()) {
+      return LOG_STATUS(Status::FragmentMetadataError(
+          "Cannot serialize fragment metadata; Writing zstd dictionary "
+          "failed"));
+    }
+  }
+  return Status::Ok();
+}
+
 // Explicit template instantiations
 template Status FragmentMetadata::append_mbr<int8_t>(const void* mbr);
 template Status FragmentMetadata::append_mbr<uint8_t>(const void* mbr);
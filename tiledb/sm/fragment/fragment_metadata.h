@@ -69,6 +69,18 @@ class FragmentMetadata {
   /*                API                */
   /* ********************************* */
 
+  /**
+   * Appends the tiles of the input fragment, whose files are appended
+   * byte-for-byte to the files of this fragment. The tile offsets of the
+   * input fragment are shifted past the tiles already appended, and its
+   * MBRs, bounding coordinates and last tile cell number are carried over.
+   * The two fragments must have the same zstd dictionaries.
+   *
+   * @param metadata The metadata of the fragment to append.
+   * @return Status
+   */
+  Status append_fragment(const FragmentMetadata* metadata);
+
   /**
    * Appends the tile bounding coordinates to the fragment metadata.
    *
@@ -262,6 +274,18 @@ class FragmentMetadata {
    */
   void set_last_tile_cell_num(uint64_t cell_num);
 
+  /**
+   * Sets the zstd dictionary the tiles of the input attribute are
+   * compressed with (its values tiles, if the attribute is var-sized).
+   *
+   * @param attribute_id The attribute id.
+   * @param data The dictionary contents, which are copied.
+   * @param size The dictionary size.
+   * @return void
+   */
+  void set_zstd_dictionary(
+      unsigned int attribute_id, const void* data, uint64_t size);
+
   /** Returns the number of tiles in the fragment. */
   uint64_t tile_num() const;
 
@@ -344,6 +368,12 @@ class FragmentMetadata {
   /** Returns the variable tile sizes. */
   const std::vector<std::vector<uint64_t>>& tile_var_sizes() const;
 
+  /**
+   * Returns the zstd dictionary of the input attribute, which is empty if
+   * its tiles are compressed without a dictionary.
+   */
+  const std::vector<char>& zstd_dictionary(unsigned int attribute_id) const;
+
  private:
   /* ********************************* */
   /*         PRIVATE ATTRIBUTES        */
@@ -417,6 +447,12 @@ class FragmentMetadata {
   /** The version of the library that created this metadata. */
   int version_[3];
 
+  /**
+   * The zstd dictionaries trained for the attributes, one per attribute
+   * (empty for the attributes without a dictionary).
+   */
+  std::vector<std::vector<char>> zstd_dictionaries_;
+
   /* ********************************* */
   /*           PRIVATE METHODS         */
   /* ********************************* */
@@ -512,6 +548,14 @@ class FragmentMetadata {
   /** Loads the library version from the buffer. */
   Status load_version(ConstBuffer* buff);
 
+  /**
+   * Loads the zstd dictionaries from the fragment metadata buffer.
+   *
+   * @param buff Metadata buffer.
+   * @return Status
+   */
+  Status load_zstd_dictionaries(ConstBuffer* buff);
+
   /**
    * Writes the bounding coordinates to the fragment metadata buffer.
    *
@@ -576,6 +620,14 @@ class FragmentMetadata {
 
   /** Writes the library version to the buffer. */
   Status write_version(Buffer* buff);
+
+  /**
+   * Writes the zstd dictionaries to the fragment metadata buffer.
+   *
+   * @param buff Metadata buffer.
+   * @return Status
+   */
+  Status write_zstd_dictionaries(Buffer* buff);
 };
 
 }  // namespace sm
@@ -31,6 +31,7 @@
  * This file implements the ReadState class.
  */
 
+#include "tiledb/sm/filter/dictionary_encoding.h"
 #include "tiledb/sm/misc/logger.h"
 #include "tiledb/sm/misc/utils.h"
 #include "tiledb/sm/query/query.h"
@@ -1360,6 +1361,8 @@ Status ReadState::init_tiles() {
             (var_size) ? constants::cell_var_offset_size : attr->cell_size(),
             0),
         delete tile);
+    if (!var_size)
+      tile->set_filters(&attr->filters());
     tiles_.emplace_back(tile);
 
     if (var_size) {
@@ -1368,6 +1371,7 @@ Status ReadState::init_tiles() {
           tile->init(
               attr->type(), attr->compressor(), datatype_size(attr->type()), 0),
           delete tile);
+      tile->set_filters(&attr->filters());
       tiles_var_.emplace_back(tile);
     } else {
       tiles_var_.emplace_back(nullptr);
@@ -1411,6 +1415,13 @@ void ReadState::init_tile_io() {
           fragment_->file_var_size(i)));
     else
       tile_io_var_.emplace_back(nullptr);
+
+    // The zstd dictionary applies to the values tiles of the attribute
+    auto& dictionary = metadata_->zstd_dictionary(i);
+    if (!dictionary.empty()) {
+      auto tile_io = var_size ? tile_io_var_.back() : tile_io_.back();
+      tile_io->set_dictionary(&dictionary[0], dictionary.size());
+    }
   }
   tile_io_.emplace_back(new TileIO(
       query_->storage_manager(),
@@ -1511,6 +1522,17 @@ Status ReadState::read_tile_var(unsigned int attribute_id, uint64_t tile_i) {
   RETURN_NOT_OK(tile_io_var->read(
       tile_var, file_var_offset, tile_compressed_var_size, tile_var_size));
 
+  // Decode dictionary encoded values
+  auto filters = tile_var->filters();
+  if (filters != nullptr && filters->contains(FilterType::FILTER_DICTIONARY)) {
+    Buffer encoded;
+    RETURN_NOT_OK(encoded.write(tile_var->data(), tile_var->size()));
+    ConstBuffer input(&encoded);
+    tile_var->reset_size();
+    RETURN_NOT_OK(DictionaryEncoding::decode(&input, tile_var->buffer()));
+    tile_var->reset_offset();
+  }
+
   // Shift variable cell offsets
   shift_var_offsets(attribute_id);
 
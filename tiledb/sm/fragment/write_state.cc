@@ -36,10 +36,15 @@
 #include <cmath>
 #include <cstring>
 #include <iostream>
+#include <type_traits>
 
 #include "tiledb/sm/buffer/const_buffer.h"
+#include "tiledb/sm/compressors/zstd_compressor.h"
+#include "tiledb/sm/filter/dictionary_encoding.h"
 #include "tiledb/sm/misc/comparators.h"
 #include "tiledb/sm/misc/logger.h"
+#include "tiledb/sm/misc/memory_tracker.h"
+#include "tiledb/sm/misc/radix_sort.h"
 #include "tiledb/sm/misc/utils.h"
 #include "tiledb/sm/query/query.h"
 #include "tiledb/sm/tile/tile.h"
@@ -59,6 +64,7 @@ WriteState::WriteState() {
   fragment_ = nullptr;
   mbr_ = nullptr;
   tile_coords_aux_ = nullptr;
+  zstd_dictionary_size_ = 0;
 }
 
 WriteState::~WriteState() {
@@ -129,6 +135,12 @@ Status WriteState::init(const Fragment* fragment) {
 
   cells_written_.resize(attribute_num + 1);
 
+  // Retrieve the zstd dictionary size from the config only once
+  auto storage_manager = fragment_->query()->storage_manager();
+  zstd_dictionary_size_ =
+      storage_manager->config().sm_params().zstd_dictionary_size_;
+  zstd_dictionary_trained_.resize(attribute_num, 0);
+
   return Status::Ok();
 }
 
@@ -244,26 +256,38 @@ Status WriteState::write(void** buffers, uint64_t* buffer_sizes) {
     // For easy reference
     auto array_schema = fragment_->query()->array_schema();
 
-    // Write each attribute individually
+    // Write the attributes in parallel, as they are stored in separate
+    // files
+    std::vector<std::function<Status()>> tasks;
     unsigned int buffer_i = 0;
     for (unsigned int i = 0; i < attribute_id_num; ++i) {
-      if (!array_schema->var_size(attribute_ids[i])) {  // FIXED CELLS
-        RETURN_NOT_OK(write_attr(
-            attribute_ids[i], buffers[buffer_i], buffer_sizes[buffer_i]));
+      auto attribute_id = attribute_ids[i];
+      if (!array_schema->var_size(attribute_id)) {  // FIXED CELLS
+        auto buffer = buffers[buffer_i];
+        auto buffer_size = buffer_sizes[buffer_i];
+        tasks.emplace_back([this, attribute_id, buffer, buffer_size]() {
+          return write_attr(attribute_id, buffer, buffer_size);
+        });
         ++buffer_i;
       } else {  // VARIABLE-SIZED CELLS
-        RETURN_NOT_OK(write_attr_var(
-            attribute_ids[i],
-            buffers[buffer_i],  // offsets
-            buffer_sizes[buffer_i],
-            buffers[buffer_i + 1],  // actual cell values
-            buffer_sizes[buffer_i + 1]));
+        auto buffer = buffers[buffer_i];  // offsets
+        auto buffer_size = buffer_sizes[buffer_i];
+        auto buffer_var = buffers[buffer_i + 1];  // actual cell values
+        auto buffer_var_size = buffer_sizes[buffer_i + 1];
+        tasks.emplace_back([this,
+                            attribute_id,
+                            buffer,
+                            buffer_size,
+                            buffer_var,
+                            buffer_var_size]() {
+          return write_attr_var(
+              attribute_id, buffer, buffer_size, buffer_var, buffer_var_size);
+        });
         buffer_i += 2;
       }
     }
 
-    // Success
-    return Status::Ok();
+    return run_parallel(tasks);
   }
 
   if (layout == Layout::UNORDERED)  // UNORDERED
@@ -317,6 +341,8 @@ Status WriteState::init_tiles() {
             (var_size) ? constants::cell_var_offset_size : attr->cell_size(),
             0),
         delete tile);
+    if (!var_size)
+      tile->set_filters(&attr->filters());
     tiles_.emplace_back(tile);
 
     if (var_size) {
@@ -330,6 +356,7 @@ Status WriteState::init_tiles() {
               datatype_size(attr->type()),
               0),
           delete tile);
+      tile->set_filters(&attr->filters());
       tiles_var_.emplace_back(tile);
     } else {
       tiles_var_.emplace_back(nullptr);
@@ -373,7 +400,129 @@ Status WriteState::init_tile_io() {
   return Status::Ok();
 }
 
-void WriteState::sort_cell_pos(
+template <class T>
+Status WriteState::radix_sort_cell_pos(
+    const T* buffer,
+    uint64_t cell_num,
+    std::vector<uint64_t>* cell_pos,
+    std::vector<uint64_t>* ids,
+    bool* sorted) const {
+  // For easy reference
+  auto array_schema = fragment_->query()->array_schema();
+  auto dim_num = array_schema->dim_num();
+  auto domain = array_schema->domain();
+  bool row_major = array_schema->cell_order() == Layout::ROW_MAJOR;
+  bool tile_grid = domain->tile_extents() != nullptr;
+  auto compute_tp = fragment_->query()->storage_manager()->compute_tp();
+  uint64_t chunk_num = utils::parallel_chunk_num(compute_tp, cell_num);
+
+  *sorted = false;
+  if (cell_num == 0) {
+    *sorted = true;
+    return Status::Ok();
+  }
+
+  // Compute the tile ids and the coordinate bounds of each chunk
+  std::vector<uint64_t> keys(cell_num);
+  std::vector<T> chunk_mins(chunk_num * dim_num);
+  std::vector<T> chunk_maxs(chunk_num * dim_num);
+  std::vector<uint64_t> chunk_max_ids(chunk_num, 0);
+  std::vector<T> tile_coords(chunk_num * dim_num);
+  RETURN_NOT_OK(utils::parallel_chunks(
+      compute_tp,
+      cell_num,
+      chunk_num,
+      [&](uint64_t chunk, uint64_t begin, uint64_t end) {
+        T* mins = &chunk_mins[chunk * dim_num];
+        T* maxs = &chunk_maxs[chunk * dim_num];
+        for (unsigned int d = 0; d < dim_num; ++d)
+          mins[d] = maxs[d] = buffer[d];
+        uint64_t max_id = 0;
+        for (uint64_t i = begin; i < end; ++i) {
+          const T* coords = &buffer[i * dim_num];
+          for (unsigned int d = 0; d < dim_num; ++d) {
+            mins[d] = std::min(mins[d], coords[d]);
+            maxs[d] = std::max(maxs[d], coords[d]);
+          }
+          if (tile_grid) {
+            keys[i] =
+                domain->tile_id<T>(coords, &tile_coords[chunk * dim_num]);
+            max_id = std::max(max_id, keys[i]);
+          }
+        }
+        chunk_max_ids[chunk] = max_id;
+        return Status::Ok();
+      }));
+
+  // Compute the key layout
+  std::vector<T> mins(chunk_mins.begin(), chunk_mins.begin() + dim_num);
+  std::vector<unsigned> dim_bits(dim_num);
+  uint64_t max_id = 0;
+  unsigned coords_bits = 0;
+  for (uint64_t c = 0; c < chunk_num; ++c)
+    max_id = std::max(max_id, chunk_max_ids[c]);
+  for (unsigned int d = 0; d < dim_num; ++d) {
+    T max = chunk_maxs[d];
+    for (uint64_t c = 1; c < chunk_num; ++c) {
+      mins[d] = std::min(mins[d], chunk_mins[c * dim_num + d]);
+      max = std::max(max, chunk_maxs[c * dim_num + d]);
+    }
+    dim_bits[d] = utils::bit_width((uint64_t)max - (uint64_t)mins[d]);
+    coords_bits += dim_bits[d];
+  }
+  unsigned id_bits = utils::bit_width(max_id);
+  if (coords_bits + id_bits > 64) {
+    if (tile_grid)
+      ids->swap(keys);
+    return Status::Ok();
+  }
+
+  // Pack the keys, most significant dimension first
+  RETURN_NOT_OK(utils::parallel_chunks(
+      compute_tp,
+      cell_num,
+      chunk_num,
+      [&](uint64_t chunk, uint64_t begin, uint64_t end) {
+        (void)chunk;
+        for (uint64_t i = begin; i < end; ++i) {
+          const T* coords = &buffer[i * dim_num];
+          uint64_t key = (id_bits == 0) ? 0 : keys[i];
+          for (unsigned int j = 0; j < dim_num; ++j) {
+            unsigned int d = row_major ? j : dim_num - j - 1;
+            uint64_t value = (uint64_t)coords[d] - (uint64_t)mins[d];
+            key = (dim_bits[d] == 64) ? value : (key << dim_bits[d]) | value;
+          }
+          keys[i] = key;
+        }
+        return Status::Ok();
+      }));
+
+  RETURN_NOT_OK(utils::radix_sort(
+      compute_tp, coords_bits + id_bits, &keys, cell_pos));
+  *sorted = true;
+
+  return Status::Ok();
+}
+
+Status WriteState::run_parallel(
+    const std::vector<std::function<Status()>>& tasks) {
+  if (tasks.size() == 1)
+    return tasks[0]();
+
+  auto compute_tp = fragment_->query()->storage_manager()->compute_tp();
+  auto memory_tracker = MemoryTracker::thread_tracker();
+  std::vector<std::future<Status>> results;
+  for (const auto& task : tasks) {
+    results.push_back(compute_tp->enqueue([&task, memory_tracker]() {
+      ScopedMemoryTracker scoped_tracker(memory_tracker);
+      return task();
+    }));
+  }
+
+  return compute_tp->wait_all_status(results);
+}
+
+Status WriteState::sort_cell_pos(
     const void* buffer,
     uint64_t buffer_size,
     std::vector<uint64_t>* cell_pos) const {
@@ -383,29 +532,32 @@ void WriteState::sort_cell_pos(
 
   // Invoke the proper templated function
   if (coords_type == Datatype::INT32)
-    sort_cell_pos<int>(buffer, buffer_size, cell_pos);
-  else if (coords_type == Datatype::INT64)
-    sort_cell_pos<int64_t>(buffer, buffer_size, cell_pos);
-  else if (coords_type == Datatype::FLOAT32)
-    sort_cell_pos<float>(buffer, buffer_size, cell_pos);
-  else if (coords_type == Datatype::FLOAT64)
-    sort_cell_pos<double>(buffer, buffer_size, cell_pos);
-  else if (coords_type == Datatype::INT8)
-    sort_cell_pos<int8_t>(buffer, buffer_size, cell_pos);
-  else if (coords_type == Datatype::UINT8)
-    sort_cell_pos<uint8_t>(buffer, buffer_size, cell_pos);
-  else if (coords_type == Datatype::INT16)
-    sort_cell_pos<int16_t>(buffer, buffer_size, cell_pos);
-  else if (coords_type == Datatype::UINT16)
-    sort_cell_pos<uint16_t>(buffer, buffer_size, cell_pos);
-  else if (coords_type == Datatype::UINT32)
-    sort_cell_pos<uint32_t>(buffer, buffer_size, cell_pos);
-  else if (coords_type == Datatype::UINT64)
-    sort_cell_pos<uint64_t>(buffer, buffer_size, cell_pos);
+    return sort_cell_pos<int>(buffer, buffer_size, cell_pos);
+  if (coords_type == Datatype::INT64)
+    return sort_cell_pos<int64_t>(buffer, buffer_size, cell_pos);
+  if (coords_type == Datatype::FLOAT32)
+    return sort_cell_pos<float>(buffer, buffer_size, cell_pos);
+  if (coords_type == Datatype::FLOAT64)
+    return sort_cell_pos<double>(buffer, buffer_size, cell_pos);
+  if (coords_type == Datatype::INT8)
+    return sort_cell_pos<int8_t>(buffer, buffer_size, cell_pos);
+  if (coords_type == Datatype::UINT8)
+    return sort_cell_pos<uint8_t>(buffer, buffer_size, cell_pos);
+  if (coords_type == Datatype::INT16)
+    return sort_cell_pos<int16_t>(buffer, buffer_size, cell_pos);
+  if (coords_type == Datatype::UINT16)
+    return sort_cell_pos<uint16_t>(buffer, buffer_size, cell_pos);
+  if (coords_type == Datatype::UINT32)
+    return sort_cell_pos<uint32_t>(buffer, buffer_size, cell_pos);
+  if (coords_type == Datatype::UINT64)
+    return sort_cell_pos<uint64_t>(buffer, buffer_size, cell_pos);
+
+  return LOG_STATUS(Status::WriteStateError(
+      "Cannot sort cells; Unsupported coordinates type"));
 }
 
 template <class T>
-void WriteState::sort_cell_pos(
+Status WriteState::sort_cell_pos(
     const void* buffer,
     uint64_t buffer_size,
     std::vector<uint64_t>* cell_pos) const {
@@ -423,6 +575,16 @@ void WriteState::sort_cell_pos(
   for (uint64_t i = 0; i < buffer_cell_num; ++i)
     (*cell_pos)[i] = i;
 
+  // Integer coordinates are radix sorted, unless their keys are too wide
+  std::vector<uint64_t> ids;
+  if (std::is_integral<T>::value) {
+    bool sorted = false;
+    RETURN_NOT_OK(radix_sort_cell_pos<T>(
+        buffer_T, buffer_cell_num, cell_pos, &ids, &sorted));
+    if (sorted)
+      return Status::Ok();
+  }
+
   // Invoke the proper sort function, based on the cell order
   if (domain->tile_extents() == nullptr) {  // NO TILE GRID
     // Sort cell positions
@@ -443,11 +605,13 @@ void WriteState::sort_cell_pos(
         assert(0);
     }
   } else {  // TILE GRID
-    // Get tile ids
-    std::vector<uint64_t> ids;
-    ids.resize(buffer_cell_num);
-    for (uint64_t i = 0; i < buffer_cell_num; ++i)
-      ids[i] = domain->tile_id<T>(&buffer_T[i * dim_num], (T*)tile_coords_aux_);
+    // Get tile ids (unless the radix sort already computed them)
+    if (ids.empty()) {
+      ids.resize(buffer_cell_num);
+      for (uint64_t i = 0; i < buffer_cell_num; ++i)
+        ids[i] =
+            domain->tile_id<T>(&buffer_T[i * dim_num], (T*)tile_coords_aux_);
+    }
     // Sort cell positions
     switch (cell_order) {
       case Layout::ROW_MAJOR:
@@ -466,6 +630,44 @@ void WriteState::sort_cell_pos(
         assert(0);
     }
   }
+
+  return Status::Ok();
+}
+
+Status WriteState::train_zstd_dictionary(
+    unsigned int attribute_id,
+    const void* buffer,
+    uint64_t buffer_size,
+    uint64_t cell_num) {
+  // For easy reference
+  auto array_schema = fragment_->query()->array_schema();
+  auto attr = array_schema->attribute(attribute_id);
+
+  // Check if a dictionary applies
+  if (zstd_dictionary_size_ == 0 || zstd_dictionary_trained_[attribute_id] ||
+      attr->compressor() != Compressor::ZSTD || cell_num == 0)
+    return Status::Ok();
+  zstd_dictionary_trained_[attribute_id] = 1;
+
+  // The dictionary applies to the values tiles of var-sized attributes,
+  // whose size is estimated from the average cell size
+  bool var_size = attr->var_size();
+  auto tile = var_size ? tiles_var_[attribute_id] : tiles_[attribute_id];
+  auto tile_io = var_size ? tile_io_var_[attribute_id] : tile_io_[attribute_id];
+  uint64_t tile_size = fragment_->tile_size(attribute_id);
+  if (var_size)
+    tile_size = buffer_size *
+                (tile_size / constants::cell_var_offset_size) / cell_num;
+
+  // Train and store the dictionary (if any)
+  RETURN_NOT_OK(tile_io->train_dictionary(
+      tile, buffer, buffer_size, tile_size, zstd_dictionary_size_));
+  auto dictionary = tile_io->dictionary();
+  if (dictionary != nullptr)
+    metadata_->set_zstd_dictionary(
+        attribute_id, &dictionary->data()[0], dictionary->data().size());
+
+  return Status::Ok();
 }
 
 Status WriteState::update_metadata(const void* buffer, uint64_t buffer_size) {
@@ -563,6 +765,14 @@ Status WriteState::write_attr(
   if (attribute_id == attribute_num)
     RETURN_NOT_OK(update_metadata(buffer, buffer_size));
 
+  // Train the zstd dictionary before the first tile is compressed
+  if (attribute_id < attribute_num)
+    RETURN_NOT_OK(train_zstd_dictionary(
+        attribute_id,
+        buffer,
+        buffer_size,
+        buffer_size / array_schema->cell_size(attribute_id)));
+
   // Preparation
   auto buf = new ConstBuffer(buffer, buffer_size);
   auto tile = tiles_[attribute_id];
@@ -618,6 +828,13 @@ Status WriteState::write_attr_var(
     return Status::Ok();
   assert(buffer != nullptr && buffer_var != nullptr);
 
+  // Train the zstd dictionary before the first tile is compressed
+  RETURN_NOT_OK(train_zstd_dictionary(
+      attribute_id,
+      buffer_var,
+      buffer_var_size,
+      buffer_size / constants::cell_var_offset_size));
+
   auto buf = new ConstBuffer(buffer, buffer_size);
   auto buf_var = new ConstBuffer(buffer_var, buffer_var_size);
 
@@ -626,24 +843,24 @@ Status WriteState::write_attr_var(
   auto tile = tiles_[attribute_id];
   auto tile_var = tiles_var_[attribute_id];
   auto tile_io = tile_io_[attribute_id];
-  auto tile_io_var = tile_io_var_[attribute_id];
 
   // Fill tiles and dispatch them for writing
   uint64_t bytes_written = 0;
   uint64_t bytes_written_var = 0;
   do {
     RETURN_NOT_OK(tile->write_with_shift(buf, buffer_var_offset));
+
+    // The values up to the next cell in the buffer, which also holds when
+    // the tile was partially filled by a previous write
     uint64_t bytes_to_write_var =
-        (buf->end()) ?
-            buffer_var_offset + buffer_var_size - tile->value<uint64_t>(0) :
-            buffer_var_offset + buf->value<uint64_t>() -
-                tile->value<uint64_t>(0);
+        ((buf->end()) ? buffer_var_size : buf->value<uint64_t>()) -
+        buf_var->offset();
 
     RETURN_NOT_OK(tile_var->write(buf_var, bytes_to_write_var));
 
     if (tile->full()) {
       RETURN_NOT_OK(tile_io->write(tile, &bytes_written));
-      RETURN_NOT_OK(tile_io_var->write(tile_var, &bytes_written_var));
+      RETURN_NOT_OK(write_tile_var(attribute_id, &bytes_written_var));
       metadata_->append_tile_offset(attribute_id, bytes_written);
       metadata_->append_tile_var_offset(attribute_id, bytes_written_var);
       metadata_->append_tile_var_size(attribute_id, tile_var->size());
@@ -669,12 +886,11 @@ Status WriteState::write_attr_var_last(unsigned int attribute_id) {
   auto tile = tiles_[attribute_id];
   auto tile_var = tiles_var_[attribute_id];
   auto tile_io = tile_io_[attribute_id];
-  auto tile_io_var = tile_io_var_[attribute_id];
 
   // Fill tiles and dispatch them for writing
   uint64_t bytes_written, bytes_written_var;
   RETURN_NOT_OK(tile_io->write(tile, &bytes_written));
-  RETURN_NOT_OK(tile_io_var->write(tile_var, &bytes_written_var));
+  RETURN_NOT_OK(write_tile_var(attribute_id, &bytes_written_var));
   metadata_->append_tile_offset(attribute_id, bytes_written);
   metadata_->append_tile_var_offset(attribute_id, bytes_written_var);
   metadata_->append_tile_var_size(attribute_id, tile_var->size());
@@ -698,15 +914,19 @@ Status WriteState::write_last_tile() {
   metadata_->set_last_tile_cell_num(tile_cell_num_[attribute_num]);
 
   // Flush the last tile for each compressed attribute (it is still in main
-  // memory
+  // memory)
+  std::vector<std::function<Status()>> tasks;
   for (unsigned int i = 0; i < attribute_num + 1; ++i) {
-    RETURN_NOT_OK(write_attr_last(i));
-    if (array_schema->var_size(i))
-      RETURN_NOT_OK(write_attr_var_last(i));
+    bool var_size = array_schema->var_size(i);
+    tasks.emplace_back([this, i, var_size]() {
+      RETURN_NOT_OK(write_attr_last(i));
+      if (var_size)
+        RETURN_NOT_OK(write_attr_var_last(i));
+      return Status::Ok();
+    });
   }
 
-  // Success
-  return Status::Ok();
+  return run_parallel(tasks);
 }
 
 Status WriteState::write_sparse_unordered(
@@ -723,33 +943,48 @@ Status WriteState::write_sparse_unordered(
 
   // Sort cell positions
   std::vector<uint64_t> cell_pos;
-  sort_cell_pos(
-      buffers[coords_buffer_i], buffer_sizes[coords_buffer_i], &cell_pos);
+  RETURN_NOT_OK(sort_cell_pos(
+      buffers[coords_buffer_i], buffer_sizes[coords_buffer_i], &cell_pos));
 
-  // Write each attribute individually
+  // Write the attributes in parallel, as they are stored in separate files
+  std::vector<std::function<Status()>> tasks;
   int buffer_i = 0;
   for (int i = 0; i < attribute_id_num; ++i) {
-    if (!array_schema->var_size(attribute_ids[i])) {  // FIXED CELLS
-      RETURN_NOT_OK(write_sparse_unordered_attr(
-          attribute_ids[i],
-          buffers[buffer_i],
-          buffer_sizes[buffer_i],
-          cell_pos));
+    auto attribute_id = attribute_ids[i];
+    if (!array_schema->var_size(attribute_id)) {  // FIXED CELLS
+      auto buffer = buffers[buffer_i];
+      auto buffer_size = buffer_sizes[buffer_i];
+      tasks.emplace_back(
+          [this, attribute_id, buffer, buffer_size, &cell_pos]() {
+            return write_sparse_unordered_attr(
+                attribute_id, buffer, buffer_size, cell_pos);
+          });
       ++buffer_i;
     } else {  // VARIABLE-SIZED CELLS
-      RETURN_NOT_OK(write_sparse_unordered_attr_var(
-          attribute_ids[i],
-          buffers[buffer_i],  // offsets
-          buffer_sizes[buffer_i],
-          buffers[buffer_i + 1],  // actual values
-          buffer_sizes[buffer_i + 1],
-          cell_pos));
+      auto buffer = buffers[buffer_i];  // offsets
+      auto buffer_size = buffer_sizes[buffer_i];
+      auto buffer_var = buffers[buffer_i + 1];  // actual values
+      auto buffer_var_size = buffer_sizes[buffer_i + 1];
+      tasks.emplace_back([this,
+                          attribute_id,
+                          buffer,
+                          buffer_size,
+                          buffer_var,
+                          buffer_var_size,
+                          &cell_pos]() {
+        return write_sparse_unordered_attr_var(
+            attribute_id,
+            buffer,
+            buffer_size,
+            buffer_var,
+            buffer_var_size,
+            cell_pos);
+      });
       buffer_i += 2;
     }
   }
 
-  // Success
-  return Status::Ok();
+  return run_parallel(tasks);
 }
 
 Status WriteState::write_sparse_unordered_attr(
@@ -886,5 +1121,29 @@ Status WriteState::write_sparse_unordered_attr_var(
   return st;
 }
 
+Status WriteState::write_tile_var(
+    unsigned int attribute_id, uint64_t* bytes_written) {
+  auto tile_var = tiles_var_[attribute_id];
+  auto tile_io_var = tile_io_var_[attribute_id];
+  auto filters = tile_var->filters();
+  if (filters == nullptr || !filters->contains(FilterType::FILTER_DICTIONARY))
+    return tile_io_var->write(tile_var, bytes_written);
+
+  // Write the encoded tile in place of the values tile
+  Buffer encoded;
+  RETURN_NOT_OK(DictionaryEncoding::encode(
+      tiles_[attribute_id], tile_var, &encoded));
+  Tile tile(
+      tile_var->type(),
+      tile_var->compressor(),
+      tile_var->compression_level(),
+      tile_var->cell_size(),
+      0,
+      &encoded,
+      false);
+  tile.set_filters(filters);
+  return tile_io_var->write(&tile, bytes_written);
+}
+
 }  // namespace sm
 }  // namespace tiledb
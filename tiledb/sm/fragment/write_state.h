@@ -39,6 +39,7 @@
 #include "tiledb/sm/tile/tile.h"
 #include "tiledb/sm/tile/tile_io.h"
 
+#include <functional>
 #include <iostream>
 #include <vector>
 
@@ -146,6 +147,19 @@ class WriteState {
    */
   std::vector<TileIO*> tile_io_var_;
 
+  /**
+   * The maximum size of the zstd dictionary trained for each `ZSTD`
+   * compressed attribute (`0` if dictionaries are disabled).
+   */
+  uint64_t zstd_dictionary_size_;
+
+  /**
+   * Whether a zstd dictionary has been trained (or training was attempted)
+   * for each attribute. This is not a `std::vector<bool>`, as the
+   * attributes are written concurrently.
+   */
+  std::vector<uint8_t> zstd_dictionary_trained_;
+
   /* ********************************* */
   /*           PRIVATE METHODS         */
   /* ********************************* */
@@ -166,6 +180,44 @@ class WriteState {
   /** Initializes the internal Tile I/O structures. */
   Status init_tile_io();
 
+  /**
+   * Sorts the input integer cell coordinates with a parallel radix sort on
+   * the compute thread pool. Each cell is packed into a 64-bit key holding
+   * its tile id followed by its coordinates relative to the minimum
+   * coordinates in the buffer, ordered by the cell order, so that the keys
+   * sort like `SmallerIdRow`/`SmallerIdCol` (or `SmallerRow`/`SmallerCol`
+   * if there is no tile grid). If the keys do not fit in 64 bits, nothing
+   * is sorted and the caller should fall back to a comparison sort.
+   *
+   * @tparam T The (integer) type of coordinates stored in *buffer*.
+   * @param buffer The buffer holding the cell coordinates.
+   * @param cell_num The number of cells in *buffer*.
+   * @param cell_pos The cell positions, which are permuted into sorted order.
+   * @param ids The tile ids of the cells are stored here if there is a tile
+   *     grid and the keys do not fit in 64 bits (left empty otherwise).
+   * @param sorted Set to `true` if the cells were sorted.
+   * @return Status
+   */
+  template <class T>
+  Status radix_sort_cell_pos(
+      const T* buffer,
+      uint64_t cell_num,
+      std::vector<uint64_t>* cell_pos,
+      std::vector<uint64_t>* ids,
+      bool* sorted) const;
+
+  /**
+   * Runs the input tasks in parallel on the compute thread pool of the
+   * storage manager, and waits for all of them to complete. Each task
+   * writes a different attribute, so the tasks share no state other than
+   * the (per-attribute) fragment metadata. The allocations of the tasks are
+   * attributed to the memory tracker of the calling thread.
+   *
+   * @param tasks The tasks to run.
+   * @return The status of the first task that failed, or Status::Ok.
+   */
+  Status run_parallel(const std::vector<std::function<Status()>>& tasks);
+
   /**
    * Sorts the input cell coordinates according to the order specified in the
    * array schema. This is not done in place; the sorted positions are stored
@@ -174,9 +226,9 @@ class WriteState {
    * @param buffer The buffer holding the cell coordinates.
    * @param buffer_size The size (in bytes) of *buffer*.
    * @param cell_pos The sorted cell positions.
-   * @return void
+   * @return Status
    */
-  void sort_cell_pos(
+  Status sort_cell_pos(
       const void* buffer,
       uint64_t buffer_size,
       std::vector<uint64_t>* cell_pos) const;
@@ -190,14 +242,34 @@ class WriteState {
    * @param buffer The buffer holding the cell coordinates.
    * @param buffer_size The size (in bytes) of *buffer*.
    * @param cell_pos The sorted cell positions.
-   * @return void
+   * @return Status
    */
   template <class T>
-  void sort_cell_pos(
+  Status sort_cell_pos(
       const void* buffer,
       uint64_t buffer_size,
       std::vector<uint64_t>* cell_pos) const;
 
+  /**
+   * Trains the zstd dictionary of the input attribute on samples of the
+   * first cells written to it, and stores it in the fragment metadata. This
+   * is done only once per attribute, before its first tile is written, and
+   * only if dictionaries are enabled and the attribute is compressed with
+   * `ZSTD`.
+   *
+   * @param attribute_id The id of the attribute this operation focuses on.
+   * @param buffer The buffer with the cell values (the variable-sized
+   *     values, if the attribute is var-sized).
+   * @param buffer_size The size of `buffer`.
+   * @param cell_num The number of cells in `buffer`.
+   * @return Status
+   */
+  Status train_zstd_dictionary(
+      unsigned int attribute_id,
+      const void* buffer,
+      uint64_t buffer_size,
+      uint64_t cell_num);
+
   /**
    * Updates the metadata structures as tiles are written. Specifically, it
    * updates the MBR and bounding coordinates of each tile.
@@ -319,6 +391,17 @@ class WriteState {
       void* buffer_var,
       uint64_t buffer_var_size,
       const std::vector<uint64_t>& cell_pos);
+
+  /**
+   * Writes the current variable-sized values tile of the input attribute to
+   * the disk, dictionary encoding it first if the attribute has the
+   * dictionary filter.
+   *
+   * @param attribute_id The id of the attribute this operation focuses on.
+   * @param bytes_written Set to the number of bytes written to the disk.
+   * @return Status
+   */
+  Status write_tile_var(unsigned int attribute_id, uint64_t* bytes_written);
 };
 
 }  // namespace sm
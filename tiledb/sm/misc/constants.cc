@@ -62,6 +62,13 @@ const char* kv_schema_filename = "__kv_schema.tdb";
 /** The fragment metadata file name. */
 const char* fragment_metadata_filename = "__fragment_metadata.tdb";
 
+/** The name of the file with the consolidated fragment metadata of an array. */
+const char* consolidated_fragment_metadata_filename =
+    "__consolidated_fragment_metadata.tdb";
+
+/** The format version of the consolidated fragment metadata file. */
+const uint32_t consolidated_fragment_metadata_version = 1;
+
 /** The default tile capacity. */
 const uint64_t capacity = 10000;
 
@@ -170,9 +177,6 @@ const char* group_filename = "__tiledb_group.tdb";
 /** The initial internal buffer size for the case of sparse arrays. */
 const uint64_t internal_buffer_size = 10000000;
 
-/** The buffer size for each attribute used in consolidation. */
-const uint64_t consolidation_buffer_size = 50000000;
-
 /** The maximum number of bytes written in a single I/O. */
 const uint64_t max_write_bytes = std::numeric_limits<int>::max();
 
@@ -211,6 +215,93 @@ const uint64_t fragment_metadata_cache_size = 10000000;
 /** The tile cache size. */
 const uint64_t tile_cache_size = 10000000;
 
+/** The maximum number of bytes cached in the buffer pool. */
+const uint64_t buffer_pool_size = 100000000;
+
+/** The minimum size of a buffer drawn from the buffer pool. */
+const uint64_t buffer_pool_min_alloc_size = 65536;
+
+/** The memory budget of a storage manager (`0` means unlimited). */
+const uint64_t memory_budget = 0;
+
+/** The time a query waits for memory budget before failing. */
+const uint64_t memory_budget_timeout_ms = 0;
+
+/** The default number of threads of the compute thread pool. */
+const uint64_t num_compute_threads = std::thread::hardware_concurrency();
+
+/** The number of tile slabs an ordered read or write pipelines. */
+const uint64_t tile_slab_num = 2;
+
+/** The maximum size of the write buffer of an array (`0` disables it). */
+const uint64_t write_buffer_size = 0;
+
+/** The age after which an array write buffer is flushed upon a write. */
+const uint64_t write_buffer_flush_ms = 10000;
+
+/** The consolidation policy, `full` or `tiered`. */
+const char* consolidation_policy = "full";
+
+/** The minimum number of fragments a tiered consolidation merges. */
+const uint64_t consolidation_min_fragments = 4;
+
+/** The maximum number of fragments a tiered consolidation merges. */
+const uint64_t consolidation_max_fragments = 16;
+
+/** The maximum size ratio of the fragments of a consolidation tier. */
+const uint64_t consolidation_size_ratio = 4;
+
+/** The memory budget in bytes of the buffers of a consolidation. */
+const uint64_t consolidation_memory_budget = 1000000000;
+
+/** The default number of partitions a consolidation reads concurrently. */
+const uint64_t consolidation_threads = std::thread::hardware_concurrency();
+
+/** The period of the auto-consolidation in ms (`0` disables it). */
+const uint64_t auto_consolidation_interval_ms = 0;
+
+/** The number of fragments that triggers an auto-consolidation. */
+const uint64_t auto_consolidation_fragment_num = 16;
+
+/** The size in bytes under which a fragment counts as small. */
+const uint64_t auto_consolidation_small_fragment_size = 10000000;
+
+/** The read amplification that triggers an auto-consolidation. */
+const uint64_t auto_consolidation_read_amplification = 8;
+
+/** The I/O budget of the auto-consolidation in bytes per second. */
+const uint64_t auto_consolidation_io_budget = 0;
+
+/** The memory budget of an out-of-core unordered write (`0` disables it). */
+const uint64_t external_sort_memory = 0;
+
+/** The scratch directory of out-of-core writes (empty for the temp dir). */
+const char* external_sort_scratch_dir = "";
+
+/** The size of the reads and writes of the out-of-core write run files. */
+const uint64_t external_sort_io_size = 1048576;
+
+/** The minimum number of items each thread of a parallel sort works on. */
+const uint64_t parallel_sort_min_chunk_size = 65536;
+
+/** The objective of the AUTO compressor when selecting a tile compressor. */
+const char* auto_compression_objective = "balanced";
+
+/** The number of bytes of a tile the AUTO compressor tries compressors on. */
+const uint64_t auto_compression_sample_size = 16384;
+
+/** The number of slices the AUTO compressor sample is taken from. */
+const uint64_t auto_compression_sample_slices = 4;
+
+/** The maximum size of a trained zstd dictionary (`0` disables them). */
+const uint64_t zstd_dictionary_size = 0;
+
+/** The minimum number of samples a zstd dictionary is trained on. */
+const uint64_t zstd_dictionary_min_samples = 16;
+
+/** How many bytes of samples a zstd dictionary is trained on per byte. */
+const uint64_t zstd_dictionary_sample_ratio = 100;
+
 /** String describing GZIP. */
 const char* gzip_str = "GZIP";
 
@@ -247,6 +338,36 @@ const char* bzip2_str = "BZIP2";
 /** String describing DOUBLE_DELTA. */
 const char* double_delta_str = "DOUBLE_DELTA";
 
+/** String describing AUTO. */
+const char* auto_str = "AUTO";
+
+/** String describing FILTER_BYTESHUFFLE. */
+const char* filter_byteshuffle_str = "BYTESHUFFLE";
+
+/** String describing FILTER_BITSHUFFLE. */
+const char* filter_bitshuffle_str = "BITSHUFFLE";
+
+/** String describing FILTER_DELTA. */
+const char* filter_delta_str = "DELTA";
+
+/** String describing FILTER_BIT_WIDTH_REDUCTION. */
+const char* filter_bit_width_reduction_str = "BIT_WIDTH_REDUCTION";
+
+/** String describing FILTER_DICTIONARY. */
+const char* filter_dictionary_str = "DICTIONARY";
+
+/** String describing FILTER_QUANTIZE. */
+const char* filter_quantize_str = "QUANTIZE";
+
+/** String describing FILTER_MANTISSA_TRUNCATION. */
+const char* filter_mantissa_truncation_str = "MANTISSA_TRUNCATION";
+
+/**
+ * The number of values in each window of the bit-width reduction filter.
+ * Each window is encoded with its own minimum value and bit width.
+ */
+const uint64_t filter_bit_width_reduction_window = 256;
+
 /** The string representation for type int32. */
 const char* int32_str = "INT32";
 
@@ -326,6 +447,24 @@ const char* null_str = "null";
 const int version[3] = {
     TILEDB_VERSION_MAJOR, TILEDB_VERSION_MINOR, TILEDB_VERSION_PATCH};
 
+/** The version of the array schema format. */
+const int array_schema_version[3] = {1, 4, 0};
+
+/** The first array schema format version with filter pipelines. */
+const int array_schema_filters_version[3] = {1, 4, 0};
+
+/**
+ * The number of cells whose coordinates are split or zipped at a time, so
+ * that each block of cells is transposed while it is cached.
+ */
+const uint64_t coords_transpose_block_cell_num = 1024;
+
+/**
+ * The number of bytes read along with the header of a generic tile, which
+ * covers small generic tiles (e.g., array schemas) in a single read.
+ */
+const uint64_t generic_tile_read_size = 65536;
+
 /** The size of a tile chunk. */
 const uint64_t tile_chunk_size = (uint64_t)std::numeric_limits<int>::max();
 
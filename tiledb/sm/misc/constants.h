@@ -142,6 +142,12 @@ extern const char* file_suffix;
 /** The fragment metadata file name. */
 extern const char* fragment_metadata_filename;
 
+/** The name of the file with the consolidated fragment metadata of an array. */
+extern const char* consolidated_fragment_metadata_filename;
+
+/** The format version of the consolidated fragment metadata file. */
+extern const uint32_t consolidated_fragment_metadata_version;
+
 /** Default datatype for a generic tile. */
 extern const Datatype generic_tile_datatype;
 
@@ -160,9 +166,6 @@ extern const char* group_filename;
 /** The initial internal buffer size for the case of sparse arrays. */
 extern const uint64_t internal_buffer_size;
 
-/** The buffer size for each attribute used in consolidation. */
-extern const uint64_t consolidation_buffer_size;
-
 /** The maximum number of bytes written in a single I/O. */
 extern const uint64_t max_write_bytes;
 
@@ -199,6 +202,93 @@ extern const uint64_t fragment_metadata_cache_size;
 /** The tile cache size. */
 extern const uint64_t tile_cache_size;
 
+/** The maximum number of bytes cached in the buffer pool. */
+extern const uint64_t buffer_pool_size;
+
+/** The minimum size of a buffer drawn from the buffer pool. */
+extern const uint64_t buffer_pool_min_alloc_size;
+
+/** The memory budget of a storage manager (`0` means unlimited). */
+extern const uint64_t memory_budget;
+
+/** The time a query waits for memory budget before failing. */
+extern const uint64_t memory_budget_timeout_ms;
+
+/** The default number of threads of the compute thread pool. */
+extern const uint64_t num_compute_threads;
+
+/** The number of tile slabs an ordered read or write pipelines. */
+extern const uint64_t tile_slab_num;
+
+/** The maximum size of the write buffer of an array (`0` disables it). */
+extern const uint64_t write_buffer_size;
+
+/** The age after which an array write buffer is flushed upon a write. */
+extern const uint64_t write_buffer_flush_ms;
+
+/** The consolidation policy, `full` or `tiered`. */
+extern const char* consolidation_policy;
+
+/** The minimum number of fragments a tiered consolidation merges. */
+extern const uint64_t consolidation_min_fragments;
+
+/** The maximum number of fragments a tiered consolidation merges. */
+extern const uint64_t consolidation_max_fragments;
+
+/** The maximum size ratio of the fragments of a consolidation tier. */
+extern const uint64_t consolidation_size_ratio;
+
+/** The memory budget in bytes of the buffers of a consolidation. */
+extern const uint64_t consolidation_memory_budget;
+
+/** The default number of partitions a consolidation reads concurrently. */
+extern const uint64_t consolidation_threads;
+
+/** The period of the auto-consolidation in ms (`0` disables it). */
+extern const uint64_t auto_consolidation_interval_ms;
+
+/** The number of fragments that triggers an auto-consolidation. */
+extern const uint64_t auto_consolidation_fragment_num;
+
+/** The size in bytes under which a fragment counts as small. */
+extern const uint64_t auto_consolidation_small_fragment_size;
+
+/** The read amplification that triggers an auto-consolidation. */
+extern const uint64_t auto_consolidation_read_amplification;
+
+/** The I/O budget of the auto-consolidation in bytes per second. */
+extern const uint64_t auto_consolidation_io_budget;
+
+/** The memory budget of an out-of-core unordered write (`0` disables it). */
+extern const uint64_t external_sort_memory;
+
+/** The scratch directory of out-of-core writes (empty for the temp dir). */
+extern const char* external_sort_scratch_dir;
+
+/** The size of the reads and writes of the out-of-core write run files. */
+extern const uint64_t external_sort_io_size;
+
+/** The minimum number of items each thread of a parallel sort works on. */
+extern const uint64_t parallel_sort_min_chunk_size;
+
+/** The objective of the AUTO compressor when selecting a tile compressor. */
+extern const char* auto_compression_objective;
+
+/** The number of bytes of a tile the AUTO compressor tries compressors on. */
+extern const uint64_t auto_compression_sample_size;
+
+/** The number of slices the AUTO compressor sample is taken from. */
+extern const uint64_t auto_compression_sample_slices;
+
+/** The maximum size of a trained zstd dictionary (`0` disables them). */
+extern const uint64_t zstd_dictionary_size;
+
+/** The minimum number of samples a zstd dictionary is trained on. */
+extern const uint64_t zstd_dictionary_min_samples;
+
+/** How many bytes of samples a zstd dictionary is trained on per byte. */
+extern const uint64_t zstd_dictionary_sample_ratio;
+
 /** String describing GZIP. */
 extern const char* gzip_str;
 
@@ -235,6 +325,36 @@ extern const char* bzip2_str;
 /** String describing DOUBLE_DELTA. */
 extern const char* double_delta_str;
 
+/** String describing AUTO. */
+extern const char* auto_str;
+
+/** String describing FILTER_BYTESHUFFLE. */
+extern const char* filter_byteshuffle_str;
+
+/** String describing FILTER_BITSHUFFLE. */
+extern const char* filter_bitshuffle_str;
+
+/** String describing FILTER_DELTA. */
+extern const char* filter_delta_str;
+
+/** String describing FILTER_BIT_WIDTH_REDUCTION. */
+extern const char* filter_bit_width_reduction_str;
+
+/** String describing FILTER_DICTIONARY. */
+extern const char* filter_dictionary_str;
+
+/** String describing FILTER_QUANTIZE. */
+extern const char* filter_quantize_str;
+
+/** String describing FILTER_MANTISSA_TRUNCATION. */
+extern const char* filter_mantissa_truncation_str;
+
+/**
+ * The number of values in each window of the bit-width reduction filter.
+ * Each window is encoded with its own minimum value and bit width.
+ */
+extern const uint64_t filter_bit_width_reduction_window;
+
 /** The string representation for type int32. */
 extern const char* int32_str;
 
@@ -313,6 +433,28 @@ extern const char* null_str;
 /** The version in format { major, minor, revision }. */
 extern const int version[3];
 
+/**
+ * The version of the array schema format in format { major, minor,
+ * revision }. Schemas of an older version have no filter pipelines, and
+ * schemas of a newer version cannot be loaded.
+ */
+extern const int array_schema_version[3];
+
+/** The first array schema format version with filter pipelines. */
+extern const int array_schema_filters_version[3];
+
+/**
+ * The number of cells whose coordinates are split or zipped at a time, so
+ * that each block of cells is transposed while it is cached.
+ */
+extern const uint64_t coords_transpose_block_cell_num;
+
+/**
+ * The number of bytes read along with the header of a generic tile, which
+ * covers small generic tiles (e.g., array schemas) in a single read.
+ */
+extern const uint64_t generic_tile_read_size;
+
 /** The size of a tile chunk. */
 extern const uint64_t tile_chunk_size;
 
@@ -0,0 +1,181 @@
+/**
+ * @file   memory_tracker.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2018 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file defines the MemoryTracker class.
+ */
+
+#include "tiledb/sm/misc/memory_tracker.h"
+#include "tiledb/sm/misc/stats.h"
+
+namespace tiledb {
+namespace sm {
+
+namespace {
+
+/** The tracker allocations of the current thread are attributed to. */
+thread_local std::shared_ptr<MemoryTracker> current_thread_tracker;
+
+/** Raises `stat` to `value` if it is smaller. */
+void atomic_max(std::atomic<uint64_t>* stat, uint64_t value) {
+  uint64_t prev = stat->load();
+  while (prev < value && !stat->compare_exchange_weak(prev, value)) {
+  }
+}
+
+}  // namespace
+
+/* ****************************** */
+/*   CONSTRUCTORS & DESTRUCTORS   */
+/* ****************************** */
+
+MemoryTracker::MemoryTracker(
+    const std::shared_ptr<MemoryTracker>& parent,
+    std::atomic<uint64_t>* current_stat,
+    std::atomic<uint64_t>* peak_stat)
+    : current_(0)
+    , current_stat_(current_stat)
+    , parent_(parent)
+    , peak_(0)
+    , peak_stat_(peak_stat) {
+}
+
+MemoryTracker::~MemoryTracker() {
+  // Release whatever is still recorded, so that the ancestors stay accurate
+  if (current_ > 0 && parent_ != nullptr)
+    parent_->record_free(current_);
+}
+
+/* ****************************** */
+/*               API              */
+/* ****************************** */
+
+std::shared_ptr<BufferPool> MemoryTracker::buffer_pool() const {
+  if (buffer_pool_ != nullptr || parent_ == nullptr)
+    return buffer_pool_;
+  return parent_->buffer_pool();
+}
+
+uint64_t MemoryTracker::current() const {
+  return current_;
+}
+
+const std::shared_ptr<MemoryTracker>& MemoryTracker::global() {
+  // Never destroyed, as buffers may be freed during static destruction
+  static auto tracker = new std::shared_ptr<MemoryTracker>(new MemoryTracker(
+      nullptr,
+      &stats::all_stats.counter_memory_current_bytes,
+      &stats::all_stats.counter_memory_peak_bytes));
+  return *tracker;
+}
+
+const std::shared_ptr<MemoryTracker>& MemoryTracker::parent() const {
+  return parent_;
+}
+
+uint64_t MemoryTracker::peak() const {
+  return peak_;
+}
+
+void MemoryTracker::record_alloc(uint64_t nbytes) {
+  uint64_t current = (current_ += nbytes);
+  atomic_max(&peak_, current);
+
+  if (stats::all_stats.enabled()) {
+    if (current_stat_ != nullptr)
+      *current_stat_ = current;
+    if (peak_stat_ != nullptr)
+      atomic_max(peak_stat_, current);
+    if (parent_ == nullptr)
+      stats::all_stats.counter_memory_alloc_total_bytes += nbytes;
+  }
+
+  if (parent_ != nullptr)
+    parent_->record_alloc(nbytes);
+}
+
+void MemoryTracker::record_free(uint64_t nbytes) {
+  uint64_t current = (current_ -= nbytes);
+
+  if (current_stat_ != nullptr && stats::all_stats.enabled())
+    *current_stat_ = current;
+
+  if (parent_ != nullptr)
+    parent_->record_free(nbytes);
+}
+
+void MemoryTracker::set_buffer_pool(
+    const std::shared_ptr<BufferPool>& buffer_pool) {
+  buffer_pool_ = buffer_pool;
+}
+
+std::shared_ptr<MemoryTracker> MemoryTracker::thread_tracker() {
+  return (current_thread_tracker != nullptr) ? current_thread_tracker :
+                                               global();
+}
+
+/* ****************************** */
+/*       ScopedMemoryTracker      */
+/* ****************************** */
+
+ScopedMemoryTracker::ScopedMemoryTracker(
+    const std::shared_ptr<MemoryTracker>& tracker)
+    : prev_tracker_(current_thread_tracker) {
+  current_thread_tracker = tracker;
+}
+
+ScopedMemoryTracker::~ScopedMemoryTracker() {
+  current_thread_tracker = prev_tracker_;
+}
+
+/* ****************************** */
+/*        ScopedMemoryUsage       */
+/* ****************************** */
+
+ScopedMemoryUsage::ScopedMemoryUsage(
+    const std::shared_ptr<MemoryTracker>& tracker)
+    : nbytes_(0)
+    , tracker_(tracker) {
+}
+
+ScopedMemoryUsage::~ScopedMemoryUsage() {
+  set(0);
+}
+
+void ScopedMemoryUsage::set(uint64_t nbytes) {
+  if (tracker_ == nullptr)
+    return;
+  if (nbytes > nbytes_)
+    tracker_->record_alloc(nbytes - nbytes_);
+  else if (nbytes < nbytes_)
+    tracker_->record_free(nbytes_ - nbytes);
+  nbytes_ = nbytes;
+}
+
+}  // namespace sm
+}  // namespace tiledb
@@ -0,0 +1,194 @@
+/**
+ * @file   memory_tracker.h
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2018 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file declares the MemoryTracker class.
+ */
+
+#ifndef TILEDB_MEMORY_TRACKER_H
+#define TILEDB_MEMORY_TRACKER_H
+
+#include <atomic>
+#include <cinttypes>
+#include <memory>
+
+namespace tiledb {
+namespace sm {
+
+class BufferPool;
+
+/**
+ * Keeps track of the current and peak number of bytes allocated on behalf
+ * of an entity, such as a query or a context. Trackers form a hierarchy:
+ * every allocation recorded in a tracker is also recorded in its parent,
+ * up to the process-wide tracker returned by `global()`.
+ *
+ * Allocations are attributed to the tracker of the calling thread (see
+ * `thread_tracker()`), which is set by `ScopedMemoryTracker`. A tracker may
+ * also provide the pool buffers draw their memory from.
+ */
+class MemoryTracker {
+ public:
+  /* ********************************* */
+  /*     CONSTRUCTORS & DESTRUCTORS    */
+  /* ********************************* */
+
+  /**
+   * Constructor.
+   *
+   * @param parent The parent tracker (`nullptr` for a root tracker).
+   * @param current_stat If not `nullptr`, a stats counter that is set to
+   *     the current usage of this tracker while stats are enabled.
+   * @param peak_stat If not `nullptr`, a stats counter that is raised to
+   *     the peak usage of this tracker while stats are enabled.
+   */
+  MemoryTracker(
+      const std::shared_ptr<MemoryTracker>& parent,
+      std::atomic<uint64_t>* current_stat = nullptr,
+      std::atomic<uint64_t>* peak_stat = nullptr);
+
+  /** Destructor. */
+  ~MemoryTracker();
+
+  /* ********************************* */
+  /*                API                */
+  /* ********************************* */
+
+  /**
+   * Returns the pool buffers attributed to this tracker draw their memory
+   * from. This is the pool of the closest tracker in the hierarchy that has
+   * one, or `nullptr` if there is none.
+   */
+  std::shared_ptr<BufferPool> buffer_pool() const;
+
+  /** Returns the number of bytes currently allocated. */
+  uint64_t current() const;
+
+  /** Returns the process-wide tracker, i.e., the root of all trackers. */
+  static const std::shared_ptr<MemoryTracker>& global();
+
+  /** Returns the parent tracker (`nullptr` for a root tracker). */
+  const std::shared_ptr<MemoryTracker>& parent() const;
+
+  /** Returns the maximum number of bytes allocated at any point in time. */
+  uint64_t peak() const;
+
+  /** Records the allocation of `nbytes` bytes. */
+  void record_alloc(uint64_t nbytes);
+
+  /** Records the deallocation of `nbytes` bytes. */
+  void record_free(uint64_t nbytes);
+
+  /**
+   * Sets the buffer pool of the tracker (and of its descendants that do
+   * not set their own). This must be called before the tracker is used.
+   */
+  void set_buffer_pool(const std::shared_ptr<BufferPool>& buffer_pool);
+
+  /**
+   * Returns the tracker allocations of the calling thread are attributed
+   * to. This is the process-wide tracker, unless the thread is within the
+   * scope of a `ScopedMemoryTracker`.
+   */
+  static std::shared_ptr<MemoryTracker> thread_tracker();
+
+ private:
+  /* ********************************* */
+  /*         PRIVATE ATTRIBUTES        */
+  /* ********************************* */
+
+  /** The buffer pool. */
+  std::shared_ptr<BufferPool> buffer_pool_;
+
+  /** The number of bytes currently allocated. */
+  std::atomic<uint64_t> current_;
+
+  /** A stats counter set to `current_`. */
+  std::atomic<uint64_t>* current_stat_;
+
+  /** The parent tracker. */
+  std::shared_ptr<MemoryTracker> parent_;
+
+  /** The maximum number of bytes allocated at any point in time. */
+  std::atomic<uint64_t> peak_;
+
+  /** A stats counter raised to `peak_`. */
+  std::atomic<uint64_t>* peak_stat_;
+};
+
+/**
+ * Attributes the allocations of the calling thread to a tracker for the
+ * lifetime of the object, restoring the previous tracker upon destruction.
+ */
+class ScopedMemoryTracker {
+ public:
+  /** Constructor. */
+  explicit ScopedMemoryTracker(const std::shared_ptr<MemoryTracker>& tracker);
+
+  /** Destructor. */
+  ~ScopedMemoryTracker();
+
+  ScopedMemoryTracker(const ScopedMemoryTracker&) = delete;
+  ScopedMemoryTracker& operator=(const ScopedMemoryTracker&) = delete;
+
+ private:
+  /** The tracker of the calling thread before this object was created. */
+  std::shared_ptr<MemoryTracker> prev_tracker_;
+};
+
+/**
+ * Records a number of bytes as allocated in a tracker for the lifetime
+ * of the object. This is used to account for structures that are not
+ * allocated through `Buffer`, such as the lists built by sparse reads.
+ */
+class ScopedMemoryUsage {
+ public:
+  /** Constructor. */
+  explicit ScopedMemoryUsage(const std::shared_ptr<MemoryTracker>& tracker);
+
+  /** Destructor. Releases the recorded bytes. */
+  ~ScopedMemoryUsage();
+
+  ScopedMemoryUsage(const ScopedMemoryUsage&) = delete;
+  ScopedMemoryUsage& operator=(const ScopedMemoryUsage&) = delete;
+
+  /** Sets the number of bytes recorded as allocated to `nbytes`. */
+  void set(uint64_t nbytes);
+
+ private:
+  /** The number of bytes currently recorded. */
+  uint64_t nbytes_;
+
+  /** The tracker. */
+  std::shared_ptr<MemoryTracker> tracker_;
+};
+
+}  // namespace sm
+}  // namespace tiledb
+
+#endif  // TILEDB_MEMORY_TRACKER_H
@@ -0,0 +1,166 @@
+/**
+ * @file   radix_sort.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2018 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file implements a parallel LSD radix sort on 64-bit keys.
+ */
+
+#include "tiledb/sm/misc/radix_sort.h"
+#include "tiledb/sm/misc/constants.h"
+#include "tiledb/sm/misc/logger.h"
+#include "tiledb/sm/misc/thread_pool.h"
+
+#include <algorithm>
+#include <future>
+
+namespace tiledb {
+namespace sm {
+
+namespace utils {
+
+/** The number of key bits sorted on in each radix sort pass. */
+static const unsigned RADIX_DIGIT_BITS = 8;
+
+/** The number of distinct digits of a radix sort pass. */
+static const uint64_t RADIX = uint64_t(1) << RADIX_DIGIT_BITS;
+
+uint64_t parallel_chunk_num(const ThreadPool* tp, uint64_t n) {
+  if (tp == nullptr)
+    return 1;
+
+  uint64_t chunk_num = n / constants::parallel_sort_min_chunk_size;
+  chunk_num = std::min(chunk_num, tp->num_threads());
+  return std::max(chunk_num, (uint64_t)1);
+}
+
+Status parallel_chunks(
+    ThreadPool* tp,
+    uint64_t n,
+    uint64_t chunk_num,
+    const std::function<Status(uint64_t, uint64_t, uint64_t)>& f) {
+  if (chunk_num <= 1)
+    return f(0, 0, n);
+
+  uint64_t chunk_size = (n + chunk_num - 1) / chunk_num;
+  std::vector<std::future<Status>> results;
+  for (uint64_t c = 0; c < chunk_num; ++c) {
+    uint64_t begin = std::min(c * chunk_size, n);
+    uint64_t end = std::min(begin + chunk_size, n);
+    results.push_back(
+        tp->enqueue([&f, c, begin, end]() { return f(c, begin, end); }));
+  }
+
+  return tp->wait_all_status(results);
+}
+
+Status radix_sort(
+    ThreadPool* tp,
+    unsigned key_bits,
+    std::vector<uint64_t>* keys,
+    std::vector<uint64_t>* values) {
+  uint64_t n = keys->size();
+  if (values->size() != n)
+    return LOG_STATUS(Status::Error(
+        "Cannot radix sort; The numbers of keys and values differ"));
+  if (n < 2 || key_bits == 0)
+    return Status::Ok();
+
+  uint64_t chunk_num = parallel_chunk_num(tp, n);
+  std::vector<uint64_t> keys_out(n);
+  std::vector<uint64_t> values_out(n);
+
+  // One histogram per chunk, which turns into the scatter offsets of the chunk
+  std::vector<uint64_t> offsets(chunk_num * RADIX);
+  uint64_t* offsets_ptr = &offsets[0];
+
+  for (unsigned shift = 0; shift < key_bits; shift += RADIX_DIGIT_BITS) {
+    const uint64_t* in_keys = &(*keys)[0];
+    const uint64_t* in_values = &(*values)[0];
+    uint64_t* out_keys = &keys_out[0];
+    uint64_t* out_values = &values_out[0];
+
+    // Histogram the digit of each chunk
+    std::fill(offsets.begin(), offsets.end(), 0);
+    RETURN_NOT_OK(parallel_chunks(
+        tp,
+        n,
+        chunk_num,
+        [in_keys, offsets_ptr, shift](
+            uint64_t chunk, uint64_t begin, uint64_t end) {
+          uint64_t* hist = &offsets_ptr[chunk * RADIX];
+          for (uint64_t i = begin; i < end; ++i)
+            ++hist[(in_keys[i] >> shift) & (RADIX - 1)];
+          return Status::Ok();
+        }));
+
+    // Turn the histograms into offsets; digits are laid out in order and,
+    // within a digit, the chunks are laid out in order, keeping it stable
+    uint64_t offset = 0;
+    bool single_digit = false;
+    for (uint64_t d = 0; d < RADIX && !single_digit; ++d) {
+      uint64_t digit_count = 0;
+      for (uint64_t c = 0; c < chunk_num; ++c) {
+        uint64_t count = offsets[c * RADIX + d];
+        offsets[c * RADIX + d] = offset;
+        offset += count;
+        digit_count += count;
+      }
+      single_digit = (digit_count == n);
+    }
+
+    // Nothing to reorder if all keys share this digit
+    if (single_digit)
+      continue;
+
+    // Scatter each chunk to its offsets
+    RETURN_NOT_OK(parallel_chunks(
+        tp,
+        n,
+        chunk_num,
+        [in_keys, in_values, out_keys, out_values, offsets_ptr, shift](
+            uint64_t chunk, uint64_t begin, uint64_t end) {
+          uint64_t* chunk_offsets = &offsets_ptr[chunk * RADIX];
+          for (uint64_t i = begin; i < end; ++i) {
+            uint64_t pos = chunk_offsets[(in_keys[i] >> shift) & (RADIX - 1)]++;
+            out_keys[pos] = in_keys[i];
+            out_values[pos] = in_values[i];
+          }
+          return Status::Ok();
+        }));
+
+    keys->swap(keys_out);
+    values->swap(values_out);
+  }
+
+  return Status::Ok();
+}
+
+}  // namespace utils
+
+}  // namespace sm
+}  // namespace tiledb
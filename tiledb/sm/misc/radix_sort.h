@@ -0,0 +1,102 @@
+/**
+ * @file   radix_sort.h
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2018 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file declares a parallel LSD radix sort on 64-bit keys.
+ */
+
+#ifndef TILEDB_RADIX_SORT_H
+#define TILEDB_RADIX_SORT_H
+
+#include <cinttypes>
+#include <functional>
+#include <vector>
+
+#include "tiledb/sm/misc/status.h"
+
+namespace tiledb {
+namespace sm {
+
+class ThreadPool;
+
+namespace utils {
+
+/**
+ * Returns the number of chunks `n` items are split into for processing on
+ * the threads of `tp`. No chunk is smaller than
+ * `constants::parallel_sort_min_chunk_size`, unless `n` is.
+ *
+ * @param tp The thread pool (may be `nullptr`, in which case this is 1).
+ * @param n The number of items.
+ * @return The number of chunks.
+ */
+uint64_t parallel_chunk_num(const ThreadPool* tp, uint64_t n);
+
+/**
+ * Splits `[0, n)` into `chunk_num` contiguous ranges of (almost) equal size
+ * and invokes `f(chunk, begin, end)` on each, in parallel on `tp`. The
+ * function must not enqueue tasks on `tp` itself.
+ *
+ * @param tp The thread pool (ignored if `chunk_num` is 1).
+ * @param n The number of items.
+ * @param chunk_num The number of chunks.
+ * @param f The function to invoke on each chunk.
+ * @return Status of the first chunk that failed, or `Ok`.
+ */
+Status parallel_chunks(
+    ThreadPool* tp,
+    uint64_t n,
+    uint64_t chunk_num,
+    const std::function<Status(uint64_t, uint64_t, uint64_t)>& f);
+
+/**
+ * Sorts `keys` in ascending order with a stable LSD radix sort, permuting
+ * `values` alongside them. Only the lowest `key_bits` bits of the keys are
+ * considered. The histogram and scatter phases of every pass are split
+ * across the threads of `tp`, and passes on a digit that is the same for all
+ * keys are skipped.
+ *
+ * @param tp The thread pool to sort on (may be `nullptr`).
+ * @param key_bits The number of (lowest) key bits to sort on.
+ * @param keys The keys to sort.
+ * @param values The values to permute alongside the keys; it must have the
+ *     same size as `keys`.
+ * @return Status
+ */
+Status radix_sort(
+    ThreadPool* tp,
+    unsigned key_bits,
+    std::vector<uint64_t>* keys,
+    std::vector<uint64_t>* values);
+
+}  // namespace utils
+
+}  // namespace sm
+}  // namespace tiledb
+
+#endif  // TILEDB_RADIX_SORT_H
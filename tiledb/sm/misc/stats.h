@@ -170,6 +170,12 @@ extern Statistics all_stats;
     stats::all_stats.counter_##counter_name += (value); \
   }
 
+/** Sets a counter stat to a value. */
+#define STATS_COUNTER_SET(counter_name, value)         \
+  if (stats::all_stats.enabled()) {                    \
+    stats::all_stats.counter_##counter_name = (value); \
+  }
+
 }  // namespace stats
 }  // namespace sm
 }  // namespace tiledb
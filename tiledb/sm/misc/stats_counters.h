@@ -137,6 +137,19 @@ STATS_DEFINE_COUNTER_STAT(vfs_write_total_bytes)
 STATS_DEFINE_COUNTER_STAT(vfs_read_num_parallelized)
 STATS_DEFINE_COUNTER_STAT(vfs_s3_num_parts_written)
 STATS_DEFINE_COUNTER_STAT(vfs_s3_write_num_parallelized)
+
+// Memory
+STATS_DEFINE_COUNTER_STAT(memory_alloc_total_bytes)
+STATS_DEFINE_COUNTER_STAT(memory_current_bytes)
+STATS_DEFINE_COUNTER_STAT(memory_peak_bytes)
+STATS_DEFINE_COUNTER_STAT(memory_ctx_peak_bytes)
+STATS_DEFINE_COUNTER_STAT(memory_query_peak_bytes)
+STATS_DEFINE_COUNTER_STAT(memory_budget_waits)
+STATS_DEFINE_COUNTER_STAT(memory_budget_rejections)
+STATS_DEFINE_COUNTER_STAT(buffer_pool_hits)
+STATS_DEFINE_COUNTER_STAT(buffer_pool_hit_bytes)
+STATS_DEFINE_COUNTER_STAT(buffer_pool_misses)
+STATS_DEFINE_COUNTER_STAT(buffer_pool_miss_bytes)
 #endif
 
 #ifdef STATS_INIT_COUNTER_STAT
@@ -146,6 +159,19 @@ STATS_INIT_COUNTER_STAT(vfs_write_total_bytes)
 STATS_INIT_COUNTER_STAT(vfs_read_num_parallelized)
 STATS_INIT_COUNTER_STAT(vfs_s3_num_parts_written)
 STATS_INIT_COUNTER_STAT(vfs_s3_write_num_parallelized)
+
+// Memory
+STATS_INIT_COUNTER_STAT(memory_alloc_total_bytes)
+STATS_INIT_COUNTER_STAT(memory_current_bytes)
+STATS_INIT_COUNTER_STAT(memory_peak_bytes)
+STATS_INIT_COUNTER_STAT(memory_ctx_peak_bytes)
+STATS_INIT_COUNTER_STAT(memory_query_peak_bytes)
+STATS_INIT_COUNTER_STAT(memory_budget_waits)
+STATS_INIT_COUNTER_STAT(memory_budget_rejections)
+STATS_INIT_COUNTER_STAT(buffer_pool_hits)
+STATS_INIT_COUNTER_STAT(buffer_pool_hit_bytes)
+STATS_INIT_COUNTER_STAT(buffer_pool_misses)
+STATS_INIT_COUNTER_STAT(buffer_pool_miss_bytes)
 #endif
 
 #ifdef STATS_REPORT_COUNTER_STAT
@@ -155,4 +181,17 @@ STATS_REPORT_COUNTER_STAT(vfs_write_total_bytes)
 STATS_REPORT_COUNTER_STAT(vfs_read_num_parallelized)
 STATS_REPORT_COUNTER_STAT(vfs_s3_num_parts_written)
 STATS_REPORT_COUNTER_STAT(vfs_s3_write_num_parallelized)
+
+// Memory
+STATS_REPORT_COUNTER_STAT(memory_alloc_total_bytes)
+STATS_REPORT_COUNTER_STAT(memory_current_bytes)
+STATS_REPORT_COUNTER_STAT(memory_peak_bytes)
+STATS_REPORT_COUNTER_STAT(memory_ctx_peak_bytes)
+STATS_REPORT_COUNTER_STAT(memory_query_peak_bytes)
+STATS_REPORT_COUNTER_STAT(memory_budget_waits)
+STATS_REPORT_COUNTER_STAT(memory_budget_rejections)
+STATS_REPORT_COUNTER_STAT(buffer_pool_hits)
+STATS_REPORT_COUNTER_STAT(buffer_pool_hit_bytes)
+STATS_REPORT_COUNTER_STAT(buffer_pool_misses)
+STATS_REPORT_COUNTER_STAT(buffer_pool_miss_bytes)
 #endif
\ No newline at end of file
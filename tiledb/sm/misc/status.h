@@ -111,6 +111,7 @@ enum class StatusCode : char {
   FS_HDFS,
   Attribute,
   SparseReader,
+  Filter,
 };
 
 class Status {
@@ -317,6 +318,11 @@ class Status {
     return Status(StatusCode::SparseReader, msg, -1);
   }
 
+  /** Return a FilterError error class Status with a given message **/
+  static Status FilterError(const std::string& msg) {
+    return Status(StatusCode::Filter, msg, -1);
+  }
+
   /** Returns true iff the status indicates success **/
   bool ok() const {
     return (state_ == nullptr);
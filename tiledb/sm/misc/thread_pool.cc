@@ -93,6 +93,21 @@ bool ThreadPool::wait_all(std::vector<std::future<Status>>& tasks) {
   return all_ok;
 }
 
+Status ThreadPool::wait_all_status(std::vector<std::future<Status>>& tasks) {
+  auto st = Status::Ok();
+  for (auto& future : tasks) {
+    if (!future.valid()) {
+      if (st.ok())
+        st = LOG_STATUS(Status::Error("Waiting on invalid future"));
+    } else {
+      Status status = future.get();
+      if (st.ok() && !status.ok())
+        st = status;
+    }
+  }
+  return st;
+}
+
 void ThreadPool::worker(ThreadPool& pool) {
   while (true) {
     std::packaged_task<Status()> task;
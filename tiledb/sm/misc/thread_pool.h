@@ -79,6 +79,15 @@ class ThreadPool {
    */
   bool wait_all(std::vector<std::future<Status>>& tasks);
 
+  /**
+   * Wait on all the given tasks to complete.
+   *
+   * @param tasks Task list to wait on.
+   * @return The status of the first task (in list order) that failed, or
+   *     Status::Ok if all tasks succeeded.
+   */
+  Status wait_all_status(std::vector<std::future<Status>>& tasks);
+
  private:
   std::mutex queue_mutex_;
 
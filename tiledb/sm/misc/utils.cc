@@ -132,6 +132,15 @@ bool is_uint(const std::string& str) {
 /*           FUNCTIONS            */
 /* ****************************** */
 
+unsigned bit_width(uint64_t value) {
+  unsigned bits = 0;
+  while (value != 0) {
+    ++bits;
+    value >>= 1;
+  }
+  return bits;
+}
+
 template <class T>
 inline bool coords_in_rect(
     const T* coords, const T* rect, unsigned int dim_num) {
@@ -73,6 +73,9 @@ bool is_uint(const std::string& str);
 /*             FUNCTIONS             */
 /* ********************************* */
 
+/** Returns the number of bits needed to represent `value`. */
+unsigned bit_width(uint64_t value);
+
 /**
  * Checks if `coords` are inside `rect`.
  *
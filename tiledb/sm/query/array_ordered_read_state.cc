@@ -38,6 +38,7 @@
 
 #include "tiledb/sm/misc/comparators.h"
 #include "tiledb/sm/misc/logger.h"
+#include "tiledb/sm/misc/memory_tracker.h"
 #include "tiledb/sm/misc/utils.h"
 #include "tiledb/sm/query/array_ordered_read_state.h"
 
@@ -71,15 +72,33 @@ ArrayOrderedReadState::ArrayOrderedReadState(Query* query)
   auto anum = (unsigned int)attribute_ids_.size();
 
   // Initializations
+  async_in_flight_ = 0;
   coords_size_ = array_schema->coords_size();
   copy_id_ = 0;
   dim_num_ = array_schema->dim_num();
   read_tile_slabs_done_ = false;
   resume_copy_ = false;
   resume_copy_2_ = false;
+  slab_num_ = (unsigned int)query->storage_manager()
+                  ->config()
+                  .sm_params()
+                  .tile_slab_num_;
   tile_coords_ = nullptr;
   tile_domain_ = nullptr;
-  for (unsigned int i = 0; i < 2; ++i) {
+  async_cv_ = std::vector<std::condition_variable>(slab_num_);
+  async_data_.resize(slab_num_);
+  async_mtx_ = std::vector<std::mutex>(slab_num_);
+  async_query_.resize(slab_num_);
+  async_wait_ = new bool[slab_num_];
+  buffer_sizes_.resize(slab_num_);
+  buffer_sizes_tmp_.resize(slab_num_);
+  buffer_sizes_tmp_bak_.resize(slab_num_);
+  buffers_.resize(slab_num_);
+  tile_slab_.resize(slab_num_);
+  tile_slab_init_ = new bool[slab_num_];
+  tile_slab_norm_.resize(slab_num_);
+  tile_slab_info_.resize(slab_num_);
+  for (unsigned int i = 0; i < slab_num_; ++i) {
     async_query_[i] = nullptr;
     buffer_sizes_[i] = nullptr;
     buffer_sizes_tmp_[i] = nullptr;
@@ -128,7 +147,7 @@ ArrayOrderedReadState::~ArrayOrderedReadState() {
   delete[] overflow_;
   delete[] overflow_still_;
 
-  for (unsigned int i = 0; i < 2; ++i) {
+  for (unsigned int i = 0; i < slab_num_; ++i) {
     if (async_query_[i] != nullptr)
       async_query_[i]->finalize();
     delete async_query_[i];
@@ -148,6 +167,8 @@ ArrayOrderedReadState::~ArrayOrderedReadState() {
     std::free(tile_slab_[i]);
     std::free(tile_slab_norm_[i]);
   }
+  delete[] async_wait_;
+  delete[] tile_slab_init_;
 
   // Free tile slab info and state, and copy state
   free_copy_state();
@@ -175,7 +196,7 @@ bool ArrayOrderedReadState::copy_tile_slab_done() const {
 }
 
 bool ArrayOrderedReadState::done() const {
-  if (!read_tile_slabs_done_)
+  if (!read_tile_slabs_done_ || async_in_flight_ > 0)
     return false;
 
   return copy_tile_slab_done();
@@ -259,7 +280,7 @@ Status ArrayOrderedReadState::init() {
   // Create buffers
   RETURN_NOT_OK(create_buffers());
 
-  for (unsigned int i = 0; i < 2; ++i)
+  for (unsigned int i = 0; i < slab_num_; ++i)
     async_data_[i] = {i, 0, this};
 
   // Initialize functors
@@ -533,16 +554,17 @@ void ArrayOrderedReadState::async_done(void* data) {
   // Retrieve data
   ArrayOrderedReadState* asrs = ((ASRS_Data*)data)->asrs_;
   unsigned int id = ((ASRS_Data*)data)->id_;
-  auto query = asrs->query_;
+  auto query = asrs->async_query_[id];
+  const auto& attribute_ids = asrs->attribute_ids_;
 
   // For easy reference
-  auto anum = (unsigned int)asrs->attribute_ids_.size();
+  auto anum = (unsigned int)attribute_ids.size();
   auto array_schema = query->array_schema();
 
   // Check for overflow
   bool overflow = false;
   for (unsigned int i = 0; i < anum; ++i) {
-    if (asrs->overflow_still_[i] && query->overflow(i)) {
+    if (asrs->overflow_still_[i] && query->overflow(attribute_ids[i])) {
       overflow = true;
       break;
     }
@@ -553,7 +575,7 @@ void ArrayOrderedReadState::async_done(void* data) {
     // Update buffer sizes
     for (unsigned int i = 0, b = 0; i < anum; ++i) {
       if (!array_schema->var_size(asrs->attribute_ids_[i])) {  // FIXED
-        if (query->overflow(i)) {
+        if (query->overflow(attribute_ids[i])) {
           // Expand buffer
           utils::expand_buffer(
               asrs->buffers_[id][b], &(asrs->buffer_sizes_[id][b]));
@@ -568,7 +590,7 @@ void ArrayOrderedReadState::async_done(void* data) {
         }
         ++b;
       } else {  // VAR
-        if (query->overflow(i)) {
+        if (query->overflow(attribute_ids[i])) {
           // Expand offset buffer only in the case of sparse arrays
           utils::expand_buffer(
               asrs->buffers_[id][b], &(asrs->buffer_sizes_[id][b]));
@@ -614,8 +636,8 @@ void ArrayOrderedReadState::async_notify(unsigned int id) {
   {
     std::lock_guard<std::mutex> lk(async_mtx_[id]);
     async_wait_[id] = false;
+    async_cv_[id].notify_one();
   }
-  async_cv_[id].notify_one();
 }
 
 Status ArrayOrderedReadState::async_submit_query(unsigned int id) {
@@ -633,6 +655,7 @@ Status ArrayOrderedReadState::async_submit_query(unsigned int id) {
     RETURN_NOT_OK(async_query_[id]->finalize());
   delete async_query_[id];
   async_query_[id] = new Query();
+  async_query_[id]->set_memory_tracker_parent(query_->memory_tracker());
   RETURN_NOT_OK(async_query_[id]->init(
       query_->storage_manager(),
       query_->array_schema(),
@@ -737,7 +760,7 @@ void ArrayOrderedReadState::calculate_buffer_sizes_dense() {
 
   // Calculate buffer sizes
   auto attribute_id_num = (unsigned int)attribute_ids_.size();
-  for (unsigned int j = 0; j < 2; ++j) {
+  for (unsigned int j = 0; j < slab_num_; ++j) {
     buffer_sizes_[j] = new uint64_t[buffer_num_];
     buffer_sizes_tmp_[j] = new uint64_t[buffer_num_];
     buffer_sizes_tmp_bak_[j] = new uint64_t[buffer_num_];
@@ -766,7 +789,7 @@ void ArrayOrderedReadState::calculate_buffer_sizes_sparse() {
 
   // Calculate buffer sizes
   auto attribute_id_num = (unsigned int)attribute_ids_.size();
-  for (unsigned int j = 0; j < 2; ++j) {
+  for (unsigned int j = 0; j < slab_num_; ++j) {
     buffer_sizes_[j] = new uint64_t[buffer_num_];
     buffer_sizes_tmp_[j] = new uint64_t[buffer_num_];
     buffer_sizes_tmp_bak_[j] = new uint64_t[buffer_num_];
@@ -1135,20 +1158,29 @@ void ArrayOrderedReadState::calculate_tile_slab_info_row(unsigned int id) {
   }
 }
 
-void ArrayOrderedReadState::copy_tile_slab_dense() {
+Status ArrayOrderedReadState::copy_tile_slab_dense() {
   // For easy reference
   auto array_schema = query_->array_schema();
 
   // Copy tile slab for each attribute separately
+  std::vector<std::function<Status()>> tasks;
   for (unsigned int i = 0, b = 0; i < attribute_ids_.size(); ++i) {
     if (!array_schema->var_size(attribute_ids_[i])) {
-      copy_tile_slab_dense(i, b);
+      tasks.emplace_back([this, i, b]() {
+        copy_tile_slab_dense(i, b);
+        return Status::Ok();
+      });
       ++b;
     } else {
-      copy_tile_slab_dense_var(i, b);
+      tasks.emplace_back([this, i, b]() {
+        copy_tile_slab_dense_var(i, b);
+        return Status::Ok();
+      });
       b += 2;
     }
   }
+
+  return run_parallel(tasks);
 }
 
 void ArrayOrderedReadState::copy_tile_slab_dense(
@@ -1276,23 +1308,33 @@ void ArrayOrderedReadState::copy_tile_slab_dense_var(
   }
 }
 
-void ArrayOrderedReadState::copy_tile_slab_sparse() {
+Status ArrayOrderedReadState::copy_tile_slab_sparse() {
   // For easy reference
   auto array_schema = query_->array_schema();
 
   // Copy tile slab for each attribute separately
+  std::vector<std::function<Status()>> tasks;
   auto anum = (unsigned int)attribute_ids_.size();
   for (unsigned int i = 0, b = 0; i < anum; ++i) {
     if (!array_schema->var_size(attribute_ids_[i])) {  // FIXED
       // Make sure not to copy coordinates if the user has not requested them
-      if (i != coords_attr_i_ || !extra_coords_)
-        copy_tile_slab_sparse(i, b);
+      if (i != coords_attr_i_ || !extra_coords_) {
+        tasks.emplace_back([this, i, b]() {
+          copy_tile_slab_sparse(i, b);
+          return Status::Ok();
+        });
+      }
       ++b;
     } else {  // VAR
-      copy_tile_slab_sparse_var(i, b);
+      tasks.emplace_back([this, i, b]() {
+        copy_tile_slab_sparse_var(i, b);
+        return Status::Ok();
+      });
       b += 2;
     }
   }
+
+  return run_parallel(tasks);
 }
 
 void ArrayOrderedReadState::copy_tile_slab_sparse(
@@ -1399,7 +1441,7 @@ void ArrayOrderedReadState::copy_tile_slab_sparse_var(
 }
 
 Status ArrayOrderedReadState::create_buffers() {
-  for (unsigned int j = 0; j < 2; ++j) {
+  for (unsigned int j = 0; j < slab_num_; ++j) {
     buffers_[j] = (void**)std::malloc(buffer_num_ * sizeof(void*));
     if (buffers_[j] == nullptr) {
       return LOG_STATUS(Status::ASRSError("Cannot create local buffers"));
@@ -1622,11 +1664,11 @@ bool ArrayOrderedReadState::next_tile_slab_dense_col() {
   auto domain = static_cast<const T*>(array_schema->domain()->domain());
   auto tile_extents =
       static_cast<const T*>(array_schema->domain()->tile_extents());
-  T* tile_slab[2];
+  std::vector<T*> tile_slab(slab_num_);
   auto tile_slab_norm = static_cast<T*>(tile_slab_norm_[copy_id_]);
-  for (unsigned int i = 0; i < 2; ++i)
+  for (unsigned int i = 0; i < slab_num_; ++i)
     tile_slab[i] = static_cast<T*>(tile_slab_[i]);
-  unsigned int prev_id = (copy_id_ + 1) % 2;
+  unsigned int prev_id = (copy_id_ + slab_num_ - 1) % slab_num_;
   T tile_start;
 
   // Check again if done, this time based on the tile slab and subarray
@@ -1698,11 +1740,11 @@ bool ArrayOrderedReadState::next_tile_slab_dense_row() {
   auto domain = static_cast<const T*>(array_schema->domain()->domain());
   auto tile_extents =
       static_cast<const T*>(array_schema->domain()->tile_extents());
-  T* tile_slab[2];
+  std::vector<T*> tile_slab(slab_num_);
   auto tile_slab_norm = static_cast<T*>(tile_slab_norm_[copy_id_]);
-  for (unsigned int i = 0; i < 2; ++i)
+  for (unsigned int i = 0; i < slab_num_; ++i)
     tile_slab[i] = static_cast<T*>(tile_slab_[i]);
-  unsigned int prev_id = (copy_id_ + 1) % 2;
+  unsigned int prev_id = (copy_id_ + slab_num_ - 1) % slab_num_;
   T tile_start;
 
   // Check again if done, this time based on the tile slab and subarray
@@ -1767,10 +1809,10 @@ bool ArrayOrderedReadState::next_tile_slab_sparse_col() {
   auto domain = static_cast<const T*>(array_schema->domain()->domain());
   auto tile_extents =
       static_cast<const T*>(array_schema->domain()->tile_extents());
-  T* tile_slab[2];
-  for (unsigned int i = 0; i < 2; ++i)
+  std::vector<T*> tile_slab(slab_num_);
+  for (unsigned int i = 0; i < slab_num_; ++i)
     tile_slab[i] = static_cast<T*>(tile_slab_[i]);
-  unsigned int prev_id = (copy_id_ + 1) % 2;
+  unsigned int prev_id = (copy_id_ + slab_num_ - 1) % slab_num_;
 
   // Check again if done, this time based on the tile slab and subarray
   if (tile_slab_init_[prev_id] && tile_slab[prev_id][2 * (dim_num_ - 1) + 1] ==
@@ -1827,10 +1869,10 @@ bool ArrayOrderedReadState::next_tile_slab_sparse_col<float>() {
   auto subarray = (const float*)subarray_;
   auto domain = (const float*)array_schema->domain()->domain();
   auto tile_extents = (const float*)array_schema->domain()->tile_extents();
-  float* tile_slab[2];
-  for (unsigned int i = 0; i < 2; ++i)
+  std::vector<float*> tile_slab(slab_num_);
+  for (unsigned int i = 0; i < slab_num_; ++i)
     tile_slab[i] = (float*)tile_slab_[i];
-  unsigned int prev_id = (copy_id_ + 1) % 2;
+  unsigned int prev_id = (copy_id_ + slab_num_ - 1) % slab_num_;
 
   // Check again if done, this time based on the tile slab and subarray
   if (tile_slab_init_[prev_id] && tile_slab[prev_id][2 * (dim_num_ - 1) + 1] ==
@@ -1888,10 +1930,10 @@ bool ArrayOrderedReadState::next_tile_slab_sparse_col<double>() {
   auto subarray = (const double*)subarray_;
   auto domain = (const double*)array_schema->domain()->domain();
   auto tile_extents = (const double*)array_schema->domain()->tile_extents();
-  double* tile_slab[2];
-  for (unsigned int i = 0; i < 2; ++i)
+  std::vector<double*> tile_slab(slab_num_);
+  for (unsigned int i = 0; i < slab_num_; ++i)
     tile_slab[i] = (double*)tile_slab_[i];
-  unsigned int prev_id = (copy_id_ + 1) % 2;
+  unsigned int prev_id = (copy_id_ + slab_num_ - 1) % slab_num_;
 
   // Check again if done, this time based on the tile slab and subarray
   if (tile_slab_init_[prev_id] && tile_slab[prev_id][2 * (dim_num_ - 1) + 1] ==
@@ -1950,10 +1992,10 @@ bool ArrayOrderedReadState::next_tile_slab_sparse_row() {
   auto domain = static_cast<const T*>(array_schema->domain()->domain());
   auto tile_extents =
       static_cast<const T*>(array_schema->domain()->tile_extents());
-  T* tile_slab[2];
-  for (unsigned int i = 0; i < 2; ++i)
+  std::vector<T*> tile_slab(slab_num_);
+  for (unsigned int i = 0; i < slab_num_; ++i)
     tile_slab[i] = static_cast<T*>(tile_slab_[i]);
-  unsigned int prev_id = (copy_id_ + 1) % 2;
+  unsigned int prev_id = (copy_id_ + slab_num_ - 1) % slab_num_;
 
   // Check again if done, this time based on the tile slab and subarray
   if (tile_slab_init_[prev_id] && tile_slab[prev_id][1] == subarray[1]) {
@@ -2003,10 +2045,10 @@ bool ArrayOrderedReadState::next_tile_slab_sparse_row<float>() {
   auto subarray = (const float*)subarray_;
   auto domain = (const float*)array_schema->domain()->domain();
   auto tile_extents = (const float*)array_schema->domain()->tile_extents();
-  float* tile_slab[2];
-  for (unsigned int i = 0; i < 2; ++i)
+  std::vector<float*> tile_slab(slab_num_);
+  for (unsigned int i = 0; i < slab_num_; ++i)
     tile_slab[i] = (float*)tile_slab_[i];
-  unsigned int prev_id = (copy_id_ + 1) % 2;
+  unsigned int prev_id = (copy_id_ + slab_num_ - 1) % slab_num_;
 
   // Check again if done, this time based on the tile slab and subarray
   if (tile_slab_init_[prev_id] && tile_slab[prev_id][1] == subarray[1]) {
@@ -2057,10 +2099,10 @@ bool ArrayOrderedReadState::next_tile_slab_sparse_row<double>() {
   auto subarray = (const double*)subarray_;
   auto domain = (const double*)array_schema->domain()->domain();
   auto tile_extents = (const double*)array_schema->domain()->tile_extents();
-  double* tile_slab[2];
-  for (unsigned int i = 0; i < 2; ++i)
+  std::vector<double*> tile_slab(slab_num_);
+  for (unsigned int i = 0; i < slab_num_; ++i)
     tile_slab[i] = (double*)tile_slab_[i];
-  unsigned int prev_id = (copy_id_ + 1) % 2;
+  unsigned int prev_id = (copy_id_ + slab_num_ - 1) % slab_num_;
 
   // Check again if done, this time based on the tile slab and subarray
   if (tile_slab_init_[prev_id] && tile_slab[prev_id][1] == subarray[1]) {
@@ -2141,12 +2183,13 @@ Status ArrayOrderedReadState::read_dense_sorted_col() {
   if (resume_copy_2_)
     goto copy_label_2;
 
-  // First AIO
-  if (next_tile_slab_dense_col<T>()) {
+  // Fill the pipeline with the first tile slabs
+  while (async_in_flight_ < slab_num_ - 1 && next_tile_slab_dense_col<T>()) {
     reset_buffer_sizes_tmp(copy_id_);
     async_wait_[copy_id_] = true;
     RETURN_NOT_OK(async_submit_query(copy_id_));
-    copy_id_ = (copy_id_ + 1) % 2;
+    ++async_in_flight_;
+    copy_id_ = (copy_id_ + 1) % slab_num_;
   }
 
   // Iterate over tile slabs
@@ -2155,9 +2198,11 @@ Status ArrayOrderedReadState::read_dense_sorted_col() {
     reset_buffer_sizes_tmp(copy_id_);
     async_wait_[copy_id_] = true;
     RETURN_NOT_OK(async_submit_query(copy_id_));
-    copy_id_ = (copy_id_ + 1) % 2;
+    ++async_in_flight_;
+    copy_id_ = (copy_id_ + 1) % slab_num_;
 
     async_wait(copy_id_);
+    --async_in_flight_;
 
     // Copy tile slab
     if (copy_tile_slab_done())
@@ -2165,7 +2210,7 @@ Status ArrayOrderedReadState::read_dense_sorted_col() {
 
   copy_label_1:  // Resume from the point the copy led to overflow
     resume_copy_ = false;
-    copy_tile_slab_dense();
+    RETURN_NOT_OK(copy_tile_slab_dense());
 
     if (overflow()) {
       resume_copy_ = true;
@@ -2174,18 +2219,26 @@ Status ArrayOrderedReadState::read_dense_sorted_col() {
   }
 
   if (!resume_copy_) {
-    copy_id_ = (copy_id_ + 1) % 2;
-    async_wait(copy_id_);
-
-    if (copy_tile_slab_done())
-      reset_tile_slab_state<T>();
-
-  copy_label_2:  // Resume from the point the copy led to overflow
-    resume_copy_2_ = false;
-    copy_tile_slab_dense();
-
-    if (overflow())
-      resume_copy_2_ = true;
+    // Rewind to right before the oldest tile slab still being read
+    copy_id_ =
+        (copy_id_ + 2 * slab_num_ - async_in_flight_ - 1) % slab_num_;
+    while (async_in_flight_ > 0) {
+      copy_id_ = (copy_id_ + 1) % slab_num_;
+      async_wait(copy_id_);
+      --async_in_flight_;
+
+      if (copy_tile_slab_done())
+        reset_tile_slab_state<T>();
+
+    copy_label_2:  // Resume from the point the copy led to overflow
+      resume_copy_2_ = false;
+      RETURN_NOT_OK(copy_tile_slab_dense());
+
+      if (overflow()) {
+        resume_copy_2_ = true;
+        break;
+      }
+    }
   }
 
   // Assign the true buffer sizes
@@ -2212,12 +2265,13 @@ Status ArrayOrderedReadState::read_dense_sorted_row() {
   if (resume_copy_2_)
     goto copy_label_2;
 
-  // First AIO
-  if (next_tile_slab_dense_row<T>()) {
+  // Fill the pipeline with the first tile slabs
+  while (async_in_flight_ < slab_num_ - 1 && next_tile_slab_dense_row<T>()) {
     reset_buffer_sizes_tmp(copy_id_);
     async_wait_[copy_id_] = true;
     RETURN_NOT_OK(async_submit_query(copy_id_));
-    copy_id_ = (copy_id_ + 1) % 2;
+    ++async_in_flight_;
+    copy_id_ = (copy_id_ + 1) % slab_num_;
   }
 
   // Iterate over each tile slab
@@ -2226,9 +2280,11 @@ Status ArrayOrderedReadState::read_dense_sorted_row() {
     reset_buffer_sizes_tmp(copy_id_);
     async_wait_[copy_id_] = true;
     RETURN_NOT_OK(async_submit_query(copy_id_));
-    copy_id_ = (copy_id_ + 1) % 2;
+    ++async_in_flight_;
+    copy_id_ = (copy_id_ + 1) % slab_num_;
 
     async_wait(copy_id_);
+    --async_in_flight_;
 
     // Copy tile slab
     if (copy_tile_slab_done())
@@ -2236,7 +2292,7 @@ Status ArrayOrderedReadState::read_dense_sorted_row() {
 
   copy_label_1:  // Resume from the point the copy led to overflow
     resume_copy_ = false;
-    copy_tile_slab_dense();
+    RETURN_NOT_OK(copy_tile_slab_dense());
 
     // Handle overflow here
     if (overflow()) {
@@ -2246,17 +2302,25 @@ Status ArrayOrderedReadState::read_dense_sorted_row() {
   }
 
   if (!resume_copy_) {
-    copy_id_ = (copy_id_ + 1) % 2;
-    async_wait(copy_id_);
-    if (copy_tile_slab_done())
-      reset_tile_slab_state<T>();
-
-  copy_label_2:  // Resume from the point the copy led to overflow
-    resume_copy_2_ = false;
-    copy_tile_slab_dense();
-
-    if (overflow())
-      resume_copy_2_ = true;
+    // Rewind to right before the oldest tile slab still being read
+    copy_id_ =
+        (copy_id_ + 2 * slab_num_ - async_in_flight_ - 1) % slab_num_;
+    while (async_in_flight_ > 0) {
+      copy_id_ = (copy_id_ + 1) % slab_num_;
+      async_wait(copy_id_);
+      --async_in_flight_;
+      if (copy_tile_slab_done())
+        reset_tile_slab_state<T>();
+
+    copy_label_2:  // Resume from the point the copy led to overflow
+      resume_copy_2_ = false;
+      RETURN_NOT_OK(copy_tile_slab_dense());
+
+      if (overflow()) {
+        resume_copy_2_ = true;
+        break;
+      }
+    }
   }
 
   // Assign the true buffer sizes
@@ -2283,12 +2347,13 @@ Status ArrayOrderedReadState::read_sparse_sorted_col() {
   if (resume_copy_2_)
     goto copy_label_2;
 
-  // First AIO
-  if (next_tile_slab_sparse_col<T>()) {
+  // Fill the pipeline with the first tile slabs
+  while (async_in_flight_ < slab_num_ - 1 && next_tile_slab_sparse_col<T>()) {
     reset_buffer_sizes_tmp(copy_id_);
     async_wait_[copy_id_] = true;
     RETURN_NOT_OK(async_submit_query(copy_id_));
-    copy_id_ = (copy_id_ + 1) % 2;
+    ++async_in_flight_;
+    copy_id_ = (copy_id_ + 1) % slab_num_;
   }
 
   // Iterate over tile slabs
@@ -2297,9 +2362,11 @@ Status ArrayOrderedReadState::read_sparse_sorted_col() {
     reset_buffer_sizes_tmp(copy_id_);
     async_wait_[copy_id_] = true;
     RETURN_NOT_OK(async_submit_query(copy_id_));
-    copy_id_ = (copy_id_ + 1) % 2;
+    ++async_in_flight_;
+    copy_id_ = (copy_id_ + 1) % slab_num_;
 
     async_wait(copy_id_);
+    --async_in_flight_;
 
     // Copy tile slab
     if (copy_tile_slab_done()) {
@@ -2309,7 +2376,7 @@ Status ArrayOrderedReadState::read_sparse_sorted_col() {
 
   copy_label_1:  // Resume from the point the copy led to overflow
     resume_copy_ = false;
-    copy_tile_slab_sparse();
+    RETURN_NOT_OK(copy_tile_slab_sparse());
 
     // Handle overflow here
     if (overflow()) {
@@ -2319,19 +2386,27 @@ Status ArrayOrderedReadState::read_sparse_sorted_col() {
   }
 
   if (!resume_copy_) {
-    copy_id_ = (copy_id_ + 1) % 2;
-    async_wait(copy_id_);
-    if (copy_tile_slab_done()) {
-      reset_tile_slab_state<T>();
-      sort_cell_pos<T>();
-    }
+    // Rewind to right before the oldest tile slab still being read
+    copy_id_ =
+        (copy_id_ + 2 * slab_num_ - async_in_flight_ - 1) % slab_num_;
+    while (async_in_flight_ > 0) {
+      copy_id_ = (copy_id_ + 1) % slab_num_;
+      async_wait(copy_id_);
+      --async_in_flight_;
+      if (copy_tile_slab_done()) {
+        reset_tile_slab_state<T>();
+        sort_cell_pos<T>();
+      }
 
-  copy_label_2:  // Resume from the point the copy led to overflow
-    resume_copy_2_ = false;
-    copy_tile_slab_sparse();
+    copy_label_2:  // Resume from the point the copy led to overflow
+      resume_copy_2_ = false;
+      RETURN_NOT_OK(copy_tile_slab_sparse());
 
-    if (overflow())
-      resume_copy_2_ = true;
+      if (overflow()) {
+        resume_copy_2_ = true;
+        break;
+      }
+    }
   }
 
   // Assign the true buffer sizes
@@ -2358,12 +2433,13 @@ Status ArrayOrderedReadState::read_sparse_sorted_row() {
   if (resume_copy_2_)
     goto copy_label_2;
 
-  // First async query
-  if (next_tile_slab_sparse_row<T>()) {
+  // Fill the pipeline with the first tile slabs
+  while (async_in_flight_ < slab_num_ - 1 && next_tile_slab_sparse_row<T>()) {
     reset_buffer_sizes_tmp(copy_id_);
     async_wait_[copy_id_] = true;
     RETURN_NOT_OK(async_submit_query(copy_id_));
-    copy_id_ = (copy_id_ + 1) % 2;
+    ++async_in_flight_;
+    copy_id_ = (copy_id_ + 1) % slab_num_;
   }
 
   // Iterate over tile slabs
@@ -2372,9 +2448,11 @@ Status ArrayOrderedReadState::read_sparse_sorted_row() {
     reset_buffer_sizes_tmp(copy_id_);
     async_wait_[copy_id_] = true;
     RETURN_NOT_OK(async_submit_query(copy_id_));
-    copy_id_ = (copy_id_ + 1) % 2;
+    ++async_in_flight_;
+    copy_id_ = (copy_id_ + 1) % slab_num_;
 
     async_wait(copy_id_);
+    --async_in_flight_;
 
     // Copy tile slab
     if (copy_tile_slab_done()) {
@@ -2385,7 +2463,7 @@ Status ArrayOrderedReadState::read_sparse_sorted_row() {
   copy_label_1:  // Resume from the point the copy led to overflow
     resume_copy_ = false;
 
-    copy_tile_slab_sparse();
+    RETURN_NOT_OK(copy_tile_slab_sparse());
 
     // Handle overflow here
     if (overflow()) {
@@ -2395,20 +2473,28 @@ Status ArrayOrderedReadState::read_sparse_sorted_row() {
   }
 
   if (!resume_copy_) {
-    copy_id_ = (copy_id_ + 1) % 2;
-    async_wait(copy_id_);
-    if (copy_tile_slab_done()) {
-      reset_tile_slab_state<T>();
-      sort_cell_pos<T>();
-    }
+    // Rewind to right before the oldest tile slab still being read
+    copy_id_ =
+        (copy_id_ + 2 * slab_num_ - async_in_flight_ - 1) % slab_num_;
+    while (async_in_flight_ > 0) {
+      copy_id_ = (copy_id_ + 1) % slab_num_;
+      async_wait(copy_id_);
+      --async_in_flight_;
+      if (copy_tile_slab_done()) {
+        reset_tile_slab_state<T>();
+        sort_cell_pos<T>();
+      }
 
-  copy_label_2:  // Resume from the point the copy led to overflow
-    resume_copy_2_ = false;
+    copy_label_2:  // Resume from the point the copy led to overflow
+      resume_copy_2_ = false;
 
-    copy_tile_slab_sparse();
+      RETURN_NOT_OK(copy_tile_slab_sparse());
 
-    if (overflow())
-      resume_copy_2_ = true;
+      if (overflow()) {
+        resume_copy_2_ = true;
+        break;
+      }
+    }
   }
 
   // Assign the true buffer sizes
@@ -2471,6 +2557,24 @@ void ArrayOrderedReadState::reset_tile_slab_state() {
   }
 }
 
+Status ArrayOrderedReadState::run_parallel(
+    const std::vector<std::function<Status()>>& tasks) {
+  if (tasks.size() == 1)
+    return tasks[0]();
+
+  auto compute_tp = query_->storage_manager()->compute_tp();
+  auto memory_tracker = MemoryTracker::thread_tracker();
+  std::vector<std::future<Status>> results;
+  for (const auto& task : tasks) {
+    results.push_back(compute_tp->enqueue([&task, memory_tracker]() {
+      ScopedMemoryTracker scoped_tracker(memory_tracker);
+      return task();
+    }));
+  }
+
+  return compute_tp->wait_all_status(results);
+}
+
 template <class T>
 void ArrayOrderedReadState::sort_cell_pos() {
   // For easy reference
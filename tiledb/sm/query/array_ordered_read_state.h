@@ -38,6 +38,7 @@
 #include "tiledb/sm/query/query.h"
 
 #include <condition_variable>
+#include <functional>
 #include <mutex>
 #include <string>
 #include <vector>
@@ -188,19 +189,22 @@ class ArrayOrderedReadState {
   void* (*advance_cell_slab_)(void*);
 
   /** Condition variables used in internal async queries. */
-  std::condition_variable async_cv_[2];
+  std::vector<std::condition_variable> async_cv_;
 
   /** Data for the internal async queries. */
-  ASRS_Data async_data_[2];
+  std::vector<ASRS_Data> async_data_;
+
+  /** Number of internal async queries submitted but not yet copied. */
+  unsigned int async_in_flight_;
 
   /** Mutexes used in internal async queries. */
-  std::mutex async_mtx_[2];
+  std::vector<std::mutex> async_mtx_;
 
   /** The internal async queries. */
-  Query* async_query_[2];
+  std::vector<Query*> async_query_;
 
   /** Wait for async conditions, one for each local buffer. */
-  bool async_wait_[2];
+  bool* async_wait_;
 
   /** The ids of the attributes the array was initialized with. */
   std::vector<unsigned int> attribute_ids_;
@@ -215,19 +219,19 @@ class ArrayOrderedReadState {
   unsigned int buffer_num_;
 
   /** Allocated sizes for buffers_. */
-  uint64_t* buffer_sizes_[2];
+  std::vector<uint64_t*> buffer_sizes_;
 
   /** Temporary buffer sizes used in internal async queries. */
-  uint64_t* buffer_sizes_tmp_[2];
+  std::vector<uint64_t*> buffer_sizes_tmp_;
 
   /**
    * Backup of temporary buffer sizes used in async queries (used when there is
    * overflow).
    */
-  uint64_t* buffer_sizes_tmp_bak_[2];
+  std::vector<uint64_t*> buffer_sizes_tmp_bak_;
 
-  /** Local buffers. */
-  void** buffers_[2];
+  /** Local buffers, one set per tile slab. */
+  std::vector<void**> buffers_;
 
   /** Function for calculating cell slab info during a copy operation. */
   void* (*calculate_cell_slab_info_)(void*);
@@ -294,6 +298,12 @@ class ArrayOrderedReadState {
   /** Used to handle overflow. */
   bool resume_copy_2_;
 
+  /**
+   * Number of tile slabs in the read pipeline, i.e., up to this number minus
+   * one tile slabs are being read while the current one is being copied.
+   */
+  unsigned int slab_num_;
+
   /** The query subarray. */
   void* subarray_;
 
@@ -303,17 +313,17 @@ class ArrayOrderedReadState {
   /** Auxiliary variable used in calculate_tile_slab_info(). */
   void* tile_domain_;
 
-  /** The tile slab to be read for the first and second buffers. */
-  void* tile_slab_[2];
+  /** The tile slab to be read for each set of local buffers. */
+  std::vector<void*> tile_slab_;
 
   /** Indicates if the tile slab has been initialized. */
-  bool tile_slab_init_[2];
+  bool* tile_slab_init_;
 
   /** Normalized tile slab. */
-  void* tile_slab_norm_[2];
+  std::vector<void*> tile_slab_norm_;
 
-  /** The info for each of the two tile slabs under investigation. */
-  TileSlabInfo tile_slab_info_[2];
+  /** The info for each of the tile slabs under investigation. */
+  std::vector<TileSlabInfo> tile_slab_info_;
 
   /** The state for the current tile slab being copied. */
   TileSlabState tile_slab_state_;
@@ -603,20 +613,20 @@ class ArrayOrderedReadState {
   /**
    * Copies a tile slab from the local buffers into the user buffers,
    * properly re-organizing the cell order to fit the targeted order.
-   * Applicable to dense arrays.
+   * Applicable to dense arrays. The attributes are copied in parallel.
    *
-   * @return void.
+   * @return Status
    */
-  void copy_tile_slab_dense();
+  Status copy_tile_slab_dense();
 
   /**
    * Copies a tile slab from the local buffers into the user buffers,
    * properly re-organizing the cell order to fit the targeted order.
-   * Applicable to sparse arrays.
+   * Applicable to sparse arrays. The attributes are copied in parallel.
    *
-   * @return void.
+   * @return Status
    */
-  void copy_tile_slab_sparse();
+  Status copy_tile_slab_sparse();
 
   /**
    * Copies a tile slab from the local buffers into the user buffers,
@@ -845,6 +855,14 @@ class ArrayOrderedReadState {
   template <class T>
   void reset_tile_slab_state();
 
+  /**
+   * Runs the input tasks in parallel on the compute thread pool.
+   *
+   * @param tasks The tasks to run.
+   * @return Status
+   */
+  Status run_parallel(const std::vector<std::function<Status()>>& tasks);
+
   /**
    * It sorts the positions of the cells based on the coordinates
    * of the current tile slab to be copied.
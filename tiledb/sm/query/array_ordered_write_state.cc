@@ -33,6 +33,7 @@
 
 #include "tiledb/sm/query/array_ordered_write_state.h"
 #include "tiledb/sm/misc/logger.h"
+#include "tiledb/sm/misc/memory_tracker.h"
 #include "tiledb/sm/misc/utils.h"
 
 /* ****************************** */
@@ -71,7 +72,23 @@ ArrayOrderedWriteState::ArrayOrderedWriteState(Query* query)
   buffer_sizes_ = nullptr;
   buffer_offsets_ = nullptr;
   buffers_ = nullptr;
-  for (unsigned int i = 0; i < 2; ++i) {
+  slab_num_ = (unsigned int)query->storage_manager()
+                  ->config()
+                  .sm_params()
+                  .tile_slab_num_;
+  async_cv_ = std::vector<std::condition_variable>(slab_num_);
+  async_data_.resize(slab_num_);
+  async_mtx_ = std::vector<std::mutex>(slab_num_);
+  async_query_.resize(slab_num_);
+  async_wait_ = new bool[slab_num_];
+  copy_state_.buffer_offsets_.resize(slab_num_);
+  copy_state_.buffer_sizes_.resize(slab_num_);
+  copy_state_.buffers_.resize(slab_num_);
+  tile_slab_.resize(slab_num_);
+  tile_slab_init_ = new bool[slab_num_];
+  tile_slab_norm_.resize(slab_num_);
+  tile_slab_info_.resize(slab_num_);
+  for (unsigned int i = 0; i < slab_num_; ++i) {
     async_query_[i] = nullptr;
     tile_slab_[i] = std::malloc(2 * coords_size_);
     tile_slab_norm_[i] = std::malloc(2 * coords_size_);
@@ -109,13 +126,15 @@ ArrayOrderedWriteState::~ArrayOrderedWriteState() {
   std::free(tile_coords_);
   std::free(tile_domain_);
 
-  for (unsigned int i = 0; i < 2; ++i) {
+  for (unsigned int i = 0; i < slab_num_; ++i) {
     if (async_query_[i] != nullptr)
       async_query_[i]->finalize();
     delete async_query_[i];
     std::free(tile_slab_[i]);
     std::free(tile_slab_norm_[i]);
   }
+  delete[] async_wait_;
+  delete[] tile_slab_init_;
 
   delete[] buffer_offsets_;
 
@@ -306,7 +325,7 @@ Status ArrayOrderedWriteState::write(void** buffers, uint64_t* buffer_sizes) {
   // Create buffers
   RETURN_NOT_OK(create_copy_state_buffers());
 
-  for (unsigned int i = 0; i < 2; ++i)
+  for (unsigned int i = 0; i < slab_num_; ++i)
     async_data_[i] = {i, 0, this};
 
   // Call the appropriate templated write
@@ -423,8 +442,8 @@ void ArrayOrderedWriteState::async_notify(unsigned int id) {
   {
     std::lock_guard<std::mutex> lk(async_mtx_[id]);
     async_wait_[id] = false;
+    async_cv_[id].notify_one();
   }
-  async_cv_[id].notify_one();
 }
 
 Status ArrayOrderedWriteState::async_submit_query(unsigned int id) {
@@ -439,6 +458,7 @@ Status ArrayOrderedWriteState::async_submit_query(unsigned int id) {
       RETURN_NOT_OK(async_query_[id]->finalize());
     delete async_query_[id];
     async_query_[id] = new Query();
+    async_query_[id]->set_memory_tracker_parent(query_->memory_tracker());
     RETURN_NOT_OK(async_query_[id]->init(
         query_->storage_manager(),
         query_->array_schema(),
@@ -454,6 +474,7 @@ Status ArrayOrderedWriteState::async_submit_query(unsigned int id) {
     if (id == 0) {
       if (async_query_[id] == nullptr) {
         async_query_[id] = new Query();
+        async_query_[id]->set_memory_tracker_parent(query_->memory_tracker());
         RETURN_NOT_OK(async_query_[id]->init(
             query_->storage_manager(),
             query_->array_schema(),
@@ -466,7 +487,7 @@ Status ArrayOrderedWriteState::async_submit_query(unsigned int id) {
             copy_state_.buffer_offsets_[id]));
         async_query_[id]->set_callback(async_done, &(async_data_[id]));
       }
-    } else {  // id == 1
+    } else {  // id > 0
       if (async_query_[id] == nullptr) {
         async_query_[id] = new Query(async_query_[0]);
         async_query_[id]->set_buffers(
@@ -838,132 +859,152 @@ void ArrayOrderedWriteState::calculate_tile_slab_info_row(unsigned int id) {
   }
 }
 
-void ArrayOrderedWriteState::copy_tile_slab() {
+Status ArrayOrderedWriteState::copy_tile_slab() {
   // For easy reference
   auto array_schema = query_->array_schema();
   auto nattributes = attribute_ids_.size();
 
   // Copy tile slab for each attribute separately
+  std::vector<std::function<Status()>> tasks;
   for (unsigned int i = 0, b = 0; i < nattributes; ++i) {
-    Datatype type = array_schema->type(attribute_ids_.at(i));
     if (!array_schema->var_size(attribute_ids_[i])) {
-      switch (type) {
-        case Datatype::INT32:
-          copy_tile_slab<int>(i, b);
-          break;
-        case Datatype::INT64:
-          copy_tile_slab<int64_t>(i, b);
-          break;
-        case Datatype::FLOAT32:
-          copy_tile_slab<float>(i, b);
-          break;
-        case Datatype::FLOAT64:
-          copy_tile_slab<double>(i, b);
-          break;
-        case Datatype::INT8:
-          copy_tile_slab<int8_t>(i, b);
-          break;
-        case Datatype::UINT8:
-          copy_tile_slab<uint8_t>(i, b);
-          break;
-        case Datatype::INT16:
-          copy_tile_slab<int16_t>(i, b);
-          break;
-        case Datatype::UINT16:
-          copy_tile_slab<uint16_t>(i, b);
-          break;
-        case Datatype::UINT32:
-          copy_tile_slab<uint32_t>(i, b);
-          break;
-        case Datatype::UINT64:
-          copy_tile_slab<uint64_t>(i, b);
-          break;
-        case Datatype::CHAR:
-          copy_tile_slab<char>(i, b);
-          break;
-        case Datatype::STRING_ASCII:
-          copy_tile_slab<uint8_t>(i, b);
-          break;
-        case Datatype::STRING_UTF8:
-          copy_tile_slab<uint8_t>(i, b);
-          break;
-        case Datatype::STRING_UTF16:
-          copy_tile_slab<uint16_t>(i, b);
-          break;
-        case Datatype::STRING_UTF32:
-          copy_tile_slab<uint32_t>(i, b);
-          break;
-        case Datatype::STRING_UCS2:
-          copy_tile_slab<uint16_t>(i, b);
-          break;
-        case Datatype::STRING_UCS4:
-          copy_tile_slab<uint32_t>(i, b);
-          break;
-        case Datatype::ANY:
-          copy_tile_slab<uint8_t>(i, b);
-          break;
-      }
+      tasks.emplace_back([this, i, b]() {
+        copy_tile_slab(i, b);
+        return Status::Ok();
+      });
       ++b;
     } else {
-      switch (type) {
-        case Datatype::INT32:
-          copy_tile_slab_var<int>(i, b);
-          break;
-        case Datatype::INT64:
-          copy_tile_slab_var<int64_t>(i, b);
-          break;
-        case Datatype::FLOAT32:
-          copy_tile_slab_var<float>(i, b);
-          break;
-        case Datatype::FLOAT64:
-          copy_tile_slab_var<double>(i, b);
-          break;
-        case Datatype::INT8:
-          copy_tile_slab_var<int8_t>(i, b);
-          break;
-        case Datatype::UINT8:
-          copy_tile_slab_var<uint8_t>(i, b);
-          break;
-        case Datatype::INT16:
-          copy_tile_slab_var<int16_t>(i, b);
-          break;
-        case Datatype::UINT16:
-          copy_tile_slab_var<uint16_t>(i, b);
-          break;
-        case Datatype::UINT32:
-          copy_tile_slab_var<uint32_t>(i, b);
-          break;
-        case Datatype::UINT64:
-          copy_tile_slab_var<uint64_t>(i, b);
-          break;
-        case Datatype::CHAR:
-          copy_tile_slab_var<char>(i, b);
-          break;
-        case Datatype::STRING_ASCII:
-          copy_tile_slab_var<uint8_t>(i, b);
-          break;
-        case Datatype::STRING_UTF8:
-          copy_tile_slab_var<uint8_t>(i, b);
-          break;
-        case Datatype::STRING_UTF16:
-          copy_tile_slab_var<uint16_t>(i, b);
-          break;
-        case Datatype::STRING_UTF32:
-          copy_tile_slab_var<uint32_t>(i, b);
-          break;
-        case Datatype::STRING_UCS2:
-          copy_tile_slab_var<uint16_t>(i, b);
-          break;
-        case Datatype::STRING_UCS4:
-          copy_tile_slab_var<uint32_t>(i, b);
-          break;
-        case Datatype::ANY:
-          copy_tile_slab_var<uint8_t>(i, b);
-          break;
-      }
+      tasks.emplace_back([this, i, b]() {
+        copy_tile_slab_var(i, b);
+        return Status::Ok();
+      });
       b += 2;
     }
   }
+
+  return run_parallel(tasks);
+}
+
+void ArrayOrderedWriteState::copy_tile_slab(
+    unsigned int aid, unsigned int bid) {
+  Datatype type = query_->array_schema()->type(attribute_ids_[aid]);
+  switch (type) {
+    case Datatype::INT32:
+      copy_tile_slab<int>(aid, bid);
+      break;
+    case Datatype::INT64:
+      copy_tile_slab<int64_t>(aid, bid);
+      break;
+    case Datatype::FLOAT32:
+      copy_tile_slab<float>(aid, bid);
+      break;
+    case Datatype::FLOAT64:
+      copy_tile_slab<double>(aid, bid);
+      break;
+    case Datatype::INT8:
+      copy_tile_slab<int8_t>(aid, bid);
+      break;
+    case Datatype::UINT8:
+      copy_tile_slab<uint8_t>(aid, bid);
+      break;
+    case Datatype::INT16:
+      copy_tile_slab<int16_t>(aid, bid);
+      break;
+    case Datatype::UINT16:
+      copy_tile_slab<uint16_t>(aid, bid);
+      break;
+    case Datatype::UINT32:
+      copy_tile_slab<uint32_t>(aid, bid);
+      break;
+    case Datatype::UINT64:
+      copy_tile_slab<uint64_t>(aid, bid);
+      break;
+    case Datatype::CHAR:
+      copy_tile_slab<char>(aid, bid);
+      break;
+    case Datatype::STRING_ASCII:
+      copy_tile_slab<uint8_t>(aid, bid);
+      break;
+    case Datatype::STRING_UTF8:
+      copy_tile_slab<uint8_t>(aid, bid);
+      break;
+    case Datatype::STRING_UTF16:
+      copy_tile_slab<uint16_t>(aid, bid);
+      break;
+    case Datatype::STRING_UTF32:
+      copy_tile_slab<uint32_t>(aid, bid);
+      break;
+    case Datatype::STRING_UCS2:
+      copy_tile_slab<uint16_t>(aid, bid);
+      break;
+    case Datatype::STRING_UCS4:
+      copy_tile_slab<uint32_t>(aid, bid);
+      break;
+    case Datatype::ANY:
+      copy_tile_slab<uint8_t>(aid, bid);
+      break;
+  }
+}
+
+void ArrayOrderedWriteState::copy_tile_slab_var(
+    unsigned int aid, unsigned int bid) {
+  Datatype type = query_->array_schema()->type(attribute_ids_[aid]);
+  switch (type) {
+    case Datatype::INT32:
+      copy_tile_slab_var<int>(aid, bid);
+      break;
+    case Datatype::INT64:
+      copy_tile_slab_var<int64_t>(aid, bid);
+      break;
+    case Datatype::FLOAT32:
+      copy_tile_slab_var<float>(aid, bid);
+      break;
+    case Datatype::FLOAT64:
+      copy_tile_slab_var<double>(aid, bid);
+      break;
+    case Datatype::INT8:
+      copy_tile_slab_var<int8_t>(aid, bid);
+      break;
+    case Datatype::UINT8:
+      copy_tile_slab_var<uint8_t>(aid, bid);
+      break;
+    case Datatype::INT16:
+      copy_tile_slab_var<int16_t>(aid, bid);
+      break;
+    case Datatype::UINT16:
+      copy_tile_slab_var<uint16_t>(aid, bid);
+      break;
+    case Datatype::UINT32:
+      copy_tile_slab_var<uint32_t>(aid, bid);
+      break;
+    case Datatype::UINT64:
+      copy_tile_slab_var<uint64_t>(aid, bid);
+      break;
+    case Datatype::CHAR:
+      copy_tile_slab_var<char>(aid, bid);
+      break;
+    case Datatype::STRING_ASCII:
+      copy_tile_slab_var<uint8_t>(aid, bid);
+      break;
+    case Datatype::STRING_UTF8:
+      copy_tile_slab_var<uint8_t>(aid, bid);
+      break;
+    case Datatype::STRING_UTF16:
+      copy_tile_slab_var<uint16_t>(aid, bid);
+      break;
+    case Datatype::STRING_UTF32:
+      copy_tile_slab_var<uint32_t>(aid, bid);
+      break;
+    case Datatype::STRING_UCS2:
+      copy_tile_slab_var<uint16_t>(aid, bid);
+      break;
+    case Datatype::STRING_UCS4:
+      copy_tile_slab_var<uint32_t>(aid, bid);
+      break;
+    case Datatype::ANY:
+      copy_tile_slab_var<uint8_t>(aid, bid);
+      break;
+  }
 }
 
 template <class T>
@@ -1143,7 +1184,7 @@ Status ArrayOrderedWriteState::create_copy_state_buffers() {
   }
 
   // Allocate buffers
-  for (unsigned int j = 0; j < 2; ++j) {
+  for (unsigned int j = 0; j < slab_num_; ++j) {
     copy_state_.buffers_[j] = (void**)std::malloc(buffer_num_ * sizeof(void*));
     if (copy_state_.buffers_[j] == nullptr) {
       return LOG_STATUS(Status::ASWSError("Cannot create local buffers"));
@@ -1463,7 +1504,7 @@ void ArrayOrderedWriteState::fill_with_empty_var<uint64_t>(unsigned int bid) {
 }
 
 void ArrayOrderedWriteState::free_copy_state() {
-  for (unsigned int i = 0; i < 2; ++i) {
+  for (unsigned int i = 0; i < slab_num_; ++i) {
     delete[] copy_state_.buffer_offsets_[i];
     if (copy_state_.buffer_sizes_[i] != nullptr)
       delete[] copy_state_.buffer_sizes_[i];
@@ -1577,7 +1618,7 @@ bool ArrayOrderedWriteState::separate_fragments() const {
 }
 
 void ArrayOrderedWriteState::init_copy_state() {
-  for (unsigned int j = 0; j < 2; ++j) {
+  for (unsigned int j = 0; j < slab_num_; ++j) {
     copy_state_.buffer_offsets_[j] = new uint64_t[buffer_num_];
     copy_state_.buffer_sizes_[j] = new uint64_t[buffer_num_];
     copy_state_.buffers_[j] = new void*[buffer_num_];
@@ -1669,11 +1710,11 @@ bool ArrayOrderedWriteState::next_tile_slab_col() {
   auto domain = static_cast<const T*>(array_schema->domain()->domain());
   auto tile_extents =
       static_cast<const T*>(array_schema->domain()->tile_extents());
-  T* tile_slab[2];
+  std::vector<T*> tile_slab(slab_num_);
   auto tile_slab_norm = static_cast<T*>(tile_slab_norm_[copy_id_]);
-  for (unsigned int i = 0; i < 2; ++i)
+  for (unsigned int i = 0; i < slab_num_; ++i)
     tile_slab[i] = static_cast<T*>(tile_slab_[i]);
-  unsigned int prev_id = (copy_id_ + 1) % 2;
+  unsigned int prev_id = (copy_id_ + slab_num_ - 1) % slab_num_;
   T tile_start;
 
   // Check again if done, this time based on the tile slab and subarray
@@ -1740,11 +1781,11 @@ bool ArrayOrderedWriteState::next_tile_slab_row() {
   auto domain = static_cast<const T*>(array_schema->domain()->domain());
   auto tile_extents =
       static_cast<const T*>(array_schema->domain()->tile_extents());
-  T* tile_slab[2];
+  std::vector<T*> tile_slab(slab_num_);
   auto tile_slab_norm = static_cast<T*>(tile_slab_norm_[copy_id_]);
-  for (unsigned int i = 0; i < 2; ++i)
+  for (unsigned int i = 0; i < slab_num_; ++i)
     tile_slab[i] = static_cast<T*>(tile_slab_[i]);
-  unsigned int prev_id = (copy_id_ + 1) % 2;
+  unsigned int prev_id = (copy_id_ + slab_num_ - 1) % slab_num_;
   T tile_start;
 
   // Check again if done, this time based on the tile slab and subarray
@@ -1827,14 +1868,14 @@ Status ArrayOrderedWriteState::write_sorted_col() {
     async_wait(copy_id_);
     reset_tile_slab_state<T>();
     reset_copy_state();
-    copy_tile_slab();
+    RETURN_NOT_OK(copy_tile_slab());
     async_wait_[copy_id_] = true;
     async_submit_query(copy_id_);
-    copy_id_ = (copy_id_ + 1) % 2;
+    copy_id_ = (copy_id_ + 1) % slab_num_;
   }
 
   // Wait for last async query to finish
-  async_wait((copy_id_ + 1) % 2);
+  async_wait((copy_id_ + slab_num_ - 1) % slab_num_);
 
   // Success
   return Status::Ok();
@@ -1857,14 +1898,14 @@ Status ArrayOrderedWriteState::write_sorted_row() {
     async_wait(copy_id_);
     reset_tile_slab_state<T>();
     reset_copy_state();
-    copy_tile_slab();
+    RETURN_NOT_OK(copy_tile_slab());
     async_wait_[copy_id_] = true;
     async_submit_query(copy_id_);
-    copy_id_ = (copy_id_ + 1) % 2;
+    copy_id_ = (copy_id_ + 1) % slab_num_;
   }
 
   // Wait for last async query to finish
-  async_wait((copy_id_ + 1) % 2);
+  async_wait((copy_id_ + slab_num_ - 1) % slab_num_);
 
   // Success
   return Status::Ok();
@@ -1898,6 +1939,24 @@ void ArrayOrderedWriteState::reset_tile_slab_state() {
   }
 }
 
+Status ArrayOrderedWriteState::run_parallel(
+    const std::vector<std::function<Status()>>& tasks) {
+  if (tasks.size() == 1)
+    return tasks[0]();
+
+  auto compute_tp = query_->storage_manager()->compute_tp();
+  auto memory_tracker = MemoryTracker::thread_tracker();
+  std::vector<std::future<Status>> results;
+  for (const auto& task : tasks) {
+    results.push_back(compute_tp->enqueue([&task, memory_tracker]() {
+      ScopedMemoryTracker scoped_tracker(memory_tracker);
+      return task();
+    }));
+  }
+
+  return compute_tp->wait_all_status(results);
+}
+
 void ArrayOrderedWriteState::update_current_tile_and_offset(unsigned int aid) {
   // For easy reference
   Datatype coords_type = query_->array_schema()->coords_type();
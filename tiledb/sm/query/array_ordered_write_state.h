@@ -38,6 +38,7 @@
 #include "tiledb/sm/query/query.h"
 
 #include <condition_variable>
+#include <functional>
 #include <mutex>
 #include <string>
 #include <vector>
@@ -71,11 +72,11 @@ class ArrayOrderedWriteState {
   /** Stores local state about the current write/copy request. */
   struct CopyState {
     /** Local buffer offsets. */
-    uint64_t* buffer_offsets_[2];
+    std::vector<uint64_t*> buffer_offsets_;
     /** Local buffer sizes. */
-    uint64_t* buffer_sizes_[2];
+    std::vector<uint64_t*> buffer_sizes_;
     /** Local buffers. */
-    void** buffers_[2];
+    std::vector<void**> buffers_;
   };
 
   /** Info about a tile slab. */
@@ -170,19 +171,19 @@ class ArrayOrderedWriteState {
   void* (*advance_cell_slab_)(void*);
 
   /** Condition variables used for the internal async queries. */
-  std::condition_variable async_cv_[2];
+  std::vector<std::condition_variable> async_cv_;
 
   /** Data for the internal async queries. */
-  ASWS_Data async_data_[2];
+  std::vector<ASWS_Data> async_data_;
 
   /** Mutexes used in async queries. */
-  std::mutex async_mtx_[2];
+  std::vector<std::mutex> async_mtx_;
 
   /** The async queries. */
-  Query* async_query_[2];
+  std::vector<Query*> async_query_;
 
   /** Wait for async flags, one for each local buffer. */
-  bool async_wait_[2];
+  bool* async_wait_;
 
   /** The ids of the attributes the array was initialized with. */
   const std::vector<unsigned int> attribute_ids_;
@@ -229,6 +230,12 @@ class ArrayOrderedWriteState {
   /** The array this sorted read state belongs to. */
   Query* query_;
 
+  /**
+   * Number of tile slabs in the write pipeline, i.e., up to this number minus
+   * one tile slabs are being written while the current one is being copied.
+   */
+  unsigned int slab_num_;
+
   /** The query subarray. */
   void* subarray_;
 
@@ -238,17 +245,17 @@ class ArrayOrderedWriteState {
   /** Auxiliary variable used in calculate_tile_slab_info(). */
   void* tile_domain_;
 
-  /** The tile slab to be read for the first and second buffers. */
-  void* tile_slab_[2];
+  /** The tile slab to be written for each set of local buffers. */
+  std::vector<void*> tile_slab_;
 
   /** Indicates if the tile slab has been initialized. */
-  bool tile_slab_init_[2];
+  bool* tile_slab_init_;
 
   /** Normalized tile slab. */
-  void* tile_slab_norm_[2];
+  std::vector<void*> tile_slab_norm_;
 
-  /** The info for each of the two tile slabs under investigation. */
-  TileSlabInfo tile_slab_info_[2];
+  /** The info for each of the tile slabs under investigation. */
+  std::vector<TileSlabInfo> tile_slab_info_;
 
   /** The state for the current tile slab being copied. */
   TileSlabState tile_slab_state_;
@@ -506,11 +513,22 @@ class ArrayOrderedWriteState {
   /**
    * Copies a tile slab from the user buffers into the local buffers,
    * properly re-organizing the cell order to follow the array global
-   * cell order.
+   * cell order. The attributes are copied in parallel.
    *
+   * @return Status
+   */
+  Status copy_tile_slab();
+
+  /**
+   * Copies a tile slab from the user buffers into the local buffers,
+   * focusing on a particular fixed-length attribute. It dispatches to
+   * the templated function based on the attribute type.
+   *
+   * @param aid The index on attribute_ids_ to focus on.
+   * @param bid The index on the copy state buffers to focus on.
    * @return void.
    */
-  void copy_tile_slab();
+  void copy_tile_slab(unsigned int aid, unsigned int bid);
 
   /**
    * Copies a tile slab from the local buffers into the user buffers,
@@ -538,6 +556,17 @@ class ArrayOrderedWriteState {
   template <class T>
   void copy_tile_slab_var(unsigned int aid, unsigned int bid);
 
+  /**
+   * Copies a tile slab from the user buffers into the local buffers,
+   * focusing on a particular variable-length attribute. It dispatches to
+   * the templated function based on the attribute type.
+   *
+   * @param aid The index on attribute_ids_ to focus on.
+   * @param bid The index on the copy state buffers to focus on.
+   * @return void.
+   */
+  void copy_tile_slab_var(unsigned int aid, unsigned int bid);
+
   /**
    * Creates the copy state buffers.
    *
@@ -706,6 +735,14 @@ class ArrayOrderedWriteState {
   template <class T>
   void reset_tile_slab_state();
 
+  /**
+   * Runs the input tasks in parallel on the compute thread pool.
+   *
+   * @param tasks The tasks to run.
+   * @return Status
+   */
+  Status run_parallel(const std::vector<std::function<Status()>>& tasks);
+
   /**
    * Calculates the new tile and local buffer offset for the new (already
    * computed) current cell coordinates in the tile slab.
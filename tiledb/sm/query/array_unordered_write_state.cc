@@ -0,0 +1,604 @@
+/**
+ * @file   array_unordered_write_state.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2018 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file implements the ArrayUnorderedWriteState class.
+ */
+
+#include "tiledb/sm/query/array_unordered_write_state.h"
+#include "tiledb/sm/misc/comparators.h"
+#include "tiledb/sm/misc/constants.h"
+#include "tiledb/sm/misc/logger.h"
+#include "tiledb/sm/misc/utils.h"
+#include "tiledb/sm/query/query.h"
+#include "tiledb/sm/storage_manager/storage_manager.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <queue>
+#include <sstream>
+#include <thread>
+
+namespace tiledb {
+namespace sm {
+
+/* ****************************** */
+/*   CONSTRUCTORS & DESTRUCTORS   */
+/* ****************************** */
+
+ArrayUnorderedWriteState::ArrayUnorderedWriteState(Query* query)
+    : attribute_ids_(query->attribute_ids())
+    , buffer_num_(0)
+    , memory_budget_(0)
+    , out_size_(0)
+    , out_query_(nullptr)
+    , query_(query) {
+}
+
+ArrayUnorderedWriteState::~ArrayUnorderedWriteState() {
+  delete out_query_;
+  remove_scratch_dir();
+}
+
+/* ****************************** */
+/*               API              */
+/* ****************************** */
+
+Status ArrayUnorderedWriteState::finalize() {
+  Status st = merge();
+  if (st.ok())
+    st = flush_output();
+  if (st.ok() && out_query_ != nullptr)
+    st = out_query_->finalize();
+  delete out_query_;
+  out_query_ = nullptr;
+
+  Status st_remove = remove_scratch_dir();
+  RETURN_NOT_OK(st);
+  return st_remove;
+}
+
+Status ArrayUnorderedWriteState::init() {
+  // For easy reference
+  auto array_schema = query_->array_schema();
+  unsigned int attribute_num = array_schema->attribute_num();
+
+  memory_budget_ =
+      query_->storage_manager()->config().sm_params().external_sort_memory_;
+  if (memory_budget_ == 0)
+    return LOG_STATUS(Status::WriteStateError(
+        "Cannot initialize unordered write state; No memory budget"));
+
+  // Locate the buffers of each attribute
+  buffer_num_ = 0;
+  for (auto id : attribute_ids_) {
+    buffer_idx_.push_back(buffer_num_);
+    if (id == attribute_num) {
+      cell_sizes_.push_back(array_schema->coords_size());
+      ++buffer_num_;
+    } else if (array_schema->var_size(id)) {
+      cell_sizes_.push_back(0);
+      buffer_num_ += 2;
+    } else {
+      cell_sizes_.push_back(array_schema->cell_size(id));
+      ++buffer_num_;
+    }
+  }
+  out_buffers_.resize(buffer_num_);
+
+  return Status::Ok();
+}
+
+Status ArrayUnorderedWriteState::write(void** buffers, uint64_t* buffer_sizes) {
+  RETURN_NOT_OK(append_cells(buffers, buffer_sizes));
+
+  // Spill the run if it exceeds the budget
+  if (run_size() >= memory_budget_)
+    return spill();
+
+  return Status::Ok();
+}
+
+/* ****************************** */
+/*         PRIVATE METHODS        */
+/* ****************************** */
+
+Status ArrayUnorderedWriteState::append_cells(
+    void** buffers, uint64_t* buffer_sizes) {
+  // For easy reference
+  auto array_schema = query_->array_schema();
+  unsigned int attribute_num = array_schema->attribute_num();
+  uint64_t coords_size = array_schema->coords_size();
+  auto id_num = (unsigned int)attribute_ids_.size();
+
+  // Get the coordinates and the number of cells
+  const char* coords = nullptr;
+  uint64_t cell_num = 0;
+  for (unsigned int i = 0; i < id_num; ++i) {
+    if (attribute_ids_[i] != attribute_num)
+      continue;
+    coords = static_cast<const char*>(buffers[buffer_idx_[i]]);
+    cell_num = buffer_sizes[buffer_idx_[i]] / coords_size;
+    if (buffer_sizes[buffer_idx_[i]] != cell_num * coords_size)
+      return LOG_STATUS(Status::WriteStateError(
+          "Cannot write cells; Invalid coordinates buffer size"));
+  }
+  if (coords == nullptr)
+    return LOG_STATUS(Status::WriteStateError(
+        "Cannot write cells; Unordered writes expect coordinates"));
+
+  // Check the attribute buffer sizes
+  for (unsigned int i = 0; i < id_num; ++i) {
+    if (attribute_ids_[i] == attribute_num)
+      continue;
+    uint64_t cell_size = cell_sizes_[i];
+    if (cell_size == 0)
+      cell_size = constants::cell_var_offset_size;
+    if (buffer_sizes[buffer_idx_[i]] != cell_num * cell_size)
+      return LOG_STATUS(Status::WriteStateError(
+          "Cannot write cells; Attribute buffer sizes do not match the number "
+          "of coordinates"));
+  }
+
+  // Append the coordinates
+  run_coords_.insert(
+      run_coords_.end(), coords, coords + cell_num * coords_size);
+
+  // Append the attribute values cell by cell
+  for (uint64_t c = 0; c < cell_num; ++c) {
+    run_offsets_.push_back(run_cells_.size());
+    for (unsigned int i = 0; i < id_num; ++i) {
+      if (attribute_ids_[i] == attribute_num)
+        continue;
+      unsigned int b = buffer_idx_[i];
+      if (cell_sizes_[i] != 0) {
+        auto values = static_cast<const char*>(buffers[b]) + c * cell_sizes_[i];
+        run_cells_.insert(run_cells_.end(), values, values + cell_sizes_[i]);
+        continue;
+      }
+
+      auto offsets = static_cast<const uint64_t*>(buffers[b]);
+      uint64_t start = offsets[c];
+      uint64_t end = (c + 1 < cell_num) ? offsets[c + 1] : buffer_sizes[b + 1];
+      if (start > end || end > buffer_sizes[b + 1])
+        return LOG_STATUS(Status::WriteStateError(
+            "Cannot write cells; Invalid var-sized attribute offsets"));
+      uint64_t size = end - start;
+      auto size_bytes = reinterpret_cast<const char*>(&size);
+      auto values = static_cast<const char*>(buffers[b + 1]) + start;
+      run_cells_.insert(
+          run_cells_.end(), size_bytes, size_bytes + sizeof(size));
+      run_cells_.insert(run_cells_.end(), values, values + size);
+    }
+  }
+
+  return Status::Ok();
+}
+
+Status ArrayUnorderedWriteState::create_scratch_dir() {
+  // Use the system temporary directory by default
+  auto sm_params = query_->storage_manager()->config().sm_params();
+  std::string dir = sm_params.external_sort_scratch_dir_;
+  if (dir.empty()) {
+    const char* tmp = getenv("TMPDIR");
+    if (tmp == nullptr)
+      tmp = getenv("TEMP");
+    dir = (tmp != nullptr) ? tmp : "/tmp";
+  }
+
+  std::stringstream ss;
+  ss << dir << "/__tiledb_sort_" << std::this_thread::get_id() << "_"
+     << utils::timestamp_ms() << "_" << reinterpret_cast<uintptr_t>(this);
+  URI uri(ss.str());
+  RETURN_NOT_OK(query_->storage_manager()->vfs()->create_dir(uri));
+  scratch_uri_ = uri;
+
+  return Status::Ok();
+}
+
+Status ArrayUnorderedWriteState::emit_cell(
+    const char* coords, const char* cell) {
+  unsigned int attribute_num = query_->array_schema()->attribute_num();
+  auto id_num = (unsigned int)attribute_ids_.size();
+
+  for (unsigned int i = 0; i < id_num; ++i) {
+    auto& out = out_buffers_[buffer_idx_[i]];
+    if (attribute_ids_[i] == attribute_num) {
+      out.insert(out.end(), coords, coords + cell_sizes_[i]);
+      out_size_ += cell_sizes_[i];
+    } else if (cell_sizes_[i] != 0) {
+      out.insert(out.end(), cell, cell + cell_sizes_[i]);
+      out_size_ += cell_sizes_[i];
+      cell += cell_sizes_[i];
+    } else {
+      auto& out_var = out_buffers_[buffer_idx_[i] + 1];
+      uint64_t size, offset = out_var.size();
+      std::memcpy(&size, cell, sizeof(size));
+      cell += sizeof(size);
+      auto offset_bytes = reinterpret_cast<const char*>(&offset);
+      out.insert(out.end(), offset_bytes, offset_bytes + sizeof(offset));
+      out_var.insert(out_var.end(), cell, cell + size);
+      out_size_ += sizeof(offset) + size;
+      cell += size;
+    }
+  }
+
+  // Write the output buffers once they take half the budget
+  if (out_size_ >= memory_budget_ / 2)
+    return flush_output();
+
+  return Status::Ok();
+}
+
+Status ArrayUnorderedWriteState::flush_output() {
+  if (out_size_ == 0)
+    return Status::Ok();
+
+  std::vector<void*> buffers(buffer_num_);
+  std::vector<uint64_t> buffer_sizes(buffer_num_);
+  for (unsigned int b = 0; b < buffer_num_; ++b) {
+    buffers[b] = out_buffers_[b].data();
+    buffer_sizes[b] = out_buffers_[b].size();
+  }
+
+  // The merged cells are written in global order into a single fragment
+  if (out_query_ == nullptr) {
+    out_query_ = new Query();
+    out_query_->set_memory_tracker_parent(query_->memory_tracker());
+    RETURN_NOT_OK(out_query_->init(
+        query_->storage_manager(),
+        query_->array_schema(),
+        query_->fragment_metadata(),
+        QueryType::WRITE,
+        Layout::GLOBAL_ORDER,
+        query_->subarray(),
+        attribute_ids_,
+        &buffers[0],
+        &buffer_sizes[0]));
+  }
+  RETURN_NOT_OK(out_query_->write(&buffers[0], &buffer_sizes[0]));
+
+  for (auto& out : out_buffers_)
+    out.clear();
+  out_size_ = 0;
+
+  return Status::Ok();
+}
+
+Status ArrayUnorderedWriteState::load_run_cell(
+    RunReader* reader, bool* done) const {
+  auto vfs = query_->storage_manager()->vfs();
+  uint64_t header_size =
+      2 * sizeof(uint64_t) + query_->array_schema()->coords_size();
+
+  *done = false;
+  auto& block = reader->block_;
+  for (;;) {
+    // Check if the cell is already in the block
+    uint64_t available = reader->block_size_ - reader->block_offset_;
+    uint64_t cell_size = header_size;
+    if (available >= header_size) {
+      uint64_t values_size;
+      std::memcpy(
+          &values_size, &block[reader->block_offset_], sizeof(values_size));
+      cell_size += values_size;
+      if (available >= cell_size)
+        return Status::Ok();
+    }
+
+    // Check if the run is exhausted
+    if (reader->file_offset_ == reader->file_size_) {
+      if (available != 0)
+        return LOG_STATUS(Status::WriteStateError(
+            "Cannot merge runs; Truncated run file"));
+      *done = true;
+      return Status::Ok();
+    }
+
+    // Move the partial cell to the start of the block and read more of it
+    if (available != 0)
+      std::memmove(&block[0], &block[reader->block_offset_], available);
+    reader->block_offset_ = 0;
+    reader->block_size_ = available;
+    if (block.size() < cell_size)
+      block.resize(cell_size);
+    uint64_t nbytes = std::min(
+        block.size() - available, reader->file_size_ - reader->file_offset_);
+    RETURN_NOT_OK(vfs->read(
+        reader->uri_, reader->file_offset_, &block[available], nbytes));
+    reader->file_offset_ += nbytes;
+    reader->block_size_ += nbytes;
+  }
+}
+
+Status ArrayUnorderedWriteState::merge() {
+  Datatype coords_type = query_->array_schema()->coords_type();
+
+  // Invoke the proper templated function
+  if (coords_type == Datatype::INT32)
+    return merge<int>();
+  if (coords_type == Datatype::INT64)
+    return merge<int64_t>();
+  if (coords_type == Datatype::FLOAT32)
+    return merge<float>();
+  if (coords_type == Datatype::FLOAT64)
+    return merge<double>();
+  if (coords_type == Datatype::INT8)
+    return merge<int8_t>();
+  if (coords_type == Datatype::UINT8)
+    return merge<uint8_t>();
+  if (coords_type == Datatype::INT16)
+    return merge<int16_t>();
+  if (coords_type == Datatype::UINT16)
+    return merge<uint16_t>();
+  if (coords_type == Datatype::UINT32)
+    return merge<uint32_t>();
+  if (coords_type == Datatype::UINT64)
+    return merge<uint64_t>();
+
+  return LOG_STATUS(Status::WriteStateError(
+      "Cannot merge cells; Unsupported coordinates type"));
+}
+
+template <class T>
+Status ArrayUnorderedWriteState::merge() {
+  // Everything spilled goes through the runs
+  if (!run_uris_.empty()) {
+    RETURN_NOT_OK(spill<T>());
+    return merge_runs<T>();
+  }
+
+  // Otherwise emit the in-memory run directly
+  uint64_t coords_size = query_->array_schema()->coords_size();
+  std::vector<uint64_t> cell_pos, ids;
+  sort_run<T>(&cell_pos, &ids);
+  for (auto pos : cell_pos)
+    RETURN_NOT_OK(emit_cell(
+        &run_coords_[pos * coords_size], &run_cells_[run_offsets_[pos]]));
+
+  run_cells_.clear();
+  run_coords_.clear();
+  run_offsets_.clear();
+
+  return Status::Ok();
+}
+
+template <class T>
+Status ArrayUnorderedWriteState::merge_runs() {
+  // For easy reference
+  auto array_schema = query_->array_schema();
+  auto domain = array_schema->domain();
+  auto dim_num = array_schema->dim_num();
+  uint64_t coords_size = array_schema->coords_size();
+  uint64_t header_size = 2 * sizeof(uint64_t);
+  auto vfs = query_->storage_manager()->vfs();
+  auto run_num = run_uris_.size();
+
+  // Half of the budget is shared by the run readers
+  uint64_t block_size = std::max<uint64_t>(
+      memory_budget_ / 2 / run_num, header_size + coords_size);
+  std::vector<RunReader> readers(run_num);
+  for (size_t r = 0; r < run_num; ++r) {
+    readers[r].block_.resize(block_size);
+    readers[r].block_offset_ = 0;
+    readers[r].block_size_ = 0;
+    readers[r].file_offset_ = 0;
+    readers[r].uri_ = run_uris_[r];
+    RETURN_NOT_OK(vfs->file_size(readers[r].uri_, &readers[r].file_size_));
+  }
+
+  // The coordinates are copied out, as they may not be aligned in the blocks
+  std::vector<T> coords_a(dim_num), coords_b(dim_num);
+  auto greater = [&](size_t a, size_t b) {
+    const char* cell_a = &readers[a].block_[readers[a].block_offset_];
+    const char* cell_b = &readers[b].block_[readers[b].block_offset_];
+    uint64_t id_a, id_b;
+    std::memcpy(&id_a, cell_a + sizeof(uint64_t), sizeof(uint64_t));
+    std::memcpy(&id_b, cell_b + sizeof(uint64_t), sizeof(uint64_t));
+    if (id_a != id_b)
+      return id_a > id_b;
+    std::memcpy(&coords_a[0], cell_a + header_size, coords_size);
+    std::memcpy(&coords_b[0], cell_b + header_size, coords_size);
+    int cmp = domain->cell_order_cmp<T>(&coords_a[0], &coords_b[0]);
+    if (cmp != 0)
+      return cmp > 0;
+    return a > b;
+  };
+  std::priority_queue<size_t, std::vector<size_t>, decltype(greater)> pq(
+      greater);
+
+  bool done;
+  for (size_t r = 0; r < run_num; ++r) {
+    RETURN_NOT_OK(load_run_cell(&readers[r], &done));
+    if (!done)
+      pq.push(r);
+  }
+
+  // Emit the smallest cell and advance its run
+  while (!pq.empty()) {
+    auto r = pq.top();
+    pq.pop();
+    auto& reader = readers[r];
+    const char* cell = &reader.block_[reader.block_offset_];
+    uint64_t values_size;
+    std::memcpy(&values_size, cell, sizeof(uint64_t));
+    RETURN_NOT_OK(emit_cell(
+        cell + header_size, cell + header_size + coords_size));
+    reader.block_offset_ += header_size + coords_size + values_size;
+    RETURN_NOT_OK(load_run_cell(&reader, &done));
+    if (!done)
+      pq.push(r);
+  }
+
+  return Status::Ok();
+}
+
+Status ArrayUnorderedWriteState::remove_scratch_dir() {
+  if (scratch_uri_.to_string().empty())
+    return Status::Ok();
+
+  run_uris_.clear();
+  Status st = query_->storage_manager()->vfs()->remove_dir(scratch_uri_);
+  scratch_uri_ = URI();
+
+  return st;
+}
+
+uint64_t ArrayUnorderedWriteState::run_cell_size(const char* cell) const {
+  unsigned int attribute_num = query_->array_schema()->attribute_num();
+  auto id_num = (unsigned int)attribute_ids_.size();
+
+  uint64_t cell_size = 0;
+  for (unsigned int i = 0; i < id_num; ++i) {
+    if (attribute_ids_[i] == attribute_num)
+      continue;
+    if (cell_sizes_[i] != 0) {
+      cell_size += cell_sizes_[i];
+    } else {
+      uint64_t size;
+      std::memcpy(&size, cell + cell_size, sizeof(size));
+      cell_size += sizeof(size) + size;
+    }
+  }
+
+  return cell_size;
+}
+
+uint64_t ArrayUnorderedWriteState::run_size() const {
+  return run_coords_.size() + run_cells_.size() +
+         run_offsets_.size() * sizeof(uint64_t);
+}
+
+template <class T>
+void ArrayUnorderedWriteState::sort_run(
+    std::vector<uint64_t>* cell_pos, std::vector<uint64_t>* ids) const {
+  // For easy reference
+  auto array_schema = query_->array_schema();
+  auto domain = array_schema->domain();
+  auto dim_num = array_schema->dim_num();
+  auto coords = reinterpret_cast<const T*>(run_coords_.data());
+  uint64_t cell_num = run_offsets_.size();
+
+  // Compute the tile ids (all zero without a tile grid)
+  std::vector<T> tile_coords(dim_num);
+  cell_pos->resize(cell_num);
+  ids->resize(cell_num);
+  for (uint64_t i = 0; i < cell_num; ++i) {
+    (*cell_pos)[i] = i;
+    (*ids)[i] = domain->tile_id<T>(&coords[i * dim_num], &tile_coords[0]);
+  }
+
+  if (array_schema->cell_order() == Layout::ROW_MAJOR)
+    std::stable_sort(
+        cell_pos->begin(),
+        cell_pos->end(),
+        SmallerIdRow<T>(coords, dim_num, *ids));
+  else
+    std::stable_sort(
+        cell_pos->begin(),
+        cell_pos->end(),
+        SmallerIdCol<T>(coords, dim_num, *ids));
+}
+
+Status ArrayUnorderedWriteState::spill() {
+  Datatype coords_type = query_->array_schema()->coords_type();
+
+  // Invoke the proper templated function
+  if (coords_type == Datatype::INT32)
+    return spill<int>();
+  if (coords_type == Datatype::INT64)
+    return spill<int64_t>();
+  if (coords_type == Datatype::FLOAT32)
+    return spill<float>();
+  if (coords_type == Datatype::FLOAT64)
+    return spill<double>();
+  if (coords_type == Datatype::INT8)
+    return spill<int8_t>();
+  if (coords_type == Datatype::UINT8)
+    return spill<uint8_t>();
+  if (coords_type == Datatype::INT16)
+    return spill<int16_t>();
+  if (coords_type == Datatype::UINT16)
+    return spill<uint16_t>();
+  if (coords_type == Datatype::UINT32)
+    return spill<uint32_t>();
+  if (coords_type == Datatype::UINT64)
+    return spill<uint64_t>();
+
+  return LOG_STATUS(Status::WriteStateError(
+      "Cannot spill cells; Unsupported coordinates type"));
+}
+
+template <class T>
+Status ArrayUnorderedWriteState::spill() {
+  if (run_offsets_.empty())
+    return Status::Ok();
+
+  // For easy reference
+  uint64_t coords_size = query_->array_schema()->coords_size();
+  auto vfs = query_->storage_manager()->vfs();
+
+  if (scratch_uri_.to_string().empty())
+    RETURN_NOT_OK(create_scratch_dir());
+  std::stringstream ss;
+  ss << "run_" << run_uris_.size();
+  URI uri = scratch_uri_.join_path(ss.str());
+  run_uris_.push_back(uri);
+
+  // Write the sorted cells in large blocks
+  std::vector<uint64_t> cell_pos, ids;
+  sort_run<T>(&cell_pos, &ids);
+  std::vector<char> block;
+  block.reserve(constants::external_sort_io_size);
+  for (auto pos : cell_pos) {
+    const char* cell = &run_cells_[run_offsets_[pos]];
+    const char* coords = &run_coords_[pos * coords_size];
+    uint64_t header[2] = {run_cell_size(cell), ids[pos]};
+    auto header_bytes = reinterpret_cast<const char*>(header);
+    block.insert(block.end(), header_bytes, header_bytes + sizeof(header));
+    block.insert(block.end(), coords, coords + coords_size);
+    block.insert(block.end(), cell, cell + header[0]);
+    if (block.size() >= constants::external_sort_io_size) {
+      RETURN_NOT_OK(vfs->write(uri, block.data(), block.size()));
+      block.clear();
+    }
+  }
+  if (!block.empty())
+    RETURN_NOT_OK(vfs->write(uri, block.data(), block.size()));
+  RETURN_NOT_OK(vfs->close_file(uri));
+
+  run_cells_.clear();
+  run_coords_.clear();
+  run_offsets_.clear();
+
+  return Status::Ok();
+}
+
+}  // namespace sm
+}  // namespace tiledb
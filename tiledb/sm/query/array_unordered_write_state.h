@@ -0,0 +1,282 @@
+/**
+ * @file   array_unordered_write_state.h
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2018 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file defines class ArrayUnorderedWriteState.
+ */
+
+#ifndef TILEDB_ARRAY_UNORDERED_WRITE_STATE_H
+#define TILEDB_ARRAY_UNORDERED_WRITE_STATE_H
+
+#include "tiledb/sm/misc/status.h"
+#include "tiledb/sm/misc/uri.h"
+
+#include <string>
+#include <vector>
+
+namespace tiledb {
+namespace sm {
+
+class Query;
+
+/**
+ * It is responsible for unordered writes to sparse arrays that do not fit
+ * in memory. The cells of all the submissions of the query are gathered in
+ * a run of a bounded size. Every full run is sorted along the array global
+ * cell order and spilled to a scratch file, and upon finalization the runs
+ * are merged into a single new fragment.
+ */
+class ArrayUnorderedWriteState {
+ public:
+  /* ********************************* */
+  /*     CONSTRUCTORS & DESTRUCTORS    */
+  /* ********************************* */
+
+  /**
+   * Constructor.
+   *
+   * @param query The query this array unordered write state belongs to.
+   */
+  explicit ArrayUnorderedWriteState(Query* query);
+
+  /** Destructor. Removes the scratch files. */
+  ~ArrayUnorderedWriteState();
+
+  /* ********************************* */
+  /*               API                 */
+  /* ********************************* */
+
+  /**
+   * Finalizes the object, merging all the cells written so far into a
+   * new fragment and removing the scratch files.
+   *
+   * @return Status
+   */
+  Status finalize();
+
+  /**
+   * Initializes the array unordered write state.
+   *
+   * @return Status
+   */
+  Status init();
+
+  /**
+   * The write function. The input cells are appended to the current run,
+   * which is spilled to a scratch file if it exceeds the memory budget.
+   *
+   * @param buffers The buffers that hold the input cells to be written.
+   * @param buffer_sizes The corresponding buffer sizes.
+   * @return Status
+   */
+  Status write(void** buffers, uint64_t* buffer_sizes);
+
+ private:
+  /* ********************************* */
+  /*         TYPE DEFINITIONS          */
+  /* ********************************* */
+
+  /** Reads the cells of a spilled run in blocks. */
+  struct RunReader {
+    /** The current block of the run file. */
+    std::vector<char> block_;
+    /** The offset of the current cell in the block. */
+    uint64_t block_offset_;
+    /** The number of valid bytes in the block. */
+    uint64_t block_size_;
+    /** The offset in the run file right after the current block. */
+    uint64_t file_offset_;
+    /** The size of the run file. */
+    uint64_t file_size_;
+    /** The URI of the run file. */
+    URI uri_;
+  };
+
+  /* ********************************* */
+  /*         PRIVATE ATTRIBUTES        */
+  /* ********************************* */
+
+  /** The ids of the attributes the query was initialized with. */
+  const std::vector<unsigned int> attribute_ids_;
+
+  /** The index of the first query buffer of each attribute. */
+  std::vector<unsigned int> buffer_idx_;
+
+  /** The number of query buffers. */
+  unsigned int buffer_num_;
+
+  /** The fixed cell size of each attribute (`0` if it is var-sized). */
+  std::vector<uint64_t> cell_sizes_;
+
+  /** The memory budget of the runs and of the output buffers. */
+  uint64_t memory_budget_;
+
+  /** The output buffers, one per query buffer. */
+  std::vector<std::vector<char>> out_buffers_;
+
+  /** The number of bytes currently held in the output buffers. */
+  uint64_t out_size_;
+
+  /** The internal query that writes the merged cells in global order. */
+  Query* out_query_;
+
+  /** The query this array unordered write state belongs to. */
+  Query* query_;
+
+  /**
+   * The attribute values of the cells of the current run. Each cell stores
+   * its values in the order of `attribute_ids_`, skipping the coordinates.
+   * Fixed-sized values are stored as is, whereas var-sized values are
+   * preceded by their size as a `uint64_t`.
+   */
+  std::vector<char> run_cells_;
+
+  /** The coordinates of the cells of the current run. */
+  std::vector<char> run_coords_;
+
+  /** The offset of each cell of the current run in `run_cells_`. */
+  std::vector<uint64_t> run_offsets_;
+
+  /** The URIs of the spilled run files. */
+  std::vector<URI> run_uris_;
+
+  /** The scratch directory of the query (empty until the first spill). */
+  URI scratch_uri_;
+
+  /* ********************************* */
+  /*          PRIVATE METHODS          */
+  /* ********************************* */
+
+  /**
+   * Appends the input cells to the current run.
+   *
+   * @param buffers The buffers that hold the input cells.
+   * @param buffer_sizes The corresponding buffer sizes.
+   * @return Status
+   */
+  Status append_cells(void** buffers, uint64_t* buffer_sizes);
+
+  /** Creates a unique scratch directory for the query. */
+  Status create_scratch_dir();
+
+  /**
+   * Appends a cell to the output buffers, writing them to the new fragment
+   * once they exceed half the memory budget.
+   *
+   * @param coords The cell coordinates.
+   * @param cell The cell attribute values, in the format of `run_cells_`.
+   * @return Status
+   */
+  Status emit_cell(const char* coords, const char* cell);
+
+  /** Writes the output buffers to the new fragment and empties them. */
+  Status flush_output();
+
+  /**
+   * Makes sure that the next cell of a spilled run is entirely held in the
+   * block of its reader, reading more of the run file if needed.
+   *
+   * @param reader The run reader.
+   * @param done Set to `true` if the run has no more cells.
+   * @return Status
+   */
+  Status load_run_cell(RunReader* reader, bool* done) const;
+
+  /**
+   * Emits all the cells written so far along the global cell order. If
+   * nothing was spilled the current run is sorted and emitted directly,
+   * otherwise it is spilled as well and all the runs are merged.
+   *
+   * @return Status
+   */
+  Status merge();
+
+  /**
+   * Emits all the cells written so far along the global cell order.
+   *
+   * @tparam T The coordinates type.
+   * @return Status
+   */
+  template <class T>
+  Status merge();
+
+  /**
+   * Merges the spilled runs, emitting their cells along the global cell
+   * order. Ties are broken by the run order, which preserves the order in
+   * which the cells were written.
+   *
+   * @tparam T The coordinates type.
+   * @return Status
+   */
+  template <class T>
+  Status merge_runs();
+
+  /** Removes the scratch directory, if it was created. */
+  Status remove_scratch_dir();
+
+  /** Returns the size of a cell in the format of `run_cells_`. */
+  uint64_t run_cell_size(const char* cell) const;
+
+  /** Returns the total size of the current run in memory. */
+  uint64_t run_size() const;
+
+  /**
+   * Sorts the cells of the current run along the global cell order. The
+   * sort is stable, so duplicate coordinates keep their write order.
+   *
+   * @tparam T The coordinates type.
+   * @param cell_pos Set to the sorted cell positions.
+   * @param ids Set to the tile id of each cell.
+   */
+  template <class T>
+  void sort_run(
+      std::vector<uint64_t>* cell_pos, std::vector<uint64_t>* ids) const;
+
+  /**
+   * Sorts the current run and spills it to a new run file.
+   *
+   * @return Status
+   */
+  Status spill();
+
+  /**
+   * Sorts the current run and spills it to a new run file. Each cell is
+   * stored as the size of its values and its tile id as `uint64_t`, followed
+   * by its coordinates and its values in the format of `run_cells_`.
+   *
+   * @tparam T The coordinates type.
+   * @return Status
+   */
+  template <class T>
+  Status spill();
+};
+
+}  // namespace sm
+}  // namespace tiledb
+
+#endif  // TILEDB_ARRAY_UNORDERED_WRITE_STATE_H
@@ -31,10 +31,13 @@
  */
 
 #include "tiledb/sm/query/query.h"
+#include "tiledb/sm/filter/dictionary_encoding.h"
 #include "tiledb/sm/misc/comparators.h"
 #include "tiledb/sm/misc/logger.h"
+#include "tiledb/sm/misc/stats.h"
 #include "tiledb/sm/misc/utils.h"
 
+#include <algorithm>
 #include <cassert>
 #include <set>
 #include <sstream>
@@ -42,6 +45,16 @@
 namespace tiledb {
 namespace sm {
 
+/**
+ * Returns an estimate of the memory consumed by a list of shared pointers,
+ * i.e., the pointed objects with their reference counts plus the list nodes.
+ */
+template <class T>
+static uint64_t shared_ptr_list_size(const std::list<std::shared_ptr<T>>& l) {
+  return l.size() * (sizeof(T) + 2 * sizeof(long) + sizeof(std::shared_ptr<T>) +
+                     2 * sizeof(void*));
+}
+
 /* ****************************** */
 /*   CONSTRUCTORS & DESTRUCTORS   */
 /* ****************************** */
@@ -52,6 +65,7 @@ Query::Query() {
   array_read_state_ = nullptr;
   array_ordered_read_state_ = nullptr;
   array_ordered_write_state_ = nullptr;
+  array_unordered_write_state_ = nullptr;
   array_schema_ = nullptr;
   buffers_ = nullptr;
   buffer_sizes_ = nullptr;
@@ -64,6 +78,8 @@ Query::Query() {
   status_ = QueryStatus::INPROGRESS;
   layout_ = Layout::ROW_MAJOR;
   buffer_num_ = 0;
+  memory_reservation_ = 0;
+  set_memory_tracker_parent(MemoryTracker::global());
 }
 
 Query::Query(Query* common_query) {
@@ -72,6 +88,7 @@ Query::Query(Query* common_query) {
   array_read_state_ = nullptr;
   array_ordered_read_state_ = nullptr;
   array_ordered_write_state_ = nullptr;
+  array_unordered_write_state_ = nullptr;
   callback_ = nullptr;
   callback_data_ = nullptr;
   fragments_init_ = false;
@@ -83,15 +100,22 @@ Query::Query(Query* common_query) {
   status_ = QueryStatus::INPROGRESS;
   consolidation_fragment_uri_ = common_query->consolidation_fragment_uri_;
   buffer_num_ = common_query->buffer_num_;
+  memory_reservation_ = 0;
+  set_memory_tracker_parent(common_query->memory_tracker()->parent());
 }
 
 Query::~Query() {
+  ScopedMemoryTracker scoped_tracker(memory_tracker_);
+
+  release_memory_reservation();
+
   if (subarray_ != nullptr)
     std::free(subarray_);
 
   delete array_read_state_;
   delete array_ordered_read_state_;
   delete array_ordered_write_state_;
+  delete array_unordered_write_state_;
 
   clear_fragments();
 }
@@ -105,6 +129,8 @@ const ArraySchema* Query::array_schema() const {
 }
 
 Status Query::async_process() {
+  ScopedMemoryTracker scoped_tracker(memory_tracker_);
+
   // In case this query follows another one (the common query)
   if (common_query_ != nullptr) {
     fragment_metadata_ = common_query_->fragment_metadata();
@@ -149,6 +175,14 @@ const std::vector<unsigned int>& Query::attribute_ids() const {
   return attribute_ids_;
 }
 
+uint64_t* Query::buffer_sizes() const {
+  return buffer_sizes_;
+}
+
+void** Query::buffers() const {
+  return buffers_;
+}
+
 Status Query::clear_fragments() {
   Status ret = Status::Ok();
   if (!fragments_borrowed_) {
@@ -277,6 +311,8 @@ Status Query::compute_subarrays(
 }
 
 Status Query::finalize() {
+  ScopedMemoryTracker scoped_tracker(memory_tracker_);
+
   // Clear sorted read state
   if (array_ordered_read_state_ != nullptr)
     RETURN_NOT_OK(array_ordered_read_state_->finalize());
@@ -289,6 +325,14 @@ Status Query::finalize() {
   delete array_ordered_write_state_;
   array_ordered_write_state_ = nullptr;
 
+  // Merge the cells of an out-of-core unordered write
+  if (array_unordered_write_state_ != nullptr)
+    RETURN_NOT_OK(array_unordered_write_state_->finalize());
+  delete array_unordered_write_state_;
+  array_unordered_write_state_ = nullptr;
+
+  release_memory_reservation();
+
   // Clear fragments
   return clear_fragments();
 }
@@ -314,6 +358,8 @@ unsigned int Query::fragment_num() const {
 }
 
 Status Query::init() {
+  ScopedMemoryTracker scoped_tracker(memory_tracker_);
+
   // Sanity checks
   if (storage_manager_ == nullptr)
     return LOG_STATUS(
@@ -335,6 +381,13 @@ Status Query::init() {
 
   RETURN_NOT_OK(check_buffer_sizes_ordered());
 
+  // Admission control: reserve the memory the query is estimated to need
+  uint64_t memory_estimate;
+  RETURN_NOT_OK(compute_memory_estimate(&memory_estimate));
+  release_memory_reservation();
+  RETURN_NOT_OK(storage_manager_->memory_budget_reserve(memory_estimate));
+  memory_reservation_ = memory_estimate;
+
   RETURN_NOT_OK(init_fragments(fragment_metadata_));
   RETURN_NOT_OK(init_states());
 
@@ -354,6 +407,8 @@ Status Query::init(
     uint64_t* buffer_sizes,
     const URI& consolidation_fragment_uri) {
   storage_manager_ = storage_manager;
+  set_memory_tracker_parent(storage_manager->memory_tracker());
+  ScopedMemoryTracker scoped_tracker(memory_tracker_);
   array_schema_ = array_schema;
   type_ = type;
   layout_ = layout;
@@ -383,6 +438,7 @@ Status Query::init(
     uint64_t* buffer_sizes,
     bool add_coords) {
   storage_manager_ = storage_manager;
+  ScopedMemoryTracker scoped_tracker(memory_tracker_);
   array_schema_ = array_schema;
   type_ = type;
   layout_ = layout;
@@ -412,6 +468,10 @@ Layout Query::layout() const {
   return layout_;
 }
 
+const std::shared_ptr<MemoryTracker>& Query::memory_tracker() const {
+  return memory_tracker_;
+}
+
 bool Query::overflow() const {
   // Not applicable to writes
   if (type_ != QueryType::READ)
@@ -503,6 +563,8 @@ Status Query::sparse_read() {
   // Compute the read coordinates for all fragments
   std::list<std::shared_ptr<OverlappingCoords<T>>> coords;
   RETURN_NOT_OK(compute_overlapping_coords<T>(tiles, &coords));
+  ScopedMemoryUsage coords_usage(memory_tracker_);
+  coords_usage.set(shared_ptr_list_size(coords));
 
   // Sort and dedup the coordinates (not applicable to the global order
   // layout for a single fragment)
@@ -514,7 +576,10 @@ Status Query::sparse_read() {
   // Compute the maximal cell ranges
   OverlappingCellRangeList cell_ranges;
   RETURN_NOT_OK(compute_cell_ranges(coords, &cell_ranges));
+  ScopedMemoryUsage cell_ranges_usage(memory_tracker_);
+  cell_ranges_usage.set(shared_ptr_list_size(cell_ranges));
   coords.clear();
+  coords_usage.set(0);
 
   // Copy cells
   for (const auto& attr : attributes_)
@@ -556,6 +621,7 @@ Status Query::read_tiles(
   auto var_size = array_schema_->var_size(attr_id);
   std::vector<std::shared_ptr<TileIO>> tile_io;
   std::vector<std::shared_ptr<TileIO>> tile_io_var;
+  bool is_coords = (attr_id == array_schema_->attribute_num());
   for (const auto& f : fragment_metadata_) {
     tile_io.emplace_back(std::make_shared<TileIO>(
         storage_manager_, f->attr_uri(attr_id), f->file_sizes(attr_id)));
@@ -566,8 +632,16 @@ Status Query::read_tiles(
           f->file_var_sizes(attr_id)));
     else
       tile_io_var.emplace_back();
+
+    // The zstd dictionary applies to the values tiles of the attribute
+    if (!is_coords) {
+      auto& dictionary = f->zstd_dictionary(attr_id);
+      if (!dictionary.empty()) {
+        auto& dictionary_io = var_size ? tile_io_var.back() : tile_io.back();
+        dictionary_io->set_dictionary(&dictionary[0], dictionary.size());
+      }
+    }
   }
-  bool is_coords = (attr_id == array_schema_->attribute_num());
 
   // For each fragment, read the tiles
   for (auto& tile : *tiles) {
@@ -583,6 +657,8 @@ Status Query::read_tiles(
         (var_size) ? constants::cell_var_offset_size :
                      array_schema_->cell_size(attr_id),
         (is_coords) ? array_schema_->dim_num() : 0));
+    if (!var_size)
+      t->set_filters(array_schema_->filters(attr_id));
     RETURN_NOT_OK(tile_io[tile->fragment_idx_]->read(
         t.get(),
         fragment_metadata_[tile->fragment_idx_]->file_offset(
@@ -601,6 +677,7 @@ Status Query::read_tiles(
           array_schema_->compression(attr_id),
           datatype_size(array_schema_->type(attr_id)),
           0));
+      t_var->set_filters(array_schema_->filters(attr_id));
       RETURN_NOT_OK(tile_io_var[tile->fragment_idx_]->read(
           t_var.get(),
           fragment_metadata_[tile->fragment_idx_]->file_var_offset(
@@ -836,6 +913,13 @@ Status Query::copy_var_cells(
   uint64_t buffer_var_offset = 0;
   uint64_t offset_size = constants::cell_var_offset_size;
   uint64_t cell_var_size;
+  const unsigned char* value;
+
+  // Dictionary encoded values are looked up directly in the encoded tiles
+  bool dictionary = array_schema_->attribute(attr_id)->filters().contains(
+      FilterType::FILTER_DICTIONARY);
+  DictionaryEncoding encoding;
+  const Tile* encoding_tile = nullptr;
 
   // Copy cells
   for (const auto& cr : cell_ranges) {
@@ -843,9 +927,19 @@ Status Query::copy_var_cells(
     const auto& tile = tile_pair.first;
     const auto& tile_var = tile_pair.second;
     const auto offsets = (uint64_t*)tile->data();
-    auto data = (unsigned char*)tile_var->data();
+    auto data = (const unsigned char*)tile_var->data();
     auto cell_num = tile->cell_num();
     auto tile_var_size = tile_var->size();
+    bool encoded = false;
+    if (dictionary) {
+      if (encoding_tile != tile_var.get()) {
+        RETURN_NOT_OK(encoding.init(data, tile_var_size));
+        encoding_tile = tile_var.get();
+      }
+      encoded = !encoding.plain();
+      data = encoding.plain_data();
+      tile_var_size = encoding.plain_size();
+    }
 
     for (uint64_t i = cr->start_; i <= cr->end_; ++i) {
       // Copy offsets
@@ -857,19 +951,21 @@ Status Query::copy_var_cells(
       buffer_offset += offset_size;
 
       // Copy values
-      cell_var_size = (i != cell_num - 1) ?
-                          offsets[i + 1] - offsets[i] :
-                          tile_var_size - (offsets[i] - offsets[0]);
+      if (encoded) {
+        RETURN_NOT_OK(encoding.cell(i, &value, &cell_var_size));
+      } else {
+        cell_var_size = (i != cell_num - 1) ?
+                            offsets[i + 1] - offsets[i] :
+                            tile_var_size - (offsets[i] - offsets[0]);
+        value = &data[offsets[i] - offsets[0]];
+      }
 
       if (buffer_var_offset + cell_var_size > buffer_sizes_[bid + 1])
         return LOG_STATUS(Status::QueryError(
             std::string("Cannot copy cell data for var-sized attribute '") +
             attribute + "'; Result buffer overflowed"));
 
-      std::memcpy(
-          buffer_var + buffer_var_offset,
-          &data[offsets[i] - offsets[0]],
-          cell_var_size);
+      std::memcpy(buffer_var + buffer_var_offset, value, cell_var_size);
       buffer_var_offset += cell_var_size;
     }
   }
@@ -882,6 +978,8 @@ Status Query::copy_var_cells(
 }
 
 Status Query::read() {
+  ScopedMemoryTracker scoped_tracker(memory_tracker_);
+
   if (!array_schema_->dense())
     return sparse_read();
 
@@ -969,6 +1067,7 @@ Status Query::set_buffers(
   // Set attribute ids
   RETURN_NOT_OK(
       array_schema_->get_attribute_ids(attributes_vec, attribute_ids_));
+  RETURN_NOT_OK(array_schema_->buffer_num(attribute_ids_, &buffer_num_));
 
   // Set attribute names
   for (unsigned i = 0; i < attribute_num; ++i)
@@ -1021,12 +1120,19 @@ Status Query::set_layout(Layout layout) {
   return Status::Ok();
 }
 
+void Query::set_memory_tracker_parent(
+    const std::shared_ptr<MemoryTracker>& parent) {
+  memory_tracker_ = std::make_shared<MemoryTracker>(
+      parent, nullptr, &stats::all_stats.counter_memory_query_peak_bytes);
+}
+
 void Query::set_status(QueryStatus status) {
   status_ = status;
 }
 
 void Query::set_storage_manager(StorageManager* storage_manager) {
   storage_manager_ = storage_manager;
+  set_memory_tracker_parent(storage_manager->memory_tracker());
 }
 
 Status Query::set_subarray(const void* subarray) {
@@ -1070,6 +1176,8 @@ QueryType Query::type() const {
 }
 
 Status Query::write() {
+  ScopedMemoryTracker scoped_tracker(memory_tracker_);
+
   // Check attributes
   RETURN_NOT_OK(check_attributes());
 
@@ -1079,6 +1187,8 @@ Status Query::write() {
   // Write based on mode
   if (layout_ == Layout::COL_MAJOR || layout_ == Layout::ROW_MAJOR) {
     RETURN_NOT_OK(array_ordered_write_state_->write(buffers_, buffer_sizes_));
+  } else if (array_unordered_write_state_ != nullptr) {
+    RETURN_NOT_OK(array_unordered_write_state_->write(buffers_, buffer_sizes_));
   } else if (layout_ == Layout::GLOBAL_ORDER || layout_ == Layout::UNORDERED) {
     RETURN_NOT_OK(write(buffers_, buffer_sizes_));
   } else {
@@ -1247,6 +1357,54 @@ Status Query::check_subarray(const T* subarray) const {
   return Status::Ok();
 }
 
+Status Query::compute_memory_estimate(uint64_t* nbytes) const {
+  *nbytes = 0;
+
+  // Writes create tiles out of the input buffers, and out-of-core writes
+  // also hold a run and the merged cells within their budget
+  if (type_ == QueryType::WRITE) {
+    for (unsigned i = 0; i < buffer_num_; ++i)
+      *nbytes += buffer_sizes_[i];
+    if (external_sort())
+      *nbytes += storage_manager_->config().sm_params().external_sort_memory_;
+    return Status::Ok();
+  }
+
+  if (fragment_metadata_.empty())
+    return Status::Ok();
+
+  // The result cannot be larger than the buffers
+  std::vector<uint64_t> max_buffer_sizes(buffer_num_);
+  RETURN_NOT_OK(storage_manager_->array_compute_max_read_buffer_sizes(
+      array_schema_,
+      fragment_metadata_,
+      subarray_,
+      attribute_ids_,
+      &max_buffer_sizes[0],
+      buffer_num_));
+  for (unsigned i = 0; i < buffer_num_; ++i)
+    *nbytes += std::min(max_buffer_sizes[i], buffer_sizes_[i]);
+
+  // One tile per attribute and fragment is in memory while copying cells
+  auto cell_num_per_tile = array_schema_->dense() ?
+                               array_schema_->domain()->cell_num_per_tile() :
+                               array_schema_->capacity();
+  for (auto aid : attribute_ids_) {
+    auto cell_size = array_schema_->var_size(aid) ?
+                         constants::cell_var_offset_size :
+                         array_schema_->cell_size(aid);
+    *nbytes += fragment_metadata_.size() * cell_num_per_tile * cell_size;
+  }
+
+  return Status::Ok();
+}
+
+bool Query::external_sort() const {
+  return type_ == QueryType::WRITE && layout_ == Layout::UNORDERED &&
+         !array_schema_->dense() &&
+         storage_manager_->config().sm_params().external_sort_memory_ != 0;
+}
+
 Status Query::init_fragments(
     const std::vector<FragmentMetadata*>& fragment_metadata) {
   // Do nothing if the fragments are already initialized
@@ -1254,7 +1412,9 @@ Status Query::init_fragments(
     return Status::Ok();
 
   if (type_ == QueryType::WRITE) {
-    RETURN_NOT_OK(new_fragment());
+    // Out-of-core unordered writes create their fragment upon finalization
+    if (!external_sort())
+      RETURN_NOT_OK(new_fragment());
   } else if (type_ == QueryType::READ) {
     RETURN_NOT_OK(open_fragments(fragment_metadata));
   }
@@ -1275,6 +1435,15 @@ Status Query::init_states() {
       array_ordered_write_state_ = nullptr;
       return st;
     }
+  } else if (external_sort() && array_unordered_write_state_ == nullptr) {
+    // The state persists across the submissions of the query
+    array_unordered_write_state_ = new ArrayUnorderedWriteState(this);
+    Status st = array_unordered_write_state_->init();
+    if (!st.ok()) {
+      delete array_unordered_write_state_;
+      array_unordered_write_state_ = nullptr;
+      return st;
+    }
   } else if (type_ == QueryType::READ && layout_ == Layout::GLOBAL_ORDER) {
     array_read_state_ = new ArrayReadState(this);
   } else if (
@@ -1334,6 +1503,14 @@ Status Query::open_fragments(const std::vector<FragmentMetadata*>& metadata) {
   return Status::Ok();
 }
 
+void Query::release_memory_reservation() {
+  if (memory_reservation_ == 0)
+    return;
+
+  storage_manager_->memory_budget_release(memory_reservation_);
+  memory_reservation_ = 0;
+}
+
 Status Query::set_attributes(
     const char** attributes, unsigned int attribute_num) {
   // Get attributes
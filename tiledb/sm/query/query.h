@@ -36,10 +36,12 @@
 #include "tiledb/sm/enums/query_status.h"
 #include "tiledb/sm/enums/query_type.h"
 #include "tiledb/sm/fragment/fragment.h"
+#include "tiledb/sm/misc/memory_tracker.h"
 #include "tiledb/sm/misc/status.h"
 #include "tiledb/sm/query/array_ordered_read_state.h"
 #include "tiledb/sm/query/array_ordered_write_state.h"
 #include "tiledb/sm/query/array_read_state.h"
+#include "tiledb/sm/query/array_unordered_write_state.h"
 #include "tiledb/sm/storage_manager/storage_manager.h"
 
 #include <functional>
@@ -53,6 +55,7 @@ namespace sm {
 class ArrayReadState;
 class ArrayOrderedReadState;
 class ArrayOrderedWriteState;
+class ArrayUnorderedWriteState;
 class Fragment;
 class StorageManager;
 
@@ -326,6 +329,12 @@ class Query {
   /** Retrieves the index of the buffer corresponding to the input attribute. */
   Status buffer_idx(const std::string& attribute, unsigned* bid) const;
 
+  /** Returns the buffer sizes of the query. */
+  uint64_t* buffer_sizes() const;
+
+  /** Returns the buffers of the query. */
+  void** buffers() const;
+
   /** Finalizes and deletes the created fragments. */
   Status clear_fragments();
 
@@ -454,6 +463,12 @@ class Query {
   /** Returns the cell layout. */
   Layout layout() const;
 
+  /**
+   * Returns the tracker of the memory allocated on behalf of the query.
+   * Its peak is reported in the `memory_query_peak_bytes` statistic.
+   */
+  const std::shared_ptr<MemoryTracker>& memory_tracker() const;
+
   /**
    * Returns true if the query cannot write to some buffer due to
    * an overflow.
@@ -541,6 +556,13 @@ class Query {
    */
   Status set_layout(Layout layout);
 
+  /**
+   * Replaces the memory tracker of the query with a new one that is a child
+   * of `parent`. This is used to attribute the memory of internal queries
+   * (e.g., those of ordered reads and writes) to the user query.
+   */
+  void set_memory_tracker_parent(const std::shared_ptr<MemoryTracker>& parent);
+
   /** Sets the query status. */
   void set_status(QueryStatus status);
 
@@ -612,6 +634,13 @@ class Query {
    */
   ArrayOrderedWriteState* array_ordered_write_state_;
 
+  /**
+   * The array unordered write state. It handles unordered write queries
+   * on sparse arrays that are sorted out of core, as configured by
+   * `sm.external_sort_memory`.
+   */
+  ArrayUnorderedWriteState* array_unordered_write_state_;
+
   /** The ids of the attributes involved in the query. */
   std::vector<unsigned int> attribute_ids_;
 
@@ -663,6 +692,15 @@ class Query {
   /** The cell layout. */
   Layout layout_;
 
+  /**
+   * The number of bytes of the storage manager memory budget reserved by
+   * the query upon initialization.
+   */
+  uint64_t memory_reservation_;
+
+  /** Tracks the memory allocated on behalf of the query. */
+  std::shared_ptr<MemoryTracker> memory_tracker_;
+
   /** The storage manager. */
   StorageManager* storage_manager_;
 
@@ -700,6 +738,24 @@ class Query {
   template <class T>
   Status check_subarray(const T* subarray) const;
 
+  /**
+   * Estimates the memory the query needs in order to be processed. For
+   * reads, this is the upper bound on the result size computed by
+   * `array_compute_max_read_buffer_sizes` (capped by the buffer sizes),
+   * plus one tile per attribute and fragment. For writes, it is the size
+   * of the input buffers.
+   *
+   * @param nbytes The estimated number of bytes.
+   * @return Status
+   */
+  Status compute_memory_estimate(uint64_t* nbytes) const;
+
+  /**
+   * Returns `true` if this is an unordered write to a sparse array whose
+   * cells are sorted out of core across all its submissions.
+   */
+  bool external_sort() const;
+
   /** Initializes the fragments (for a read query). */
   Status init_fragments(
       const std::vector<FragmentMetadata*>& fragment_metadata);
@@ -732,6 +788,9 @@ class Query {
    */
   Status open_fragments(const std::vector<FragmentMetadata*>& metadata);
 
+  /** Releases the memory budget reserved by the query (if any). */
+  void release_memory_reservation();
+
   /** Sets the query attributes. */
   Status set_attributes(const char** attributes, unsigned int attribute_num);
 
@@ -158,6 +158,50 @@ Status Config::set(const std::string& param, const std::string& value) {
     RETURN_NOT_OK(set_sm_array_schema_cache_size(value));
   } else if (param == "sm.fragment_metadata_cache_size") {
     RETURN_NOT_OK(set_sm_fragment_metadata_cache_size(value));
+  } else if (param == "sm.buffer_pool_size") {
+    RETURN_NOT_OK(set_sm_buffer_pool_size(value));
+  } else if (param == "sm.memory_budget") {
+    RETURN_NOT_OK(set_sm_memory_budget(value));
+  } else if (param == "sm.memory_budget_timeout_ms") {
+    RETURN_NOT_OK(set_sm_memory_budget_timeout_ms(value));
+  } else if (param == "sm.auto_compression_objective") {
+    RETURN_NOT_OK(set_sm_auto_compression_objective(value));
+  } else if (param == "sm.zstd_dictionary_size") {
+    RETURN_NOT_OK(set_sm_zstd_dictionary_size(value));
+  } else if (param == "sm.num_compute_threads") {
+    RETURN_NOT_OK(set_sm_num_compute_threads(value));
+  } else if (param == "sm.tile_slab_num") {
+    RETURN_NOT_OK(set_sm_tile_slab_num(value));
+  } else if (param == "sm.write_buffer_size") {
+    RETURN_NOT_OK(set_sm_write_buffer_size(value));
+  } else if (param == "sm.write_buffer_flush_ms") {
+    RETURN_NOT_OK(set_sm_write_buffer_flush_ms(value));
+  } else if (param == "sm.consolidation_policy") {
+    RETURN_NOT_OK(set_sm_consolidation_policy(value));
+  } else if (param == "sm.consolidation_min_fragments") {
+    RETURN_NOT_OK(set_sm_consolidation_min_fragments(value));
+  } else if (param == "sm.consolidation_max_fragments") {
+    RETURN_NOT_OK(set_sm_consolidation_max_fragments(value));
+  } else if (param == "sm.consolidation_size_ratio") {
+    RETURN_NOT_OK(set_sm_consolidation_size_ratio(value));
+  } else if (param == "sm.consolidation_memory_budget") {
+    RETURN_NOT_OK(set_sm_consolidation_memory_budget(value));
+  } else if (param == "sm.consolidation_threads") {
+    RETURN_NOT_OK(set_sm_consolidation_threads(value));
+  } else if (param == "sm.auto_consolidation_interval_ms") {
+    RETURN_NOT_OK(set_sm_auto_consolidation_interval_ms(value));
+  } else if (param == "sm.auto_consolidation_fragment_num") {
+    RETURN_NOT_OK(set_sm_auto_consolidation_fragment_num(value));
+  } else if (param == "sm.auto_consolidation_small_fragment_size") {
+    RETURN_NOT_OK(set_sm_auto_consolidation_small_fragment_size(value));
+  } else if (param == "sm.auto_consolidation_read_amplification") {
+    RETURN_NOT_OK(set_sm_auto_consolidation_read_amplification(value));
+  } else if (param == "sm.auto_consolidation_io_budget") {
+    RETURN_NOT_OK(set_sm_auto_consolidation_io_budget(value));
+  } else if (param == "sm.external_sort_memory") {
+    RETURN_NOT_OK(set_sm_external_sort_memory(value));
+  } else if (param == "sm.external_sort_scratch_dir") {
+    RETURN_NOT_OK(set_sm_external_sort_scratch_dir(value));
   } else if (param == "vfs.max_parallel_ops") {
     RETURN_NOT_OK(set_vfs_max_parallel_ops(value));
   } else if (param == "vfs.min_parallel_size") {
@@ -233,6 +277,125 @@ Status Config::unset(const std::string& param) {
     value << sm_params_.fragment_metadata_cache_size_;
     param_values_["sm.fragment_metadata_cache_size"] = value.str();
     value.str(std::string());
+  } else if (param == "sm.buffer_pool_size") {
+    sm_params_.buffer_pool_size_ = constants::buffer_pool_size;
+    value << sm_params_.buffer_pool_size_;
+    param_values_["sm.buffer_pool_size"] = value.str();
+    value.str(std::string());
+  } else if (param == "sm.memory_budget") {
+    sm_params_.memory_budget_ = constants::memory_budget;
+    value << sm_params_.memory_budget_;
+    param_values_["sm.memory_budget"] = value.str();
+    value.str(std::string());
+  } else if (param == "sm.memory_budget_timeout_ms") {
+    sm_params_.memory_budget_timeout_ms_ = constants::memory_budget_timeout_ms;
+    value << sm_params_.memory_budget_timeout_ms_;
+    param_values_["sm.memory_budget_timeout_ms"] = value.str();
+    value.str(std::string());
+  } else if (param == "sm.auto_compression_objective") {
+    sm_params_.auto_compression_objective_ =
+        constants::auto_compression_objective;
+    value << sm_params_.auto_compression_objective_;
+    param_values_["sm.auto_compression_objective"] = value.str();
+    value.str(std::string());
+  } else if (param == "sm.zstd_dictionary_size") {
+    sm_params_.zstd_dictionary_size_ = constants::zstd_dictionary_size;
+    value << sm_params_.zstd_dictionary_size_;
+    param_values_["sm.zstd_dictionary_size"] = value.str();
+    value.str(std::string());
+  } else if (param == "sm.num_compute_threads") {
+    sm_params_.num_compute_threads_ = constants::num_compute_threads;
+    value << sm_params_.num_compute_threads_;
+    param_values_["sm.num_compute_threads"] = value.str();
+    value.str(std::string());
+  } else if (param == "sm.tile_slab_num") {
+    sm_params_.tile_slab_num_ = constants::tile_slab_num;
+    value << sm_params_.tile_slab_num_;
+    param_values_["sm.tile_slab_num"] = value.str();
+    value.str(std::string());
+  } else if (param == "sm.write_buffer_size") {
+    sm_params_.write_buffer_size_ = constants::write_buffer_size;
+    value << sm_params_.write_buffer_size_;
+    param_values_["sm.write_buffer_size"] = value.str();
+    value.str(std::string());
+  } else if (param == "sm.write_buffer_flush_ms") {
+    sm_params_.write_buffer_flush_ms_ = constants::write_buffer_flush_ms;
+    value << sm_params_.write_buffer_flush_ms_;
+    param_values_["sm.write_buffer_flush_ms"] = value.str();
+    value.str(std::string());
+  } else if (param == "sm.consolidation_policy") {
+    sm_params_.consolidation_policy_ = constants::consolidation_policy;
+    value << sm_params_.consolidation_policy_;
+    param_values_["sm.consolidation_policy"] = value.str();
+    value.str(std::string());
+  } else if (param == "sm.consolidation_min_fragments") {
+    sm_params_.consolidation_min_fragments_ =
+        constants::consolidation_min_fragments;
+    value << sm_params_.consolidation_min_fragments_;
+    param_values_["sm.consolidation_min_fragments"] = value.str();
+    value.str(std::string());
+  } else if (param == "sm.consolidation_max_fragments") {
+    sm_params_.consolidation_max_fragments_ =
+        constants::consolidation_max_fragments;
+    value << sm_params_.consolidation_max_fragments_;
+    param_values_["sm.consolidation_max_fragments"] = value.str();
+    value.str(std::string());
+  } else if (param == "sm.consolidation_size_ratio") {
+    sm_params_.consolidation_size_ratio_ = constants::consolidation_size_ratio;
+    value << sm_params_.consolidation_size_ratio_;
+    param_values_["sm.consolidation_size_ratio"] = value.str();
+    value.str(std::string());
+  } else if (param == "sm.consolidation_memory_budget") {
+    sm_params_.consolidation_memory_budget_ =
+        constants::consolidation_memory_budget;
+    value << sm_params_.consolidation_memory_budget_;
+    param_values_["sm.consolidation_memory_budget"] = value.str();
+    value.str(std::string());
+  } else if (param == "sm.consolidation_threads") {
+    sm_params_.consolidation_threads_ = constants::consolidation_threads;
+    value << sm_params_.consolidation_threads_;
+    param_values_["sm.consolidation_threads"] = value.str();
+    value.str(std::string());
+  } else if (param == "sm.auto_consolidation_interval_ms") {
+    sm_params_.auto_consolidation_interval_ms_ =
+        constants::auto_consolidation_interval_ms;
+    value << sm_params_.auto_consolidation_interval_ms_;
+    param_values_["sm.auto_consolidation_interval_ms"] = value.str();
+    value.str(std::string());
+  } else if (param == "sm.auto_consolidation_fragment_num") {
+    sm_params_.auto_consolidation_fragment_num_ =
+        constants::auto_consolidation_fragment_num;
+    value << sm_params_.auto_consolidation_fragment_num_;
+    param_values_["sm.auto_consolidation_fragment_num"] = value.str();
+    value.str(std::string());
+  } else if (param == "sm.auto_consolidation_small_fragment_size") {
+    sm_params_.auto_consolidation_small_fragment_size_ =
+        constants::auto_consolidation_small_fragment_size;
+    value << sm_params_.auto_consolidation_small_fragment_size_;
+    param_values_["sm.auto_consolidation_small_fragment_size"] = value.str();
+    value.str(std::string());
+  } else if (param == "sm.auto_consolidation_read_amplification") {
+    sm_params_.auto_consolidation_read_amplification_ =
+        constants::auto_consolidation_read_amplification;
+    value << sm_params_.auto_consolidation_read_amplification_;
+    param_values_["sm.auto_consolidation_read_amplification"] = value.str();
+    value.str(std::string());
+  } else if (param == "sm.auto_consolidation_io_budget") {
+    sm_params_.auto_consolidation_io_budget_ =
+        constants::auto_consolidation_io_budget;
+    value << sm_params_.auto_consolidation_io_budget_;
+    param_values_["sm.auto_consolidation_io_budget"] = value.str();
+    value.str(std::string());
+  } else if (param == "sm.external_sort_memory") {
+    sm_params_.external_sort_memory_ = constants::external_sort_memory;
+    value << sm_params_.external_sort_memory_;
+    param_values_["sm.external_sort_memory"] = value.str();
+    value.str(std::string());
+  } else if (param == "sm.external_sort_scratch_dir") {
+    sm_params_.external_sort_scratch_dir_ =
+        constants::external_sort_scratch_dir;
+    param_values_["sm.external_sort_scratch_dir"] =
+        sm_params_.external_sort_scratch_dir_;
   } else if (param == "vfs.max_parallel_ops") {
     vfs_params_.max_parallel_ops_ = constants::vfs_max_parallel_ops;
     value << vfs_params_.max_parallel_ops_;
@@ -335,6 +498,93 @@ void Config::set_default_param_values() {
   param_values_["sm.fragment_metadata_cache_size"] = value.str();
   value.str(std::string());
 
+  value << sm_params_.buffer_pool_size_;
+  param_values_["sm.buffer_pool_size"] = value.str();
+  value.str(std::string());
+
+  value << sm_params_.memory_budget_;
+  param_values_["sm.memory_budget"] = value.str();
+  value.str(std::string());
+
+  value << sm_params_.memory_budget_timeout_ms_;
+  param_values_["sm.memory_budget_timeout_ms"] = value.str();
+  value.str(std::string());
+
+  value << sm_params_.auto_compression_objective_;
+  param_values_["sm.auto_compression_objective"] = value.str();
+  value.str(std::string());
+
+  value << sm_params_.zstd_dictionary_size_;
+  param_values_["sm.zstd_dictionary_size"] = value.str();
+  value.str(std::string());
+
+  value << sm_params_.num_compute_threads_;
+  param_values_["sm.num_compute_threads"] = value.str();
+  value.str(std::string());
+
+  value << sm_params_.tile_slab_num_;
+  param_values_["sm.tile_slab_num"] = value.str();
+  value.str(std::string());
+
+  value << sm_params_.write_buffer_size_;
+  param_values_["sm.write_buffer_size"] = value.str();
+  value.str(std::string());
+
+  value << sm_params_.write_buffer_flush_ms_;
+  param_values_["sm.write_buffer_flush_ms"] = value.str();
+  value.str(std::string());
+
+  value << sm_params_.consolidation_policy_;
+  param_values_["sm.consolidation_policy"] = value.str();
+  value.str(std::string());
+
+  value << sm_params_.consolidation_min_fragments_;
+  param_values_["sm.consolidation_min_fragments"] = value.str();
+  value.str(std::string());
+
+  value << sm_params_.consolidation_max_fragments_;
+  param_values_["sm.consolidation_max_fragments"] = value.str();
+  value.str(std::string());
+
+  value << sm_params_.consolidation_size_ratio_;
+  param_values_["sm.consolidation_size_ratio"] = value.str();
+  value.str(std::string());
+
+  value << sm_params_.consolidation_memory_budget_;
+  param_values_["sm.consolidation_memory_budget"] = value.str();
+  value.str(std::string());
+
+  value << sm_params_.consolidation_threads_;
+  param_values_["sm.consolidation_threads"] = value.str();
+  value.str(std::string());
+
+  value << sm_params_.auto_consolidation_interval_ms_;
+  param_values_["sm.auto_consolidation_interval_ms"] = value.str();
+  value.str(std::string());
+
+  value << sm_params_.auto_consolidation_fragment_num_;
+  param_values_["sm.auto_consolidation_fragment_num"] = value.str();
+  value.str(std::string());
+
+  value << sm_params_.auto_consolidation_small_fragment_size_;
+  param_values_["sm.auto_consolidation_small_fragment_size"] = value.str();
+  value.str(std::string());
+
+  value << sm_params_.auto_consolidation_read_amplification_;
+  param_values_["sm.auto_consolidation_read_amplification"] = value.str();
+  value.str(std::string());
+
+  value << sm_params_.auto_consolidation_io_budget_;
+  param_values_["sm.auto_consolidation_io_budget"] = value.str();
+  value.str(std::string());
+
+  value << sm_params_.external_sort_memory_;
+  param_values_["sm.external_sort_memory"] = value.str();
+  value.str(std::string());
+
+  param_values_["sm.external_sort_scratch_dir"] =
+      sm_params_.external_sort_scratch_dir_;
+
   value << vfs_params_.max_parallel_ops_;
   param_values_["vfs.max_parallel_ops"] = value.str();
   value.str(std::string());
@@ -401,6 +651,141 @@ Status Config::set_sm_array_schema_cache_size(const std::string& value) {
   return Status::Ok();
 }
 
+Status Config::set_sm_auto_compression_objective(const std::string& value) {
+  if (value != "ratio" && value != "balanced" && value != "speed")
+    return LOG_STATUS(Status::ConfigError(
+        "Cannot set parameter; Invalid AUTO compression objective"));
+  sm_params_.auto_compression_objective_ = value;
+  return Status::Ok();
+}
+
+Status Config::set_sm_auto_consolidation_fragment_num(
+    const std::string& value) {
+  uint64_t v;
+  RETURN_NOT_OK(utils::parse::convert(value, &v));
+  sm_params_.auto_consolidation_fragment_num_ = v;
+
+  return Status::Ok();
+}
+
+Status Config::set_sm_auto_consolidation_interval_ms(const std::string& value) {
+  uint64_t v;
+  RETURN_NOT_OK(utils::parse::convert(value, &v));
+  sm_params_.auto_consolidation_interval_ms_ = v;
+
+  return Status::Ok();
+}
+
+Status Config::set_sm_auto_consolidation_io_budget(const std::string& value) {
+  uint64_t v;
+  RETURN_NOT_OK(utils::parse::convert(value, &v));
+  sm_params_.auto_consolidation_io_budget_ = v;
+
+  return Status::Ok();
+}
+
+Status Config::set_sm_auto_consolidation_read_amplification(
+    const std::string& value) {
+  uint64_t v;
+  RETURN_NOT_OK(utils::parse::convert(value, &v));
+  sm_params_.auto_consolidation_read_amplification_ = v;
+
+  return Status::Ok();
+}
+
+Status Config::set_sm_auto_consolidation_small_fragment_size(
+    const std::string& value) {
+  uint64_t v;
+  RETURN_NOT_OK(utils::parse::convert(value, &v));
+  sm_params_.auto_consolidation_small_fragment_size_ = v;
+
+  return Status::Ok();
+}
+
+Status Config::set_sm_buffer_pool_size(const std::string& value) {
+  uint64_t v;
+  RETURN_NOT_OK(utils::parse::convert(value, &v));
+  sm_params_.buffer_pool_size_ = v;
+
+  return Status::Ok();
+}
+
+Status Config::set_sm_consolidation_max_fragments(const std::string& value) {
+  uint64_t v;
+  RETURN_NOT_OK(utils::parse::convert(value, &v));
+  if (v < 2)
+    return LOG_STATUS(Status::ConfigError(
+        "Cannot set parameter; Consolidation must merge at least 2 fragments"));
+  sm_params_.consolidation_max_fragments_ = v;
+
+  return Status::Ok();
+}
+
+Status Config::set_sm_consolidation_memory_budget(const std::string& value) {
+  uint64_t v;
+  RETURN_NOT_OK(utils::parse::convert(value, &v));
+  if (v == 0)
+    return LOG_STATUS(Status::ConfigError(
+        "Cannot set parameter; Consolidation memory budget must be non-zero"));
+  sm_params_.consolidation_memory_budget_ = v;
+
+  return Status::Ok();
+}
+
+Status Config::set_sm_consolidation_min_fragments(const std::string& value) {
+  uint64_t v;
+  RETURN_NOT_OK(utils::parse::convert(value, &v));
+  if (v < 2)
+    return LOG_STATUS(Status::ConfigError(
+        "Cannot set parameter; Consolidation must merge at least 2 fragments"));
+  sm_params_.consolidation_min_fragments_ = v;
+
+  return Status::Ok();
+}
+
+Status Config::set_sm_consolidation_policy(const std::string& value) {
+  if (value != "full" && value != "tiered")
+    return LOG_STATUS(Status::ConfigError(
+        "Cannot set parameter; Invalid consolidation policy"));
+  sm_params_.consolidation_policy_ = value;
+  return Status::Ok();
+}
+
+Status Config::set_sm_consolidation_size_ratio(const std::string& value) {
+  uint64_t v;
+  RETURN_NOT_OK(utils::parse::convert(value, &v));
+  if (v < 1)
+    return LOG_STATUS(Status::ConfigError(
+        "Cannot set parameter; Consolidation size ratio must be at least 1"));
+  sm_params_.consolidation_size_ratio_ = v;
+
+  return Status::Ok();
+}
+
+Status Config::set_sm_consolidation_threads(const std::string& value) {
+  uint64_t v;
+  RETURN_NOT_OK(utils::parse::convert(value, &v));
+  if (v == 0)
+    return LOG_STATUS(Status::ConfigError(
+        "Cannot set parameter; Consolidation threads must be non-zero"));
+  sm_params_.consolidation_threads_ = v;
+
+  return Status::Ok();
+}
+
+Status Config::set_sm_external_sort_memory(const std::string& value) {
+  uint64_t v;
+  RETURN_NOT_OK(utils::parse::convert(value, &v));
+  sm_params_.external_sort_memory_ = v;
+
+  return Status::Ok();
+}
+
+Status Config::set_sm_external_sort_scratch_dir(const std::string& value) {
+  sm_params_.external_sort_scratch_dir_ = value;
+  return Status::Ok();
+}
+
 Status Config::set_sm_fragment_metadata_cache_size(const std::string& value) {
   uint64_t v;
   RETURN_NOT_OK(utils::parse::convert(value, &v));
@@ -409,6 +794,34 @@ Status Config::set_sm_fragment_metadata_cache_size(const std::string& value) {
   return Status::Ok();
 }
 
+Status Config::set_sm_memory_budget(const std::string& value) {
+  uint64_t v;
+  RETURN_NOT_OK(utils::parse::convert(value, &v));
+  sm_params_.memory_budget_ = v;
+
+  return Status::Ok();
+}
+
+Status Config::set_sm_memory_budget_timeout_ms(const std::string& value) {
+  uint64_t v;
+  RETURN_NOT_OK(utils::parse::convert(value, &v));
+  sm_params_.memory_budget_timeout_ms_ = v;
+
+  return Status::Ok();
+}
+
+Status Config::set_sm_num_compute_threads(const std::string& value) {
+  uint64_t v;
+  RETURN_NOT_OK(utils::parse::convert(value, &v));
+  if (v == 0)
+    return LOG_STATUS(Status::ConfigError(
+        "Cannot set parameter; The number of compute threads must be "
+        "positive"));
+  sm_params_.num_compute_threads_ = v;
+
+  return Status::Ok();
+}
+
 Status Config::set_sm_tile_cache_size(const std::string& value) {
   uint64_t v;
   RETURN_NOT_OK(utils::parse::convert(value, &v));
@@ -417,6 +830,41 @@ Status Config::set_sm_tile_cache_size(const std::string& value) {
   return Status::Ok();
 }
 
+Status Config::set_sm_tile_slab_num(const std::string& value) {
+  uint64_t v;
+  RETURN_NOT_OK(utils::parse::convert(value, &v));
+  if (v < 2)
+    return LOG_STATUS(Status::ConfigError(
+        "Cannot set parameter; The number of tile slabs must be at least 2"));
+  sm_params_.tile_slab_num_ = v;
+
+  return Status::Ok();
+}
+
+Status Config::set_sm_write_buffer_flush_ms(const std::string& value) {
+  uint64_t v;
+  RETURN_NOT_OK(utils::parse::convert(value, &v));
+  sm_params_.write_buffer_flush_ms_ = v;
+
+  return Status::Ok();
+}
+
+Status Config::set_sm_write_buffer_size(const std::string& value) {
+  uint64_t v;
+  RETURN_NOT_OK(utils::parse::convert(value, &v));
+  sm_params_.write_buffer_size_ = v;
+
+  return Status::Ok();
+}
+
+Status Config::set_sm_zstd_dictionary_size(const std::string& value) {
+  uint64_t v;
+  RETURN_NOT_OK(utils::parse::convert(value, &v));
+  sm_params_.zstd_dictionary_size_ = v;
+
+  return Status::Ok();
+}
+
 Status Config::set_vfs_max_parallel_ops(const std::string& value) {
   uint64_t v;
   RETURN_NOT_OK(utils::parse::convert(value, &v));
@@ -52,13 +52,61 @@ class Config {
   /** Storage manager parameters. */
   struct SMParams {
     uint64_t array_schema_cache_size_;
+    std::string auto_compression_objective_;
+    uint64_t auto_consolidation_fragment_num_;
+    uint64_t auto_consolidation_interval_ms_;
+    uint64_t auto_consolidation_io_budget_;
+    uint64_t auto_consolidation_read_amplification_;
+    uint64_t auto_consolidation_small_fragment_size_;
+    uint64_t buffer_pool_size_;
+    uint64_t consolidation_max_fragments_;
+    uint64_t consolidation_memory_budget_;
+    uint64_t consolidation_min_fragments_;
+    std::string consolidation_policy_;
+    uint64_t consolidation_size_ratio_;
+    uint64_t consolidation_threads_;
+    uint64_t external_sort_memory_;
+    std::string external_sort_scratch_dir_;
     uint64_t fragment_metadata_cache_size_;
+    uint64_t memory_budget_;
+    uint64_t memory_budget_timeout_ms_;
+    uint64_t num_compute_threads_;
     uint64_t tile_cache_size_;
+    uint64_t tile_slab_num_;
+    uint64_t write_buffer_flush_ms_;
+    uint64_t write_buffer_size_;
+    uint64_t zstd_dictionary_size_;
 
     SMParams() {
       array_schema_cache_size_ = constants::array_schema_cache_size;
+      auto_compression_objective_ = constants::auto_compression_objective;
+      auto_consolidation_fragment_num_ =
+          constants::auto_consolidation_fragment_num;
+      auto_consolidation_interval_ms_ =
+          constants::auto_consolidation_interval_ms;
+      auto_consolidation_io_budget_ = constants::auto_consolidation_io_budget;
+      auto_consolidation_read_amplification_ =
+          constants::auto_consolidation_read_amplification;
+      auto_consolidation_small_fragment_size_ =
+          constants::auto_consolidation_small_fragment_size;
+      buffer_pool_size_ = constants::buffer_pool_size;
+      consolidation_max_fragments_ = constants::consolidation_max_fragments;
+      consolidation_memory_budget_ = constants::consolidation_memory_budget;
+      consolidation_min_fragments_ = constants::consolidation_min_fragments;
+      consolidation_policy_ = constants::consolidation_policy;
+      consolidation_size_ratio_ = constants::consolidation_size_ratio;
+      consolidation_threads_ = constants::consolidation_threads;
+      external_sort_memory_ = constants::external_sort_memory;
+      external_sort_scratch_dir_ = constants::external_sort_scratch_dir;
       fragment_metadata_cache_size_ = constants::fragment_metadata_cache_size;
+      memory_budget_ = constants::memory_budget;
+      memory_budget_timeout_ms_ = constants::memory_budget_timeout_ms;
+      num_compute_threads_ = constants::num_compute_threads;
       tile_cache_size_ = constants::tile_cache_size;
+      tile_slab_num_ = constants::tile_slab_num;
+      write_buffer_flush_ms_ = constants::write_buffer_flush_ms;
+      write_buffer_size_ = constants::write_buffer_size;
+      zstd_dictionary_size_ = constants::zstd_dictionary_size;
     }
   };
 
@@ -157,6 +205,33 @@ class Config {
    *    The fragment metadata cache size in bytes. Any `uint64_t` value is
    *    acceptable. <br>
    *    **Default**: 10,000,000
+   * - `sm.buffer_pool_size` <br>
+   *    The maximum number of bytes of freed tile and scratch buffers cached
+   *    for reuse by later allocations. `0` disables the buffer pool. <br>
+   *    **Default**: 100,000,000
+   * - `sm.memory_budget` <br>
+   *    The maximum number of bytes the queries of a context may reserve at
+   *    the same time, based on an estimate computed at query initialization.
+   *    `0` means unlimited. <br>
+   *    **Default**: 0
+   * - `sm.memory_budget_timeout_ms` <br>
+   *    How long (in ms) a query waits for memory budget to be released by
+   *    other queries before its initialization fails. `0` means that it
+   *    fails immediately. <br>
+   *    **Default**: 0
+   * - `sm.auto_compression_objective` <br>
+   *    What the `AUTO` compressor favors when it selects the compressor of
+   *    a tile: `ratio` (the smallest tile), `speed` (the fastest compressor
+   *    to decompress within 50% of the smallest tile) or `balanced` (the
+   *    fastest to decompress within 10% of the smallest tile). <br>
+   *    **Default**: balanced
+   * - `sm.zstd_dictionary_size` <br>
+   *    The maximum size in bytes of the zstd dictionary trained for each
+   *    `ZSTD` compressed attribute when a fragment is written or
+   *    consolidated. The dictionary is trained on samples of the first cells
+   *    written and stored in the fragment metadata, so that small tiles
+   *    compress almost as well as large ones. `0` disables dictionaries. <br>
+   *    **Default**: 0
    * - `vfs.max_parallel_ops` <br>
    *    The maximum number of VFS parallel operations.<br>
    *    **Default**: number of cores
@@ -257,12 +332,85 @@ class Config {
   /** Sets the array metadata cache size, properly parsing the input value. */
   Status set_sm_array_schema_cache_size(const std::string& value);
 
+  /**
+   * Sets the objective of the AUTO compressor, properly checking the input
+   * value.
+   */
+  Status set_sm_auto_compression_objective(const std::string& value);
+
+  /** Sets the number of fragments that triggers an auto-consolidation. */
+  Status set_sm_auto_consolidation_fragment_num(const std::string& value);
+
+  /** Sets the period of the auto-consolidation. */
+  Status set_sm_auto_consolidation_interval_ms(const std::string& value);
+
+  /** Sets the I/O budget of the auto-consolidation. */
+  Status set_sm_auto_consolidation_io_budget(const std::string& value);
+
+  /** Sets the read amplification that triggers an auto-consolidation. */
+  Status set_sm_auto_consolidation_read_amplification(const std::string& value);
+
+  /** Sets the size under which a fragment counts as small. */
+  Status set_sm_auto_consolidation_small_fragment_size(
+      const std::string& value);
+
+  /** Sets the buffer pool size, properly parsing the input value. */
+  Status set_sm_buffer_pool_size(const std::string& value);
+
+  /** Sets the maximum number of fragments a tiered consolidation merges. */
+  Status set_sm_consolidation_max_fragments(const std::string& value);
+
+  /** Sets the memory budget of the buffers of a consolidation. */
+  Status set_sm_consolidation_memory_budget(const std::string& value);
+
+  /** Sets the minimum number of fragments a tiered consolidation merges. */
+  Status set_sm_consolidation_min_fragments(const std::string& value);
+
+  /** Sets the consolidation policy. */
+  Status set_sm_consolidation_policy(const std::string& value);
+
+  /** Sets the size ratio of the consolidation tiers. */
+  Status set_sm_consolidation_size_ratio(const std::string& value);
+
+  /** Sets the number of partitions a consolidation reads concurrently. */
+  Status set_sm_consolidation_threads(const std::string& value);
+
+  /** Sets the external sort memory budget, properly parsing the input value. */
+  Status set_sm_external_sort_memory(const std::string& value);
+
+  /** Sets the external sort scratch directory. */
+  Status set_sm_external_sort_scratch_dir(const std::string& value);
+
   /** Sets the fragment metadata cache size, properly parsing the input value.*/
   Status set_sm_fragment_metadata_cache_size(const std::string& value);
 
+  /** Sets the memory budget, properly parsing the input value. */
+  Status set_sm_memory_budget(const std::string& value);
+
+  /** Sets the memory budget timeout, properly parsing the input value. */
+  Status set_sm_memory_budget_timeout_ms(const std::string& value);
+
+  /**
+   * Sets the number of threads of the compute thread pool, properly parsing
+   * and checking the input value.
+   */
+  Status set_sm_num_compute_threads(const std::string& value);
+
   /** Sets the tile cache size, properly parsing the input value. */
   Status set_sm_tile_cache_size(const std::string& value);
 
+  /** Sets the number of pipelined tile slabs of ordered queries. */
+  Status set_sm_tile_slab_num(const std::string& value);
+
+  /** Sets the write buffer flush age, properly parsing the input value. */
+  Status set_sm_write_buffer_flush_ms(const std::string& value);
+
+  /** Sets the write buffer size, properly parsing the input value. */
+  Status set_sm_write_buffer_size(const std::string& value);
+
+  /** Sets the zstd dictionary size, properly parsing the input value. */
+  Status set_sm_zstd_dictionary_size(const std::string& value);
+
   /** Sets the max number of allowed VFS parallel operations. */
   Status set_vfs_max_parallel_ops(const std::string& value);
 
@@ -31,10 +31,16 @@
  */
 
 #include "tiledb/sm/storage_manager/consolidator.h"
+#include "tiledb/sm/fragment/fragment_metadata.h"
 #include "tiledb/sm/misc/logger.h"
+#include "tiledb/sm/misc/thread_pool.h"
 #include "tiledb/sm/misc/utils.h"
 #include "tiledb/sm/storage_manager/storage_manager.h"
+#include "tiledb/sm/tile/tile_io.h"
 
+#include <algorithm>
+#include <cstring>
+#include <limits>
 #include <sstream>
 
 /* ****************************** */
@@ -60,6 +66,7 @@ Consolidator::~Consolidator() = default;
 
 Status Consolidator::consolidate(const char* array_name) {
   std::vector<URI> old_fragment_uris;
+  std::vector<FragmentMetadata*> to_copy;
   URI new_fragment_uri;
   URI array_uri = URI(array_name);
 
@@ -67,12 +74,6 @@ Status Consolidator::consolidate(const char* array_name) {
   auto array_schema = (ArraySchema*)nullptr;
   RETURN_NOT_OK(storage_manager_->load_array_schema(array_uri, &array_schema));
 
-  // Create subarray
-  void* subarray = nullptr;
-  RETURN_NOT_OK_ELSE(
-      create_subarray(array_uri.to_string(), array_schema, &subarray),
-      delete array_schema);
-
   // Prepare buffers
   void** buffers;
   uint64_t* buffer_sizes;
@@ -82,26 +83,36 @@ Status Consolidator::consolidate(const char* array_name) {
       delete array_schema);
 
   // Create queries
+  void* subarray = nullptr;
   unsigned int fragment_num;
   auto query_r = new Query();
   auto query_w = new Query();
   Status st = create_queries(
       query_r,
       query_w,
-      subarray,
+      &subarray,
       array_name,
       buffers,
       buffer_sizes,
-      &fragment_num);
+      &fragment_num,
+      &new_fragment_uri,
+      &to_copy);
   if (!st.ok())
     goto clean_up;
 
   // Check number of fragments
-  if (fragment_num <= 1)  // Nothing to consolidate
+  if (fragment_num <= 1) {  // Nothing to consolidate, close the array
+    st = storage_manager_->query_finalize(query_r);
     goto clean_up;
+  }
 
-  // Read from one array and write to the other
-  st = copy_array(subarray, query_r, query_w);
+  // Read from one array and write to the other, unless the tiles of the
+  // fragments can be copied as they are
+  if (to_copy.empty())
+    st = copy_array(
+        subarray, query_r, query_w, buffers, buffer_sizes, buffer_num);
+  else
+    st = copy_tiles(query_r->array_schema(), to_copy, new_fragment_uri);
   if (!st.ok())
     goto clean_up;
 
@@ -109,7 +120,8 @@ Status Consolidator::consolidate(const char* array_name) {
   old_fragment_uris = query_r->fragment_uris();
 
   // Finalize both queries
-  st = finalize_queries(query_r, query_w);
+  st = (to_copy.empty()) ? finalize_queries(query_r, query_w) :
+                           storage_manager_->query_finalize(query_r);
   if (!st.ok())
     goto clean_up;
 
@@ -140,36 +152,135 @@ clean_up:
   return st;
 }
 
+Status Consolidator::consolidate_metadata(const char* array_name) {
+  // Open the array to get its fragments, which also keeps them from being
+  // deleted until the consolidated metadata is stored
+  auto query = new Query();
+  RETURN_NOT_OK_ELSE(
+      storage_manager_->query_init(query, array_name, QueryType::READ),
+      delete query);
+
+  auto buff = new Buffer();
+  Status st = serialize_metadata(query->fragment_metadata(), buff);
+  if (st.ok())
+    st = storage_manager_->store_consolidated_fragment_metadata(
+        URI(array_name), buff);
+  delete buff;
+  Status st_finalize = storage_manager_->query_finalize(query);
+  delete query;
+  RETURN_NOT_OK(st);
+
+  return st_finalize;
+}
+
+Status Consolidator::consolidation_due(
+    const char* array_name, bool* due, uint64_t* size) {
+  *due = false;
+  *size = 0;
+
+  // Open the array to get the metadata of its fragments
+  auto query = new Query();
+  RETURN_NOT_OK_ELSE(
+      storage_manager_->query_init(query, array_name, QueryType::READ),
+      delete query);
+  Status st = consolidation_due(
+      query->array_schema(), query->fragment_metadata(), due, size);
+  Status st_finalize = storage_manager_->query_finalize(query);
+  delete query;
+  RETURN_NOT_OK(st);
+
+  return st_finalize;
+}
+
 /* ****************************** */
 /*        PRIVATE METHODS         */
 /* ****************************** */
 
 Status Consolidator::copy_array(
-    void* read_subarray, Query* query_r, Query* query_w) {
-  // Compute subarrays
+    void* read_subarray,
+    Query* query_r,
+    Query* query_w,
+    void** buffers,
+    uint64_t* buffer_sizes,
+    unsigned int buffer_num) {
+  // Partition the subarray along the tile boundaries
+  uint64_t buffer_size = buffer_sizes[0];
   std::vector<void*> subarrays;
   RETURN_NOT_OK(query_r->compute_subarrays(read_subarray, &subarrays));
+  uint64_t partition_num = subarrays.size();
 
-  for (auto subarray : subarrays) {
-    auto s = (uint64_t*)subarray;
-    std::cout << s[0] << " " << s[1] << " " << s[2] << " " << s[3] << "\n";
+  // Create a set of buffers for each partition in flight
+  auto sm_params = storage_manager_->config().sm_params();
+  auto slot_num = std::min<uint64_t>(
+      std::max<uint64_t>(sm_params.consolidation_threads_, 1), partition_num);
+  std::vector<void**> slot_buffers(slot_num, nullptr);
+  std::vector<uint64_t*> slot_buffer_sizes(slot_num, nullptr);
+  std::vector<Query*> slot_queries(slot_num, nullptr);
+  std::vector<std::future<Status>> slot_tasks(slot_num);
+  Status st = Status::Ok();
+  for (uint64_t s = 0; s < slot_num && st.ok(); ++s) {
+    if (s == 0) {
+      slot_buffers[s] = buffers;
+      slot_buffer_sizes[s] = buffer_sizes;
+    } else {
+      unsigned int num;
+      st = create_buffers(
+          query_r->array_schema(),
+          &slot_buffers[s],
+          &slot_buffer_sizes[s],
+          &num);
+    }
   }
 
-  // Perform a potentilly step-wise copy in a loop
-  Status st = Status::Ok();
-  for (const auto& s : subarrays) {
-    st = query_r->set_subarray(s);
-    if (!st.ok())
-      break;
-    st = storage_manager_->query_submit(query_r);
-    if (!st.ok())
-      break;
-    st = storage_manager_->query_submit(query_w);
-    if (!st.ok())
-      break;
+  // Read the partitions concurrently and write them in order. The reads run
+  // on their own thread pool, since they may use the compute thread pool.
+  ThreadPool thread_pool(std::max<uint64_t>(slot_num, 1));
+  auto read_next = [&](uint64_t p) {
+    auto s = p % slot_num;
+    slot_queries[s] = new Query();
+    auto query = slot_queries[s];
+    auto subarray = subarrays[p];
+    auto read_buffers = slot_buffers[s];
+    auto read_buffer_sizes = slot_buffer_sizes[s];
+    slot_tasks[s] = thread_pool.enqueue([=]() {
+      return read_partition(
+          query_r,
+          subarray,
+          read_buffers,
+          read_buffer_sizes,
+          buffer_num,
+          buffer_size,
+          query);
+    });
+  };
+  for (uint64_t p = 0; p < slot_num && st.ok(); ++p)
+    read_next(p);
+  for (uint64_t p = 0; p < partition_num && st.ok(); ++p) {
+    auto s = p % slot_num;
+    st = slot_tasks[s].get();
+    if (st.ok())
+      st = write_partition(
+          slot_queries[s],
+          query_w,
+          slot_buffers[s],
+          slot_buffer_sizes[s],
+          buffer_num,
+          buffer_size);
+    delete slot_queries[s];
+    slot_queries[s] = nullptr;
+    if (st.ok() && p + slot_num < partition_num)
+      read_next(p + slot_num);
   }
 
-  // Clean up
+  // Clean up, after the reads still in flight upon error
+  for (uint64_t s = 0; s < slot_num; ++s) {
+    if (slot_tasks[s].valid())
+      slot_tasks[s].wait();
+    delete slot_queries[s];
+    if (s != 0 && slot_buffers[s] != nullptr)
+      free_buffers(buffer_num, slot_buffers[s], slot_buffer_sizes[s]);
+  }
+  query_w->set_buffers(buffers, buffer_sizes);
   for (const auto& s : subarrays) {
     if (s != nullptr)
       std::free(s);
@@ -178,8 +289,229 @@ Status Consolidator::copy_array(
   return st;
 }
 
+Status Consolidator::copy_file(
+    const URI& from,
+    const URI& to,
+    uint64_t size,
+    void* buffer,
+    uint64_t buffer_size) const {
+  auto vfs = storage_manager_->vfs();
+  for (uint64_t offset = 0; offset < size; offset += buffer_size) {
+    auto nbytes = std::min(buffer_size, size - offset);
+    RETURN_NOT_OK(vfs->read(from, offset, buffer, nbytes));
+    RETURN_NOT_OK(vfs->write(to, buffer, nbytes));
+  }
+
+  return Status::Ok();
+}
+
+Status Consolidator::copy_tiles(
+    const ArraySchema* array_schema,
+    const std::vector<FragmentMetadata*>& fragment_metadata,
+    const URI& new_fragment_uri) const {
+  // For easy reference
+  auto vfs = storage_manager_->vfs();
+  auto attribute_num = array_schema->attribute_num();
+  auto dense = array_schema->dense();
+  auto file_num = (dense) ? attribute_num : attribute_num + 1;
+
+  // The non-empty domain of a dense fragment spans the tiles of the copied
+  // fragments, which differ only along the slowest varying dimension
+  auto domain_size = 2 * array_schema->coords_size();
+  std::vector<char> non_empty_domain(domain_size);
+  if (dense) {
+    auto dim_num = array_schema->dim_num();
+    auto d =
+        (array_schema->tile_order() == Layout::ROW_MAJOR) ? 0 : dim_num - 1;
+    auto coord_size = array_schema->coords_size() / dim_num;
+    auto last = static_cast<const char*>(fragment_metadata.back()->domain());
+    std::memcpy(
+        &non_empty_domain[0], fragment_metadata.front()->domain(), domain_size);
+    std::memcpy(
+        &non_empty_domain[(2 * d + 1) * coord_size],
+        &last[(2 * d + 1) * coord_size],
+        coord_size);
+  } else {
+    std::memcpy(
+        &non_empty_domain[0], array_schema->domain()->domain(), domain_size);
+  }
+
+  // Copy through a buffer within the memory budget
+  uint64_t max_file_size = 0;
+  for (auto metadata : fragment_metadata) {
+    for (unsigned int i = 0; i < file_num; ++i) {
+      max_file_size = std::max(max_file_size, metadata->file_sizes(i));
+      if (i < attribute_num && array_schema->var_size(i))
+        max_file_size = std::max(max_file_size, metadata->file_var_sizes(i));
+    }
+  }
+  auto sm_params = storage_manager_->config().sm_params();
+  auto buffer_size =
+      std::min(sm_params.consolidation_memory_budget_, max_file_size);
+  auto buffer = std::malloc(std::max<uint64_t>(buffer_size, 1));
+  if (buffer == nullptr)
+    return LOG_STATUS(Status::ConsolidationError(
+        "Cannot copy tiles; Memory allocation failed"));
+
+  // Append the files of each fragment to the new fragment and merge their
+  // metadata. The new fragment becomes visible once its metadata is stored.
+  auto new_metadata =
+      new FragmentMetadata(array_schema, dense, new_fragment_uri);
+  Status st = new_metadata->init(&non_empty_domain[0]);
+  if (st.ok())
+    st = vfs->create_dir(new_fragment_uri);
+  std::vector<uint64_t> file_sizes(file_num, 0);
+  std::vector<uint64_t> file_var_sizes(attribute_num, 0);
+  for (auto metadata : fragment_metadata) {
+    for (unsigned int i = 0; i < file_num && st.ok(); ++i) {
+      st = copy_file(
+          metadata->attr_uri(i),
+          new_metadata->attr_uri(i),
+          metadata->file_sizes(i),
+          buffer,
+          buffer_size);
+      file_sizes[i] += metadata->file_sizes(i);
+      if (st.ok() && i < attribute_num && array_schema->var_size(i)) {
+        st = copy_file(
+            metadata->attr_var_uri(i),
+            new_metadata->attr_var_uri(i),
+            metadata->file_var_sizes(i),
+            buffer,
+            buffer_size);
+        file_var_sizes[i] += metadata->file_var_sizes(i);
+      }
+    }
+    if (st.ok())
+      st = new_metadata->append_fragment(metadata);
+    if (!st.ok())
+      break;
+  }
+  for (unsigned int i = 0; i < file_num && st.ok(); ++i) {
+    if (file_sizes[i] != 0)
+      st = vfs->close_file(new_metadata->attr_uri(i));
+    if (st.ok() && i < attribute_num && file_var_sizes[i] != 0)
+      st = vfs->close_file(new_metadata->attr_var_uri(i));
+  }
+  if (st.ok())
+    st = storage_manager_->store_fragment_metadata(new_metadata);
+
+  // Clean up, removing the partially copied fragment upon error
+  if (!st.ok())
+    vfs->remove_dir(new_fragment_uri);
+  delete new_metadata;
+  std::free(buffer);
+
+  return st;
+}
+
+Status Consolidator::consolidation_due(
+    const ArraySchema* array_schema,
+    const std::vector<FragmentMetadata*>& fragment_metadata,
+    bool* due,
+    uint64_t* size) const {
+  Datatype coords_type = array_schema->coords_type();
+
+  // Invoke the proper templated function
+  if (coords_type == Datatype::INT32)
+    return consolidation_due<int>(array_schema, fragment_metadata, due, size);
+  if (coords_type == Datatype::INT64)
+    return consolidation_due<int64_t>(
+        array_schema, fragment_metadata, due, size);
+  if (coords_type == Datatype::FLOAT32)
+    return consolidation_due<float>(array_schema, fragment_metadata, due, size);
+  if (coords_type == Datatype::FLOAT64)
+    return consolidation_due<double>(
+        array_schema, fragment_metadata, due, size);
+  if (coords_type == Datatype::INT8)
+    return consolidation_due<int8_t>(
+        array_schema, fragment_metadata, due, size);
+  if (coords_type == Datatype::UINT8)
+    return consolidation_due<uint8_t>(
+        array_schema, fragment_metadata, due, size);
+  if (coords_type == Datatype::INT16)
+    return consolidation_due<int16_t>(
+        array_schema, fragment_metadata, due, size);
+  if (coords_type == Datatype::UINT16)
+    return consolidation_due<uint16_t>(
+        array_schema, fragment_metadata, due, size);
+  if (coords_type == Datatype::UINT32)
+    return consolidation_due<uint32_t>(
+        array_schema, fragment_metadata, due, size);
+  if (coords_type == Datatype::UINT64)
+    return consolidation_due<uint64_t>(
+        array_schema, fragment_metadata, due, size);
+
+  return LOG_STATUS(Status::ConsolidationError(
+      "Cannot check consolidation; Unsupported coordinates type"));
+}
+
+template <class T>
+Status Consolidator::consolidation_due(
+    const ArraySchema* array_schema,
+    const std::vector<FragmentMetadata*>& fragment_metadata,
+    bool* due,
+    uint64_t* size) const {
+  // For easy reference
+  auto sm_params = storage_manager_->config().sm_params();
+  auto dim_num = array_schema->dim_num();
+  uint64_t fragment_num = fragment_metadata.size();
+  *due = false;
+  *size = 0;
+
+  // A single fragment is never consolidated
+  if (fragment_num <= 1)
+    return Status::Ok();
+
+  // Count the small fragments
+  uint64_t small_num = 0;
+  for (auto metadata : fragment_metadata) {
+    uint64_t metadata_size;
+    RETURN_NOT_OK(fragment_size(metadata->fragment_uri(), &metadata_size));
+    *size += metadata_size;
+    if (metadata_size < sm_params.auto_consolidation_small_fragment_size_)
+      ++small_num;
+  }
+
+  if (sm_params.auto_consolidation_fragment_num_ != 0 &&
+      fragment_num >= sm_params.auto_consolidation_fragment_num_) {
+    *due = true;
+    return Status::Ok();
+  }
+
+  auto min_small_num =
+      std::max<uint64_t>(sm_params.consolidation_min_fragments_, 2);
+  if (sm_params.auto_consolidation_small_fragment_size_ != 0 &&
+      small_num >= min_small_num) {
+    *due = true;
+    return Status::Ok();
+  }
+
+  // Count the other fragments a read in the non-empty domain of each
+  // fragment visits
+  if (sm_params.auto_consolidation_read_amplification_ == 0 ||
+      fragment_num <= sm_params.auto_consolidation_read_amplification_)
+    return Status::Ok();
+  for (auto metadata : fragment_metadata) {
+    auto domain = (const T*)metadata->non_empty_domain();
+    uint64_t overlap_num = 0;
+    for (auto other : fragment_metadata) {
+      if (other == metadata)
+        continue;
+      auto other_domain = (const T*)other->non_empty_domain();
+      if (utils::overlap(domain, other_domain, dim_num))
+        ++overlap_num;
+    }
+    if (overlap_num >= sm_params.auto_consolidation_read_amplification_) {
+      *due = true;
+      break;
+    }
+  }
+
+  return Status::Ok();
+}
+
 Status Consolidator::create_buffers(
-    ArraySchema* array_meta,
+    const ArraySchema* array_meta,
     void*** buffers,
     uint64_t** buffer_sizes,
     unsigned int* buffer_num) {
@@ -205,13 +537,19 @@ Status Consolidator::create_buffers(
         "Cannot create consolidation buffer sizes; Memory allocation failed"));
   }
 
+  // Split the memory budget among the buffers of the partitions in flight
+  auto sm_params = storage_manager_->config().sm_params();
+  auto slot_num = std::max<uint64_t>(sm_params.consolidation_threads_, 1);
+  auto buffer_size =
+      sm_params.consolidation_memory_budget_ / (slot_num * *buffer_num);
+
   // Allocate space for each buffer
   bool error = false;
   for (unsigned int i = 0; i < *buffer_num; ++i) {
-    (*buffers)[i] = std::malloc(constants::consolidation_buffer_size);
+    (*buffers)[i] = std::malloc(buffer_size);
     if ((*buffers)[i] == nullptr)  // The loop should continue to
       error = true;                // allocate nullptr to each buffer
-    (*buffer_sizes)[i] = constants::consolidation_buffer_size;
+    (*buffer_sizes)[i] = buffer_size;
   }
 
   // Clean up upon error
@@ -230,15 +568,31 @@ Status Consolidator::create_buffers(
 Status Consolidator::create_queries(
     Query* query_r,
     Query* query_w,
-    void* subarray,
+    void** subarray,
     const char* array_name,
     void** buffers,
     uint64_t* buffer_sizes,
-    unsigned int* fragment_num) {
-  // Create read query
-  RETURN_NOT_OK(storage_manager_->query_init(
-      query_r,
-      array_name,
+    unsigned int* fragment_num,
+    URI* new_fragment_uri,
+    std::vector<FragmentMetadata*>* to_copy) {
+  // Open the array and select the fragments to consolidate
+  RETURN_NOT_OK(
+      storage_manager_->query_init(query_r, array_name, QueryType::READ));
+  auto array_schema = query_r->array_schema();
+  std::vector<FragmentMetadata*> to_consolidate;
+  RETURN_NOT_OK(select_fragments(
+      array_schema, query_r->fragment_metadata(), &to_consolidate, subarray));
+
+  // Get fragment num and terminate with success if it is <=1
+  *fragment_num = (unsigned int)to_consolidate.size();
+  if (*fragment_num <= 1)
+    return Status::Ok();
+
+  // Create read query on the selected fragments
+  RETURN_NOT_OK(query_r->init(
+      storage_manager_,
+      array_schema,
+      to_consolidate,
       QueryType::READ,
       Layout::GLOBAL_ORDER,
       nullptr,
@@ -247,14 +601,14 @@ Status Consolidator::create_queries(
       buffers,
       buffer_sizes));
 
-  // Get fragment num and terminate with success if it is <=1
-  *fragment_num = query_r->fragment_num();
-  if (*fragment_num <= 1)
-    return Status::Ok();
-
   // Get last fragment URI, which will be the URI of the consolidated fragment
-  URI new_fragment_uri = query_r->last_fragment_uri();
-  RETURN_NOT_OK(rename_new_fragment_uri(&new_fragment_uri));
+  *new_fragment_uri = query_r->last_fragment_uri();
+  RETURN_NOT_OK(rename_new_fragment_uri(new_fragment_uri));
+
+  // The tiles of non-overlapping fragments are copied without a write query
+  RETURN_NOT_OK(tile_copy_order(array_schema, to_consolidate, to_copy));
+  if (!to_copy->empty())
+    return Status::Ok();
 
   // Create write query
   RETURN_NOT_OK(storage_manager_->query_init(
@@ -262,34 +616,12 @@ Status Consolidator::create_queries(
       array_name,
       QueryType::WRITE,
       Layout::GLOBAL_ORDER,
-      subarray,
+      *subarray,
       nullptr,
       0,
       buffers,
       buffer_sizes,
-      new_fragment_uri));
-
-  return Status::Ok();
-}
-
-Status Consolidator::create_subarray(
-    const std::string& array_name,
-    const ArraySchema* array_schema,
-    void** subarray) const {
-  // Create subarray only for the dense case
-  if (array_schema->dense()) {
-    *subarray = std::malloc(2 * array_schema->coords_size());
-    if (*subarray == nullptr)
-      return LOG_STATUS(Status::ConsolidationError(
-          "Cannot create subarray; Failed to allocate memory"));
-    bool is_empty;
-    RETURN_NOT_OK_ELSE(
-        storage_manager_->array_get_non_empty_domain(
-            array_name.c_str(), *subarray, &is_empty),
-        std::free(subarray));
-    assert(!is_empty);
-    array_schema->domain()->expand_domain(*subarray);
-  }
+      *new_fragment_uri));
 
   return Status::Ok();
 }
@@ -308,6 +640,21 @@ Status Consolidator::finalize_queries(Query* query_r, Query* query_w) {
   return Status::Ok();
 }
 
+Status Consolidator::fragment_size(const URI& uri, uint64_t* size) const {
+  auto vfs = storage_manager_->vfs();
+  std::vector<URI> uris;
+  RETURN_NOT_OK(vfs->ls(uri, &uris));
+
+  *size = 0;
+  for (const auto& file_uri : uris) {
+    uint64_t file_size;
+    RETURN_NOT_OK(vfs->file_size(file_uri, &file_size));
+    *size += file_size;
+  }
+
+  return Status::Ok();
+}
+
 void Consolidator::free_buffers(
     unsigned int buffer_num, void** buffers, uint64_t* buffer_sizes) {
   for (unsigned int i = 0; i < buffer_num; ++i) {
@@ -318,6 +665,33 @@ void Consolidator::free_buffers(
   delete[] buffer_sizes;
 }
 
+Status Consolidator::read_partition(
+    const Query* query_r,
+    const void* subarray,
+    void** buffers,
+    uint64_t* buffer_sizes,
+    unsigned int buffer_num,
+    uint64_t buffer_size,
+    Query* query) {
+  for (unsigned int i = 0; i < buffer_num; ++i)
+    buffer_sizes[i] = buffer_size;
+
+  RETURN_NOT_OK(query->init(
+      storage_manager_,
+      query_r->array_schema(),
+      query_r->fragment_metadata(),
+      QueryType::READ,
+      Layout::GLOBAL_ORDER,
+      subarray,
+      nullptr,
+      0,
+      buffers,
+      buffer_sizes));
+  RETURN_NOT_OK(query->init());
+
+  return query->read();
+}
+
 Status Consolidator::rename_new_fragment_uri(URI* uri) const {
   // Get timestamp
   std::string name = uri->last_path_part();
@@ -334,5 +708,323 @@ Status Consolidator::rename_new_fragment_uri(URI* uri) const {
   return Status::Ok();
 }
 
+Status Consolidator::select_fragments(
+    const ArraySchema* array_schema,
+    const std::vector<FragmentMetadata*>& fragment_metadata,
+    std::vector<FragmentMetadata*>* to_consolidate,
+    void** write_subarray) const {
+  Datatype coords_type = array_schema->coords_type();
+
+  // Invoke the proper templated function
+  if (coords_type == Datatype::INT32)
+    return select_fragments<int>(
+        array_schema, fragment_metadata, to_consolidate, write_subarray);
+  if (coords_type == Datatype::INT64)
+    return select_fragments<int64_t>(
+        array_schema, fragment_metadata, to_consolidate, write_subarray);
+  if (coords_type == Datatype::FLOAT32)
+    return select_fragments<float>(
+        array_schema, fragment_metadata, to_consolidate, write_subarray);
+  if (coords_type == Datatype::FLOAT64)
+    return select_fragments<double>(
+        array_schema, fragment_metadata, to_consolidate, write_subarray);
+  if (coords_type == Datatype::INT8)
+    return select_fragments<int8_t>(
+        array_schema, fragment_metadata, to_consolidate, write_subarray);
+  if (coords_type == Datatype::UINT8)
+    return select_fragments<uint8_t>(
+        array_schema, fragment_metadata, to_consolidate, write_subarray);
+  if (coords_type == Datatype::INT16)
+    return select_fragments<int16_t>(
+        array_schema, fragment_metadata, to_consolidate, write_subarray);
+  if (coords_type == Datatype::UINT16)
+    return select_fragments<uint16_t>(
+        array_schema, fragment_metadata, to_consolidate, write_subarray);
+  if (coords_type == Datatype::UINT32)
+    return select_fragments<uint32_t>(
+        array_schema, fragment_metadata, to_consolidate, write_subarray);
+  if (coords_type == Datatype::UINT64)
+    return select_fragments<uint64_t>(
+        array_schema, fragment_metadata, to_consolidate, write_subarray);
+
+  return LOG_STATUS(Status::ConsolidationError(
+      "Cannot select fragments; Unsupported coordinates type"));
+}
+
+template <class T>
+Status Consolidator::select_fragments(
+    const ArraySchema* array_schema,
+    const std::vector<FragmentMetadata*>& fragment_metadata,
+    std::vector<FragmentMetadata*>* to_consolidate,
+    void** write_subarray) const {
+  // For easy reference
+  auto sm_params = storage_manager_->config().sm_params();
+  auto dim_num = array_schema->dim_num();
+  bool dense = array_schema->dense();
+  size_t fragment_num = fragment_metadata.size();
+
+  // The full policy selects all the fragments
+  size_t begin = 0, end = fragment_num;
+  if (sm_params.consolidation_policy_ == "tiered" && fragment_num > 1) {
+    std::vector<uint64_t> sizes(fragment_num);
+    for (size_t i = 0; i < fragment_num; ++i)
+      RETURN_NOT_OK(
+          fragment_size(fragment_metadata[i]->fragment_uri(), &sizes[i]));
+
+    // Find the longest run of similar fragments starting at each fragment
+    std::vector<T> domain(2 * dim_num);
+    uint64_t best_size = 0;
+    end = 0;
+    for (size_t i = 0; i < fragment_num; ++i) {
+      uint64_t min_size = sizes[i], max_size = sizes[i], size = sizes[i];
+      size_t j = i + 1;
+      for (; j < fragment_num && j - i < sm_params.consolidation_max_fragments_;
+           ++j) {
+        uint64_t new_min_size = std::min(min_size, sizes[j]);
+        uint64_t new_max_size = std::max(max_size, sizes[j]);
+        if (new_max_size > sm_params.consolidation_size_ratio_ * new_min_size)
+          break;
+
+        // The older dense fragments must not intersect the covered tiles
+        if (dense) {
+          tile_domain<T>(array_schema, fragment_metadata, i, j + 1, &domain[0]);
+          bool overlap = false;
+          for (size_t k = 0; k < i && !overlap; ++k) {
+            auto older = (const T*)fragment_metadata[k]->non_empty_domain();
+            overlap = true;
+            for (unsigned int d = 0; d < dim_num && overlap; ++d)
+              overlap = older[2 * d] <= domain[2 * d + 1] &&
+                        domain[2 * d] <= older[2 * d + 1];
+          }
+          if (overlap)
+            break;
+        }
+
+        min_size = new_min_size;
+        max_size = new_max_size;
+        size += sizes[j];
+      }
+
+      // Prefer the run with the smallest average fragment size
+      if (j - i < sm_params.consolidation_min_fragments_)
+        continue;
+      if (end == 0 || size * (end - begin) < best_size * (j - i)) {
+        begin = i;
+        end = j;
+        best_size = size;
+      }
+    }
+  }
+
+  to_consolidate->assign(
+      fragment_metadata.begin() + begin, fragment_metadata.begin() + end);
+
+  // Dense fragments are written into their expanded non-empty domain
+  if (dense && to_consolidate->size() > 1) {
+    *write_subarray = std::malloc(2 * array_schema->coords_size());
+    if (*write_subarray == nullptr)
+      return LOG_STATUS(Status::ConsolidationError(
+          "Cannot create subarray; Failed to allocate memory"));
+    tile_domain<T>(
+        array_schema,
+        fragment_metadata,
+        begin,
+        end,
+        static_cast<T*>(*write_subarray));
+  }
+
+  return Status::Ok();
+}
+
+Status Consolidator::serialize_metadata(
+    const std::vector<FragmentMetadata*>& fragment_metadata,
+    Buffer* buff) const {
+  uint32_t version = constants::consolidated_fragment_metadata_version;
+  uint64_t fragment_num = fragment_metadata.size();
+  RETURN_NOT_OK(buff->write(&version, sizeof(uint32_t)));
+  RETURN_NOT_OK(buff->write(&fragment_num, sizeof(uint64_t)));
+
+  for (auto metadata : fragment_metadata) {
+    // Read the metadata file of the fragment
+    auto metadata_uri = metadata->fragment_uri().join_path(
+        std::string(constants::fragment_metadata_filename));
+    TileIO tile_io(storage_manager_, metadata_uri);
+    auto tile = (Tile*)nullptr;
+    RETURN_NOT_OK(tile_io.read_generic(&tile, 0));
+    auto tile_buff = tile->buffer();
+
+    // Append its entry
+    auto name = metadata->fragment_uri().last_path_part();
+    uint64_t name_size = name.size();
+    char dense = metadata->dense() ? 1 : 0;
+    uint64_t size = tile_buff->size();
+    Status st = buff->write(&name_size, sizeof(uint64_t));
+    if (st.ok())
+      st = buff->write(name.data(), name_size);
+    if (st.ok())
+      st = buff->write(&dense, sizeof(char));
+    if (st.ok())
+      st = buff->write(&size, sizeof(uint64_t));
+    if (st.ok())
+      st = buff->write(tile_buff->data(), size);
+    delete tile;
+    RETURN_NOT_OK(st);
+  }
+
+  return Status::Ok();
+}
+
+Status Consolidator::tile_copy_order(
+    const ArraySchema* array_schema,
+    const std::vector<FragmentMetadata*>& fragment_metadata,
+    std::vector<FragmentMetadata*>* order) const {
+  Datatype coords_type = array_schema->coords_type();
+
+  // Invoke the proper templated function
+  if (coords_type == Datatype::INT32)
+    return tile_copy_order<int>(array_schema, fragment_metadata, order);
+  if (coords_type == Datatype::INT64)
+    return tile_copy_order<int64_t>(array_schema, fragment_metadata, order);
+  if (coords_type == Datatype::FLOAT32)
+    return tile_copy_order<float>(array_schema, fragment_metadata, order);
+  if (coords_type == Datatype::FLOAT64)
+    return tile_copy_order<double>(array_schema, fragment_metadata, order);
+  if (coords_type == Datatype::INT8)
+    return tile_copy_order<int8_t>(array_schema, fragment_metadata, order);
+  if (coords_type == Datatype::UINT8)
+    return tile_copy_order<uint8_t>(array_schema, fragment_metadata, order);
+  if (coords_type == Datatype::INT16)
+    return tile_copy_order<int16_t>(array_schema, fragment_metadata, order);
+  if (coords_type == Datatype::UINT16)
+    return tile_copy_order<uint16_t>(array_schema, fragment_metadata, order);
+  if (coords_type == Datatype::UINT32)
+    return tile_copy_order<uint32_t>(array_schema, fragment_metadata, order);
+  if (coords_type == Datatype::UINT64)
+    return tile_copy_order<uint64_t>(array_schema, fragment_metadata, order);
+
+  return LOG_STATUS(Status::ConsolidationError(
+      "Cannot check tile copy; Unsupported coordinates type"));
+}
+
+template <class T>
+Status Consolidator::tile_copy_order(
+    const ArraySchema* array_schema,
+    const std::vector<FragmentMetadata*>& fragment_metadata,
+    std::vector<FragmentMetadata*>* order) const {
+  // For easy reference
+  auto domain = array_schema->domain();
+  auto dim_num = array_schema->dim_num();
+  auto attribute_num = array_schema->attribute_num();
+  auto dense = array_schema->dense();
+  order->clear();
+
+  // The fragments must be of the array type and share their dictionaries
+  for (auto metadata : fragment_metadata) {
+    if (metadata->dense() != dense || metadata->tile_num() == 0)
+      return Status::Ok();
+    for (unsigned int i = 0; i < attribute_num; ++i) {
+      if (metadata->zstd_dictionary(i) !=
+          fragment_metadata[0]->zstd_dictionary(i))
+        return Status::Ok();
+    }
+  }
+
+  auto sorted = fragment_metadata;
+  if (dense) {
+    // The fragments must stack along the slowest varying dimension
+    if (!std::numeric_limits<T>::is_integer)
+      return Status::Ok();
+    auto d =
+        (array_schema->tile_order() == Layout::ROW_MAJOR) ? 0 : dim_num - 1;
+    std::sort(
+        sorted.begin(),
+        sorted.end(),
+        [d](const FragmentMetadata* a, const FragmentMetadata* b) {
+          return static_cast<const T*>(a->domain())[2 * d] <
+                 static_cast<const T*>(b->domain())[2 * d];
+        });
+    for (size_t i = 1; i < sorted.size(); ++i) {
+      auto prev = static_cast<const T*>(sorted[i - 1]->domain());
+      auto cur = static_cast<const T*>(sorted[i]->domain());
+      for (unsigned int j = 0; j < dim_num; ++j) {
+        if (j == d && prev[2 * j + 1] + 1 != cur[2 * j])
+          return Status::Ok();
+        if (j != d &&
+            (prev[2 * j] != cur[2 * j] || prev[2 * j + 1] != cur[2 * j + 1]))
+          return Status::Ok();
+      }
+    }
+  } else {
+    // Each fragment must end with a full tile before the next one begins
+    auto global_cmp = [domain](const T* a, const T* b) {
+      int cmp = domain->tile_order_cmp<T>(a, b);
+      return (cmp != 0) ? cmp : domain->cell_order_cmp<T>(a, b);
+    };
+    std::sort(
+        sorted.begin(),
+        sorted.end(),
+        [&global_cmp](const FragmentMetadata* a, const FragmentMetadata* b) {
+          return global_cmp(
+                     static_cast<const T*>(a->bounding_coords().front()),
+                     static_cast<const T*>(b->bounding_coords().front())) < 0;
+        });
+    for (size_t i = 1; i < sorted.size(); ++i) {
+      auto prev_last =
+          static_cast<const T*>(sorted[i - 1]->bounding_coords().back()) +
+          dim_num;
+      auto cur_first = static_cast<const T*>(sorted[i]->bounding_coords()[0]);
+      if (sorted[i - 1]->last_tile_cell_num() != array_schema->capacity() ||
+          global_cmp(prev_last, cur_first) >= 0)
+        return Status::Ok();
+    }
+  }
+
+  *order = sorted;
+
+  return Status::Ok();
+}
+
+template <class T>
+void Consolidator::tile_domain(
+    const ArraySchema* array_schema,
+    const std::vector<FragmentMetadata*>& fragment_metadata,
+    size_t begin,
+    size_t end,
+    T* domain) const {
+  auto dim_num = array_schema->dim_num();
+  auto first = (const T*)fragment_metadata[begin]->non_empty_domain();
+  std::memcpy(domain, first, 2 * dim_num * sizeof(T));
+  for (size_t i = begin + 1; i < end; ++i) {
+    auto non_empty_domain = (const T*)fragment_metadata[i]->non_empty_domain();
+    for (unsigned int d = 0; d < dim_num; ++d) {
+      domain[2 * d] = std::min(domain[2 * d], non_empty_domain[2 * d]);
+      domain[2 * d + 1] =
+          std::max(domain[2 * d + 1], non_empty_domain[2 * d + 1]);
+    }
+  }
+  array_schema->domain()->expand_domain(static_cast<void*>(domain));
+}
+
+Status Consolidator::write_partition(
+    Query* query,
+    Query* query_w,
+    void** buffers,
+    uint64_t* buffer_sizes,
+    unsigned int buffer_num,
+    uint64_t buffer_size) {
+  query_w->set_buffers(buffers, buffer_sizes);
+  RETURN_NOT_OK(storage_manager_->query_submit(query_w));
+
+  // Continue reading the partition upon a buffer overflow
+  while (query->status() == QueryStatus::INCOMPLETE) {
+    for (unsigned int i = 0; i < buffer_num; ++i)
+      buffer_sizes[i] = buffer_size;
+    RETURN_NOT_OK(query->read());
+    RETURN_NOT_OK(storage_manager_->query_submit(query_w));
+  }
+
+  return Status::Ok();
+}
+
 }  // namespace sm
 }  // namespace tiledb
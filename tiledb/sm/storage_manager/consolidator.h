@@ -41,6 +41,8 @@ namespace tiledb {
 namespace sm {
 
 class ArraySchema;
+class Buffer;
+class FragmentMetadata;
 class Query;
 class StorageManager;
 class URI;
@@ -66,9 +68,35 @@ class Consolidator {
   /*                API                */
   /* ********************************* */
 
-  /** Consolidates the fragments of the input array. */
+  /**
+   * Consolidates the fragments of the input array. The fragments that get
+   * consolidated are selected by the `sm.consolidation_policy` config
+   * parameter. If their tiles do not overlap and follow each other in the
+   * global order, they are copied into the new fragment without being
+   * decompressed.
+   */
   Status consolidate(const char* array_name);
 
+  /**
+   * Consolidates the metadata of all the fragments of the input array into
+   * a single file, which records the name and the type of each fragment
+   * along with its metadata. Fragments created afterwards are not in the
+   * file and keep being loaded from their own metadata files, while the
+   * entries of the fragments that no longer exist are ignored.
+   */
+  Status consolidate_metadata(const char* array_name);
+
+  /**
+   * Checks whether the fragments of the input array exceed one of the
+   * `sm.auto_consolidation_*` thresholds.
+   *
+   * @param array_name The array name.
+   * @param due Set to `true` if the array must be consolidated.
+   * @param size Set to the total size of the fragments of the array in bytes.
+   * @return Status
+   */
+  Status consolidation_due(const char* array_name, bool* due, uint64_t* size);
+
  private:
   /* ********************************* */
   /*        PRIVATE ATTRIBUTES         */
@@ -83,19 +111,91 @@ class Consolidator {
 
   /**
    * Copies the array by reading from the fragments to be consolidated
-   * (with *query_r*) and writing to the new fragment (with *query_w*).
+   * (opened by *query_r*) and writing to the new fragment (with *query_w*).
+   * The read subarray is partitioned along the tile boundaries, such that
+   * the results of each partition fit in a set of buffers. Up to
+   * `sm.consolidation_threads` partitions are read concurrently, each into
+   * its own set of buffers, while the partitions that have been read are
+   * written in global order.
    *
    * @param read_subarray The read subarray.
    * @param query_r The read query.
    * @param query_w The write query.
+   * @param buffers The first set of buffers, with which the queries were
+   *     created.
+   * @param buffer_sizes The corresponding buffer sizes.
+   * @param buffer_num The number of buffers in a set.
    * @return Status
    */
-  Status copy_array(void* read_subarray, Query* query_r, Query* query_w);
+  Status copy_array(
+      void* read_subarray,
+      Query* query_r,
+      Query* query_w,
+      void** buffers,
+      uint64_t* buffer_sizes,
+      unsigned int buffer_num);
+
+  /**
+   * Appends the first *size* bytes of a file to another file.
+   *
+   * @param from The file to copy from.
+   * @param to The file to append to.
+   * @param size The number of bytes to copy.
+   * @param buffer The buffer through which the bytes are copied.
+   * @param buffer_size The size of the buffer.
+   * @return Status
+   */
+  Status copy_file(
+      const URI& from,
+      const URI& to,
+      uint64_t size,
+      void* buffer,
+      uint64_t buffer_size) const;
+
+  /**
+   * Creates the new fragment by concatenating the files of the input
+   * fragments, without decompressing their tiles. The fragments must be
+   * ordered as computed by `tile_copy_order`.
+   *
+   * @param array_schema The array schema.
+   * @param fragment_metadata The metadata of the fragments to copy.
+   * @param new_fragment_uri The URI of the new fragment.
+   * @return Status
+   */
+  Status copy_tiles(
+      const ArraySchema* array_schema,
+      const std::vector<FragmentMetadata*>& fragment_metadata,
+      const URI& new_fragment_uri) const;
+
+  /**
+   * Checks whether the input fragments exceed one of the
+   * `sm.auto_consolidation_*` thresholds.
+   *
+   * @param array_schema The array schema.
+   * @param fragment_metadata The metadata of the fragments of the array.
+   * @param due Set to `true` if the array must be consolidated.
+   * @param size Set to the total size of the fragments in bytes.
+   * @return Status
+   */
+  Status consolidation_due(
+      const ArraySchema* array_schema,
+      const std::vector<FragmentMetadata*>& fragment_metadata,
+      bool* due,
+      uint64_t* size) const;
+
+  /** Implements `consolidation_due` for the coordinates type `T`. */
+  template <class T>
+  Status consolidation_due(
+      const ArraySchema* array_schema,
+      const std::vector<FragmentMetadata*>& fragment_metadata,
+      bool* due,
+      uint64_t* size) const;
 
   /**
    * Creates the buffers that will be used upon reading the input fragments and
    * writing into the new fragment. It also retrieves the number of buffers
-   * created.
+   * created. The size of each buffer is `sm.consolidation_memory_budget`
+   * divided by the number of buffers of all the partitions in flight.
    *
    * @param array_schema The array schema.
    * @param buffers The buffers to be created.
@@ -104,7 +204,7 @@ class Consolidator {
    * @return Status
    */
   Status create_buffers(
-      ArraySchema* array_schema,
+      const ArraySchema* array_schema,
       void*** buffers,
       uint64_t** buffer_sizes,
       unsigned int* buffer_num);
@@ -115,27 +215,28 @@ class Consolidator {
    *
    * @param query_r This query reads from the fragments to be consolidated.
    * @param query_w This query writes to the new consolidated fragment.
-   * @param write_subarray The subarray to write into.
+   * @param write_subarray The subarray to write into, which is created only
+   *     for dense arrays.
    * @param array_name The array name.
    * @param buffers The buffers to be passed in the queries.
    * @param buffer_sizes The corresponding buffer sizes.
    * @param fragment_num The number of fragments to be retrieved.
+   * @param new_fragment_uri The URI of the consolidated fragment.
+   * @param to_copy If the tiles of the selected fragments can be copied,
+   *     these are the fragments in the order in which they are copied, and
+   *     the write query is not created.
    * @return Status
    */
   Status create_queries(
       Query* query_r,
       Query* query_w,
-      void* write_subarray,
+      void** write_subarray,
       const char* array_name,
       void** buffers,
       uint64_t* buffer_sizes,
-      unsigned int* fragment_num);
-
-  /** Creates the subarray that should represent the entire array domain. */
-  Status create_subarray(
-      const std::string& array_name,
-      const ArraySchema* array_schema,
-      void** subarray) const;
+      unsigned int* fragment_num,
+      URI* new_fragment_uri,
+      std::vector<FragmentMetadata*>* to_copy);
 
   /**
    * Deletes the old fragments that got consolidated.
@@ -147,6 +248,9 @@ class Consolidator {
   /** Finalizes the input queries. */
   Status finalize_queries(Query* query_r, Query* query_w);
 
+  /** Computes the size of a fragment as the total size of its files. */
+  Status fragment_size(const URI& uri, uint64_t* size) const;
+
   /**
    * Frees the input buffers.
    *
@@ -157,6 +261,29 @@ class Consolidator {
   void free_buffers(
       unsigned int buffer_num, void** buffers, uint64_t* buffer_sizes);
 
+  /**
+   * Reads a partition of the fragments to be consolidated.
+   *
+   * @param query_r The read query that opened the fragments.
+   * @param subarray The subarray of the partition.
+   * @param buffers The buffers to read into.
+   * @param buffer_sizes The corresponding buffer sizes, which are set to
+   *     *buffer_size* before reading.
+   * @param buffer_num The number of buffers.
+   * @param buffer_size The size of each buffer.
+   * @param query The query that reads the partition, which is created by the
+   *     caller.
+   * @return Status
+   */
+  Status read_partition(
+      const Query* query_r,
+      const void* subarray,
+      void** buffers,
+      uint64_t* buffer_sizes,
+      unsigned int buffer_num,
+      uint64_t buffer_size,
+      Query* query);
+
   /**
    * Renames the new fragment URI. The new name has the format
    * `__<thread_id>_<timestamp>_<last_fragment_timestamp>`, where
@@ -166,6 +293,123 @@ class Consolidator {
    * consolidated fragments.
    */
   Status rename_new_fragment_uri(URI* uri) const;
+
+  /**
+   * Selects the fragments to consolidate, according to the consolidation
+   * policy. The `full` policy selects all the fragments. The `tiered` policy
+   * selects a run of consecutive fragments, which keeps the order of the
+   * remaining fragments intact, whose sizes differ by at most
+   * `sm.consolidation_size_ratio`. Among the runs of at least
+   * `sm.consolidation_min_fragments` and at most
+   * `sm.consolidation_max_fragments` fragments, it selects the run with the
+   * smallest average fragment size. For dense arrays, the run must not
+   * overlap any older fragment within the tiles it covers, since the
+   * consolidated fragment fills the empty cells of those tiles.
+   *
+   * @param array_schema The array schema.
+   * @param fragment_metadata The metadata of all the fragments, sorted by
+   *     timestamp.
+   * @param to_consolidate The selected fragments, which are fewer than two
+   *     if there is nothing to consolidate.
+   * @param write_subarray For dense arrays, it is set to the non-empty domain
+   *     of the selected fragments expanded to the tile boundaries.
+   * @return Status
+   */
+  Status select_fragments(
+      const ArraySchema* array_schema,
+      const std::vector<FragmentMetadata*>& fragment_metadata,
+      std::vector<FragmentMetadata*>* to_consolidate,
+      void** write_subarray) const;
+
+  /** Templated version of `select_fragments` on the coordinates type. */
+  template <class T>
+  Status select_fragments(
+      const ArraySchema* array_schema,
+      const std::vector<FragmentMetadata*>& fragment_metadata,
+      std::vector<FragmentMetadata*>* to_consolidate,
+      void** write_subarray) const;
+
+  /**
+   * Serializes the metadata files of the input fragments into the
+   * consolidated fragment metadata format, i.e., the format version and
+   * the number of fragments, followed by the name size, name, dense flag,
+   * metadata size and (decompressed) metadata of each fragment.
+   *
+   * @param fragment_metadata The metadata of the fragments.
+   * @param buff The buffer to serialize into.
+   * @return Status
+   */
+  Status serialize_metadata(
+      const std::vector<FragmentMetadata*>& fragment_metadata,
+      Buffer* buff) const;
+
+  /**
+   * Checks whether the tiles of the input fragments can be concatenated
+   * into the consolidated fragment as they are, which holds if they do not
+   * overlap and follow each other in the global order. For sparse arrays,
+   * the last cell of each fragment must precede the first cell of the next
+   * one, and all but the last fragment must end with a full tile. For dense
+   * arrays, the tiles of the fragments must be disjoint and stack along the
+   * slowest varying dimension of the tile order into a hyper-rectangle. The
+   * fragments must also have the same zstd dictionaries.
+   *
+   * @param array_schema The array schema.
+   * @param fragment_metadata The metadata of the fragments.
+   * @param order The fragments in the order in which they are concatenated,
+   *     or empty if the tiles cannot be copied.
+   * @return Status
+   */
+  Status tile_copy_order(
+      const ArraySchema* array_schema,
+      const std::vector<FragmentMetadata*>& fragment_metadata,
+      std::vector<FragmentMetadata*>* order) const;
+
+  /** Templated version of `tile_copy_order` on the coordinates type. */
+  template <class T>
+  Status tile_copy_order(
+      const ArraySchema* array_schema,
+      const std::vector<FragmentMetadata*>& fragment_metadata,
+      std::vector<FragmentMetadata*>* order) const;
+
+  /**
+   * Computes the non-empty domain of the fragments in the range
+   * `[begin, end)`, expanded to the tile boundaries.
+   *
+   * @tparam T The coordinates type.
+   * @param array_schema The array schema.
+   * @param fragment_metadata The fragment metadata.
+   * @param begin The first fragment of the range.
+   * @param end The fragment right after the range.
+   * @param domain The computed domain.
+   */
+  template <class T>
+  void tile_domain(
+      const ArraySchema* array_schema,
+      const std::vector<FragmentMetadata*>& fragment_metadata,
+      size_t begin,
+      size_t end,
+      T* domain) const;
+
+  /**
+   * Writes a partition that has been read into the new fragment. If the
+   * results of the partition did not fit in the buffers, it continues reading
+   * the partition and writes the rest of its results.
+   *
+   * @param query The query that reads the partition.
+   * @param query_w The write query.
+   * @param buffers The buffers that hold the results of the partition.
+   * @param buffer_sizes The corresponding buffer sizes.
+   * @param buffer_num The number of buffers.
+   * @param buffer_size The size of each buffer.
+   * @return Status
+   */
+  Status write_partition(
+      Query* query,
+      Query* query_w,
+      void** buffers,
+      uint64_t* buffer_sizes,
+      unsigned int buffer_num,
+      uint64_t buffer_size);
 };
 
 }  // namespace sm
@@ -32,9 +32,12 @@
  */
 
 #include <algorithm>
+#include <chrono>
 #include <sstream>
 
+#include "tiledb/sm/buffer/buffer_pool.h"
 #include "tiledb/sm/misc/logger.h"
+#include "tiledb/sm/misc/stats.h"
 #include "tiledb/sm/misc/utils.h"
 #include "tiledb/sm/storage_manager/storage_manager.h"
 
@@ -55,18 +58,41 @@ StorageManager::StorageManager() {
   async_done_ = false;
   async_thread_[0] = nullptr;
   async_thread_[1] = nullptr;
+  auto_consolidation_done_ = false;
+  auto_consolidation_thread_ = nullptr;
+  compute_tp_ = nullptr;
   consolidator_ = nullptr;
   array_schema_cache_ = nullptr;
   fragment_metadata_cache_ = nullptr;
+  memory_budget_reserved_ = 0;
+  queries_in_progress_ = 0;
+  memory_tracker_ = std::make_shared<MemoryTracker>(
+      MemoryTracker::global(),
+      nullptr,
+      &stats::all_stats.counter_memory_ctx_peak_bytes);
   tile_cache_ = nullptr;
   vfs_ = nullptr;
 }
 
 StorageManager::~StorageManager() {
+  // No consolidation may start while the storage manager is torn down
+  auto_consolidation_stop();
+  delete auto_consolidation_thread_;
+
+  // Write the buffered cells before anything is torn down
+  for (auto write_buffer : write_buffers(URI())) {
+    auto st = write_buffer->flush();
+    if (!st.ok())
+      LOG_STATUS(st);
+    delete write_buffer;
+  }
+  write_buffers_.clear();
+
   async_stop();
   delete async_thread_[0];
   delete async_thread_[1];
   delete array_schema_cache_;
+  delete compute_tp_;
   delete consolidator_;
   delete fragment_metadata_cache_;
   delete tile_cache_;
@@ -241,9 +267,38 @@ Status StorageManager::array_consolidate(const char* array_name) {
     return LOG_STATUS(Status::StorageManagerError(
         "Cannot consolidate array; Array does not exist"));
   }
+  std::lock_guard<std::mutex> lock(consolidation_mtx_);
   return consolidator_->consolidate(array_name);
 }
 
+Status StorageManager::array_consolidate_metadata(const char* array_name) {
+  // Check array URI
+  URI array_uri(array_name);
+  if (array_uri.is_invalid()) {
+    return LOG_STATUS(Status::StorageManagerError(
+        "Cannot consolidate array metadata; Invalid URI"));
+  }
+  // Check if array exists
+  ObjectType obj_type;
+  RETURN_NOT_OK(object_type(array_uri, &obj_type));
+
+  if (obj_type != ObjectType::ARRAY && obj_type != ObjectType::KEY_VALUE) {
+    return LOG_STATUS(Status::StorageManagerError(
+        "Cannot consolidate array metadata; Array does not exist"));
+  }
+  std::lock_guard<std::mutex> lock(consolidation_mtx_);
+  return consolidator_->consolidate_metadata(array_name);
+}
+
+Status StorageManager::array_flush_writes(const char* array_name) {
+  URI array_uri(array_name);
+  if (array_uri.is_invalid())
+    return LOG_STATUS(Status::StorageManagerError(
+        "Cannot flush array writes; Invalid URI"));
+
+  return write_buffers_flush(array_uri);
+}
+
 Status StorageManager::array_create(
     const URI& array_uri, ArraySchema* array_schema) {
   // Check array schema
@@ -442,6 +497,10 @@ Status StorageManager::async_push_query(Query* query, int i) {
   return Status::Ok();
 }
 
+ThreadPool* StorageManager::compute_tp() const {
+  return compute_tp_;
+}
+
 Config StorageManager::config() const {
   return config_;
 }
@@ -465,7 +524,7 @@ Status StorageManager::delete_fragment(const URI& uri) const {
   return vfs_->remove_dir(uri);
 }
 
-Status StorageManager::object_remove(const char* path) const {
+Status StorageManager::object_remove(const char* path) {
   auto uri = URI(path);
   if (uri.is_invalid())
     return LOG_STATUS(Status::StorageManagerError(
@@ -478,11 +537,14 @@ Status StorageManager::object_remove(const char* path) const {
         std::string("Cannot remove object '") + path +
         "'; Invalid TileDB object"));
 
+  for (auto write_buffer : write_buffers(uri))
+    write_buffer->clear();
+
   return vfs_->remove_dir(uri);
 }
 
 Status StorageManager::object_move(
-    const char* old_path, const char* new_path) const {
+    const char* old_path, const char* new_path) {
   auto old_uri = URI(old_path);
   if (old_uri.is_invalid())
     return LOG_STATUS(Status::StorageManagerError(
@@ -500,6 +562,8 @@ Status StorageManager::object_move(
         std::string("Cannot move object '") + old_path +
         "'; Invalid TileDB object"));
 
+  RETURN_NOT_OK(write_buffers_flush(old_uri));
+
   return vfs_->move_dir(old_uri, new_uri);
 }
 
@@ -546,10 +610,21 @@ Status StorageManager::init(Config* config) {
   fragment_metadata_cache_ =
       new LRUCache(sm_params.fragment_metadata_cache_size_);
   tile_cache_ = new LRUCache(sm_params.tile_cache_size_);
+  memory_tracker_->set_buffer_pool(
+      std::make_shared<BufferPool>(sm_params.buffer_pool_size_));
   async_thread_[0] = new std::thread(async_start, this, 0);
   async_thread_[1] = new std::thread(async_start, this, 1);
+  compute_tp_ = new (std::nothrow)
+      ThreadPool(std::max<uint64_t>(sm_params.num_compute_threads_, 1));
+  if (compute_tp_ == nullptr)
+    return LOG_STATUS(Status::StorageManagerError(
+        "Cannot initialize storage manager; Compute thread pool allocation "
+        "failed"));
   vfs_ = new VFS();
   RETURN_NOT_OK(vfs_->init(config_.vfs_params()));
+  if (sm_params.auto_consolidation_interval_ms_ != 0)
+    auto_consolidation_thread_ =
+        new std::thread(auto_consolidation_start, this);
   return Status::Ok();
 }
 
@@ -695,6 +770,52 @@ Status StorageManager::load_fragment_metadata(
   return st;
 }
 
+Status StorageManager::memory_budget_reserve(uint64_t nbytes) {
+  auto sm_params = config_.sm_params();
+  auto budget = sm_params.memory_budget_;
+  if (budget != 0 && nbytes > budget) {
+    STATS_COUNTER_ADD(memory_budget_rejections, 1);
+    return LOG_STATUS(Status::StorageManagerError(
+        "Cannot reserve memory; The query requires an estimated " +
+        std::to_string(nbytes) + " bytes, which exceeds the memory budget of " +
+        std::to_string(budget) + " bytes"));
+  }
+
+  // Wait until enough budget is released
+  std::unique_lock<std::mutex> lck(memory_budget_mtx_);
+  if (budget != 0 && memory_budget_reserved_ + nbytes > budget) {
+    STATS_COUNTER_ADD(memory_budget_waits, 1);
+    auto timeout =
+        std::chrono::milliseconds(sm_params.memory_budget_timeout_ms_);
+    if (!memory_budget_cv_.wait_for(lck, timeout, [&]() {
+          return memory_budget_reserved_ + nbytes <= budget;
+        })) {
+      STATS_COUNTER_ADD(memory_budget_rejections, 1);
+      return LOG_STATUS(Status::StorageManagerError(
+          "Cannot reserve memory; Memory budget exhausted by other queries"));
+    }
+  }
+  memory_budget_reserved_ += nbytes;
+
+  return Status::Ok();
+}
+
+void StorageManager::memory_budget_release(uint64_t nbytes) {
+  if (nbytes == 0)
+    return;
+
+  {
+    std::unique_lock<std::mutex> lck(memory_budget_mtx_);
+    assert(memory_budget_reserved_ >= nbytes);
+    memory_budget_reserved_ -= nbytes;
+  }
+  memory_budget_cv_.notify_all();
+}
+
+const std::shared_ptr<MemoryTracker>& StorageManager::memory_tracker() const {
+  return memory_tracker_;
+}
+
 Status StorageManager::object_type(const URI& uri, ObjectType* type) const {
   bool is_group;
   RETURN_NOT_OK(this->is_group(uri, &is_group));
@@ -937,20 +1058,19 @@ Status StorageManager::query_init(
 }
 
 Status StorageManager::query_submit(Query* query) {
-  // Initialize query
-  if (query->status() != QueryStatus::INCOMPLETE)
-    RETURN_NOT_OK(query->init());
+  ++queries_in_progress_;
+  Status st = query_process(query);
+  --queries_in_progress_;
 
-  // Based on the query type, invoke the appropriate call
-  QueryType query_type = query->type();
-  if (query_type == QueryType::READ)
-    return query->read();
-
-  return query->write();
+  return st;
 }
 
 Status StorageManager::query_submit_async(
     Query* query, std::function<void(void*)> callback, void* callback_data) {
+  // Async writes are not buffered, but land after the buffered cells
+  if (query->type() == QueryType::WRITE)
+    RETURN_NOT_OK(write_buffers_flush(query->array_schema()->array_uri()));
+
   // Initialize query
   if (query->status() != QueryStatus::INCOMPLETE)
     RETURN_NOT_OK(query->init());
@@ -969,9 +1089,8 @@ Status StorageManager::read_from_cache(
   std::stringstream key;
   key << uri.to_string() << "+" << offset;
   RETURN_NOT_OK(buffer->realloc(nbytes));
-  RETURN_NOT_OK(
-      tile_cache_->read(key.str(), buffer->data(), 0, nbytes, in_cache));
-  buffer->set_size(nbytes);
+  buffer->reset_size();
+  RETURN_NOT_OK(tile_cache_->read(key.str(), buffer, in_cache));
   buffer->reset_offset();
 
   return Status::Ok();
@@ -987,6 +1106,18 @@ Status StorageManager::read(
   return Status::Ok();
 }
 
+Status StorageManager::read_up_to(
+    const URI& uri, uint64_t offset, Buffer* buffer, uint64_t nbytes) const {
+  uint64_t nbytes_read;
+  RETURN_NOT_OK(buffer->realloc(nbytes));
+  RETURN_NOT_OK(
+      vfs_->read_up_to(uri, offset, buffer->data(), nbytes, &nbytes_read));
+  buffer->set_size(nbytes_read);
+  buffer->reset_offset();
+
+  return Status::Ok();
+}
+
 Status StorageManager::store_array_schema(ArraySchema* array_schema) {
   auto& array_uri = array_schema->array_uri();
   URI array_schema_uri = array_uri.join_path(constants::array_schema_filename);
@@ -1025,6 +1156,41 @@ Status StorageManager::store_array_schema(ArraySchema* array_schema) {
   return st;
 }
 
+Status StorageManager::store_consolidated_fragment_metadata(
+    const URI& array_uri, Buffer* buff) {
+  // Write to a hidden file first, so that readers never see a partial file
+  URI uri = array_uri.join_path(
+      std::string(constants::consolidated_fragment_metadata_filename));
+  URI tmp_uri = array_uri.join_path(
+      std::string(".") + constants::consolidated_fragment_metadata_filename);
+  bool is_file;
+  RETURN_NOT_OK(vfs_->is_file(tmp_uri, &is_file));
+  if (is_file)
+    RETURN_NOT_OK(vfs_->remove_file(tmp_uri));
+
+  buff->reset_offset();
+  auto tile = new Tile(
+      constants::generic_tile_datatype,
+      constants::generic_tile_compressor,
+      constants::generic_tile_compression_level,
+      constants::generic_tile_cell_size,
+      0,
+      buff,
+      false);
+
+  auto tile_io = new TileIO(this, tmp_uri);
+  Status st = tile_io->write_generic(tile);
+  if (st.ok())
+    st = close_file(tmp_uri);
+  if (st.ok())
+    st = vfs_->move_file(tmp_uri, uri);
+
+  delete tile;
+  delete tile_io;
+
+  return st;
+}
+
 Status StorageManager::store_fragment_metadata(FragmentMetadata* metadata) {
   // Do nothing if fragment directory does not exist. The fragment directory
   // is created only when some attribute file is written
@@ -1230,6 +1396,10 @@ Status StorageManager::array_open(
     QueryType type,
     const ArraySchema** array_schema,
     std::vector<FragmentMetadata*>* fragment_metadata) {
+  // Readers see the buffered cells of the array
+  if (type == QueryType::READ)
+    RETURN_NOT_OK(write_buffers_flush(array_uri));
+
   // Check if array exists
   bool is_array = false;
   RETURN_NOT_OK(this->is_array(array_uri, &is_array));
@@ -1242,6 +1412,12 @@ Status StorageManager::array_open(
         Status::StorageManagerError("Cannot open array; Array does not exist"));
   }
 
+  // Register the array for auto-consolidation
+  if (auto_consolidation_thread_ != nullptr) {
+    std::lock_guard<std::mutex> lock(auto_consolidation_mtx_);
+    auto_consolidation_arrays_.insert(array_uri.to_string());
+  }
+
   // Lock the array in shared mode
   RETURN_NOT_OK(object_lock(array_uri, SLOCK));
 
@@ -1283,14 +1459,100 @@ Status StorageManager::array_open(
   return Status::Ok();
 }
 
+bool StorageManager::array_is_open(const URI& array_uri) {
+  std::lock_guard<std::mutex> lock(open_array_mtx_);
+  return open_arrays_.find(array_uri.to_string()) != open_arrays_.end();
+}
+
 Status StorageManager::array_open_error(OpenArray* open_array) {
   open_array->mtx_unlock();
   return array_close(open_array->array_uri());
 }
 
+void StorageManager::auto_consolidation_process() {
+  // For easy reference
+  auto sm_params = config_.sm_params();
+  auto interval =
+      std::chrono::milliseconds(sm_params.auto_consolidation_interval_ms_);
+  auto io_budget = sm_params.auto_consolidation_io_budget_;
+  auto resume_time = std::chrono::steady_clock::now();
+
+  std::unique_lock<std::mutex> lock(auto_consolidation_mtx_);
+  while (!auto_consolidation_done_) {
+    auto_consolidation_cv_.wait_for(
+        lock, interval, [this] { return auto_consolidation_done_; });
+    if (auto_consolidation_done_)
+      break;
+
+    // Yield to the queries and stay within the I/O budget
+    if (queries_in_progress_ > 0 ||
+        std::chrono::steady_clock::now() < resume_time)
+      continue;
+
+    std::vector<std::string> arrays(
+        auto_consolidation_arrays_.begin(), auto_consolidation_arrays_.end());
+    lock.unlock();
+
+    // Consolidate the first array that is due
+    std::vector<std::string> removed;
+    for (const auto& array : arrays) {
+      URI array_uri(array);
+      bool exists = false;
+      Status st = is_array(array_uri, &exists);
+      if (st.ok() && !exists)
+        st = is_kv(array_uri, &exists);
+      if (st.ok() && !exists) {
+        removed.push_back(array);
+        continue;
+      }
+
+      bool due = false;
+      uint64_t size = 0;
+      if (st.ok())
+        st = consolidator_->consolidation_due(array.c_str(), &due, &size);
+      if (st.ok() && due && queries_in_progress_ == 0 &&
+          !array_is_open(array_uri)) {
+        std::lock_guard<std::mutex> consolidation_lock(consolidation_mtx_);
+        st = consolidator_->consolidate(array.c_str());
+        if (io_budget != 0)
+          resume_time = std::chrono::steady_clock::now() +
+                        std::chrono::milliseconds(size * 1000 / io_budget);
+      }
+      if (!st.ok())
+        LOG_STATUS(st);
+      if (due)
+        break;
+    }
+
+    lock.lock();
+    for (const auto& array : removed)
+      auto_consolidation_arrays_.erase(array);
+  }
+}
+
+void StorageManager::auto_consolidation_start(
+    StorageManager* storage_manager) {
+  storage_manager->auto_consolidation_process();
+}
+
+void StorageManager::auto_consolidation_stop() {
+  // Check if auto-consolidation was never started
+  if (auto_consolidation_thread_ == nullptr)
+    return;
+
+  {
+    std::lock_guard<std::mutex> lock(auto_consolidation_mtx_);
+    auto_consolidation_done_ = true;
+  }
+  auto_consolidation_cv_.notify_one();
+  auto_consolidation_thread_->join();
+}
+
 void StorageManager::async_process_query(Query* query) {
   // For easy reference
+  ++queries_in_progress_;
   Status st = query->async_process();
+  --queries_in_progress_;
   if (!st.ok())
     LOG_STATUS(st);
 }
@@ -1326,7 +1588,9 @@ void StorageManager::async_stop() {
 }
 
 Status StorageManager::get_fragment_uris(
-    const URI& array_uri, std::vector<URI>* fragment_uris) const {
+    const URI& array_uri,
+    const std::map<std::string, ConsolidatedEntry>& consolidated,
+    std::vector<URI>* fragment_uris) const {
   // Get all uris in the array directory
   std::vector<URI> uris;
   RETURN_NOT_OK(vfs_->ls(array_uri.join_path(""), &uris));
@@ -1334,10 +1598,13 @@ Status StorageManager::get_fragment_uris(
   // Get only the fragment uris
   bool exists;
   for (auto& uri : uris) {
-    if (utils::starts_with(uri.last_path_part(), "."))
+    auto name = uri.last_path_part();
+    if (utils::starts_with(name, "."))
       continue;
 
-    RETURN_NOT_OK(is_fragment(uri, &exists))
+    exists = consolidated.find(name) != consolidated.end();
+    if (!exists)
+      RETURN_NOT_OK(is_fragment(uri, &exists))
     if (exists)
       fragment_uris->push_back(uri);
   }
@@ -1345,6 +1612,69 @@ Status StorageManager::get_fragment_uris(
   return Status::Ok();
 }
 
+Status StorageManager::load_consolidated_fragment_metadata(
+    const URI& array_uri,
+    Buffer** buff,
+    std::map<std::string, ConsolidatedEntry>* consolidated) {
+  *buff = nullptr;
+  URI uri = array_uri.join_path(
+      std::string(constants::consolidated_fragment_metadata_filename));
+  bool is_file;
+  RETURN_NOT_OK(vfs_->is_file(uri, &is_file));
+  if (!is_file)
+    return Status::Ok();
+
+  // The file may be replaced concurrently, in which case it is ignored
+  auto tile_io = new TileIO(this, uri);
+  auto tile = (Tile*)nullptr;
+  Status st = tile_io->read_generic(&tile, 0);
+  delete tile_io;
+  if (!st.ok())
+    return Status::Ok();
+  tile->disown_buff();
+  *buff = tile->buffer();
+  delete tile;
+
+  // Index the entries of the fragments
+  ConstBuffer cbuff(*buff);
+  uint32_t version = 0;
+  uint64_t fragment_num = 0;
+  st = cbuff.read(&version, sizeof(uint32_t));
+  if (st.ok() && version == constants::consolidated_fragment_metadata_version)
+    st = cbuff.read(&fragment_num, sizeof(uint64_t));
+  for (uint64_t i = 0; st.ok() && i < fragment_num; ++i) {
+    uint64_t name_size = 0, size = 0;
+    std::string name;
+    char dense = 0;
+    st = cbuff.read(&name_size, sizeof(uint64_t));
+    if (st.ok() && name_size <= cbuff.nbytes_left_to_read()) {
+      name.resize(name_size);
+      st = cbuff.read(&name[0], name_size);
+    }
+    if (st.ok())
+      st = cbuff.read(&dense, sizeof(char));
+    if (st.ok())
+      st = cbuff.read(&size, sizeof(uint64_t));
+    if (st.ok() && size > cbuff.nbytes_left_to_read())
+      st = Status::StorageManagerError(
+          "Cannot load consolidated fragment metadata; Invalid entry size");
+    if (st.ok()) {
+      (*consolidated)[name] = {dense != 0, cbuff.offset(), size};
+      cbuff.advance_offset(size);
+    }
+  }
+
+  // A corrupt file is ignored as well
+  if (!st.ok()) {
+    LOG_STATUS(st);
+    consolidated->clear();
+    delete *buff;
+    *buff = nullptr;
+  }
+
+  return Status::Ok();
+}
+
 Status StorageManager::open_array_get_entry(
     const URI& array_uri, OpenArray** open_array) {
   // Find the open array entry
@@ -1375,27 +1705,48 @@ Status StorageManager::open_array_load_array_schema(
 
 Status StorageManager::open_array_load_fragment_metadata(
     OpenArray* open_array, std::vector<FragmentMetadata*>* fragment_metadata) {
+  // Load the consolidated fragment metadata, if any
+  Buffer* buff;
+  std::map<std::string, ConsolidatedEntry> consolidated;
+  const URI& array_uri = open_array->array_uri();
+  RETURN_NOT_OK(
+      load_consolidated_fragment_metadata(array_uri, &buff, &consolidated));
+
   // Get all the fragment uris, sorted by timestamp
   std::vector<URI> fragment_uris;
-  const URI& array_uri = open_array->array_uri();
-  RETURN_NOT_OK(get_fragment_uris(array_uri, &fragment_uris));
+  RETURN_NOT_OK_ELSE(
+      get_fragment_uris(array_uri, consolidated, &fragment_uris), delete buff);
   sort_fragment_uris(&fragment_uris);
 
-  if (fragment_uris.empty())
-    return Status::Ok();
-
   // Load the metadata for each fragment
+  Status st;
   for (auto& uri : fragment_uris) {
     // Find metadata entry in open array
     auto metadata = open_array->fragment_metadata_get(uri);
     // If not found, load metadata and store in open array
     if (metadata == nullptr) {
-      URI coords_uri = uri.join_path(
-          std::string("/") + constants::coords + constants::file_suffix);
-      bool sparse;
-      RETURN_NOT_OK(vfs_->is_file(coords_uri, &sparse));
-      metadata = new FragmentMetadata(open_array->array_schema(), !sparse, uri);
-      RETURN_NOT_OK_ELSE(load_fragment_metadata(metadata), delete metadata);
+      auto it = consolidated.find(uri.last_path_part());
+      if (it != consolidated.end()) {
+        // Deserialize from the consolidated fragment metadata
+        metadata = new FragmentMetadata(
+            open_array->array_schema(), it->second.dense_, uri);
+        ConstBuffer cbuff(buff->data(it->second.offset_), it->second.size_);
+        st = metadata->deserialize(&cbuff);
+      } else {
+        URI coords_uri = uri.join_path(
+            std::string("/") + constants::coords + constants::file_suffix);
+        bool sparse;
+        st = vfs_->is_file(coords_uri, &sparse);
+        if (!st.ok())
+          break;
+        metadata =
+            new FragmentMetadata(open_array->array_schema(), !sparse, uri);
+        st = load_fragment_metadata(metadata);
+      }
+      if (!st.ok()) {
+        delete metadata;
+        break;
+      }
       open_array->fragment_metadata_add(metadata);
     }
 
@@ -1403,7 +1754,27 @@ Status StorageManager::open_array_load_fragment_metadata(
     fragment_metadata->push_back(metadata);
   }
 
-  return Status::Ok();
+  delete buff;
+
+  return st;
+}
+
+Status StorageManager::query_process(Query* query) {
+  // Initialize query, unless its cells are buffered
+  if (query->status() != QueryStatus::INCOMPLETE) {
+    bool buffered = false;
+    RETURN_NOT_OK(write_buffer_append(query, &buffered));
+    if (buffered)
+      return Status::Ok();
+    RETURN_NOT_OK(query->init());
+  }
+
+  // Based on the query type, invoke the appropriate call
+  QueryType query_type = query->type();
+  if (query_type == QueryType::READ)
+    return query->read();
+
+  return query->write();
 }
 
 void StorageManager::sort_fragment_uris(std::vector<URI>* fragment_uris) const {
@@ -1442,5 +1813,62 @@ void StorageManager::sort_fragment_uris(std::vector<URI>* fragment_uris) const {
   *fragment_uris = fragment_uris_sorted;
 }
 
+Status StorageManager::write_buffer_append(Query* query, bool* buffered) {
+  *buffered = false;
+  if (query->type() != QueryType::WRITE)
+    return Status::Ok();
+
+  auto sm_params = config_.sm_params();
+  if (sm_params.write_buffer_size_ == 0)
+    return Status::Ok();
+
+  // Out-of-core unordered writes gather their cells themselves
+  auto array_uri = query->array_schema()->array_uri();
+  if (!WriteBuffer::bufferable(query) || sm_params.external_sort_memory_ != 0)
+    return write_buffers_flush(array_uri);
+
+  // Get or create the write buffer of the array
+  WriteBuffer* write_buffer;
+  write_buffers_mtx_.lock();
+  auto& entry = write_buffers_[array_uri.to_string()];
+  if (entry == nullptr)
+    entry = new WriteBuffer(
+        this,
+        array_uri,
+        sm_params.write_buffer_size_,
+        sm_params.write_buffer_flush_ms_);
+  write_buffer = entry;
+  write_buffers_mtx_.unlock();
+
+  RETURN_NOT_OK(write_buffer->append(query, buffered));
+  if (*buffered)
+    query->set_status(QueryStatus::COMPLETED);
+
+  return Status::Ok();
+}
+
+std::vector<WriteBuffer*> StorageManager::write_buffers(const URI& uri) {
+  std::string prefix = uri.to_string();
+  if (!prefix.empty() && prefix.back() == '/')
+    prefix.pop_back();
+  std::vector<WriteBuffer*> ret;
+  std::unique_lock<std::mutex> lck(write_buffers_mtx_);
+  for (const auto& entry : write_buffers_) {
+    const auto& array_uri = entry.first;
+    if (prefix.empty() || array_uri == prefix ||
+        array_uri.compare(0, prefix.size() + 1, prefix + "/") == 0)
+      ret.push_back(entry.second);
+  }
+
+  return ret;
+}
+
+Status StorageManager::write_buffers_flush(const URI& uri) {
+  for (auto write_buffer : write_buffers(uri))
+    RETURN_NOT_OK(write_buffer->flush());
+
+  return Status::Ok();
+}
+
 }  // namespace sm
 }  // namespace tiledb
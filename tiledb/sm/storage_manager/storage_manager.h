@@ -34,12 +34,14 @@
 #ifndef TILEDB_STORAGE_MANAGER_H
 #define TILEDB_STORAGE_MANAGER_H
 
+#include <atomic>
 #include <condition_variable>
 #include <functional>
 #include <list>
 #include <map>
 #include <mutex>
 #include <queue>
+#include <set>
 #include <string>
 #include <thread>
 
@@ -48,13 +50,16 @@
 #include "tiledb/sm/enums/object_type.h"
 #include "tiledb/sm/enums/walk_order.h"
 #include "tiledb/sm/filesystem/vfs.h"
+#include "tiledb/sm/misc/memory_tracker.h"
 #include "tiledb/sm/misc/status.h"
+#include "tiledb/sm/misc/thread_pool.h"
 #include "tiledb/sm/misc/uri.h"
 #include "tiledb/sm/query/query.h"
 #include "tiledb/sm/storage_manager/config.h"
 #include "tiledb/sm/storage_manager/consolidator.h"
 #include "tiledb/sm/storage_manager/locked_object.h"
 #include "tiledb/sm/storage_manager/open_array.h"
+#include "tiledb/sm/storage_manager/write_buffer.h"
 
 namespace tiledb {
 namespace sm {
@@ -186,6 +191,16 @@ class StorageManager {
    */
   Status array_consolidate(const char* array_name);
 
+  /**
+   * Consolidates the metadata of all the fragments of an array into a single
+   * file, so that opening the array reads one file instead of one per
+   * fragment.
+   *
+   * @param array_name The name of the array whose metadata is consolidated.
+   * @return Status
+   */
+  Status array_consolidate_metadata(const char* array_name);
+
   /**
    * Creates a TileDB array storing its schema.
    *
@@ -195,6 +210,15 @@ class StorageManager {
    */
   Status array_create(const URI& array_uri, ArraySchema* array_schema);
 
+  /**
+   * Writes the cells of an array that are buffered in memory (see
+   * `sm.write_buffer_size`) to a new fragment.
+   *
+   * @param array_name The array name.
+   * @return Status
+   */
+  Status array_flush_writes(const char* array_name);
+
   /**
    * Retrieves the non-empty domain from an array. This is the union of the
    * non-empty domains of the array fragments.
@@ -237,6 +261,13 @@ class StorageManager {
    */
   Status async_push_query(Query* query, int i);
 
+  /**
+   * Returns the thread pool that runs the compute-heavy parts of queries
+   * (`sm.num_compute_threads`). A task running on the pool must not wait on
+   * other tasks it enqueues to it, as that may deadlock.
+   */
+  ThreadPool* compute_tp() const;
+
   /** Returns the configuration parameters. */
   Config config() const;
 
@@ -345,14 +376,40 @@ class StorageManager {
    */
   Status load_fragment_metadata(FragmentMetadata* metadata);
 
-  /** Removes a TileDB object (group, array, kv). */
-  Status object_remove(const char* path) const;
+  /**
+   * Reserves `nbytes` bytes of the memory budget (`sm.memory_budget`) of
+   * the storage manager. If not enough budget is available, it waits for
+   * up to `sm.memory_budget_timeout_ms` ms for other queries to release
+   * their reservations.
+   *
+   * @param nbytes The number of bytes to reserve.
+   * @return Status An error if `nbytes` exceeds the entire budget, or if
+   *     the budget was not released on time.
+   */
+  Status memory_budget_reserve(uint64_t nbytes);
+
+  /** Releases `nbytes` bytes reserved with `memory_budget_reserve`. */
+  void memory_budget_release(uint64_t nbytes);
+
+  /**
+   * Returns the tracker of the memory allocated on behalf of this storage
+   * manager (i.e., context). It is the parent of all query trackers and
+   * provides the buffer pool of the storage manager (`sm.buffer_pool_size`).
+   */
+  const std::shared_ptr<MemoryTracker>& memory_tracker() const;
+
+  /**
+   * Removes a TileDB object (group, array, kv), discarding the cells
+   * buffered for the arrays it contains.
+   */
+  Status object_remove(const char* path);
 
   /**
    * Renames a TileDB object (group, array, kv). If
-   * `new_path` exists, `new_path` will be overwritten.
+   * `new_path` exists, `new_path` will be overwritten. The cells buffered
+   * for the arrays it contains are flushed first.
    */
-  Status object_move(const char* old_path, const char* new_path) const;
+  Status object_move(const char* old_path, const char* new_path);
 
   /**
    * Creates a new object iterator for the input path. The iteration
@@ -503,8 +560,12 @@ class StorageManager {
    * @param uri The URI of the cached object.
    * @param offset The offset of the cached object.
    * @param buffer The buffer to write into. The function reallocates memory
-   *     for the buffer, sets its size to *nbytes* and resets its offset.
-   * @param nbytes Number of bytes to be read.
+   *     for the buffer, sets its size to the size of the cached object and
+   *     resets its offset.
+   * @param nbytes The expected size of the cached object, used to allocate
+   *     the buffer. The object may be smaller, e.g., for tiles that are
+   *     encoded to a different size than the one recorded in the fragment
+   *     metadata.
    * @param in_cache This is set to `true` if the object is in the cache,
    *     and `false` otherwise.
    * @return Status.
@@ -529,6 +590,22 @@ class StorageManager {
   Status read(
       const URI& uri, uint64_t offset, Buffer* buffer, uint64_t nbytes) const;
 
+  /**
+   * Reads up to the input number of bytes from a file into the input buffer,
+   * in a single request to the filesystem.
+   *
+   * @param uri The URI file to read from.
+   * @param offset The offset in the file the read will start from.
+   * @param buffer The buffer to write into. The function reallocates memory
+   *     for the buffer, sets its size to the number of bytes read (which is
+   *     smaller than *nbytes* if the end of the file is reached) and resets
+   *     its offset.
+   * @param nbytes The maximum number of bytes to read.
+   * @return Status.
+   */
+  Status read_up_to(
+      const URI& uri, uint64_t offset, Buffer* buffer, uint64_t nbytes) const;
+
   /**
    * Stores an array schema into persistent storage.
    *
@@ -537,6 +614,17 @@ class StorageManager {
    */
   Status store_array_schema(ArraySchema* array_schema);
 
+  /**
+   * Stores the consolidated fragment metadata of an array, replacing the
+   * existing one.
+   *
+   * @param array_uri The array URI.
+   * @param buff The serialized consolidated fragment metadata.
+   * @return Status
+   */
+  Status store_consolidated_fragment_metadata(
+      const URI& array_uri, Buffer* buff);
+
   /**
    * Stores the fragment metadata into persistent storage.
    *
@@ -578,6 +666,20 @@ class StorageManager {
   Status write(const URI& uri, Buffer* buffer) const;
 
  private:
+  /* ********************************* */
+  /*      PRIVATE TYPE DEFINITIONS     */
+  /* ********************************* */
+
+  /** The entry of a fragment in the consolidated fragment metadata. */
+  struct ConsolidatedEntry {
+    /** `True` if the fragment is dense. */
+    bool dense_;
+    /** The offset of the fragment metadata in the file. */
+    uint64_t offset_;
+    /** The size of the fragment metadata. */
+    uint64_t size_;
+  };
+
   /* ********************************* */
   /*        PRIVATE ATTRIBUTES         */
   /* ********************************* */
@@ -615,12 +717,39 @@ class StorageManager {
    */
   std::thread* async_thread_[2];
 
+  /**
+   * The URIs of the arrays opened by this storage manager, which the
+   * auto-consolidation checks (see `sm.auto_consolidation_interval_ms`).
+   */
+  std::set<std::string> auto_consolidation_arrays_;
+
+  /** Wakes up the auto-consolidation thread. */
+  std::condition_variable auto_consolidation_cv_;
+
+  /** If true, the auto-consolidation thread will be eventually terminated. */
+  bool auto_consolidation_done_;
+
+  /**
+   * Mutex protecting `auto_consolidation_arrays_` and
+   * `auto_consolidation_done_`.
+   */
+  std::mutex auto_consolidation_mtx_;
+
+  /** The auto-consolidation thread, if auto-consolidation is enabled. */
+  std::thread* auto_consolidation_thread_;
+
+  /** The thread pool for compute-heavy query work. */
+  ThreadPool* compute_tp_;
+
   /** Stores the TileDB configuration parameters. */
   Config config_;
 
   /** Object that handles array consolidation. */
   Consolidator* consolidator_;
 
+  /** Serializes the consolidations of this storage manager. */
+  std::mutex consolidation_mtx_;
+
   /** A fragment metadata cache. */
   LRUCache* fragment_metadata_cache_;
 
@@ -633,6 +762,18 @@ class StorageManager {
    */
   std::map<std::string, LockedObject*> locked_objs_;
 
+  /** Notifies the queries waiting for memory budget. */
+  std::condition_variable memory_budget_cv_;
+
+  /** Mutex protecting `memory_budget_reserved_`. */
+  std::mutex memory_budget_mtx_;
+
+  /** The number of bytes of the memory budget currently reserved. */
+  uint64_t memory_budget_reserved_;
+
+  /** Tracks the memory allocated by the queries of this storage manager. */
+  std::shared_ptr<MemoryTracker> memory_tracker_;
+
   /** Mutex for managing OpenArray objects. */
   std::mutex open_array_mtx_;
 
@@ -642,6 +783,12 @@ class StorageManager {
    */
   std::map<std::string, OpenArray*> open_arrays_;
 
+  /**
+   * The number of queries currently submitted. The auto-consolidation
+   * starts only when it is zero.
+   */
+  std::atomic<uint64_t> queries_in_progress_;
+
   /** A tile cache. */
   LRUCache* tile_cache_;
 
@@ -651,6 +798,16 @@ class StorageManager {
    */
   VFS* vfs_;
 
+  /**
+   * The write buffers of the arrays that received buffered writes (see
+   * `sm.write_buffer_size`), indexed by array URI. They are kept until the
+   * storage manager is destroyed.
+   */
+  std::map<std::string, WriteBuffer*> write_buffers_;
+
+  /** Mutex for managing the write buffers. */
+  std::mutex write_buffers_mtx_;
+
   /* ********************************* */
   /*         PRIVATE METHODS           */
   /* ********************************* */
@@ -688,11 +845,35 @@ class StorageManager {
       const ArraySchema** array_schema,
       std::vector<FragmentMetadata*>* fragment_metadata);
 
+  /** Returns `true` if the input array is open in this storage manager. */
+  bool array_is_open(const URI& array_uri);
+
   /**
    * Invokes in case an error occurs in array_open. It is a clean-up function.
    */
   Status array_open_error(OpenArray* open_array);
 
+  /**
+   * Consolidates the first of the opened arrays that is due for
+   * consolidation every `sm.auto_consolidation_interval_ms`, until
+   * `auto_consolidation_stop` is called. No consolidation starts while
+   * queries are in progress or the array is open in this storage manager.
+   * A consolidation holds the exclusive lock of the array, so queries that
+   * open the array while it runs (e.g., from other contexts) wait for it.
+   */
+  void auto_consolidation_process();
+
+  /**
+   * Starts the auto-consolidation.
+   *
+   * @param storage_manager The storage manager object that handles the
+   *     auto-consolidation thread.
+   */
+  static void auto_consolidation_start(StorageManager* storage_manager);
+
+  /** Stops the auto-consolidation. */
+  void auto_consolidation_stop();
+
   /**
    * Starts listening to async queries.
    *
@@ -719,9 +900,33 @@ class StorageManager {
    */
   void async_process_queries(int i);
 
-  /** Retrieves all the fragment URI's of an array. */
+  /**
+   * Retrieves all the fragment URI's of an array. The URIs named in
+   * `consolidated` are known to be fragments and are not checked.
+   */
   Status get_fragment_uris(
-      const URI& array_uri, std::vector<URI>* fragment_uris) const;
+      const URI& array_uri,
+      const std::map<std::string, ConsolidatedEntry>& consolidated,
+      std::vector<URI>* fragment_uris) const;
+
+  /**
+   * Loads the consolidated fragment metadata file of an array (see
+   * `array_consolidate_metadata`). If the file does not exist, cannot be
+   * read or has another format version, nothing is loaded and the
+   * metadata of each fragment is read from its own file.
+   *
+   * @param array_uri The array URI.
+   * @param buff Set to the contents of the file, or `nullptr`. It must be
+   *     deleted by the caller.
+   * @param consolidated Maps the name of each fragment in the file to
+   *     whether it is dense and the offset and size of its metadata in
+   *     `buff`.
+   * @return Status
+   */
+  Status load_consolidated_fragment_metadata(
+      const URI& array_uri,
+      Buffer** buff,
+      std::map<std::string, ConsolidatedEntry>* consolidated);
 
   /** Retrieves an open array entry for the given array URI. */
   Status open_array_get_entry(const URI& array_uri, OpenArray** open_array);
@@ -734,11 +939,36 @@ class StorageManager {
   Status open_array_load_fragment_metadata(
       OpenArray* open_array, std::vector<FragmentMetadata*>* fragment_metadata);
 
+  /** Initializes (if needed) and processes a query. */
+  Status query_process(Query* query);
+
   /**
    * Sorts the input fragment URIs in ascending timestamp order, breaking
    * ties using the process id.
    */
   void sort_fragment_uris(std::vector<URI>* fragment_uris) const;
+
+  /**
+   * Appends the cells of the input write query to the write buffer of its
+   * array, if write buffering is enabled and the query is bufferable. Any
+   * other write flushes the write buffer of the array, so that its cells
+   * land in an older fragment than those of the query.
+   *
+   * @param query The query.
+   * @param buffered Set to `true` if the cells were buffered, in which case
+   *     the query is completed.
+   * @return Status
+   */
+  Status write_buffer_append(Query* query, bool* buffered);
+
+  /**
+   * Returns the write buffers of the arrays at or under the input URI (or
+   * of all the arrays, if the URI is empty).
+   */
+  std::vector<WriteBuffer*> write_buffers(const URI& uri);
+
+  /** Flushes the write buffers of the arrays at or under the input URI. */
+  Status write_buffers_flush(const URI& uri);
 };
 
 }  // namespace sm
@@ -0,0 +1,271 @@
+/**
+ * @file   write_buffer.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2018 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file implements class WriteBuffer.
+ */
+
+#include "tiledb/sm/storage_manager/write_buffer.h"
+#include "tiledb/sm/misc/constants.h"
+#include "tiledb/sm/misc/logger.h"
+#include "tiledb/sm/misc/utils.h"
+#include "tiledb/sm/query/query.h"
+#include "tiledb/sm/storage_manager/storage_manager.h"
+
+#include <cstring>
+#include <set>
+
+namespace tiledb {
+namespace sm {
+
+/* ****************************** */
+/*   CONSTRUCTORS & DESTRUCTORS   */
+/* ****************************** */
+
+WriteBuffer::WriteBuffer(
+    StorageManager* storage_manager,
+    const URI& array_uri,
+    uint64_t max_size,
+    uint64_t flush_ms)
+    : array_uri_(array_uri)
+    , cell_num_(0)
+    , first_append_ms_(0)
+    , flush_ms_(flush_ms)
+    , max_size_(max_size)
+    , size_(0)
+    , storage_manager_(storage_manager) {
+}
+
+WriteBuffer::~WriteBuffer() = default;
+
+/* ****************************** */
+/*               API              */
+/* ****************************** */
+
+Status WriteBuffer::append(const Query* query, bool* appended) {
+  std::unique_lock<std::mutex> lck(mtx_);
+  *appended = false;
+
+  // Compute the size of the new cells
+  unsigned buffer_num = 0;
+  auto array_schema = query->array_schema();
+  RETURN_NOT_OK(array_schema->buffer_num(query->attribute_ids(), &buffer_num));
+  uint64_t nbytes = 0;
+  for (unsigned i = 0; i < buffer_num; ++i)
+    nbytes += query->buffer_sizes()[i];
+
+  // Large writes bypass the buffer, after the cells buffered before them
+  if (nbytes > max_size_)
+    return flush_unsafe();
+
+  // Make room for the new cells, and write the cells they overwrite first
+  if (size_ + nbytes > max_size_ || buffered(query))
+    RETURN_NOT_OK(flush_unsafe());
+
+  RETURN_NOT_OK(append_cells(query));
+  *appended = true;
+
+  // Flush if the buffer got full or old enough
+  if (size_ >= max_size_ ||
+      (flush_ms_ != 0 && utils::timestamp_ms() - first_append_ms_ >= flush_ms_))
+    return flush_unsafe();
+
+  return Status::Ok();
+}
+
+bool WriteBuffer::bufferable(const Query* query) {
+  auto array_schema = query->array_schema();
+  if (query->type() != QueryType::WRITE ||
+      query->layout() != Layout::UNORDERED || array_schema->dense())
+    return false;
+
+  // All the attributes and the coordinates must be written
+  const auto& attribute_ids = query->attribute_ids();
+  std::set<unsigned> unique_ids(attribute_ids.begin(), attribute_ids.end());
+  return unique_ids.size() == attribute_ids.size() &&
+         unique_ids.size() == array_schema->attribute_num() + 1;
+}
+
+void WriteBuffer::clear() {
+  std::unique_lock<std::mutex> lck(mtx_);
+  clear_unsafe();
+}
+
+Status WriteBuffer::flush() {
+  std::unique_lock<std::mutex> lck(mtx_);
+  return flush_unsafe();
+}
+
+/* ****************************** */
+/*        PRIVATE METHODS         */
+/* ****************************** */
+
+Status WriteBuffer::append_cells(const Query* query) {
+  // For easy reference
+  auto array_schema = query->array_schema();
+  auto attribute_num = array_schema->attribute_num();
+  const auto& attribute_ids = query->attribute_ids();
+  auto buffers = query->buffers();
+  auto buffer_sizes = query->buffer_sizes();
+
+  // Map each attribute to its first buffer in this write buffer
+  std::vector<unsigned> first_buffer(attribute_num + 1);
+  unsigned buffer_num = 0;
+  for (unsigned i = 0; i <= attribute_num; ++i) {
+    first_buffer[i] = buffer_num;
+    buffer_num += (i < attribute_num && array_schema->var_size(i)) ? 2 : 1;
+  }
+  buffers_.resize(buffer_num);
+
+  // Compute the number of new cells
+  int coords_buffer_i = -1;
+  RETURN_NOT_OK(query->coords_buffer_i(&coords_buffer_i));
+  uint64_t cell_num =
+      buffer_sizes[coords_buffer_i] / array_schema->coords_size();
+
+  // Check the buffer sizes before appending anything
+  unsigned query_buffer_i = 0;
+  for (auto id : attribute_ids) {
+    bool var_size = id != attribute_num && array_schema->var_size(id);
+    uint64_t cell_size = var_size ? constants::cell_var_offset_size :
+                                    array_schema->cell_size(id);
+    if (buffer_sizes[query_buffer_i] != cell_num * cell_size)
+      return LOG_STATUS(Status::StorageManagerError(
+          "Cannot buffer write; Buffer sizes do not match the number of "
+          "cells"));
+    query_buffer_i += var_size ? 2 : 1;
+  }
+
+  // Append the cells
+  query_buffer_i = 0;
+  for (auto id : attribute_ids) {
+    auto& buffer = buffers_[first_buffer[id]];
+    auto data = static_cast<const uint8_t*>(buffers[query_buffer_i]);
+    auto data_size = buffer_sizes[query_buffer_i];
+    if (id == attribute_num || !array_schema->var_size(id)) {
+      buffer.insert(buffer.end(), data, data + data_size);
+      ++query_buffer_i;
+      continue;
+    }
+
+    // Shift the offsets past the values already buffered
+    auto& values = buffers_[first_buffer[id] + 1];
+    auto offsets = static_cast<const uint64_t*>(buffers[query_buffer_i]);
+    uint64_t values_offset = values.size();
+    uint64_t old_size = buffer.size();
+    buffer.resize(old_size + data_size);
+    auto new_offsets = reinterpret_cast<uint64_t*>(&buffer[old_size]);
+    for (uint64_t c = 0; c < cell_num; ++c)
+      new_offsets[c] = offsets[c] + values_offset;
+    auto values_data =
+        static_cast<const uint8_t*>(buffers[query_buffer_i + 1]);
+    values.insert(
+        values.end(),
+        values_data,
+        values_data + buffer_sizes[query_buffer_i + 1]);
+    query_buffer_i += 2;
+  }
+
+  // Index the new coordinates
+  auto coords_size = array_schema->coords_size();
+  auto coords = static_cast<const char*>(buffers[coords_buffer_i]);
+  for (uint64_t c = 0; c < cell_num; ++c)
+    coords_.emplace(coords + c * coords_size, coords_size);
+
+  if (cell_num_ == 0)
+    first_append_ms_ = utils::timestamp_ms();
+  cell_num_ += cell_num;
+  for (unsigned i = 0; i < query_buffer_i; ++i)
+    size_ += buffer_sizes[i];
+
+  return Status::Ok();
+}
+
+bool WriteBuffer::buffered(const Query* query) const {
+  if (cell_num_ == 0)
+    return false;
+
+  int coords_buffer_i = -1;
+  if (!query->coords_buffer_i(&coords_buffer_i).ok())
+    return false;
+  auto coords_size = query->array_schema()->coords_size();
+  auto coords = static_cast<const char*>(query->buffers()[coords_buffer_i]);
+  uint64_t cell_num = query->buffer_sizes()[coords_buffer_i] / coords_size;
+  for (uint64_t c = 0; c < cell_num; ++c) {
+    if (coords_.count(std::string(coords + c * coords_size, coords_size)))
+      return true;
+  }
+
+  return false;
+}
+
+void WriteBuffer::clear_unsafe() {
+  buffers_.clear();
+  coords_.clear();
+  cell_num_ = 0;
+  first_append_ms_ = 0;
+  size_ = 0;
+}
+
+Status WriteBuffer::flush_unsafe() {
+  if (cell_num_ == 0)
+    return Status::Ok();
+
+  std::vector<void*> buffers;
+  std::vector<uint64_t> buffer_sizes;
+  for (auto& buffer : buffers_) {
+    buffers.push_back(buffer.data());
+    buffer_sizes.push_back(buffer.size());
+  }
+
+  // Write all the buffered cells as a new fragment
+  Query query;
+  RETURN_NOT_OK(storage_manager_->query_init(
+      &query,
+      array_uri_.c_str(),
+      QueryType::WRITE,
+      Layout::UNORDERED,
+      nullptr,
+      nullptr,
+      0,
+      buffers.data(),
+      buffer_sizes.data()));
+  auto st = query.init();
+  if (st.ok())
+    st = query.write();
+  auto st_finalize = storage_manager_->query_finalize(&query);
+  RETURN_NOT_OK(st);
+  RETURN_NOT_OK(st_finalize);
+
+  clear_unsafe();
+
+  return Status::Ok();
+}
+
+}  // namespace sm
+}  // namespace tiledb
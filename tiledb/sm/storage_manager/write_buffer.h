@@ -0,0 +1,176 @@
+/**
+ * @file   write_buffer.h
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2018 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file defines class WriteBuffer.
+ */
+
+#ifndef TILEDB_WRITE_BUFFER_H
+#define TILEDB_WRITE_BUFFER_H
+
+#include <mutex>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "tiledb/sm/misc/status.h"
+#include "tiledb/sm/misc/uri.h"
+
+namespace tiledb {
+namespace sm {
+
+class Query;
+class StorageManager;
+
+/**
+ * Accumulates in memory the cells of small unordered writes to a sparse
+ * array, and writes them to the array as a single fragment (which sorts
+ * them) once the buffer gets full or old enough, so that a stream of small
+ * writes does not create a stream of tiny fragments. The buffer holds one
+ * buffer per attribute (two for var-sized attributes), in the order of the
+ * array schema, followed by the coordinates, i.e., the buffers of a write
+ * query on all the attributes.
+ *
+ * A write with a cell already in the buffer flushes the buffer first, so
+ * that the later write lands in a newer fragment and its cell wins, as
+ * without buffering.
+ */
+class WriteBuffer {
+ public:
+  /* ********************************* */
+  /*     CONSTRUCTORS & DESTRUCTORS    */
+  /* ********************************* */
+
+  /**
+   * Constructor.
+   *
+   * @param storage_manager The storage manager.
+   * @param array_uri The URI of the array the buffer writes to.
+   * @param max_size The maximum number of bytes the buffer holds.
+   * @param flush_ms The age (in ms) of the oldest buffered cell after which
+   *     the next append flushes the buffer (`0` means no age limit).
+   */
+  WriteBuffer(
+      StorageManager* storage_manager,
+      const URI& array_uri,
+      uint64_t max_size,
+      uint64_t flush_ms);
+
+  /** Destructor. */
+  ~WriteBuffer();
+
+  /* ********************************* */
+  /*                API                */
+  /* ********************************* */
+
+  /**
+   * Appends the cells of the input write query to the buffer. If they do
+   * not fit along with the buffered cells, or some of their coordinates are
+   * already buffered, the buffer is flushed first, and
+   * if the buffer gets full or old enough, it is flushed afterwards. If the
+   * cells are larger than the entire buffer, the buffer is flushed and the
+   * cells are not appended, so that the query writes them itself after the
+   * buffered ones.
+   *
+   * @param query The query, which must be bufferable (see `bufferable`).
+   * @param appended Set to `true` if the cells were appended.
+   * @return Status
+   */
+  Status append(const Query* query, bool* appended);
+
+  /** Returns `true` if the cells of the input query can be buffered. */
+  static bool bufferable(const Query* query);
+
+  /** Discards the buffered cells. */
+  void clear();
+
+  /**
+   * Writes the buffered cells to a new fragment of the array and clears
+   * the buffer. The cells are kept if the write fails.
+   */
+  Status flush();
+
+ private:
+  /* ********************************* */
+  /*         PRIVATE ATTRIBUTES        */
+  /* ********************************* */
+
+  /** The URI of the array the buffer writes to. */
+  URI array_uri_;
+
+  /** The buffered cells, in the layout of a query on all the attributes. */
+  std::vector<std::vector<uint8_t>> buffers_;
+
+  /** The coordinates of the buffered cells. */
+  std::unordered_set<std::string> coords_;
+
+  /** The number of buffered cells. */
+  uint64_t cell_num_;
+
+  /** The time (in ms) the oldest buffered cell was appended. */
+  uint64_t first_append_ms_;
+
+  /** The age (in ms) of the buffer after which an append flushes it. */
+  uint64_t flush_ms_;
+
+  /** The maximum number of bytes the buffer holds. */
+  uint64_t max_size_;
+
+  /** Protects the buffer; held while flushing, so that readers wait. */
+  std::mutex mtx_;
+
+  /** The number of buffered bytes. */
+  uint64_t size_;
+
+  /** The storage manager. */
+  StorageManager* storage_manager_;
+
+  /* ********************************* */
+  /*          PRIVATE METHODS          */
+  /* ********************************* */
+
+  /** Appends the cells of the input query, which must fit in the buffer. */
+  Status append_cells(const Query* query);
+
+  /**
+   * Returns `true` if some of the coordinates of the input query are
+   * already buffered.
+   */
+  bool buffered(const Query* query) const;
+
+  /** Clears the buffer, assuming the mutex is locked. */
+  void clear_unsafe();
+
+  /** Flushes the buffer, assuming the mutex is locked. */
+  Status flush_unsafe();
+};
+
+}  // namespace sm
+}  // namespace tiledb
+
+#endif  // TILEDB_WRITE_BUFFER_H
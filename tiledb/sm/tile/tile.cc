@@ -31,13 +31,117 @@
  */
 
 #include "tiledb/sm/tile/tile.h"
+#include "tiledb/sm/misc/constants.h"
 #include "tiledb/sm/misc/logger.h"
 
 #include <iostream>
 
+/* ****************************** */
+/*             MACROS             */
+/* ****************************** */
+
+#define MIN(a, b) ((a) < (b) ? (a) : (b))
+
 namespace tiledb {
 namespace sm {
 
+/* ****************************** */
+/*        STATIC FUNCTIONS        */
+/* ****************************** */
+
+/**
+ * Copies the `cell_num` zipped coordinates of `dim_num` dimensions in
+ * `zipped` to `split`, such that the values of each dimension appear
+ * contiguously. The cells are processed in cache-sized blocks.
+ */
+template <class T>
+static void split_coords(
+    const T* zipped, unsigned int dim_num, uint64_t cell_num, T* split) {
+  uint64_t block = constants::coords_transpose_block_cell_num;
+  for (uint64_t first = 0; first < cell_num; first += block) {
+    uint64_t last = MIN(first + block, cell_num);
+    for (unsigned int j = 0; j < dim_num; ++j) {
+      auto dim = split + j * cell_num;
+      auto coords = zipped + j;
+      for (uint64_t i = first; i < last; ++i)
+        dim[i] = coords[i * dim_num];
+    }
+  }
+}
+
+/** The inverse of `split_coords()`. */
+template <class T>
+static void zip_coords(
+    const T* split, unsigned int dim_num, uint64_t cell_num, T* zipped) {
+  uint64_t block = constants::coords_transpose_block_cell_num;
+  for (uint64_t first = 0; first < cell_num; first += block) {
+    uint64_t last = MIN(first + block, cell_num);
+    for (unsigned int j = 0; j < dim_num; ++j) {
+      auto dim = split + j * cell_num;
+      auto coords = zipped + j;
+      for (uint64_t i = first; i < last; ++i)
+        coords[i * dim_num] = dim[i];
+    }
+  }
+}
+
+/**
+ * Splits (`zip` is *false*) or zips (`zip` is *true*) the coordinates in
+ * `input` into `output`, moving each coordinate as a value of type `T`.
+ */
+template <class T>
+static void transpose_coords(
+    bool zip,
+    const void* input,
+    unsigned int dim_num,
+    uint64_t cell_num,
+    void* output) {
+  if (zip)
+    zip_coords((const T*)input, dim_num, cell_num, (T*)output);
+  else
+    split_coords((const T*)input, dim_num, cell_num, (T*)output);
+}
+
+/**
+ * Splits (`zip` is *false*) or zips (`zip` is *true*) the coordinates of
+ * `coord_size` bytes in `input` into `output`.
+ */
+static void transpose_coords(
+    bool zip,
+    const void* input,
+    uint64_t coord_size,
+    unsigned int dim_num,
+    uint64_t cell_num,
+    void* output) {
+  switch (coord_size) {
+    case sizeof(uint8_t):
+      return transpose_coords<uint8_t>(zip, input, dim_num, cell_num, output);
+    case sizeof(uint16_t):
+      return transpose_coords<uint16_t>(zip, input, dim_num, cell_num, output);
+    case sizeof(uint32_t):
+      return transpose_coords<uint32_t>(zip, input, dim_num, cell_num, output);
+    case sizeof(uint64_t):
+      return transpose_coords<uint64_t>(zip, input, dim_num, cell_num, output);
+    default:
+      break;
+  }
+
+  // Any other coordinate size
+  auto input_c = (const char*)input;
+  auto output_c = (char*)output;
+  uint64_t cell_size = dim_num * coord_size;
+  for (unsigned int j = 0; j < dim_num; ++j) {
+    for (uint64_t i = 0; i < cell_num; ++i) {
+      uint64_t zipped = i * cell_size + j * coord_size;
+      uint64_t split = (j * cell_num + i) * coord_size;
+      if (zip)
+        std::memcpy(output_c + zipped, input_c + split, coord_size);
+      else
+        std::memcpy(output_c + split, input_c + zipped, coord_size);
+    }
+  }
+}
+
 /* ****************************** */
 /*   CONSTRUCTORS & DESTRUCTORS   */
 /* ****************************** */
@@ -48,6 +152,7 @@ Tile::Tile() {
   compressor_ = Compressor::NO_COMPRESSION;
   compression_level_ = -1;
   dim_num_ = 0;
+  filters_ = nullptr;
   owns_buff_ = true;
   type_ = Datatype::INT32;
 }
@@ -58,6 +163,7 @@ Tile::Tile(unsigned int dim_num)
   cell_size_ = 0;
   compressor_ = Compressor::NO_COMPRESSION;
   compression_level_ = -1;
+  filters_ = nullptr;
   owns_buff_ = true;
   type_ = Datatype::INT32;
 }
@@ -75,6 +181,7 @@ Tile::Tile(
     , compressor_(compressor)
     , compression_level_(compression_level)
     , dim_num_(dim_num)
+    , filters_(nullptr)
     , owns_buff_(owns_buff)
     , type_(type) {
 }
@@ -172,6 +279,15 @@ bool Tile::empty() const {
   return buffer_->size() == 0;
 }
 
+bool Tile::encoded() const {
+  return compressor_ != Compressor::NO_COMPRESSION ||
+         (filters_ != nullptr && !filters_->empty());
+}
+
+const FilterPipeline* Tile::filters() const {
+  return filters_;
+}
+
 bool Tile::full() const {
   return (buffer_->size() != 0) &&
          (buffer_->offset() == buffer_->alloced_size());
@@ -199,6 +315,10 @@ void Tile::reset_size() {
   buffer_->reset_size();
 }
 
+void Tile::set_filters(const FilterPipeline* filters) {
+  filters_ = filters;
+}
+
 void Tile::set_offset(uint64_t offset) {
   buffer_->set_offset(offset);
 }
@@ -210,32 +330,9 @@ void Tile::set_size(uint64_t size) {
 uint64_t Tile::size() const {
   return buffer_->size();
 }
-void Tile::split_coordinates() {
+Status Tile::split_coordinates(Buffer* scratch) {
   assert(dim_num_ > 0);
-
-  // For easy reference
-  uint64_t tile_size = buffer_->size();
-  uint64_t coord_size = cell_size_ / dim_num_;
-  uint64_t cell_num = tile_size / cell_size_;
-  auto tile_c = (char*)buffer_->data();
-  uint64_t ptr = 0, ptr_tmp = 0;
-
-  // Create a tile clone
-  auto tile_tmp = (char*)malloc(tile_size);
-  std::memcpy(tile_tmp, tile_c, tile_size);
-
-  // Split coordinates
-  for (unsigned int j = 0; j < dim_num_; ++j) {
-    ptr_tmp = j * coord_size;
-    for (uint64_t i = 0; i < cell_num; ++i) {
-      std::memcpy(tile_c + ptr, tile_tmp + ptr_tmp, coord_size);
-      ptr += coord_size;
-      ptr_tmp += cell_size_;
-    }
-  }
-
-  // Clean up
-  std::free((void*)tile_tmp);
+  return transpose_coordinates(false, scratch);
 }
 
 bool Tile::stores_coords() const {
@@ -264,37 +361,31 @@ Status Tile::write_with_shift(ConstBuffer* buf, uint64_t offset) {
   return Status::Ok();
 }
 
-void Tile::zip_coordinates() {
+Status Tile::zip_coordinates(Buffer* scratch) {
   assert(dim_num_ > 0);
+  return transpose_coordinates(true, scratch);
+}
+
+/* ****************************** */
+/*          PRIVATE METHODS       */
+/* ****************************** */
 
+Status Tile::transpose_coordinates(bool zip, Buffer* scratch) {
   // For easy reference
   uint64_t tile_size = buffer_->size();
   uint64_t coord_size = cell_size_ / dim_num_;
   uint64_t cell_num = tile_size / cell_size_;
-  auto tile_c = (char*)buffer_->data();
-  uint64_t ptr = 0, ptr_tmp = 0;
+  if (dim_num_ == 1 || cell_num == 0)
+    return Status::Ok();
 
-  // Create a tile clone
-  auto tile_tmp = (char*)malloc(tile_size);
-  std::memcpy(tile_tmp, tile_c, tile_size);
+  // Copy the tile to the scratch buffer and transpose it back
+  RETURN_NOT_OK(scratch->realloc(tile_size));
+  std::memcpy(scratch->data(), buffer_->data(), tile_size);
+  transpose_coords(
+      zip, scratch->data(), coord_size, dim_num_, cell_num, buffer_->data());
 
-  // Zip coordinates
-  for (unsigned int j = 0; j < dim_num_; ++j) {
-    ptr = j * coord_size;
-    for (uint64_t i = 0; i < cell_num; ++i) {
-      std::memcpy(tile_c + ptr, tile_tmp + ptr_tmp, coord_size);
-      ptr += cell_size_;
-      ptr_tmp += coord_size;
-    }
-  }
-
-  // Clean up
-  std::free((void*)tile_tmp);
+  return Status::Ok();
 }
 
-/* ****************************** */
-/*          PRIVATE METHODS       */
-/* ****************************** */
-
 }  // namespace sm
 }  // namespace tiledb
@@ -36,6 +36,7 @@
 #include "tiledb/sm/array_schema/attribute.h"
 #include "tiledb/sm/buffer/buffer.h"
 #include "tiledb/sm/buffer/const_buffer.h"
+#include "tiledb/sm/filter/filter_pipeline.h"
 #include "tiledb/sm/misc/status.h"
 
 #include <cinttypes>
@@ -170,6 +171,18 @@ class Tile {
   /** Checks if the tile is empty. */
   bool empty() const;
 
+  /**
+   * Returns *true* if the tile is stored encoded, i.e., it is compressed
+   * or filtered.
+   */
+  bool encoded() const;
+
+  /**
+   * Returns the filter pipeline applied to the tile data before compression,
+   * or `nullptr` if the tile is not filtered.
+   */
+  const FilterPipeline* filters() const;
+
   /** Checks if the tile is full. */
   bool full() const;
 
@@ -188,6 +201,12 @@ class Tile {
   /** Resets the tile size. */
   void reset_size();
 
+  /**
+   * Sets the filter pipeline of the tile. The pipeline is not owned by
+   * the tile and must outlive it.
+   */
+  void set_filters(const FilterPipeline* filters);
+
   /** Sets the tile offset. */
   void set_offset(uint64_t offset);
 
@@ -200,8 +219,12 @@ class Tile {
   /**
    * Splits the coordinates such that all the values of each dimension
    * appear contiguously in the buffer.
+   *
+   * @param scratch A buffer the tile is copied to while splitting, which
+   *     is grown as needed and can be reused across tiles.
+   * @return Status
    */
-  void split_coordinates();
+  Status split_coordinates(Buffer* scratch);
 
   /** Returns *true* if the tile stores coordinates. */
   bool stores_coords() const;
@@ -241,8 +264,12 @@ class Tile {
   /**
    * Zips the coordinate values such that a cell's coordinates across
    * all dimensions appear contiguously in the buffer.
+   *
+   * @param scratch A buffer the tile is copied to while zipping, which is
+   *     grown as needed and can be reused across tiles.
+   * @return Status
    */
-  void zip_coordinates();
+  Status zip_coordinates(Buffer* scratch);
 
  private:
   /* ********************************* */
@@ -267,6 +294,9 @@ class Tile {
    */
   unsigned int dim_num_;
 
+  /** The filter pipeline of the tile (`nullptr` if it is not filtered). */
+  const FilterPipeline* filters_;
+
   /**
    * If *true* the tile object will delete *buff* upon
    * destruction, otherwise it will not delete it.
@@ -279,6 +309,12 @@ class Tile {
   /* ********************************* */
   /*          PRIVATE METHODS          */
   /* ********************************* */
+
+  /**
+   * Splits (`zip` is *false*) or zips (`zip` is *true*) the coordinates of
+   * the tile, through the input scratch buffer.
+   */
+  Status transpose_coordinates(bool zip, Buffer* scratch);
 };
 
 }  // namespace sm
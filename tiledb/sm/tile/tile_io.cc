@@ -40,21 +40,51 @@
 #include "tiledb/sm/compressors/zstd_compressor.h"
 #include "tiledb/sm/misc/logger.h"
 
+#include <limits>
+
 /* ****************************** */
 /*             MACROS             */
 /* ****************************** */
 
+#define MAX(a, b) ((a) > (b) ? (a) : (b))
 #define MIN(a, b) ((a) < (b) ? (a) : (b))
 
 namespace tiledb {
 namespace sm {
 
+/* ****************************** */
+/*        STATIC FUNCTIONS        */
+/* ****************************** */
+
+/**
+ * The compressors the AUTO compressor selects from, in decreasing order of
+ * decompression speed.
+ */
+static const Compressor auto_candidates[] = {Compressor::NO_COMPRESSION,
+                                             Compressor::RLE,
+                                             Compressor::LZ4,
+                                             Compressor::DOUBLE_DELTA,
+                                             Compressor::ZSTD};
+
+/** Returns *true* if the AUTO compressor may select `compressor`. */
+static bool auto_candidate(Compressor compressor) {
+  for (auto candidate : auto_candidates) {
+    if (compressor == candidate)
+      return true;
+  }
+  return false;
+}
+
 /* ****************************** */
 /*   CONSTRUCTORS & DESTRUCTORS   */
 /* ****************************** */
 
 TileIO::TileIO() {
-  buffer_ = nullptr;
+  auto_tolerance_ = -1;
+  buffer_ = new Buffer();
+  dictionary_ = nullptr;
+  filter_buffer_ = new Buffer();
+  filter_scratch_ = new Buffer();
   file_size_ = 0;
   storage_manager_ = nullptr;
   uri_ = URI("");
@@ -63,26 +93,205 @@ TileIO::TileIO() {
 TileIO::TileIO(StorageManager* storage_manager, const URI& uri)
     : storage_manager_(storage_manager)
     , uri_(uri) {
+  auto_tolerance_ = -1;
+  dictionary_ = nullptr;
   file_size_ = 0;
   buffer_ = new Buffer();
+  filter_buffer_ = new Buffer();
+  filter_scratch_ = new Buffer();
 }
 
 TileIO::TileIO(
     StorageManager* storage_manager, const URI& uri, uint64_t file_size)
-    : file_size_(file_size)
+    : auto_tolerance_(-1)
+    , dictionary_(nullptr)
+    , file_size_(file_size)
     , storage_manager_(storage_manager)
     , uri_(uri) {
   buffer_ = new Buffer();
+  filter_buffer_ = new Buffer();
+  filter_scratch_ = new Buffer();
 }
 
 TileIO::~TileIO() {
   delete buffer_;
+  delete dictionary_;
+  delete filter_buffer_;
+  delete filter_scratch_;
 }
 
 /* ****************************** */
 /*               API              */
 /* ****************************** */
 
+Buffer* TileIO::buffer() const {
+  return buffer_;
+}
+
+Status TileIO::compress_one_tile(Tile* tile) {
+  // For easy reference
+  auto level = tile->compression_level();
+  auto compressor = tile->compressor();
+  auto type = tile->type();
+  auto cell_size = tile->cell_size();
+  auto tile_size = tile->size();
+  auto filters = tile->filters();
+  bool filtered = filters != nullptr && !filters->empty();
+
+  // Compute necessary info for chunking
+  uint64_t chunk_num, max_chunk_size, overhead;
+  RETURN_NOT_OK(
+      compute_chunking_info(tile, &chunk_num, &max_chunk_size, &overhead));
+
+  // Select the compressor of the tile
+  auto selected = compressor;
+  if (compressor == Compressor::AUTO)
+    RETURN_NOT_OK(select_compressor(tile, &selected));
+
+  // Properly reallocate buffer
+  RETURN_NOT_OK(buffer_->realloc(buffer_->size() + tile_size + overhead));
+
+  // Write number of chunks
+  RETURN_NOT_OK(buffer_->write(&chunk_num, sizeof(uint64_t)));
+
+  // Compress in chunks
+  Status st;
+  uint64_t compressed_chunk_size = 0;
+  uint64_t left_to_compress = tile_size;
+  for (uint64_t i = 0; i < chunk_num; ++i) {
+    // Write chunk info
+    auto chunk_size = MIN(left_to_compress, max_chunk_size);
+
+    RETURN_NOT_OK(buffer_->write(&chunk_size, sizeof(uint64_t)));
+    uint64_t buffer_offset = buffer_->offset();  // Will be used later
+    RETURN_NOT_OK(buffer_->write(&compressed_chunk_size, sizeof(uint64_t)));
+
+    // Create const buffer
+    auto input_buffer = new ConstBuffer(tile->cur_data(), chunk_size);
+
+    // Run the filter pipeline on the chunk before compressing it
+    if (filtered) {
+      filter_buffer_->reset_size();
+      filter_buffer_->reset_offset();
+      st = filters->run_forward(
+          type, input_buffer, filter_buffer_, filter_scratch_);
+      delete input_buffer;
+      RETURN_NOT_OK(st);
+      input_buffer = new ConstBuffer(filter_buffer_);
+    }
+
+    // Invoke the proper compressor, preceded by the compressor itself if it
+    // was selected for the tile
+    if (compressor == Compressor::AUTO) {
+      auto selected_c = (char)selected;
+      st = buffer_->write(&selected_c, sizeof(char));
+    }
+    if (st.ok())
+      st = compress_chunk(
+          selected,
+          level,
+          type,
+          cell_size,
+          dictionary_,
+          input_buffer,
+          buffer_);
+    delete input_buffer;
+    RETURN_NOT_OK(st);
+
+    // Write compressed chunk size
+    compressed_chunk_size =
+        buffer_->size() - (buffer_offset + sizeof(uint64_t));
+    std::memcpy(
+        buffer_->data(buffer_offset), &compressed_chunk_size, sizeof(uint64_t));
+
+    // Update
+    left_to_compress -= chunk_size;
+    tile->advance_offset(chunk_size);
+  }
+
+  assert(left_to_compress == 0);
+
+  return Status::Ok();
+}
+
+Status TileIO::decompress_one_tile(Tile* tile) {
+  // Read number of chunks
+  uint64_t chunk_num;
+
+  RETURN_NOT_OK(buffer_->read(&chunk_num, sizeof(uint64_t)));
+  assert(chunk_num > 0);
+
+  Status st;
+  Datatype type = tile->type();
+  auto filters = tile->filters();
+  bool filtered = filters != nullptr && !filters->empty();
+  for (uint64_t i = 0; i < chunk_num; ++i) {
+    // Read original and compressed chunk size
+    uint64_t chunk_size, compressed_chunk_size;
+    RETURN_NOT_OK(buffer_->read(&chunk_size, sizeof(uint64_t)));
+    RETURN_NOT_OK(buffer_->read(&compressed_chunk_size, sizeof(uint64_t)));
+
+    // Retrieve the compressor selected for the tile
+    auto chunk_data = (const char*)buffer_->cur_data();
+    auto chunk_data_size = compressed_chunk_size;
+    auto compressor = tile->compressor();
+    if (compressor == Compressor::AUTO) {
+      if (chunk_data_size < sizeof(char) ||
+          !auto_candidate((Compressor)chunk_data[0]))
+        return LOG_STATUS(Status::TileIOError(
+            "Cannot decompress tile; Invalid AUTO tile compressor"));
+      compressor = (Compressor)chunk_data[0];
+      chunk_data += sizeof(char);
+      chunk_data_size -= sizeof(char);
+    }
+
+    auto input_buffer = new ConstBuffer(chunk_data, chunk_data_size);
+
+    // Filtered chunks are decompressed into an intermediate buffer
+    auto output_buffer = tile->buffer();
+    if (filtered) {
+      filter_buffer_->reset_size();
+      filter_buffer_->reset_offset();
+      st = filter_buffer_->realloc(
+          chunk_size + filters->overhead(type, chunk_size));
+      if (!st.ok()) {
+        delete input_buffer;
+        return st;
+      }
+      output_buffer = filter_buffer_;
+    }
+
+    // Invoke the proper decompressor
+    st = decompress_chunk(
+        compressor,
+        type,
+        tile->cell_size(),
+        dictionary_,
+        input_buffer,
+        output_buffer);
+
+    delete input_buffer;
+    RETURN_NOT_OK(st);
+
+    // Reverse the filter pipeline into the tile
+    if (filtered) {
+      auto filtered_buffer = new ConstBuffer(filter_buffer_);
+      st = filters->run_reverse(
+          type, filtered_buffer, tile->buffer(), filter_scratch_);
+      delete filtered_buffer;
+      RETURN_NOT_OK(st);
+    }
+
+    buffer_->advance_offset(compressed_chunk_size);
+  }
+
+  return st;
+}
+
+const ZStdDictionary* TileIO::dictionary() const {
+  return dictionary_;
+}
+
 uint64_t TileIO::file_size() const {
   return file_size_;
 }
@@ -99,8 +308,8 @@ Status TileIO::read(
   if (in_cache)
     return Status::Ok();
 
-  // No compression
-  if (tile->compressor() == Compressor::NO_COMPRESSION) {
+  // No compression or filters
+  if (!tile->encoded()) {
     RETURN_NOT_OK(
         storage_manager_->read(uri_, file_offset, tile->buffer(), tile_size));
   } else {  // Compression
@@ -125,18 +334,46 @@ Status TileIO::read_generic(Tile** tile, uint64_t file_offset) {
   uint64_t compressed_size;
   uint64_t header_size;
 
+  // Read the header along with the start of the tile data in one request,
+  // which covers small tiles entirely
+  RETURN_NOT_OK(storage_manager_->read_up_to(
+      uri_, file_offset, buffer_, constants::generic_tile_read_size));
   RETURN_NOT_OK(read_generic_tile_header(
-      tile, file_offset, &tile_size, &compressed_size, &header_size));
-  RETURN_NOT_OK_ELSE(
-      read(*tile, file_offset + header_size, compressed_size, tile_size),
-      delete *tile);
+      tile, &tile_size, &compressed_size, &header_size));
+
+  // Read the rest of the tile data, if any
+  auto encoded = (*tile)->encoded();
+  uint64_t nbytes = header_size + (encoded ? compressed_size : tile_size);
+  uint64_t nbytes_read = buffer_->size();
+  if (nbytes > nbytes_read) {
+    RETURN_NOT_OK_ELSE(buffer_->realloc(nbytes), delete *tile);
+    RETURN_NOT_OK_ELSE(
+        storage_manager_->vfs()->read(
+            uri_,
+            file_offset + nbytes_read,
+            buffer_->data(nbytes_read),
+            nbytes - nbytes_read),
+        delete *tile);
+    buffer_->set_size(nbytes);
+  }
+
+  // Decompress or copy the tile data
+  Status st = (*tile)->realloc(tile_size);
+  if (st.ok() && encoded) {
+    buffer_->set_offset(header_size);
+    st = decompress_tile(*tile);
+  } else if (st.ok()) {
+    ConstBuffer data(buffer_->data(header_size), tile_size);
+    st = (*tile)->write(&data, tile_size);
+  }
+  RETURN_NOT_OK_ELSE(st, delete *tile);
+  (*tile)->reset_offset();
 
   return Status::Ok();
 }
 
 Status TileIO::read_generic_tile_header(
     Tile** tile,
-    uint64_t file_offset,
     uint64_t* tile_size,
     uint64_t* compressed_size,
     uint64_t* header_size) {
@@ -147,32 +384,114 @@ Status TileIO::read_generic_tile_header(
   char compressor;
   int compression_level;
 
-  // Read header from file
-  auto header_buff = new Buffer();
-  RETURN_NOT_OK_ELSE(
-      storage_manager_->read(uri_, file_offset, header_buff, *header_size),
-      delete header_buff);
-
   // Read header individual values
-  RETURN_NOT_OK_ELSE(
-      header_buff->read(compressed_size, sizeof(uint64_t)), delete header_buff);
-  RETURN_NOT_OK_ELSE(
-      header_buff->read(tile_size, sizeof(uint64_t)), delete header_buff);
-  RETURN_NOT_OK_ELSE(
-      header_buff->read(&datatype, sizeof(char)), delete header_buff);
-  RETURN_NOT_OK_ELSE(
-      header_buff->read(&cell_size, sizeof(uint64_t)), delete header_buff);
-  RETURN_NOT_OK_ELSE(
-      header_buff->read(&compressor, sizeof(char)), delete header_buff);
-  RETURN_NOT_OK_ELSE(
-      header_buff->read(&compression_level, sizeof(int)), delete header_buff);
-
-  delete header_buff;
+  buffer_->reset_offset();
+  RETURN_NOT_OK(buffer_->read(compressed_size, sizeof(uint64_t)));
+  RETURN_NOT_OK(buffer_->read(tile_size, sizeof(uint64_t)));
+  RETURN_NOT_OK(buffer_->read(&datatype, sizeof(char)));
+  RETURN_NOT_OK(buffer_->read(&cell_size, sizeof(uint64_t)));
+  RETURN_NOT_OK(buffer_->read(&compressor, sizeof(char)));
+  RETURN_NOT_OK(buffer_->read(&compression_level, sizeof(int)));
 
   *tile = new Tile();
   RETURN_NOT_OK_ELSE(
       (*tile)->init((Datatype)datatype, (Compressor)compressor, cell_size, 0),
-      delete tile);
+      delete *tile);
+
+  return Status::Ok();
+}
+
+void TileIO::set_dictionary(const void* data, uint64_t size) {
+  delete dictionary_;
+  dictionary_ = (size == 0) ? nullptr : new ZStdDictionary(data, size);
+}
+
+Status TileIO::train_dictionary(
+    Tile* tile,
+    const void* data,
+    uint64_t size,
+    uint64_t sample_size,
+    uint64_t capacity) {
+  // For easy reference
+  auto type = tile->type();
+  auto cell_size = tile->cell_size();
+  auto data_c = (const char*)data;
+  auto filters = tile->filters();
+  bool filtered = filters != nullptr && !filters->empty();
+
+  // Take at least the minimum number of whole-cell samples, within the
+  // total sample size the dictionary capacity calls for
+  uint64_t min_samples = constants::zstd_dictionary_min_samples;
+  uint64_t budget =
+      MIN(size, capacity * constants::zstd_dictionary_sample_ratio);
+  sample_size = MIN(sample_size, budget / min_samples);
+  sample_size = sample_size / cell_size * cell_size;
+  if (sample_size == 0)
+    return Status::Ok();
+  uint64_t sample_num = budget / sample_size;
+  uint64_t cell_num = size / cell_size;
+  uint64_t sample_cell_num = sample_size / cell_size;
+
+  // Gather evenly spaced samples, filtered like the chunks of the tiles.
+  // Every other sample is held out to evaluate the trained dictionary on
+  // data it has not seen.
+  Buffer samples[2];
+  std::vector<uint64_t> sample_sizes[2];
+  for (uint64_t i = 0; i < sample_num; ++i) {
+    uint64_t first = i * (cell_num - sample_cell_num) / (sample_num - 1);
+    ConstBuffer input(data_c + first * cell_size, sample_size);
+    auto set = i % 2;
+    uint64_t offset = samples[set].size();
+    if (filtered) {
+      filter_buffer_->reset_size();
+      filter_buffer_->reset_offset();
+      RETURN_NOT_OK(
+          filters->run_forward(type, &input, filter_buffer_, filter_scratch_));
+      RETURN_NOT_OK(
+          samples[set].write(filter_buffer_->data(), filter_buffer_->size()));
+    } else {
+      RETURN_NOT_OK(samples[set].write(&input, sample_size));
+    }
+    sample_sizes[set].push_back(samples[set].size() - offset);
+  }
+
+  // Train the dictionary. Training fails on samples with too little in
+  // common to learn from, in which case the chunks are compressed without
+  // a dictionary as usual.
+  Buffer dictionary;
+  if (!ZStd::train_dictionary(
+           samples[0].data(), sample_sizes[0], capacity, &dictionary)
+           .ok())
+    return Status::Ok();
+  ZStdDictionary trained(dictionary.data(), dictionary.size());
+
+  // Compress the held out samples with and without the dictionary
+  auto level = tile->compression_level();
+  uint64_t dictionary_size = 0, plain_size = 0, offset = 0;
+  Buffer compressed;
+  for (auto sample : sample_sizes[1]) {
+    RETURN_NOT_OK(compressed.realloc(sample + ZStd::overhead(sample)));
+    ConstBuffer input(samples[1].data(offset), sample);
+    compressed.reset_size();
+    compressed.reset_offset();
+    RETURN_NOT_OK(ZStd::compress(level, &trained, &input, &compressed));
+    dictionary_size += compressed.size();
+    compressed.reset_size();
+    compressed.reset_offset();
+    RETURN_NOT_OK(ZStd::compress(level, &input, &compressed));
+    plain_size += compressed.size();
+    offset += sample;
+  }
+
+  // Keep the dictionary only if the bytes it is expected to save across
+  // the data outweigh its own size. This is not the case for tiles large
+  // enough to learn from themselves.
+  if (dictionary_size >= plain_size)
+    return Status::Ok();
+  double held_out_size = (double)sample_sizes[1].size() * sample_size;
+  double saved = (double)(plain_size - dictionary_size) * size / held_out_size;
+  if (saved > dictionary.size())
+    set_dictionary(dictionary.data(), dictionary.size());
 
   return Status::Ok();
 }
@@ -183,14 +502,13 @@ Status TileIO::write(Tile* tile, uint64_t* bytes_written) {
   buffer_->reset_size();
   buffer_->reset_offset();
 
-  // Compress tile
-  Compressor compressor = tile->compressor();
-  if (compressor != Compressor::NO_COMPRESSION)
+  // Filter and compress tile
+  bool encoded = tile->encoded();
+  if (encoded)
     RETURN_NOT_OK(compress_tile(tile));
 
   // Prepare to write
-  auto buffer =
-      (compressor == Compressor::NO_COMPRESSION) ? tile->buffer() : buffer_;
+  auto buffer = encoded ? buffer_ : tile->buffer();
   *bytes_written = buffer->size();
 
   RETURN_NOT_OK(storage_manager_->write(uri_, buffer));
@@ -248,13 +566,67 @@ Status TileIO::write_generic_tile_header(Tile* tile, uint64_t compressed_size) {
 /*          PRIVATE METHODS       */
 /* ****************************** */
 
+Status TileIO::compress_chunk(
+    Compressor compressor,
+    int level,
+    Datatype type,
+    uint64_t cell_size,
+    ZStdDictionary* dictionary,
+    ConstBuffer* input_buffer,
+    Buffer* output_buffer) {
+  auto type_size = datatype_size(type);
+  switch (compressor) {
+    case Compressor::NO_COMPRESSION:
+      return output_buffer->write(input_buffer->data(), input_buffer->size());
+    case Compressor::GZIP:
+      return GZip::compress(level, input_buffer, output_buffer);
+    case Compressor::ZSTD:
+      return ZStd::compress(level, dictionary, input_buffer, output_buffer);
+    case Compressor::LZ4:
+      return LZ4::compress(level, input_buffer, output_buffer);
+    case Compressor::BLOSC_LZ:
+      return Blosc::compress(
+          "blosclz", type_size, level, input_buffer, output_buffer);
+#undef BLOSC_LZ4
+    case Compressor::BLOSC_LZ4:
+      return Blosc::compress(
+          "lz4", type_size, level, input_buffer, output_buffer);
+#undef BLOSC_LZ4HC
+    case Compressor::BLOSC_LZ4HC:
+      return Blosc::compress(
+          "lz4hc", type_size, level, input_buffer, output_buffer);
+#undef BLOSC_SNAPPY
+    case Compressor::BLOSC_SNAPPY:
+      return Blosc::compress(
+          "snappy", type_size, level, input_buffer, output_buffer);
+#undef BLOSC_ZLIB
+    case Compressor::BLOSC_ZLIB:
+      return Blosc::compress(
+          "zlib", type_size, level, input_buffer, output_buffer);
+#undef BLOSC_ZSTD
+    case Compressor::BLOSC_ZSTD:
+      return Blosc::compress(
+          "zstd", type_size, level, input_buffer, output_buffer);
+    case Compressor::RLE:
+      return RLE::compress(cell_size, input_buffer, output_buffer);
+    case Compressor::BZIP2:
+      return BZip::compress(level, input_buffer, output_buffer);
+    case Compressor::DOUBLE_DELTA:
+      return DoubleDelta::compress(type, input_buffer, output_buffer);
+    default:
+      assert(0);
+      return LOG_STATUS(
+          Status::TileIOError("Cannot compress tile; Invalid compressor"));
+  }
+}
+
 Status TileIO::compress_tile(Tile* tile) {
   // Simple case - No coordinates
   if (!tile->stores_coords())
     return compress_one_tile(tile);
 
   // Split coordinates
-  tile->split_coordinates();
+  RETURN_NOT_OK(tile->split_coordinates(filter_scratch_));
 
   // Compress each dimension tile
   auto dim_num = tile->dim_num();
@@ -271,6 +643,7 @@ Status TileIO::compress_tile(Tile* tile) {
         dim_num,
         buff,
         false);
+    dim_tile->set_filters(tile->filters());
     st = compress_one_tile(dim_tile);
     delete buff;
     delete dim_tile;
@@ -281,106 +654,44 @@ Status TileIO::compress_tile(Tile* tile) {
   return Status::Ok();
 }
 
-Status TileIO::compress_one_tile(Tile* tile) {
-  // For easy reference
-  auto level = tile->compression_level();
-  auto type_size = datatype_size(tile->type());
-  auto compressor = tile->compressor();
-  auto type = tile->type();
-  auto cell_size = tile->cell_size();
-  auto tile_size = tile->size();
-
-  // Compute necessary info for chunking
-  uint64_t chunk_num, max_chunk_size, overhead;
-  RETURN_NOT_OK(
-      compute_chunking_info(tile, &chunk_num, &max_chunk_size, &overhead));
-
-  // Properly reallocate buffer
-  RETURN_NOT_OK(buffer_->realloc(buffer_->size() + tile_size + overhead));
-
-  // Write number of chunks
-  RETURN_NOT_OK(buffer_->write(&chunk_num, sizeof(uint64_t)));
-
-  // Compress in chunks
-  Status st;
-  uint64_t compressed_chunk_size = 0;
-  uint64_t left_to_compress = tile_size;
-  for (uint64_t i = 0; i < chunk_num; ++i) {
-    // Write chunk info
-    auto chunk_size = MIN(left_to_compress, max_chunk_size);
-
-    RETURN_NOT_OK(buffer_->write(&chunk_size, sizeof(uint64_t)));
-    uint64_t buffer_offset = buffer_->offset();  // Will be used later
-    RETURN_NOT_OK(buffer_->write(&compressed_chunk_size, sizeof(uint64_t)));
-
-    // Create const buffer
-    auto input_buffer = new ConstBuffer(tile->cur_data(), chunk_size);
-
-    // Invoke the proper compressor
-    switch (compressor) {
-      case Compressor::GZIP:
-        st = GZip::compress(level, input_buffer, buffer_);
-        break;
-      case Compressor::ZSTD:
-        st = ZStd::compress(level, input_buffer, buffer_);
-        break;
-      case Compressor::LZ4:
-        st = LZ4::compress(level, input_buffer, buffer_);
-        break;
-      case Compressor::BLOSC_LZ:
-        st =
-            Blosc::compress("blosclz", type_size, level, input_buffer, buffer_);
-        break;
+uint64_t TileIO::compressor_overhead(
+    Compressor compressor, Tile* tile, uint64_t nbytes) const {
+  switch (compressor) {
+    case Compressor::GZIP:
+      return GZip::overhead(nbytes);
+    case Compressor::ZSTD:
+      return ZStd::overhead(nbytes);
+    case Compressor::LZ4:
+      return LZ4::overhead(nbytes);
+    case Compressor::BLOSC_LZ:
 #undef BLOSC_LZ4
-      case Compressor::BLOSC_LZ4:
-        st = Blosc::compress("lz4", type_size, level, input_buffer, buffer_);
-        break;
+    case Compressor::BLOSC_LZ4:
 #undef BLOSC_LZ4HC
-      case Compressor::BLOSC_LZ4HC:
-        st = Blosc::compress("lz4hc", type_size, level, input_buffer, buffer_);
-        break;
+    case Compressor::BLOSC_LZ4HC:
 #undef BLOSC_SNAPPY
-      case Compressor::BLOSC_SNAPPY:
-        st = Blosc::compress("snappy", type_size, level, input_buffer, buffer_);
-        break;
+    case Compressor::BLOSC_SNAPPY:
 #undef BLOSC_ZLIB
-      case Compressor::BLOSC_ZLIB:
-        st = Blosc::compress("zlib", type_size, level, input_buffer, buffer_);
-        break;
+    case Compressor::BLOSC_ZLIB:
 #undef BLOSC_ZSTD
-      case Compressor::BLOSC_ZSTD:
-        st = Blosc::compress("zstd", type_size, level, input_buffer, buffer_);
-        break;
-      case Compressor::RLE:
-        st = RLE::compress(cell_size, input_buffer, buffer_);
-        break;
-      case Compressor::BZIP2:
-        st = BZip::compress(level, input_buffer, buffer_);
-        break;
-      case Compressor::DOUBLE_DELTA:
-        st = DoubleDelta::compress(type, input_buffer, buffer_);
-        break;
-      default:
-        assert(0);
+    case Compressor::BLOSC_ZSTD:
+      return Blosc::overhead(nbytes);
+    case Compressor::RLE:
+      return RLE::overhead(nbytes, tile->cell_size());
+    case Compressor::BZIP2:
+      return BZip::overhead(nbytes);
+    case Compressor::DOUBLE_DELTA:
+      return DoubleDelta::overhead(nbytes);
+    case Compressor::AUTO: {
+      // The selected compressor precedes the compressed data
+      uint64_t overhead = 0;
+      for (auto candidate : auto_candidates)
+        overhead = MAX(overhead, compressor_overhead(candidate, tile, nbytes));
+      return sizeof(char) + overhead;
     }
-
-    delete input_buffer;
-    RETURN_NOT_OK(st);
-
-    // Write compressed chunk size
-    compressed_chunk_size =
-        buffer_->size() - (buffer_offset + sizeof(uint64_t));
-    std::memcpy(
-        buffer_->data(buffer_offset), &compressed_chunk_size, sizeof(uint64_t));
-
-    // Update
-    left_to_compress -= chunk_size;
-    tile->advance_offset(chunk_size);
+    default:
+      // No compression
+      return 0;
   }
-
-  assert(left_to_compress == 0);
-
-  return Status::Ok();
 }
 
 Status TileIO::compute_chunking_info(
@@ -424,6 +735,46 @@ Status TileIO::compute_chunking_info(
   return Status::Ok();
 }
 
+Status TileIO::decompress_chunk(
+    Compressor compressor,
+    Datatype type,
+    uint64_t cell_size,
+    ZStdDictionary* dictionary,
+    ConstBuffer* input_buffer,
+    Buffer* output_buffer) {
+  switch (compressor) {
+    case Compressor::NO_COMPRESSION:
+      return output_buffer->write(input_buffer->data(), input_buffer->size());
+    case Compressor::GZIP:
+      return GZip::decompress(input_buffer, output_buffer);
+    case Compressor::ZSTD:
+      return ZStd::decompress(dictionary, input_buffer, output_buffer);
+    case Compressor::LZ4:
+      return LZ4::decompress(input_buffer, output_buffer);
+    case Compressor::BLOSC_LZ:
+#undef BLOSC_LZ4
+    case Compressor::BLOSC_LZ4:
+#undef BLOSC_LZ4HC
+    case Compressor::BLOSC_LZ4HC:
+#undef BLOSC_SNAPPY
+    case Compressor::BLOSC_SNAPPY:
+#undef BLOSC_ZLIB
+    case Compressor::BLOSC_ZLIB:
+#undef BLOSC_ZSTD
+    case Compressor::BLOSC_ZSTD:
+      return Blosc::decompress(input_buffer, output_buffer);
+    case Compressor::RLE:
+      return RLE::decompress(cell_size, input_buffer, output_buffer);
+    case Compressor::BZIP2:
+      return BZip::decompress(input_buffer, output_buffer);
+    case Compressor::DOUBLE_DELTA:
+      return DoubleDelta::decompress(type, input_buffer, output_buffer);
+    default:
+      return LOG_STATUS(
+          Status::TileIOError("Cannot decompress tile; Invalid compressor"));
+  }
+}
+
 Status TileIO::decompress_tile(Tile* tile) {
   // Simple case - No coordinates
   if (!tile->stores_coords())
@@ -435,106 +786,120 @@ Status TileIO::decompress_tile(Tile* tile) {
     RETURN_NOT_OK(decompress_one_tile(tile));
 
   // Zip coordinates
-  tile->zip_coordinates();
+  RETURN_NOT_OK(tile->zip_coordinates(filter_scratch_));
 
   return Status::Ok();
 }
 
-Status TileIO::decompress_one_tile(Tile* tile) {
-  // Read number of chunks
-  uint64_t chunk_num;
-
-  RETURN_NOT_OK(buffer_->read(&chunk_num, sizeof(uint64_t)));
-  assert(chunk_num > 0);
-
-  Status st;
-  Datatype type = tile->type();
-  for (uint64_t i = 0; i < chunk_num; ++i) {
-    // Read original and compressed chunk size
-    uint64_t chunk_size, compressed_chunk_size;
-    RETURN_NOT_OK(buffer_->read(&chunk_size, sizeof(uint64_t)));
-    RETURN_NOT_OK(buffer_->read(&compressed_chunk_size, sizeof(uint64_t)));
+uint64_t TileIO::overhead(Tile* tile, uint64_t nbytes) const {
+  // The compressor runs on the output of the filters
+  auto filters = tile->filters();
+  uint64_t filter_overhead =
+      (filters != nullptr) ? filters->overhead(tile->type(), nbytes) : 0;
+  return filter_overhead +
+         compressor_overhead(
+             tile->compressor(), tile, nbytes + filter_overhead);
+}
 
-    auto input_buffer =
-        new ConstBuffer(buffer_->cur_data(), compressed_chunk_size);
+Status TileIO::select_compressor(Tile* tile, Compressor* compressor) {
+  // For easy reference
+  auto level = tile->compression_level();
+  auto type = tile->type();
+  auto cell_size = tile->cell_size();
+  auto tile_size = tile->size();
+  auto data = (const char*)tile->cur_data();
+  auto filters = tile->filters();
+  bool filtered = filters != nullptr && !filters->empty();
+
+  // Retrieve the objective from the config only once
+  if (auto_tolerance_ < 0) {
+    auto objective =
+        (storage_manager_ != nullptr) ?
+            storage_manager_->config().sm_params().auto_compression_objective_ :
+            std::string(constants::auto_compression_objective);
+    auto_tolerance_ =
+        (objective == "ratio") ? 0 : (objective == "speed") ? 0.5 : 0.1;
+  }
 
-    // Invoke the proper decompressor
-    switch (tile->compressor()) {
-      case Compressor::NO_COMPRESSION:
-        assert(0);
-        break;
-      case Compressor::GZIP:
-        st = GZip::decompress(input_buffer, tile->buffer());
-        break;
-      case Compressor::ZSTD:
-        st = ZStd::decompress(input_buffer, tile->buffer());
-        break;
-      case Compressor::LZ4:
-        st = LZ4::decompress(input_buffer, tile->buffer());
-        break;
-      case Compressor::BLOSC_LZ:
-#undef BLOSC_LZ4
-      case Compressor::BLOSC_LZ4:
-#undef BLOSC_LZ4HC
-      case Compressor::BLOSC_LZ4HC:
-#undef BLOSC_SNAPPY
-      case Compressor::BLOSC_SNAPPY:
-#undef BLOSC_ZLIB
-      case Compressor::BLOSC_ZLIB:
-#undef BLOSC_ZSTD
-      case Compressor::BLOSC_ZSTD:
-        st = Blosc::decompress(input_buffer, tile->buffer());
-        break;
-      case Compressor::RLE:
-        st = RLE::decompress(tile->cell_size(), input_buffer, tile->buffer());
-        break;
-      case Compressor::BZIP2:
-        st = BZip::decompress(input_buffer, tile->buffer());
-        break;
-      case Compressor::DOUBLE_DELTA:
-        st = DoubleDelta::decompress(type, input_buffer, tile->buffer());
-        break;
+  // Sample whole cells from evenly spaced slices of the tile
+  uint64_t cell_num = tile_size / cell_size;
+  uint64_t slice_num = constants::auto_compression_sample_slices;
+  uint64_t slice_cell_num =
+      MAX(constants::auto_compression_sample_size / slice_num / cell_size, 1);
+  Buffer sample;
+  const char* sample_data = data;
+  uint64_t sample_size = tile_size;
+  if (cell_num > slice_num * slice_cell_num) {
+    RETURN_NOT_OK(sample.realloc(slice_num * slice_cell_num * cell_size));
+    for (uint64_t i = 0; i < slice_num; ++i) {
+      uint64_t first =
+          (slice_num > 1) ? i * (cell_num - slice_cell_num) / (slice_num - 1) :
+                            0;
+      RETURN_NOT_OK(sample.write(
+          data + first * cell_size, slice_cell_num * cell_size));
     }
+    sample_data = (const char*)sample.data();
+    sample_size = sample.size();
+  }
 
-    delete input_buffer;
-    RETURN_NOT_OK(st);
-
-    buffer_->advance_offset(compressed_chunk_size);
+  // The compressors run on the output of the filters
+  if (filtered) {
+    ConstBuffer input(sample_data, sample_size);
+    filter_buffer_->reset_size();
+    filter_buffer_->reset_offset();
+    RETURN_NOT_OK(
+        filters->run_forward(type, &input, filter_buffer_, filter_scratch_));
+    sample_data = (const char*)filter_buffer_->data();
+    sample_size = filter_buffer_->size();
   }
 
-  return st;
-}
+  // Compress the sample with each candidate. Filtered data are not made of
+  // typed values, which RLE and double delta rely on. A candidate that fails
+  // on the sample is not selectable.
+  const uint64_t candidate_num =
+      sizeof(auto_candidates) / sizeof(auto_candidates[0]);
+  uint64_t sizes[candidate_num];
+  uint64_t min_size = std::numeric_limits<uint64_t>::max();
+  Buffer compressed;
+  for (uint64_t i = 0; i < candidate_num; ++i) {
+    auto candidate = auto_candidates[i];
+    sizes[i] = std::numeric_limits<uint64_t>::max();
+    if (filtered && (candidate == Compressor::RLE ||
+                     candidate == Compressor::DOUBLE_DELTA))
+      continue;
+    ConstBuffer input(sample_data, sample_size);
+    compressed.reset_size();
+    compressed.reset_offset();
+    uint64_t capacity =
+        sample_size + compressor_overhead(candidate, tile, sample_size);
+    if (compressed.alloced_size() < capacity)
+      RETURN_NOT_OK(compressed.realloc(capacity));
+    Status st = compress_chunk(
+        candidate,
+        level,
+        type,
+        cell_size,
+        dictionary_,
+        &input,
+        &compressed);
+    if (!st.ok() || (compressed.size() == 0 && sample_size != 0))
+      continue;
+    sizes[i] = compressed.size();
+    min_size = MIN(min_size, sizes[i]);
+  }
 
-uint64_t TileIO::overhead(Tile* tile, uint64_t nbytes) const {
-  switch (tile->compressor()) {
-    case Compressor::GZIP:
-      return GZip::overhead(nbytes);
-    case Compressor::ZSTD:
-      return ZStd::overhead(nbytes);
-    case Compressor::LZ4:
-      return LZ4::overhead(nbytes);
-    case Compressor::BLOSC_LZ:
-#undef BLOSC_LZ4
-    case Compressor::BLOSC_LZ4:
-#undef BLOSC_LZ4HC
-    case Compressor::BLOSC_LZ4HC:
-#undef BLOSC_SNAPPY
-    case Compressor::BLOSC_SNAPPY:
-#undef BLOSC_ZLIB
-    case Compressor::BLOSC_ZLIB:
-#undef BLOSC_ZSTD
-    case Compressor::BLOSC_ZSTD:
-      return Blosc::overhead(nbytes);
-    case Compressor::RLE:
-      return RLE::overhead(nbytes, tile->cell_size());
-    case Compressor::BZIP2:
-      return BZip::overhead(nbytes);
-    case Compressor::DOUBLE_DELTA:
-      return DoubleDelta::overhead(nbytes);
-    default:
-      // No compression
-      return 0;
+  // Select the fastest candidate to decompress that compresses the sample
+  // within the tolerance of the objective
+  *compressor = Compressor::NO_COMPRESSION;
+  for (uint64_t i = 0; i < candidate_num; ++i) {
+    if (sizes[i] != std::numeric_limits<uint64_t>::max() &&
+        sizes[i] <= min_size * (1 + auto_tolerance_)) {
+      *compressor = auto_candidates[i];
+      break;
+    }
   }
+
+  return Status::Ok();
 }
 
 }  // namespace sm
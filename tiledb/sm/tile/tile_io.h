@@ -41,6 +41,7 @@ namespace tiledb {
 namespace sm {
 
 class StorageManager;
+class ZStdDictionary;
 
 /** Handles IO (reading/writing) for tiles. */
 class TileIO {
@@ -76,6 +77,34 @@ class TileIO {
   /*                API                */
   /* ********************************* */
 
+  /** Returns the internal buffer that holds the compressed tile data. */
+  Buffer* buffer() const;
+
+  /**
+   * Compresses a single tile, starting at the current tile offset. The
+   * compressed data are appended to the internal buffer (see `buffer()`),
+   * which the caller should reset beforehand when compressing a tile
+   * in isolation (e.g., for benchmarking). With the AUTO compressor, the
+   * compressor selected for the tile precedes the data of each chunk.
+   *
+   * @param tile The tile to be compressed.
+   * @return Status
+   */
+  Status compress_one_tile(Tile* tile);
+
+  /**
+   * Decompresses the internal buffer, starting at its current offset, into
+   * a tile. The tile buffer must have been reset and allocated enough space
+   * to hold the decompressed data.
+   *
+   * @param tile The tile where the decompressed data will be stored.
+   * @return Status
+   */
+  Status decompress_one_tile(Tile* tile);
+
+  /** Returns the zstd dictionary of the object (`nullptr` if none). */
+  const ZStdDictionary* dictionary() const;
+
   /** Returns the size of the file. */
   uint64_t file_size() const;
 
@@ -97,9 +126,10 @@ class TileIO {
   /**
    * Reads a generic tile from the file. This means that there are not tile
    * metadata kept anywhere except for the file. Therefore, the function
-   * first reads a small header to retrieve appropriate information about
-   * the tile, and then reads the tile data. Note that it creates a new
-   * Tile object.
+   * reads a small header to retrieve appropriate information about the
+   * tile, along with the start of the tile data, and then reads the rest of
+   * the tile data only if the tile does not fit in the first read. Note that
+   * it creates a new Tile object.
    *
    * @param tile The tile that will hold the read data.
    * @param file_offset The offset in the file to read from.
@@ -108,12 +138,12 @@ class TileIO {
   Status read_generic(Tile** tile, uint64_t file_offset);
 
   /**
-   * Reads the generic tile header from the file. It also creates a new tile
+   * Parses the generic tile header at the start of the internal buffer,
+   * which holds the bytes read from the file. It also creates a new tile
    * with the header information, and retrieves the tile original and
    * compressed size.
    *
    * @param tile The tile to be created.
-   * @param file_offset The offset where the header read will begin.
    * @param tile_size The original tile size to be retrieved.
    * @param compressed_size The compressed tile size to be retrieved.
    * @param header_size The size of the retrieved header.
@@ -121,11 +151,42 @@ class TileIO {
    */
   Status read_generic_tile_header(
       Tile** tile,
-      uint64_t file_offset,
       uint64_t* tile_size,
       uint64_t* compressed_size,
       uint64_t* header_size);
 
+  /**
+   * Sets the zstd dictionary `ZSTD` chunks are (de)compressed with.
+   *
+   * @param data The dictionary contents, which are copied.
+   * @param size The dictionary size (`0` to remove the dictionary).
+   * @return void
+   */
+  void set_dictionary(const void* data, uint64_t size);
+
+  /**
+   * Trains a zstd dictionary on evenly spaced samples of the input data,
+   * after running the filters of the input tile on each of them, and sets
+   * it as the dictionary of the object (see `set_dictionary()`). No
+   * dictionary is set if the data are too few to train one on, or if the
+   * dictionary is not expected to save more than its own size.
+   *
+   * @param tile The tile the data will be written through, which determines
+   *     the filters and the cell size the samples are aligned to.
+   * @param data The data to sample.
+   * @param size The size of `data`.
+   * @param sample_size The (maximum) size of each sample, typically the
+   *     tile size.
+   * @param capacity The maximum dictionary size.
+   * @return Status
+   */
+  Status train_dictionary(
+      Tile* tile,
+      const void* data,
+      uint64_t size,
+      uint64_t sample_size,
+      uint64_t capacity);
+
   /**
    * Writes (appends) a tile into the file.
    *
@@ -163,15 +224,41 @@ class TileIO {
   /*         PRIVATE ATTRIBUTES        */
   /* ********************************* */
 
+  /**
+   * How much larger than the smallest compressed sample the sample of the
+   * compressor selected by the AUTO compressor may be, as a fraction of the
+   * former. It is derived from the `sm.auto_compression_objective` config
+   * parameter upon the first selection (negative until then).
+   */
+  double auto_tolerance_;
+
   /**
    * An internal buffer used to facilitate compression/decompression (or
    * other future filters).
    */
   Buffer* buffer_;
 
+  /**
+   * The zstd dictionary `ZSTD` chunks are (de)compressed with (`nullptr` if
+   * there is none).
+   */
+  ZStdDictionary* dictionary_;
+
   /** The size of the file pointed by `uri_`. */
   uint64_t file_size_;
 
+  /**
+   * An internal buffer holding the filtered data of a tile chunk, i.e.,
+   * the input of the compressor upon writing and its output upon reading.
+   */
+  Buffer* filter_buffer_;
+
+  /**
+   * A scratch buffer used by filter pipelines with multiple filters, and
+   * to split and zip the coordinates of coordinate tiles.
+   */
+  Buffer* filter_scratch_;
+
   /** The storage manager object. */
   StorageManager* storage_manager_;
 
@@ -182,6 +269,27 @@ class TileIO {
   /*          PRIVATE METHODS          */
   /* ********************************* */
 
+  /**
+   * Compresses a chunk with the input compressor.
+   *
+   * @param compressor The compressor.
+   * @param level The compression level.
+   * @param type The type of the chunk values.
+   * @param cell_size The cell size of the chunk.
+   * @param dictionary The zstd dictionary (if any).
+   * @param input_buffer The chunk to be compressed.
+   * @param output_buffer The buffer the compressed chunk is appended to.
+   * @return Status
+   */
+  static Status compress_chunk(
+      Compressor compressor,
+      int level,
+      Datatype type,
+      uint64_t cell_size,
+      ZStdDictionary* dictionary,
+      ConstBuffer* input_buffer,
+      Buffer* output_buffer);
+
   /**
    * Compresses a tile. The compressed data are written in buffer_.
    * Note that a coordinates tile must be split into one tile per
@@ -194,12 +302,11 @@ class TileIO {
   Status compress_tile(Tile* tile);
 
   /**
-   * Compresses a single tile. The compressed data are written in buffer_.
-   *
-   * @param tile The tile to be compressed.
-   * @return Status
+   * Computes the overhead of the input compressor alone on *nbytes* of the
+   * input tile.
    */
-  Status compress_one_tile(Tile* tile);
+  uint64_t compressor_overhead(
+      Compressor compressor, Tile* tile, uint64_t nbytes) const;
 
   /**
    * Computes necessary info for chunking a tile upon compression.
@@ -216,6 +323,25 @@ class TileIO {
       uint64_t* max_chunk_size,
       uint64_t* overhead);
 
+  /**
+   * Decompresses a chunk with the input compressor.
+   *
+   * @param compressor The compressor.
+   * @param type The type of the chunk values.
+   * @param cell_size The cell size of the chunk.
+   * @param dictionary The zstd dictionary (if any).
+   * @param input_buffer The chunk to be decompressed.
+   * @param output_buffer The buffer the decompressed chunk is appended to.
+   * @return Status
+   */
+  static Status decompress_chunk(
+      Compressor compressor,
+      Datatype type,
+      uint64_t cell_size,
+      ZStdDictionary* dictionary,
+      ConstBuffer* input_buffer,
+      Buffer* output_buffer);
+
   /**
    * Decompresses buffer_ into a tile.
    * Note that a coordinates tile was split into one tile per
@@ -228,15 +354,22 @@ class TileIO {
   Status decompress_tile(Tile* tile);
 
   /**
-   * Decompresses buffer_ into a tile.
+   * Computes the encoding overhead (filters plus compression) on *nbytes*
+   * of the input tile.
+   */
+  uint64_t overhead(Tile* tile, uint64_t nbytes) const;
+
+  /**
+   * Selects the compressor of a tile with the AUTO compressor. Each
+   * candidate compressor is tried on a sample of the tile (after its
+   * filters), and the fastest one to decompress among those whose output
+   * is within the tolerance of the smallest one is selected.
    *
-   * @param tile The tile where the decompressed data will be stored.
+   * @param tile The tile, starting at its current offset.
+   * @param compressor The selected compressor.
    * @return Status
    */
-  Status decompress_one_tile(Tile* tile);
-
-  /** Computes the compression overhead on *nbytes* of the input tile. */
-  uint64_t overhead(Tile* tile, uint64_t nbytes) const;
+  Status select_compressor(Tile* tile, Compressor* compressor);
 };
 
 }  // namespace sm